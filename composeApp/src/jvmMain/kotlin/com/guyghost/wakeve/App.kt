@@ -209,6 +209,12 @@ fun App() {
                     )
                 }
 
+                // Logout leaves this branch and app exit disposes it: stop syncing, including
+                // any open debounce window, so nothing is sent once the user is signed out
+                DisposableEffect(syncManager) {
+                    onDispose { syncManager.dispose() }
+                }
+
                 val repository = remember {
                     SyncedEventRepository(database, syncManager)
                 }
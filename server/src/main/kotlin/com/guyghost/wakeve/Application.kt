@@ -3,9 +3,11 @@ package com.guyghost.wakeve
 import com.auth0.jwt.JWT
 import com.auth0.jwt.algorithms.Algorithm
 import com.guyghost.wakeve.analytics.AnalyticsDashboard
+import com.guyghost.wakeve.analytics.DashboardStatsRebuilder
 import com.guyghost.wakeve.auth.AppleOAuth2Service
 import com.guyghost.wakeve.auth.AuthenticationService
 import com.guyghost.wakeve.auth.GoogleOAuth2Service
+import com.guyghost.wakeve.auth.DatabaseTokenRevocationBus
 import com.guyghost.wakeve.cache.JwtBlacklistCache
 import com.guyghost.wakeve.calendar.CalendarService
 import com.guyghost.wakeve.calendar.PlatformCalendarServiceImpl
@@ -14,15 +16,17 @@ import com.guyghost.wakeve.metrics.AuthMetricsCollector
 import com.guyghost.wakeve.notification.EventNotificationTrigger
 import com.guyghost.wakeve.notification.NotificationPreferencesRepository
 import com.guyghost.wakeve.notification.NotificationScheduler
+import com.guyghost.wakeve.notification.PushDeliveryPipeline
 import com.guyghost.wakeve.notification.ServerAPNsSender
 import com.guyghost.wakeve.notification.ServerFCMSender
 import com.guyghost.wakeve.moderation.ModerationPolicy
 import com.guyghost.wakeve.moderation.ModerationRepository
+import com.guyghost.wakeve.moderation.ModerationTermsFile
 import com.guyghost.wakeve.gamification.BadgeEligibilityChecker
 import com.guyghost.wakeve.gamification.GamificationService
 import com.guyghost.wakeve.gamification.repository.InMemoryUserBadgesRepository
 import com.guyghost.wakeve.gamification.repository.InMemoryUserPointsRepository
-import com.guyghost.wakeve.repository.PotentialLocationRepository
+import com.guyghost.wakeve.repository.DatabasePotentialLocationRepository
 import com.guyghost.wakeve.repository.PotentialLocationRepositoryInterface
 import com.guyghost.wakeve.routes.ChatService
 import com.guyghost.wakeve.routes.analyticsRoutes
@@ -31,7 +35,10 @@ import com.guyghost.wakeve.routes.authRoutes
 import com.guyghost.wakeve.routes.budgetRoutes
 import com.guyghost.wakeve.routes.calendarRoutes
 import com.guyghost.wakeve.routes.chatRoutes
+import com.guyghost.wakeve.routes.TcpChatBroadcastBroker
 import com.guyghost.wakeve.routes.chatWebSocketRoute
+import com.guyghost.wakeve.routes.createChatBroadcastBus
+import com.guyghost.wakeve.routes.eventChatConnections
 import com.guyghost.wakeve.routes.commentRoutes
 import com.guyghost.wakeve.routes.dashboardRoutes
 import com.guyghost.wakeve.routes.eventRoutes
@@ -55,6 +62,7 @@ import com.guyghost.wakeve.routes.voteRoutes
 import com.guyghost.wakeve.invitation.InvitationRepository
 import com.guyghost.wakeve.sync.SyncService
 import com.guyghost.wakeve.auth.SessionRepository
+import com.guyghost.wakeve.auth.TokenRevocationBus
 import com.guyghost.wakeve.database.DatabaseProvider
 import com.guyghost.wakeve.repository.DatabaseEventRepository
 import com.guyghost.wakeve.repository.ScenarioRepository
@@ -63,6 +71,7 @@ import com.guyghost.wakeve.payment.TricountHandoffRepository
 import io.ktor.http.HttpStatusCode
 import io.ktor.serialization.kotlinx.json.json
 import io.ktor.server.application.Application
+import io.ktor.server.application.ApplicationStopping
 import io.ktor.server.application.createRouteScopedPlugin
 import io.ktor.server.application.install
 import io.ktor.server.auth.Authentication
@@ -88,8 +97,14 @@ import io.micrometer.core.instrument.binder.jvm.JvmThreadMetrics
 import io.micrometer.core.instrument.binder.system.ProcessorMetrics
 import io.micrometer.prometheusmetrics.PrometheusConfig
 import io.micrometer.prometheusmetrics.PrometheusMeterRegistry
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.runBlocking
 import kotlinx.serialization.json.Json
 import kotlin.time.Duration.Companion.minutes
+import java.io.File
+import java.net.InetAddress
 
 const val SERVER_PORT = 8080
 
@@ -97,7 +112,6 @@ const val SERVER_PORT = 8080
  * Configuration for JWT Blacklist checking plugin.
  */
 class JWTBlacklistConfig {
-    var sessionRepository: SessionRepository? = null
     var jwtBlacklistCache: JwtBlacklistCache? = null
 }
 
@@ -106,14 +120,13 @@ class JWTBlacklistConfig {
  *
  * This plugin intercepts authenticated requests and checks if the JWT token
  * has been revoked/blacklisted. If the token is blacklisted, it responds
- * with 401 Unauthorized.
+ * with 401 Unauthorized. The check is in memory only: the blacklist is loaded
+ * at startup and kept current by the token revocation bus.
  */
 val JWTBlacklistPlugin = createRouteScopedPlugin(
     name = "JWTBlacklistPlugin",
     createConfiguration = ::JWTBlacklistConfig
 ) {
-    val sessionRepository = pluginConfig.sessionRepository
-        ?: error("SessionRepository must be configured for JWTBlacklistPlugin")
     val jwtBlacklistCache = pluginConfig.jwtBlacklistCache
         ?: error("JwtBlacklistCache must be configured for JWTBlacklistPlugin")
 
@@ -126,24 +139,7 @@ val JWTBlacklistPlugin = createRouteScopedPlugin(
         val token = authHeader?.removePrefix("Bearer ")?.trim()
 
         if (token != null) {
-            // Check cache first (non-blocking)
-            val cachedResult = jwtBlacklistCache.get(token)
-
-            val isBlacklisted = if (cachedResult != null) {
-                // Use cached result
-                cachedResult
-            } else {
-                // Check database and cache result
-                val result = sessionRepository.isTokenBlacklisted(token)
-                    .getOrElse {
-                        // SECURITY: Fail closed - if we can't verify the token status,
-                        // assume it's revoked to be safe. Log the error for debugging.
-                        this@createRouteScopedPlugin.environment.log.error("Failed to check token blacklist", it)
-                        true // Fail closed for security
-                    }
-                jwtBlacklistCache.put(token, result)
-                result
-            }
+            val isBlacklisted = jwtBlacklistCache.isBlacklisted(token)
 
             if (isBlacklisted) {
                 call.respond(
@@ -222,15 +218,23 @@ val PermissionCheckPlugin = createRouteScopedPlugin(
     }
 }
 
-fun main() {
+fun main(args: Array<String>) {
     // Initialize database
     val database = DatabaseProvider.getDatabase(JvmDatabaseFactory("wakev_server.db"))
+
+    // Maintenance command: recompute the dashboard counters, then exit
+    if (args.firstOrNull() == "rebuild-dashboard-stats") {
+        val result = DashboardStatsRebuilder(database).rebuild()
+        println("Rebuilt dashboard stats for ${result.organizers} organizers (${result.repairedOrganizers} repaired)")
+        return
+    }
+
     val eventRepository = DatabaseEventRepository(database)
     val scenarioRepository = ScenarioRepository(database)
     val budgetRepository = com.guyghost.wakeve.budget.BudgetRepository(database)
     val mealRepository = com.guyghost.wakeve.meal.MealRepository(database)
     val commentRepository = com.guyghost.wakeve.comment.CommentRepository(database)
-    val locationRepository = PotentialLocationRepository(eventRepository)
+    val locationRepository = DatabasePotentialLocationRepository(database, eventRepository)
     val accommodationRepository = com.guyghost.wakeve.accommodation.AccommodationRepository(database)
     val transportRepository = TransportRepository(database)
     val tricountHandoffRepository = TricountHandoffRepository(database)
@@ -239,10 +243,29 @@ fun main() {
     val platformCalendarService = PlatformCalendarServiceImpl()
     val calendarService = CalendarService(database, platformCalendarService)
     
+    // Chat broadcast bus: in-process unless CHAT_BUS_ADDRESS points at a broker.
+    // CHAT_BUS_BROKER_PORT makes this node host the broker for the others, on loopback
+    // unless CHAT_BUS_BROKER_HOST names a private interface.
+    val chatBusSecret = System.getenv("CHAT_BUS_SECRET")
+    System.getenv("CHAT_BUS_BROKER_PORT")?.toIntOrNull()?.let { port ->
+        // SECURITY: peers must prove they know the shared secret before they can publish or subscribe
+        val secret = chatBusSecret
+            ?: throw IllegalStateException("CHAT_BUS_SECRET environment variable must be set when CHAT_BUS_BROKER_PORT is set")
+        val bindAddress = System.getenv("CHAT_BUS_BROKER_HOST")
+            ?.let(InetAddress::getByName)
+            ?: InetAddress.getLoopbackAddress()
+        TcpChatBroadcastBroker(secret, port, bindAddress).start()
+    }
+    eventChatConnections.connectBus(createChatBroadcastBus(secret = chatBusSecret))
+
     // Initialize Chat Service
     val moderationRepository = ModerationRepository(database)
     val moderationPolicy = ModerationPolicy()
-    val chatService = ChatService(database, moderationRepository = moderationRepository)
+    // MODERATION_TERMS_FILE replaces the built-in term lists and is re-read when edited
+    System.getenv("MODERATION_TERMS_FILE")?.let { path ->
+        ModerationTermsFile(File(path), moderationPolicy).watch(CoroutineScope(Dispatchers.IO + SupervisorJob()))
+    }
+    val chatService = ChatService(database, moderationPolicy = moderationPolicy, moderationRepository = moderationRepository)
 
     // Initialize Analytics Dashboard
     val analyticsDashboard = AnalyticsDashboard(database)
@@ -255,18 +278,19 @@ fun main() {
 
     // Initialize Notification Service
     val notificationPreferencesRepo = NotificationPreferencesRepository(database)
-    val fcmSender = ServerFCMSender()
-    val apnsSender = ServerAPNsSender()
+    // Push delivery is queued and batched by the pipeline, in front of the pooled senders
+    val pushDeliveryPipeline = PushDeliveryPipeline(ServerFCMSender(), ServerAPNsSender())
+    pushDeliveryPipeline.start(CoroutineScope(Dispatchers.IO + SupervisorJob()))
     val notificationService = com.guyghost.wakeve.notification.NotificationService(
         database = database,
         preferencesRepository = notificationPreferencesRepo,
-        fcmSender = fcmSender,
-        apnsSender = apnsSender
+        fcmSender = pushDeliveryPipeline.fcm,
+        apnsSender = pushDeliveryPipeline.apns
     )
     val eventNotificationTrigger = EventNotificationTrigger(notificationService, eventRepository, moderationRepository)
 
     // Initialize and start the notification scheduler
-    val notificationScheduler = NotificationScheduler(notificationService, eventNotificationTrigger, eventRepository)
+    val notificationScheduler = NotificationScheduler(notificationService, eventNotificationTrigger, eventRepository, database)
     notificationScheduler.start()
 
     embeddedServer(Netty, port = SERVER_PORT, host = "0.0.0.0", module = {
@@ -288,7 +312,8 @@ fun main() {
             eventNotificationTrigger = eventNotificationTrigger,
             gamificationService = gamificationService,
             transportRepository = transportRepository,
-            moderationPolicy = moderationPolicy
+            moderationPolicy = moderationPolicy,
+            pushDeliveryPipeline = pushDeliveryPipeline
         )
     }).start(wait = true)
 }
@@ -300,7 +325,7 @@ fun Application.module(
     budgetRepository: com.guyghost.wakeve.budget.BudgetRepository = com.guyghost.wakeve.budget.BudgetRepository(database),
     mealRepository: com.guyghost.wakeve.meal.MealRepository = com.guyghost.wakeve.meal.MealRepository(database),
     commentRepository: com.guyghost.wakeve.comment.CommentRepository = com.guyghost.wakeve.comment.CommentRepository(database),
-    locationRepository: PotentialLocationRepositoryInterface = PotentialLocationRepository(eventRepository),
+    locationRepository: PotentialLocationRepositoryInterface = DatabasePotentialLocationRepository(database, eventRepository),
     calendarService: CalendarService = CalendarService(database, PlatformCalendarServiceImpl()),
     moderationRepository: ModerationRepository = ModerationRepository(database),
     moderationPolicy: ModerationPolicy = ModerationPolicy(),
@@ -316,7 +341,9 @@ fun Application.module(
     ),
     eventNotificationTrigger: EventNotificationTrigger = EventNotificationTrigger(notificationService, eventRepository, moderationRepository),
     gamificationService: GamificationService = createGamificationService(),
-    transportRepository: TransportRepository = TransportRepository(database)
+    transportRepository: TransportRepository = TransportRepository(database),
+    tokenRevocationBus: TokenRevocationBus = DatabaseTokenRevocationBus(SessionRepository(database)),
+    pushDeliveryPipeline: PushDeliveryPipeline? = null
 ) {
     // Initialize metrics
     val meterRegistry = PrometheusMeterRegistry(PrometheusConfig.DEFAULT)
@@ -327,6 +354,37 @@ fun Application.module(
     JvmMemoryMetrics().bindTo(meterRegistry)
     JvmThreadMetrics().bindTo(meterRegistry)
     ProcessorMetrics().bindTo(meterRegistry)
+    chatService.persistenceMetrics.bindTo(meterRegistry)
+    pushDeliveryPipeline?.metrics?.bindTo(meterRegistry)
+    eventNotificationTrigger.notificationRateLimiter.metrics.bindTo(meterRegistry)
+
+    // Send the open notification batches, then deliver the pushes already accepted,
+    // before the process exits
+    monitor.subscribe(ApplicationStopping) {
+        runBlocking {
+            chatService.shutdown()
+            eventNotificationTrigger.shutdown()
+            pushDeliveryPipeline?.let { pipeline ->
+                val undelivered = pipeline.drain(PushDeliveryPipeline.DEFAULT_DRAIN_TIMEOUT_MS)
+                if (undelivered > 0) {
+                    environment.log.warn("Push delivery drain timed out with $undelivered pushes queued")
+                }
+            }
+        }
+    }
+
+    // In-memory JWT blacklist: subscribe before loading so no revocation falls in between,
+    // then follow revocations made by other instances.
+    // SECURITY: startup fails if the blacklist cannot be loaded, rather than serving without it.
+    val jwtBlacklistCache = JwtBlacklistCache()
+    jwtBlacklistCache.metrics.bindTo(meterRegistry)
+    tokenRevocationBus.subscribe(jwtBlacklistCache::recordRevoked)
+    jwtBlacklistCache.loadRevoked(runBlocking { SessionRepository(database).getRevokedTokens() }.getOrThrow())
+    tokenRevocationBus.startPropagation(this)
+    jwtBlacklistCache.startExpiryPurge(this)
+
+    // Analytics rollups: loaded once, then only the days touched by new rows are re-rolled
+    analyticsDashboard.rollup.startRefresh(this)
 
     // Initialize authentication services
     // SECURITY: JWT_SECRET environment variable is required
@@ -368,11 +426,13 @@ fun Application.module(
         jwtIssuer = jwtIssuer,
         jwtAudience = jwtAudience,
         googleService = googleOAuth2,
-        appleService = appleOAuth2
+        appleService = appleOAuth2,
+        onTokenRevoked = tokenRevocationBus::publish
     )
 
     // OTP manager pour l'authentification par email
     val otpManager = com.guyghost.wakeve.auth.OtpManager()
+    otpManager.requestLimiter.metrics.bindTo(meterRegistry)
 
     // Nettoyage périodique des OTP expirés (toutes les 10 minutes)
     java.util.Timer("otp-cleanup", true).scheduleAtFixedRate(
@@ -383,10 +443,8 @@ fun Application.module(
         600_000L  // intervalle: 10 minutes
     )
 
-    val sessionRepository = SessionRepository(database)
-    val sessionManager = SessionManager(database)
-    val jwtBlacklistCache = JwtBlacklistCache()
-    val syncService = SyncService(database)
+    val sessionManager = SessionManager(database, tokenRevocationBus::publish)
+    val syncService = SyncService(database, eventNotificationTrigger::onEventUpdated)
     val tricountHandoffRepository = TricountHandoffRepository(database)
 
     // Install plugins
@@ -487,13 +545,12 @@ fun Application.module(
                 authenticate("auth-jwt") {
                     // WebSocket endpoint for real-time chat. Authentication is required so
                     // moderation block filters can be applied per recipient.
-                    chatWebSocketRoute(database, moderationRepository)
+                    chatWebSocketRoute(database, moderationRepository, chatService.presence)
 
                     rateLimit(RateLimitName("api")) {
                         route("/api") {
                             // Install JWT blacklist checking for all API routes
                             install(JWTBlacklistPlugin) {
-                                this.sessionRepository = sessionRepository
                                 this.jwtBlacklistCache = jwtBlacklistCache
                             }
 
@@ -1,5 +1,6 @@
 package com.guyghost.wakeve
 
+import com.guyghost.wakeve.auth.RevokedTokenData
 import com.guyghost.wakeve.auth.SessionData
 import com.guyghost.wakeve.auth.SessionRepository
 import com.guyghost.wakeve.database.WakeveDb
@@ -9,8 +10,11 @@ import com.guyghost.wakeve.database.WakeveDb
  *
  * This manager provides high-level session operations for the server endpoints.
  */
-class SessionManager(private val database: WakeveDb) {
-    private val sessionRepository = SessionRepository(database)
+class SessionManager(
+    private val database: WakeveDb,
+    onTokenRevoked: (RevokedTokenData) -> Unit = {}
+) {
+    private val sessionRepository = SessionRepository(database, onTokenRevoked)
 
     /**
      * Get all active sessions for a user
@@ -4,17 +4,20 @@ import com.guyghost.wakeve.database.WakeveDb
 import kotlinx.datetime.Clock
 import kotlinx.datetime.DateTimeUnit
 import kotlinx.datetime.TimeZone
-import kotlinx.datetime.atStartOfDayIn
 import kotlinx.datetime.minus
-import kotlinx.datetime.toLocalDateTime
 import kotlinx.serialization.Serializable
 
 /**
  * Service for calculating analytics metrics.
  *
  * Provides metrics for MAU, DAU, retention, and event creation funnels.
+ * Those are answered from the in-memory daily bitmaps and counters of
+ * [rollup] rather than by scanning the analytics tables per request.
  */
-class AnalyticsDashboard(private val database: WakeveDb) {
+class AnalyticsDashboard(
+    private val database: WakeveDb,
+    val rollup: AnalyticsRollup = AnalyticsRollup(database)
+) {
 
     @Serializable
     data class Metrics(
@@ -35,14 +38,11 @@ class AnalyticsDashboard(private val database: WakeveDb) {
     /**
      * Get Monthly Active Users (MAU)
      *
-     * @return Number of unique users active in the last 30 days
+     * @return Number of unique users active in the last 30 days (UTC, today included)
      */
     fun getMAU(): Int {
-        val thirtyDaysAgo = Clock.System.now().minus(30, DateTimeUnit.DAY, TimeZone.UTC)
-        return database.analyticsQueries
-            .getActiveUsersSince(thirtyDaysAgo.toEpochMilliseconds())
-            .executeAsOne()
-            .toInt()
+        val today = rollup.today()
+        return rollup.activeUsers(today - 29, today)
     }
 
     /**
@@ -51,37 +51,22 @@ class AnalyticsDashboard(private val database: WakeveDb) {
      * @return Number of unique users active today (UTC)
      */
     fun getDAU(): Int {
-        val today = Clock.System.now().toLocalDateTime(TimeZone.UTC).date
-        val startOfDay = today.atStartOfDayIn(TimeZone.UTC)
-
-        return database.analyticsQueries
-            .getActiveUsersSince(startOfDay.toEpochMilliseconds())
-            .executeAsOne()
-            .toInt()
+        val today = rollup.today()
+        return rollup.activeUsers(today, today)
     }
 
     /**
      * Get retention cohort analysis
      *
-     * Calculates retention rate for users who signed up N days ago.
+     * Calculates the share of users who signed up N days ago and were active
+     * again on any later day.
      *
      * @param days Number of days ago for cohort analysis (default: 7)
      * @return Retention rate as percentage (0-100)
      */
     fun getRetention(days: Int = 7): Double {
-        val cohortDate = Clock.System.now().minus(days, DateTimeUnit.DAY, TimeZone.UTC)
-
-        val cohortUsers = database.analyticsQueries
-            .getNewUsersOnDate(cohortDate.toLocalDateTime(TimeZone.UTC).date.toString())
-            .executeAsOne()
-
-        val retainedUsers = database.analyticsQueries
-            .getRetainedUsers(cohortDate.toEpochMilliseconds())
-            .executeAsOne()
-
-        return if (cohortUsers > 0) {
-            (retainedUsers.toDouble() / cohortUsers) * 100
-        } else 0.0
+        val today = rollup.today()
+        return rollup.retention(cohortDay = today - days, throughDay = today)
     }
 
     /**
@@ -92,25 +77,13 @@ class AnalyticsDashboard(private val database: WakeveDb) {
      * @return List of funnel steps with counts and conversion rates
      */
     fun getEventCreationFunnel(): List<FunnelStep> {
-        val steps = listOf(
-            "event_started" to "Event Started",
-            "event_details_entered" to "Details Entered",
-            "time_slots_added" to "Time Slots Added",
-            "event_created" to "Event Created"
-        )
-
-        return steps.mapIndexed { index, (eventName, label) ->
-            val count = database.analyticsQueries
-                .getEventCount(eventName)
-                .executeAsOne()
-                .toInt()
+        val counts = EVENT_CREATION_FUNNEL.map { (eventName, _) -> rollup.funnelCount(eventName).toInt() }
 
+        return EVENT_CREATION_FUNNEL.mapIndexed { index, (_, label) ->
+            val count = counts[index]
             val conversionRate = if (index == 0) 100.0
             else {
-                val previousCount = database.analyticsQueries
-                    .getEventCount(steps[index - 1].first)
-                    .executeAsOne()
-                    .toInt()
+                val previousCount = counts[index - 1]
                 if (previousCount > 0) (count.toDouble() / previousCount) * 100 else 0.0
             }
 
@@ -138,13 +111,7 @@ class AnalyticsDashboard(private val database: WakeveDb) {
      *
      * @return Number of users who registered today (UTC)
      */
-    private fun getNewUsersToday(): Int {
-        val today = Clock.System.now().toLocalDateTime(TimeZone.UTC).date
-        return database.analyticsQueries
-            .getNewUsersOnDate(today.toString())
-            .executeAsOne()
-            .toInt()
-    }
+    private fun getNewUsersToday(): Int = rollup.newUsers(rollup.today())
 
     /**
      * Get active events count
@@ -158,4 +125,14 @@ class AnalyticsDashboard(private val database: WakeveDb) {
             .executeAsOne()
             .toInt()
     }
+
+    companion object {
+        /** Funnel event types in step order, with their display labels. */
+        val EVENT_CREATION_FUNNEL = listOf(
+            "event_started" to "Event Started",
+            "event_details_entered" to "Details Entered",
+            "time_slots_added" to "Time Slots Added",
+            "event_created" to "Event Created"
+        )
+    }
 }
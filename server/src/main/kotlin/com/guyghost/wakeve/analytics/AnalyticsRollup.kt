@@ -0,0 +1,229 @@
+package com.guyghost.wakeve.analytics
+
+import com.guyghost.wakeve.database.WakeveDb
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.isActive
+import kotlinx.coroutines.launch
+import kotlinx.datetime.LocalDate
+import org.slf4j.LoggerFactory
+import java.util.BitSet
+import java.util.concurrent.locks.ReentrantReadWriteLock
+import kotlin.concurrent.read
+import kotlin.concurrent.write
+
+/**
+ * In-memory daily rollups of the analytics tables.
+ *
+ * Each user id is interned to a dense integer, and every UTC day keeps a
+ * [BitSet] of the users active that day and of the users who signed up that
+ * day, plus a count per funnel event type. Active-user, signup and retention
+ * figures are then unions and intersections of a few bitmaps, never a scan of
+ * the raw tables.
+ *
+ * Writes reach the rollup through the `analytics_rollup_dirty_day` table: the
+ * database triggers stamp the day of every inserted or deleted session, funnel
+ * event or user with a new version, and [refreshDirtyDays] re-reads only the
+ * days above the last version this instance rolled. A late event therefore
+ * re-rolls its own day and nothing else, on every server instance.
+ *
+ * Bitmaps are kept for the last [windowDays] days; funnel counters are tiny and
+ * kept for all time.
+ */
+class AnalyticsRollup(
+    private val database: WakeveDb,
+    private val windowDays: Int = DEFAULT_WINDOW_DAYS,
+    private val clock: () -> Long = System::currentTimeMillis
+) {
+    private val logger = LoggerFactory.getLogger(AnalyticsRollup::class.java)
+    private val queries = database.analyticsQueries
+    private val lock = ReentrantReadWriteLock()
+
+    // All guarded by lock
+    private val userIndex = HashMap<String, Int>()
+    private val activeByDay = HashMap<Long, BitSet>()
+    private val signupsByDay = HashMap<Long, BitSet>()
+    private val funnelByDay = HashMap<Long, Map<String, Long>>()
+    private val funnelTotals = HashMap<String, Long>()
+
+    @Volatile
+    private var loaded = false
+
+    // Highest dirty-day version already rolled; only touched by rebuild and refresh
+    @Volatile
+    private var rolledVersion = 0L
+
+    /** Current UTC epoch day. */
+    fun today(): Long = Math.floorDiv(clock(), MILLIS_PER_DAY)
+
+    /**
+     * Number of distinct users active on any day in [fromDay]..[toDay].
+     */
+    fun activeUsers(fromDay: Long, toDay: Long): Int = read {
+        unionOf(activeByDay, fromDay, toDay).cardinality()
+    }
+
+    /**
+     * Number of users who signed up on [day].
+     */
+    fun newUsers(day: Long): Int = read {
+        signupsByDay[day]?.cardinality() ?: 0
+    }
+
+    /**
+     * Share of the users who signed up on [cohortDay] that were active again on
+     * a later day up to [throughDay].
+     *
+     * @return Retention rate as percentage (0-100)
+     */
+    fun retention(cohortDay: Long, throughDay: Long): Double = read {
+        val cohort = signupsByDay[cohortDay]
+        if (cohort == null || cohort.isEmpty) return@read 0.0
+        val retained = unionOf(activeByDay, cohortDay + 1, throughDay)
+        retained.and(cohort)
+        retained.cardinality().toDouble() / cohort.cardinality() * 100
+    }
+
+    /**
+     * All-time number of funnel events of [eventType].
+     */
+    fun funnelCount(eventType: String): Long = read {
+        funnelTotals[eventType] ?: 0L
+    }
+
+    /**
+     * Reloads the whole window from the source tables.
+     */
+    fun rebuild() {
+        val today = today()
+        val firstDay = today - windowDays + 1
+        // Versioned before reading: rows written during the load re-roll their day
+        val version = queries.selectRollupDirtyVersion().executeAsOne()
+
+        val sessions = queries.selectActiveUserDaysBetween(firstDay * MILLIS_PER_DAY, Long.MAX_VALUE).executeAsList()
+        val signups = queries.selectSignupDatesBetween(dateOf(firstDay), MAX_DATE).executeAsList()
+        val funnel = queries.selectFunnelCountsBetween(Long.MIN_VALUE, Long.MAX_VALUE).executeAsList()
+
+        lock.write {
+            activeByDay.clear()
+            signupsByDay.clear()
+            funnelByDay.clear()
+            funnelTotals.clear()
+            sessions.forEach { activeByDay.getOrPut(it.day) { BitSet() }.set(indexOf(it.user_id)) }
+            signups.forEach { row ->
+                val day = row.signupDate?.let { LocalDate.parse(it).toEpochDays().toLong() } ?: return@forEach
+                signupsByDay.getOrPut(day) { BitSet() }.set(indexOf(row.id))
+            }
+            funnel.groupBy({ it.day }, { it.event_type to it.eventCount }).forEach { (day, counts) ->
+                replaceFunnelDay(day, counts.toMap())
+            }
+            rolledVersion = version
+            loaded = true
+            logger.info("Analytics rollup loaded: {} active days, {} users", activeByDay.size, userIndex.size)
+        }
+    }
+
+    /**
+     * Re-rolls every day the triggers marked as changed since the last refresh.
+     *
+     * @return Number of days re-rolled
+     */
+    fun refreshDirtyDays(): Int {
+        if (!loaded) {
+            ensureLoaded()
+            return 0
+        }
+        val dirty = queries.selectRollupDirtyDaysAfter(rolledVersion).executeAsList()
+        if (dirty.isEmpty()) return 0
+        // Advance before re-reading, so a row landing meanwhile gets a higher version
+        rolledVersion = dirty.last().version
+        dirty.forEach { rollDay(it.day) }
+        evictOutsideWindow()
+        return dirty.size
+    }
+
+    /**
+     * Loads the rollup, then calls [refreshDirtyDays] every [intervalMs] until
+     * [scope] is cancelled.
+     */
+    fun startRefresh(scope: CoroutineScope, intervalMs: Long = DEFAULT_REFRESH_INTERVAL_MS): Job =
+        scope.launch(Dispatchers.IO) {
+            while (isActive) {
+                try {
+                    refreshDirtyDays()
+                } catch (e: Exception) {
+                    logger.error("Analytics rollup refresh failed", e)
+                }
+                delay(intervalMs)
+            }
+        }
+
+    /**
+     * Recomputes one day from the source tables and swaps it in.
+     */
+    private fun rollDay(day: Long) {
+        val from = day * MILLIS_PER_DAY
+        val to = from + MILLIS_PER_DAY
+        val inWindow = day > today() - windowDays
+        val activeUsers = if (inWindow) queries.selectActiveUserDaysBetween(from, to).executeAsList() else emptyList()
+        val signups = if (inWindow) queries.selectSignupDatesBetween(dateOf(day), dateOf(day + 1)).executeAsList() else emptyList()
+        val funnel = queries.selectFunnelCountsBetween(from, to).executeAsList()
+
+        lock.write {
+            if (inWindow) {
+                activeByDay.putOrRemove(day, BitSet().apply { activeUsers.forEach { set(indexOf(it.user_id)) } })
+                signupsByDay.putOrRemove(day, BitSet().apply { signups.forEach { set(indexOf(it.id)) } })
+            }
+            replaceFunnelDay(day, funnel.associate { it.event_type to it.eventCount })
+        }
+    }
+
+    private fun evictOutsideWindow() {
+        val firstDay = today() - windowDays + 1
+        lock.write {
+            activeByDay.keys.removeIf { it < firstDay }
+            signupsByDay.keys.removeIf { it < firstDay }
+        }
+    }
+
+    // Callers hold the write lock
+    private fun replaceFunnelDay(day: Long, counts: Map<String, Long>) {
+        funnelByDay[day]?.forEach { (eventType, count) -> funnelTotals[eventType] = (funnelTotals[eventType] ?: 0L) - count }
+        counts.forEach { (eventType, count) -> funnelTotals[eventType] = (funnelTotals[eventType] ?: 0L) + count }
+        if (counts.isEmpty()) funnelByDay.remove(day) else funnelByDay[day] = counts
+    }
+
+    // Callers hold the write lock
+    private fun indexOf(userId: String): Int = userIndex.getOrPut(userId) { userIndex.size }
+
+    private fun HashMap<Long, BitSet>.putOrRemove(day: Long, users: BitSet) {
+        if (users.isEmpty) remove(day) else put(day, users)
+    }
+
+    private fun unionOf(bitmaps: Map<Long, BitSet>, fromDay: Long, toDay: Long): BitSet {
+        val union = BitSet()
+        for (day in fromDay..toDay) bitmaps[day]?.let(union::or)
+        return union
+    }
+
+    private fun ensureLoaded() {
+        if (!loaded) synchronized(this) { if (!loaded) rebuild() }
+    }
+
+    private inline fun <T> read(block: () -> T): T {
+        ensureLoaded()
+        return lock.read(block)
+    }
+
+    private fun dateOf(day: Long): String = LocalDate.fromEpochDays(day.toInt()).toString()
+
+    private companion object {
+        const val MILLIS_PER_DAY = 86_400_000L
+        // Longest retention cohort the API accepts (365 days) plus a month
+        const val DEFAULT_WINDOW_DAYS = 400
+        const val DEFAULT_REFRESH_INTERVAL_MS = 10_000L
+        const val MAX_DATE = "9999-12-31"
+    }
+}
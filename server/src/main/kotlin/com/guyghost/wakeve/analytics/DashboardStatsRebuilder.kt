@@ -0,0 +1,47 @@
+package com.guyghost.wakeve.analytics
+
+import com.guyghost.wakeve.database.WakeveDb
+
+/**
+ * Recomputes the organizer dashboard counters from the source tables.
+ *
+ * The counters are normally kept current by database triggers; a rebuild
+ * repairs drift left by manual edits, restores or bugs. Run it with
+ * `rebuild-dashboard-stats` as the server's first argument.
+ */
+class DashboardStatsRebuilder(private val database: WakeveDb) {
+
+    /**
+     * @property organizers Organizers with counters after the rebuild
+     * @property repairedOrganizers Organizers whose totals were wrong before it
+     */
+    data class Result(
+        val organizers: Int,
+        val repairedOrganizers: Int
+    )
+
+    fun rebuild(): Result {
+        val queries = database.dashboardQueries
+        return database.transactionWithResult {
+            val before = queries.selectAllOrganizerStats().executeAsList().associateBy { it.organizerId }
+
+            queries.clearEventDashboardStats()
+            queries.rebuildEventDashboardStats()
+            queries.clearOrganizerDashboardStats()
+            queries.rebuildOrganizerDashboardStats()
+            queries.clearOrganizerEventStatusCount()
+            queries.rebuildOrganizerEventStatusCount()
+
+            val after = queries.selectAllOrganizerStats().executeAsList()
+            // Organizers that lost all events disappear from the rebuilt table
+            val vanished = before.keys - after.map { it.organizerId }.toSet()
+            val repaired = after.count { before[it.organizerId] != it } +
+                vanished.count { organizerId ->
+                    val stale = before.getValue(organizerId)
+                    stale.eventCount != 0L || stale.participantCount != 0L ||
+                        stale.voteCount != 0L || stale.commentCount != 0L
+                }
+            Result(organizers = after.size, repairedOrganizers = repaired)
+        }
+    }
+}
@@ -33,10 +33,11 @@ class AuthenticationService(
     googleService: GoogleOAuth2Service? = null,
     appleService: AppleOAuth2Service? = null,
     auditLogger: SecurityAuditLogger = AuditLogger(),
-    appleRevocationService: AppleAccountRevocationService? = appleService
+    appleRevocationService: AppleAccountRevocationService? = appleService,
+    onTokenRevoked: (RevokedTokenData) -> Unit = {}
 ) {
     private val userRepository = UserRepository(db)
-    private val sessionRepository = SessionRepository(db)
+    private val sessionRepository = SessionRepository(db, onTokenRevoked)
     private val googleOAuth2 = googleService
     private val appleOAuth2 = appleService
     private val jwtAlgorithm = Algorithm.HMAC256(jwtSecret)
@@ -1,5 +1,7 @@
 package com.guyghost.wakeve.auth
 
+import com.guyghost.wakeve.security.RateLimitPolicy
+import com.guyghost.wakeve.security.RateLimiter
 import org.slf4j.LoggerFactory
 import java.security.SecureRandom
 import java.time.Instant
@@ -11,7 +13,7 @@ import java.util.concurrent.ConcurrentHashMap
  * Stocke les OTP en mémoire avec expiration automatique, rate limiting,
  * et compteur de tentatives pour la sécurité.
  *
- * Thread-safe via ConcurrentHashMap.
+ * Thread-safe via ConcurrentHashMap et [RateLimiter].
  */
 class OtpManager(
     /** Durée de validité d'un OTP en secondes (défaut: 5 minutes) */
@@ -29,8 +31,14 @@ class OtpManager(
     /** Stockage des OTP actifs, clé = email */
     private val otpStore = ConcurrentHashMap<String, OtpEntry>()
 
-    /** Historique des demandes pour le rate limiting, clé = email */
-    private val requestHistory = ConcurrentHashMap<String, MutableList<Instant>>()
+    /**
+     * Rate limiting des demandes par email : au plus [maxRequestsPerWindow]
+     * sur toute fenêtre glissante de rateLimitWindowSeconds.
+     */
+    val requestLimiter = RateLimiter(
+        name = "otp.request",
+        policy = RateLimitPolicy(maxRequestsPerWindow, rateLimitWindowSeconds * 1000)
+    )
 
     /**
      * Entrée OTP stockée en mémoire.
@@ -51,18 +59,8 @@ class OtpManager(
      * @param email L'adresse email à vérifier
      * @return true si l'email a dépassé le nombre maximum de demandes
      */
-    fun isRateLimited(email: String): Boolean {
-        val normalizedEmail = email.lowercase().trim()
-        val now = Instant.now()
-        val windowStart = now.minusSeconds(rateLimitWindowSeconds)
-
-        val history = requestHistory[normalizedEmail] ?: return false
-
-        // Nettoyer les entrées hors fenêtre
-        history.removeAll { it.isBefore(windowStart) }
-
-        return history.size >= maxRequestsPerWindow
-    }
+    fun isRateLimited(email: String): Boolean =
+        requestLimiter.isLimited(email.lowercase().trim())
 
     /**
      * Génère un nouvel OTP pour l'email donné.
@@ -73,7 +71,8 @@ class OtpManager(
     fun generateOtp(email: String): String? {
         val normalizedEmail = email.lowercase().trim()
 
-        if (isRateLimited(normalizedEmail)) {
+        // Vérification et comptage atomiques de la demande
+        if (!requestLimiter.tryAcquire(normalizedEmail)) {
             logger.warn("OTP request rate limit reached")
             return null
         }
@@ -88,9 +87,6 @@ class OtpManager(
             expiresAt = now.plusSeconds(otpTtlSeconds)
         )
 
-        // Enregistrer la demande dans l'historique
-        requestHistory.computeIfAbsent(normalizedEmail) { mutableListOf() }.add(now)
-
         logger.info("OTP generated; expires in {}s", otpTtlSeconds)
 
         return code
@@ -101,14 +97,8 @@ class OtpManager(
      */
     fun discardOtp(email: String) {
         val normalizedEmail = email.lowercase().trim()
-        otpStore.remove(normalizedEmail)
-
-        val history = requestHistory[normalizedEmail] ?: return
-        if (history.isNotEmpty()) {
-            history.removeAt(history.lastIndex)
-        }
-        if (history.isEmpty()) {
-            requestHistory.remove(normalizedEmail)
+        if (otpStore.remove(normalizedEmail) != null) {
+            requestLimiter.refund(normalizedEmail)
         }
     }
 
@@ -173,27 +163,17 @@ class OtpManager(
     }
 
     /**
-     * Nettoie les OTP expirés et l'historique de rate limiting obsolète.
-     * Appelé périodiquement pour libérer la mémoire.
+     * Nettoie les OTP expirés.
+     * Appelé périodiquement pour libérer la mémoire ; le rate limiter
+     * oublie seul les emails dont la fenêtre est écoulée.
      */
     fun cleanupExpired() {
-        val now = Instant.now()
-        val windowStart = now.minusSeconds(rateLimitWindowSeconds)
-
         // Nettoyer les OTP expirés
         val expiredEmails = otpStore.entries
             .filter { it.value.isExpired() }
             .map { it.key }
         expiredEmails.forEach { otpStore.remove(it) }
 
-        // Nettoyer l'historique de rate limiting
-        requestHistory.forEach { (email, history) ->
-            history.removeAll { it.isBefore(windowStart) }
-            if (history.isEmpty()) {
-                requestHistory.remove(email)
-            }
-        }
-
         if (expiredEmails.isNotEmpty()) {
             logger.debug("Nettoyage: {} OTP expirés supprimés", expiredEmails.size)
         }
@@ -0,0 +1,128 @@
+package com.guyghost.wakeve.auth
+
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.isActive
+import kotlinx.coroutines.launch
+import org.slf4j.LoggerFactory
+import java.util.concurrent.CopyOnWriteArrayList
+
+/**
+ * Broadcasts token revocations to every server instance.
+ *
+ * Each instance publishes the tokens it blacklists and subscribes its in-memory
+ * revocation set, so request authentication never has to read the blacklist table.
+ */
+interface TokenRevocationBus {
+    fun publish(revoked: RevokedTokenData)
+
+    /**
+     * Registers [listener] for every later revocation.
+     *
+     * @return Handle that removes the listener
+     */
+    fun subscribe(listener: (RevokedTokenData) -> Unit): () -> Unit
+
+    /**
+     * Starts receiving revocations made by other instances, until [scope] is cancelled.
+     * Called once the in-memory blacklist has been loaded.
+     */
+    fun startPropagation(scope: CoroutineScope) {}
+}
+
+/**
+ * In-process [TokenRevocationBus]. Delivery is synchronous, so a revocation is
+ * visible to every subscriber before [publish] returns.
+ *
+ * Only instances that share the same object (e.g. several modules in one test)
+ * see each other's revocations; separate servers need [DatabaseTokenRevocationBus].
+ */
+class LocalTokenRevocationBus : TokenRevocationBus {
+    private val logger = LoggerFactory.getLogger(LocalTokenRevocationBus::class.java)
+    private val listeners = CopyOnWriteArrayList<(RevokedTokenData) -> Unit>()
+
+    override fun publish(revoked: RevokedTokenData) {
+        listeners.forEach { listener ->
+            try {
+                listener(revoked)
+            } catch (e: Exception) {
+                logger.error("Token revocation listener failed", e)
+            }
+        }
+    }
+
+    override fun subscribe(listener: (RevokedTokenData) -> Unit): () -> Unit {
+        listeners += listener
+        return { listeners -= listener }
+    }
+}
+
+/**
+ * [TokenRevocationBus] shared by every instance through the blacklist table.
+ *
+ * Local revocations are delivered synchronously, as with [LocalTokenRevocationBus];
+ * the row itself is already written by [SessionRepository]. Revocations from other
+ * instances are picked up by polling the table on `revoked_at`, so they reach
+ * this instance within one [pollIntervalMs]. Each poll reaches back
+ * [overlapMs] before the previous one to absorb clock skew between instances;
+ * re-delivered entries are harmless since recording a revocation is idempotent.
+ */
+class DatabaseTokenRevocationBus(
+    private val loadRevokedSince: suspend (String) -> Result<List<RevokedTokenData>>,
+    private val pollIntervalMs: Long = DEFAULT_POLL_INTERVAL_MS,
+    private val overlapMs: Long = DEFAULT_OVERLAP_MS,
+    private val clock: () -> Long = System::currentTimeMillis
+) : TokenRevocationBus {
+    constructor(sessionRepository: SessionRepository) : this(sessionRepository::getTokensRevokedSince)
+
+    private val logger = LoggerFactory.getLogger(DatabaseTokenRevocationBus::class.java)
+    private val local = LocalTokenRevocationBus()
+
+    override fun publish(revoked: RevokedTokenData) = local.publish(revoked)
+
+    override fun subscribe(listener: (RevokedTokenData) -> Unit): () -> Unit = local.subscribe(listener)
+
+    override fun startPropagation(scope: CoroutineScope) {
+        startPolling(scope)
+    }
+
+    /**
+     * Polls the blacklist table every [pollIntervalMs] until [scope] is cancelled.
+     */
+    fun startPolling(scope: CoroutineScope): Job {
+        var lastPollAt = clock()
+        return scope.launch {
+            while (isActive) {
+                delay(pollIntervalMs)
+                lastPollAt = pollOnce(lastPollAt)
+            }
+        }
+    }
+
+    /**
+     * Delivers revocations recorded since [previousPollAt] (minus the overlap).
+     *
+     * @return Start time of this poll, to pass to the next one; unchanged if the read failed
+     */
+    suspend fun pollOnce(previousPollAt: Long): Long {
+        val startedAt = clock()
+        // revoked_at holds epoch millis, so the text comparison orders correctly
+        val since = (previousPollAt - overlapMs).coerceAtLeast(0).toString()
+        return loadRevokedSince(since).fold(
+            onSuccess = { tokens ->
+                tokens.forEach(local::publish)
+                startedAt
+            },
+            onFailure = { error ->
+                logger.error("Failed to poll token revocations", error)
+                previousPollAt
+            }
+        )
+    }
+
+    private companion object {
+        const val DEFAULT_POLL_INTERVAL_MS = 5_000L
+        const val DEFAULT_OVERLAP_MS = 60_000L
+    }
+}
@@ -1,100 +1,143 @@
 package com.guyghost.wakeve.cache
 
-import kotlinx.coroutines.sync.Mutex
-import kotlinx.coroutines.sync.withLock
+import com.guyghost.wakeve.auth.RevokedTokenData
+import com.guyghost.wakeve.metrics.JwtBlacklistMetrics
+import com.guyghost.wakeve.util.sha256Hash
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.isActive
+import kotlinx.coroutines.launch
+import java.time.Instant
+import java.time.format.DateTimeParseException
+import java.util.concurrent.ConcurrentHashMap
 
 /**
- * Thread-safe LRU cache for JWT blacklist checks.
+ * In-memory copy of the JWT blacklist.
  *
- * This cache stores blacklist status for JWT tokens to avoid
- * repeated database lookups. Entries expire after [ttlMillis].
+ * Holds every revoked, unexpired token, keyed by the SHA-256 hash of the token
+ * (the same identifier the blacklist table uses). It is filled once by
+ * [loadRevoked] at startup and then kept current by [recordRevoked], fed from
+ * the revocation bus, so [isBlacklisted] never touches the database.
  *
- * @property maxSize Maximum number of entries in the cache (default: 10,000)
- * @property ttlMillis Time-to-live for cache entries in milliseconds (default: 5 minutes)
+ * A [RevokedTokenBloomFilter] in front of the set answers the common "not
+ * revoked" case. Reads take no lock; writes are rare and serialized so a filter
+ * rebuild cannot lose a concurrent revocation. Entries are dropped once the
+ * token itself has expired ([purgeExpired]), which keeps memory bounded.
  */
 class JwtBlacklistCache(
-    private val maxSize: Int = 10000,
-    private val ttlMillis: Long = 5 * 60 * 1000 // 5 minutes
+    val metrics: JwtBlacklistMetrics = JwtBlacklistMetrics(),
+    private val clock: () -> Long = System::currentTimeMillis
 ) {
-    internal data class CacheEntry(
-        val isBlacklisted: Boolean,
-        val timestamp: Long
-    )
+    // Token hash -> token expiry (epoch millis)
+    private val revoked = ConcurrentHashMap<String, Long>()
+    private val writeLock = Any()
 
-    init {
-        require(maxSize > 0) { "maxSize must be positive" }
-        require(ttlMillis > 0) { "ttlMillis must be positive" }
-    }
+    @Volatile
+    private var revokedFilter = RevokedTokenBloomFilter(expectedInsertions = MIN_FILTER_CAPACITY)
+
+    /** Number of revoked tokens held in memory. */
+    val size: Int get() = revoked.size
 
     /**
-     * LRU cache using LinkedHashMap with access-order mode.
-     * The third parameter (true) enables access-order, which makes the map LRU.
+     * Checks [token] against the in-memory blacklist.
      */
-    private val cache = LinkedHashMap<String, CacheEntry>(maxSize, 0.75f, true)
-    private val mutex = Mutex()
+    fun isBlacklisted(token: String): Boolean {
+        val tokenHash = sha256Hash(token)
+        if (!revokedFilter.mightContain(tokenHash)) {
+            metrics.recordFilterNegative()
+            return false
+        }
+        if (tokenHash !in revoked) {
+            metrics.recordFalsePositive()
+            return false
+        }
+        metrics.recordRevokedHit()
+        return true
+    }
 
     /**
-     * Get blacklist status from cache.
-     * Returns null if not in cache or expired.
-     *
-     * @param token JWT token to look up
-     * @return Boolean blacklist status, or null if not in cache or expired
+     * Adds the blacklist read at startup. Merges with revocations already
+     * received, so the bus can be subscribed before loading without a gap.
      */
-    suspend fun get(token: String): Boolean? = mutex.withLock {
-        val entry = cache[token]
-        when {
-            entry == null -> null
-            isExpired(entry) -> {
-                cache.remove(token)
-                null
+    fun loadRevoked(tokens: Collection<RevokedTokenData>) {
+        synchronized(writeLock) {
+            val now = clock()
+            tokens.forEach { token ->
+                val expiresAt = parseExpiry(token.expiresAt, now)
+                if (expiresAt > now) revoked[token.tokenHash] = expiresAt
             }
-            else -> entry.isBlacklisted
+            rebuildFilter()
         }
     }
 
     /**
-     * Store blacklist status in cache.
-     *
-     * @param token JWT token to cache
-     * @param isBlacklisted Blacklist status to store
+     * Adds one revocation, typically delivered by the revocation bus.
      */
-    suspend fun put(token: String, isBlacklisted: Boolean) {
-        mutex.withLock {
-            if (cache.size >= maxSize) {
-                // Remove oldest entry (LRU eviction)
-                cache.remove(cache.keys.first())
+    fun recordRevoked(token: RevokedTokenData) {
+        synchronized(writeLock) {
+            revoked[token.tokenHash] = parseExpiry(token.expiresAt, clock())
+            if (revoked.size > revokedFilter.expectedInsertions) {
+                rebuildFilter()
+            } else {
+                revokedFilter.put(token.tokenHash)
+                metrics.setRevokedTokenCount(revoked.size)
             }
-            cache[token] = CacheEntry(isBlacklisted, System.currentTimeMillis())
         }
     }
 
     /**
-     * Remove entry from cache (e.g., on token revocation).
+     * Drops tokens that have expired; they are rejected by JWT validation anyway.
      *
-     * @param token JWT token to remove from cache
+     * @return Number of entries removed
      */
-    suspend fun remove(token: String) {
-        mutex.withLock {
-            cache.remove(token)
+    fun purgeExpired(): Int = synchronized(writeLock) {
+        val now = clock()
+        val before = revoked.size
+        revoked.values.removeIf { it <= now }
+        val removed = before - revoked.size
+        // The filter cannot forget entries; rebuild once most of it is stale
+        if (removed > 0 && revokedFilter.size > revoked.size * 2) {
+            rebuildFilter()
+        } else {
+            metrics.setRevokedTokenCount(revoked.size)
         }
+        removed
     }
 
     /**
-     * Clear entire cache.
+     * Calls [purgeExpired] every [intervalMs] until [scope] is cancelled.
      */
-    suspend fun clear() {
-        mutex.withLock {
-            cache.clear()
+    fun startExpiryPurge(scope: CoroutineScope, intervalMs: Long = DEFAULT_PURGE_INTERVAL_MS): Job =
+        scope.launch {
+            while (isActive) {
+                delay(intervalMs)
+                purgeExpired()
+            }
         }
+
+    private fun rebuildFilter() {
+        val filter = RevokedTokenBloomFilter(expectedInsertions = maxOf(MIN_FILTER_CAPACITY, revoked.size * 2))
+        revoked.keys.forEach(filter::put)
+        revokedFilter = filter
+        metrics.setRevokedTokenCount(revoked.size)
     }
 
     /**
-     * Check if a cache entry has expired.
-     *
-     * @param entry Cache entry to check
-     * @return true if the entry has expired
+     * Blacklist expiries are stored either as epoch millis or as ISO-8601
+     * instants. Unparseable values are kept for a full day.
      */
-    private fun isExpired(entry: CacheEntry): Boolean {
-        return System.currentTimeMillis() - entry.timestamp > ttlMillis
+    private fun parseExpiry(expiresAt: String, now: Long): Long =
+        expiresAt.toLongOrNull()
+            ?: try {
+                Instant.parse(expiresAt).toEpochMilli()
+            } catch (e: DateTimeParseException) {
+                now + FALLBACK_RETENTION_MS
+            }
+
+    private companion object {
+        const val MIN_FILTER_CAPACITY = 10_000
+        const val DEFAULT_PURGE_INTERVAL_MS = 60_000L
+        const val FALLBACK_RETENTION_MS = 24 * 60 * 60 * 1000L
     }
 }
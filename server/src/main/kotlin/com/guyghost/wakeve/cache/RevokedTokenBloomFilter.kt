@@ -0,0 +1,100 @@
+package com.guyghost.wakeve.cache
+
+import java.util.concurrent.atomic.AtomicInteger
+import java.util.concurrent.atomic.AtomicLongArray
+import kotlin.math.ceil
+import kotlin.math.ln
+import kotlin.math.roundToInt
+
+/**
+ * Bloom filter over revoked token hashes.
+ *
+ * [mightContain] never answers false for a token that was [put], so a negative
+ * answer proves the token is not revoked. Reads and writes are lock-free.
+ * Entries cannot be removed; the owner rebuilds the filter instead.
+ *
+ * Keys are SHA-256 hex digests, which are already uniformly distributed, so the
+ * bit positions are derived from the digest itself (double hashing).
+ *
+ * @property expectedInsertions Number of tokens the filter is sized for
+ * @property falsePositiveRate Target false-positive probability at that size
+ */
+class RevokedTokenBloomFilter(
+    val expectedInsertions: Int = DEFAULT_EXPECTED_INSERTIONS,
+    val falsePositiveRate: Double = DEFAULT_FALSE_POSITIVE_RATE
+) {
+    init {
+        require(expectedInsertions > 0) { "expectedInsertions must be positive" }
+        require(falsePositiveRate > 0.0 && falsePositiveRate < 1.0) { "falsePositiveRate must be in (0, 1)" }
+    }
+
+    private val bitCount: Long = ceil(-expectedInsertions * ln(falsePositiveRate) / (LN2 * LN2)).toLong()
+        .coerceAtLeast(Long.SIZE_BITS.toLong())
+    private val hashCount: Int = (bitCount.toDouble() / expectedInsertions * LN2).roundToInt().coerceIn(1, MAX_HASHES)
+    private val words = AtomicLongArray(((bitCount + Long.SIZE_BITS - 1) / Long.SIZE_BITS).toInt())
+    private val insertions = AtomicInteger(0)
+
+    /** Number of distinct tokens added, used to decide when the filter is overfull. */
+    val size: Int get() = insertions.get()
+
+    fun put(tokenHash: String) {
+        var changed = false
+        forEachBit(tokenHash) { index ->
+            val word = (index ushr 6).toInt()
+            val mask = 1L shl (index and 63).toInt()
+            while (true) {
+                val current = words.get(word)
+                if (current and mask != 0L) break
+                if (words.compareAndSet(word, current, current or mask)) {
+                    changed = true
+                    break
+                }
+            }
+            true
+        }
+        // Re-adding a token sets no new bit and must not count towards the size
+        if (changed) insertions.incrementAndGet()
+    }
+
+    fun mightContain(tokenHash: String): Boolean =
+        forEachBit(tokenHash) { index ->
+            words.get((index ushr 6).toInt()) and (1L shl (index and 63).toInt()) != 0L
+        }
+
+    /**
+     * Visits the [hashCount] bit positions of [key] until [visit] returns false.
+     *
+     * @return false if any visit returned false
+     */
+    private inline fun forEachBit(key: String, visit: (Long) -> Boolean): Boolean {
+        val h1 = digestWord(key, 0)
+        val h2 = digestWord(key, 16) or 1L
+        for (i in 0 until hashCount) {
+            val combined = h1 + i * h2
+            if (!visit(Math.floorMod(combined, bitCount))) return false
+        }
+        return true
+    }
+
+    private fun digestWord(key: String, offset: Int): Long =
+        try {
+            java.lang.Long.parseUnsignedLong(key, offset, offset + 16, 16)
+        } catch (e: RuntimeException) {
+            // Not a hex digest; spread the string hash instead
+            mix(key.hashCode().toLong() + offset)
+        }
+
+    private fun mix(value: Long): Long {
+        var z = value + -0x61c8864680b583ebL
+        z = (z xor (z ushr 30)) * -0x40a7b892e31b1a47L
+        z = (z xor (z ushr 27)) * -0x6b2fb644ecceee15L
+        return z xor (z ushr 31)
+    }
+
+    private companion object {
+        const val DEFAULT_EXPECTED_INSERTIONS = 100_000
+        const val DEFAULT_FALSE_POSITIVE_RATE = 0.001
+        const val MAX_HASHES = 16
+        val LN2 = ln(2.0)
+    }
+}
@@ -1,11 +1,19 @@
 package com.guyghost.wakeve.i18n
 
+import java.util.concurrent.ConcurrentHashMap
+
 /**
  * Server-side localization system for notification messages and other server-generated text.
  *
  * Supports 5 languages: EN, FR, ES, IT, PT.
  * Uses a key-based translation map with parameterized string formatting.
  *
+ * Translations are compiled once, at startup, into templates split around their
+ * `%s` placeholders and indexed by key index and locale index; normalized
+ * locales are cached. Formatting appends the pieces to a per-thread
+ * [StringBuilder], so a call allocates little more than its result. Hot paths
+ * can resolve [keyIndex] and [localeIndex] once and call [format] or [appendTo].
+ *
  * Usage:
  * ```
  * ServerLocalizer.t("notification.vote.title_single", "fr") // "Nouveau vote"
@@ -149,6 +157,22 @@ object ServerLocalizer {
             "pt" to "\"%s\": %s"
         ))
 
+        put("notification.comment.title_multiple", mapOf(
+            "en" to "%s new comments",
+            "fr" to "%s nouveaux commentaires",
+            "es" to "%s comentarios nuevos",
+            "it" to "%s nuovi commenti",
+            "pt" to "%s novos comentários"
+        ))
+
+        put("notification.comment.body_multiple", mapOf(
+            "en" to "New comments from %s on \"%s\"",
+            "fr" to "Nouveaux commentaires de %s sur \"%s\"",
+            "es" to "Nuevos comentarios de %s en \"%s\"",
+            "it" to "Nuovi commenti di %s su \"%s\"",
+            "pt" to "Novos comentários de %s em \"%s\""
+        ))
+
         // ==================== NOTIFICATION: DEADLINE ====================
 
         put("notification.deadline.title", mapOf(
@@ -749,10 +773,34 @@ object ServerLocalizer {
     }
 
     /**
-     * Supported locale codes.
+     * Supported locale codes, in locale-index order.
      */
     val supportedLocales = setOf("en", "fr", "es", "it", "pt")
 
+    private val localeCodes = supportedLocales.toTypedArray()
+    private val defaultLocaleIndex = localeCodes.indexOf("fr")
+
+    /**
+     * A template split around its `%s` placeholders: n placeholders give n + 1 literals.
+     */
+    private class CompiledTemplate(val source: String, val literals: Array<String>)
+
+    // Key name -> key index, and templates indexed by [key index][locale index].
+    // Locales missing a translation point at the French template.
+    private val keyIndexes = HashMap<String, Int>(translations.size * 2)
+    private val templates: Array<Array<CompiledTemplate?>> = translations.entries.mapIndexed { index, (key, byLocale) ->
+        keyIndexes[key] = index
+        val fallback = byLocale["fr"]?.let(::compile)
+        Array(localeCodes.size) { locale -> byLocale[localeCodes[locale]]?.let(::compile) ?: fallback }
+    }.toTypedArray()
+
+    // Raw locale -> locale index, e.g. "fr-FR" -> index of "fr"
+    private val localeIndexCache = ConcurrentHashMap<String, Int>().apply {
+        localeCodes.forEachIndexed { index, code -> put(code, index) }
+    }
+
+    private val builders = ThreadLocal.withInitial { StringBuilder(DEFAULT_BUILDER_CAPACITY) }
+
     /**
      * Translates a key to the given locale with optional parameter substitution.
      *
@@ -762,25 +810,83 @@ object ServerLocalizer {
      * @return The translated string, or the key itself if not found.
      */
     fun t(key: String, locale: String = "fr", vararg params: Any): String {
-        val normalizedLocale = normalizeLocale(locale)
-        val localeMap = translations[key] ?: return key
-        val template = localeMap[normalizedLocale] ?: localeMap["fr"] ?: return key
+        val keyIndex = keyIndexes[key] ?: return key
+        return format(keyIndex, localeIndex(locale), params) ?: key
+    }
 
-        if (params.isEmpty()) return template
+    /**
+     * Index of a translation key, to format it without looking the name up
+     * on every call; -1 if the key is unknown.
+     */
+    fun keyIndex(key: String): Int = keyIndexes[key] ?: -1
 
-        var result = template
-        for (param in params) {
-            result = result.replaceFirst("%s", param.toString())
+    /**
+     * Index of the supported locale a locale string normalizes to.
+     */
+    fun localeIndex(locale: String): Int =
+        localeIndexCache[locale] ?: computeLocaleIndex(locale).also { index ->
+            // Locale strings come from clients: only remember a bounded number of them
+            if (localeIndexCache.size < MAX_CACHED_LOCALES) localeIndexCache[locale] = index
         }
+
+    /**
+     * Formats a pre-resolved key, see [keyIndex] and [localeIndex].
+     *
+     * @return The translated string, or null if the key has no template
+     */
+    fun format(keyIndex: Int, localeIndex: Int, params: Array<out Any>): String? {
+        val template = templates.getOrNull(keyIndex)?.getOrNull(localeIndex) ?: return null
+        val literals = template.literals
+        if (literals.size == 1) return literals[0]
+        if (params.isEmpty()) return template.source
+
+        val builder = builders.get()
+        builder.setLength(0)
+        appendTo(builder, template, params)
+        val result = builder.toString()
+        // Do not keep a builder grown by an unusually long message
+        if (builder.capacity() > MAX_BUILDER_CAPACITY) builders.set(StringBuilder(DEFAULT_BUILDER_CAPACITY))
         return result
     }
 
+    /**
+     * Appends a pre-resolved translation to [builder], without any intermediate string.
+     *
+     * @return false if the key has no template
+     */
+    fun appendTo(builder: StringBuilder, keyIndex: Int, localeIndex: Int, vararg params: Any): Boolean {
+        val template = templates.getOrNull(keyIndex)?.getOrNull(localeIndex) ?: return false
+        appendTo(builder, template, params)
+        return true
+    }
+
     /**
      * Normalizes a locale string to a supported 2-letter code.
      * Handles formats like "fr-FR", "en_US", "pt-BR", etc.
      */
-    fun normalizeLocale(locale: String): String {
-        val code = locale.lowercase().split("-", "_").firstOrNull() ?: "fr"
-        return if (code in supportedLocales) code else "fr"
+    fun normalizeLocale(locale: String): String = localeCodes[localeIndex(locale)]
+
+    private fun appendTo(builder: StringBuilder, template: CompiledTemplate, params: Array<out Any>) {
+        val literals = template.literals
+        builder.append(literals[0])
+        for (i in 1 until literals.size) {
+            // Placeholders without a parameter are left as is
+            if (i <= params.size) builder.append(params[i - 1]) else builder.append(PLACEHOLDER)
+            builder.append(literals[i])
+        }
     }
+
+    private fun computeLocaleIndex(locale: String): Int {
+        val end = locale.indexOfFirst { it == '-' || it == '_' }.let { if (it < 0) locale.length else it }
+        val code = locale.substring(0, end).lowercase()
+        return localeCodes.indexOf(code).takeIf { it >= 0 } ?: defaultLocaleIndex
+    }
+
+    private fun compile(template: String): CompiledTemplate =
+        CompiledTemplate(template, template.split(PLACEHOLDER).map(String::intern).toTypedArray())
+
+    private const val PLACEHOLDER = "%s"
+    private const val DEFAULT_BUILDER_CAPACITY = 256
+    private const val MAX_BUILDER_CAPACITY = 8_192
+    private const val MAX_CACHED_LOCALES = 1_024
 }
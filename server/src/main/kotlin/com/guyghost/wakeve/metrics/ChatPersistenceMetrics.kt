@@ -0,0 +1,84 @@
+package com.guyghost.wakeve.metrics
+
+import io.micrometer.core.instrument.Counter
+import io.micrometer.core.instrument.DistributionSummary
+import io.micrometer.core.instrument.Gauge
+import io.micrometer.core.instrument.MeterRegistry
+import io.micrometer.core.instrument.Timer
+import io.micrometer.core.instrument.binder.MeterBinder
+import io.micrometer.core.instrument.composite.CompositeMeterRegistry
+import io.micrometer.core.instrument.simple.SimpleMeterRegistry
+import java.util.concurrent.TimeUnit
+import java.util.concurrent.atomic.AtomicInteger
+
+/**
+ * Chat persistence metrics using Micrometer.
+ *
+ * Collects metrics for:
+ * - Messages committed (messages/sec is the rate of this counter)
+ * - Messages whose write failed
+ * - Messages per committed transaction
+ * - Commit duration
+ * - Messages waiting to be written
+ *
+ * Meters exist from the moment the chat service starts and are backed by a local
+ * registry, so the getters work whether or not [bindTo] has attached the
+ * application registry yet.
+ */
+class ChatPersistenceMetrics : MeterBinder {
+
+    private val registry = CompositeMeterRegistry().apply { add(SimpleMeterRegistry()) }
+
+    private val queueDepth = AtomicInteger(0)
+
+    private val persistedCounter: Counter = Counter.builder("chat.persistence.messages")
+        .description("Number of chat messages committed to the database")
+        .register(registry)
+
+    private val failureCounter: Counter = Counter.builder("chat.persistence.failures")
+        .description("Number of chat messages that could not be persisted")
+        .register(registry)
+
+    private val batchSizeSummary: DistributionSummary = DistributionSummary.builder("chat.persistence.batch.size")
+        .description("Number of chat messages committed per transaction")
+        .baseUnit("messages")
+        .register(registry)
+
+    private val commitTimer: Timer = Timer.builder("chat.persistence.commit.duration")
+        .description("Time taken to commit one batch of chat messages")
+        .register(registry)
+
+    init {
+        Gauge.builder("chat.persistence.queue.depth", queueDepth) { it.get().toDouble() }
+            .description("Number of chat messages waiting to be written")
+            .register(registry)
+    }
+
+    override fun bindTo(registry: MeterRegistry) {
+        this.registry.add(registry)
+    }
+
+    fun recordQueued() {
+        queueDepth.incrementAndGet()
+    }
+
+    fun recordCommit(batchSize: Int, durationNanos: Long) {
+        queueDepth.addAndGet(-batchSize)
+        persistedCounter.increment(batchSize.toDouble())
+        batchSizeSummary.record(batchSize.toDouble())
+        commitTimer.record(durationNanos, TimeUnit.NANOSECONDS)
+    }
+
+    fun recordFailure() {
+        queueDepth.decrementAndGet()
+        failureCounter.increment()
+    }
+
+    // Getters for current values (useful for testing and reporting)
+    fun getPersistedCount(): Double = persistedCounter.count()
+    fun getFailureCount(): Double = failureCounter.count()
+    fun getCommitCount(): Long = batchSizeSummary.count()
+    fun getMeanBatchSize(): Double = batchSizeSummary.mean()
+    fun getMaxBatchSize(): Double = batchSizeSummary.max()
+    fun getQueueDepth(): Int = queueDepth.get()
+}
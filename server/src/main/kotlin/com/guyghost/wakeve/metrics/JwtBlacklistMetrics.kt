@@ -0,0 +1,77 @@
+package com.guyghost.wakeve.metrics
+
+import io.micrometer.core.instrument.Counter
+import io.micrometer.core.instrument.Gauge
+import io.micrometer.core.instrument.MeterRegistry
+import io.micrometer.core.instrument.binder.MeterBinder
+import io.micrometer.core.instrument.composite.CompositeMeterRegistry
+import io.micrometer.core.instrument.simple.SimpleMeterRegistry
+import java.util.concurrent.atomic.AtomicInteger
+
+/**
+ * JWT blacklist check metrics using Micrometer.
+ *
+ * Collects metrics for:
+ * - Checks answered by the revocation filter alone (token proven not revoked)
+ * - Checks that found the token in the revocation set
+ * - Filter false positives (filter said "maybe", the revocation set said "not revoked")
+ * - Number of revoked tokens held in memory
+ *
+ * Like [ChatPersistenceMetrics], meters are backed by a local registry until
+ * [bindTo] attaches the application registry.
+ */
+class JwtBlacklistMetrics : MeterBinder {
+
+    private val registry = CompositeMeterRegistry().apply { add(SimpleMeterRegistry()) }
+    private val revokedTokens = AtomicInteger(0)
+
+    private val filterNegativeCounter: Counter = Counter.builder("auth.blacklist.filter.negative")
+        .description("Blacklist checks answered by the revocation filter alone")
+        .register(registry)
+
+    private val revokedHitCounter: Counter = Counter.builder("auth.blacklist.revoked.hit")
+        .description("Blacklist checks that rejected a revoked token")
+        .register(registry)
+
+    private val falsePositiveCounter: Counter = Counter.builder("auth.blacklist.filter.false_positive")
+        .description("Tokens the revocation filter flagged that turned out not to be revoked")
+        .register(registry)
+
+    init {
+        Gauge.builder("auth.blacklist.revoked.size", revokedTokens) { it.get().toDouble() }
+            .description("Revoked tokens held in memory")
+            .register(registry)
+    }
+
+    override fun bindTo(registry: MeterRegistry) {
+        this.registry.add(registry)
+    }
+
+    fun recordFilterNegative() {
+        filterNegativeCounter.increment()
+    }
+
+    fun recordRevokedHit() {
+        revokedHitCounter.increment()
+    }
+
+    fun recordFalsePositive() {
+        falsePositiveCounter.increment()
+    }
+
+    fun setRevokedTokenCount(count: Int) {
+        revokedTokens.set(count)
+    }
+
+    // Getters for current values (useful for testing and reporting)
+    fun getFilterNegativeCount(): Double = filterNegativeCounter.count()
+    fun getRevokedHitCount(): Double = revokedHitCounter.count()
+    fun getFalsePositiveCount(): Double = falsePositiveCounter.count()
+    fun getRevokedTokenCount(): Int = revokedTokens.get()
+
+    /** Share of non-revoked tokens the filter failed to rule out. */
+    fun getFalsePositiveRate(): Double {
+        val total = getFalsePositiveCount() + getFilterNegativeCount()
+        return if (total == 0.0) 0.0 else getFalsePositiveCount() / total
+    }
+}
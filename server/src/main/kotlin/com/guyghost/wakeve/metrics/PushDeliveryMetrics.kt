@@ -0,0 +1,101 @@
+package com.guyghost.wakeve.metrics
+
+import io.micrometer.core.instrument.Counter
+import io.micrometer.core.instrument.DistributionSummary
+import io.micrometer.core.instrument.Gauge
+import io.micrometer.core.instrument.MeterRegistry
+import io.micrometer.core.instrument.Timer
+import io.micrometer.core.instrument.binder.MeterBinder
+import io.micrometer.core.instrument.composite.CompositeMeterRegistry
+import io.micrometer.core.instrument.simple.SimpleMeterRegistry
+import java.util.concurrent.TimeUnit
+import java.util.concurrent.atomic.AtomicInteger
+
+/**
+ * Push delivery metrics using Micrometer.
+ *
+ * Collects metrics for:
+ * - Pushes delivered (sends/sec is the rate of this counter)
+ * - Pushes given up on, and retry attempts
+ * - Tokens per multicast request
+ * - Latency from enqueue to delivery, with its p99
+ * - Pushes waiting for delivery
+ *
+ * Meters are backed by a local registry, so the getters work whether or not
+ * [bindTo] has attached the application registry yet.
+ */
+class PushDeliveryMetrics : MeterBinder {
+
+    private val registry = CompositeMeterRegistry().apply { add(SimpleMeterRegistry()) }
+
+    private val pending = AtomicInteger(0)
+
+    private val sentCounter: Counter = Counter.builder("push.delivery.sent")
+        .description("Number of pushes accepted by the push gateways")
+        .register(registry)
+
+    private val failedCounter: Counter = Counter.builder("push.delivery.failed")
+        .description("Number of pushes dropped after a permanent failure or the last retry")
+        .register(registry)
+
+    private val retriedCounter: Counter = Counter.builder("push.delivery.retried")
+        .description("Number of push delivery retries")
+        .register(registry)
+
+    private val batchSizeSummary: DistributionSummary = DistributionSummary.builder("push.delivery.batch.size")
+        .description("Number of tokens per multicast request")
+        .baseUnit("tokens")
+        .register(registry)
+
+    private val latencyTimer: Timer = Timer.builder("push.delivery.latency")
+        .description("Time from enqueue to delivery of a push")
+        .publishPercentiles(0.5, 0.99)
+        .register(registry)
+
+    init {
+        Gauge.builder("push.delivery.pending", pending) { it.get().toDouble() }
+            .description("Number of pushes waiting for delivery or a retry")
+            .register(registry)
+    }
+
+    override fun bindTo(registry: MeterRegistry) {
+        this.registry.add(registry)
+    }
+
+    fun recordEnqueued(count: Int) {
+        pending.addAndGet(count)
+    }
+
+    fun recordBatch(size: Int) {
+        batchSizeSummary.record(size.toDouble())
+    }
+
+    fun recordSent(latencyNanos: Long) {
+        pending.decrementAndGet()
+        sentCounter.increment()
+        latencyTimer.record(latencyNanos, TimeUnit.NANOSECONDS)
+    }
+
+    fun recordFailed() {
+        pending.decrementAndGet()
+        failedCounter.increment()
+    }
+
+    fun recordRetried() {
+        retriedCounter.increment()
+    }
+
+    // Getters for current values (useful for testing and reporting)
+    fun getSentCount(): Double = sentCounter.count()
+    fun getFailedCount(): Double = failedCounter.count()
+    fun getRetriedCount(): Double = retriedCounter.count()
+    fun getBatchCount(): Long = batchSizeSummary.count()
+    fun getMeanBatchSize(): Double = batchSizeSummary.mean()
+    fun getPendingCount(): Int = pending.get()
+
+    fun getP99LatencyMillis(): Double =
+        latencyTimer.takeSnapshot().percentileValues()
+            .firstOrNull { it.percentile() == 0.99 }
+            ?.value(TimeUnit.MILLISECONDS)
+            ?: 0.0
+}
@@ -0,0 +1,59 @@
+package com.guyghost.wakeve.metrics
+
+import io.micrometer.core.instrument.Counter
+import io.micrometer.core.instrument.MeterRegistry
+import io.micrometer.core.instrument.binder.MeterBinder
+import io.micrometer.core.instrument.composite.CompositeMeterRegistry
+import io.micrometer.core.instrument.simple.SimpleMeterRegistry
+
+/**
+ * Metrics of one rate limiter using Micrometer, tagged with the limiter name.
+ *
+ * Collects metrics for:
+ * - Requests let through
+ * - Requests rejected because the key was over its limit
+ * - Permits given back (e.g. an OTP that could not be delivered)
+ *
+ * Like [ChatPersistenceMetrics], meters are backed by a local registry until
+ * [bindTo] attaches the application registry.
+ */
+class RateLimiterMetrics(limiterName: String) : MeterBinder {
+
+    private val registry = CompositeMeterRegistry().apply { add(SimpleMeterRegistry()) }
+
+    private val allowedCounter: Counter = Counter.builder("ratelimit.allowed")
+        .description("Requests let through by the rate limiter")
+        .tag("limiter", limiterName)
+        .register(registry)
+
+    private val rejectedCounter: Counter = Counter.builder("ratelimit.rejected")
+        .description("Requests rejected by the rate limiter")
+        .tag("limiter", limiterName)
+        .register(registry)
+
+    private val refundedCounter: Counter = Counter.builder("ratelimit.refunded")
+        .description("Permits given back to the rate limiter")
+        .tag("limiter", limiterName)
+        .register(registry)
+
+    override fun bindTo(registry: MeterRegistry) {
+        this.registry.add(registry)
+    }
+
+    fun recordAllowed() {
+        allowedCounter.increment()
+    }
+
+    fun recordRejected() {
+        rejectedCounter.increment()
+    }
+
+    fun recordRefunded() {
+        refundedCounter.increment()
+    }
+
+    // Getters for current values (useful for testing and reporting)
+    fun getAllowedCount(): Double = allowedCounter.count()
+    fun getRejectedCount(): Double = rejectedCounter.count()
+    fun getRefundedCount(): Double = refundedCounter.count()
+}
@@ -51,6 +51,8 @@ enum class TypingStatus {
  * @property isOffline Whether message was created while offline
  * @property reactions List of reactions to this message
  * @property readBy List of user IDs who have read this message
+ * @property reactionCounts Number of reactions per emoji
+ * @property readCount Number of users who have read this message
  * @property isEdited Whether the message has been edited
  */
 @Serializable
@@ -69,6 +71,8 @@ data class ChatMessage(
     val isOffline: Boolean = false,
     val reactions: List<Reaction> = emptyList(),
     val readBy: List<String> = emptyList(),
+    val reactionCounts: Map<String, Int> = emptyMap(),
+    val readCount: Int = 0,
     val isEdited: Boolean = false,
     val moderationStatus: ModerationStatus = ModerationStatus.APPROVED
 )
@@ -135,14 +139,17 @@ data class AddReactionRequest(
  * Response for paginated messages.
  *
  * @property messages List of messages
- * @property totalCount Total number of messages
+ * @property totalCount Total number of messages; only on the first page and on offset pages,
+ *   so following a cursor never costs a count over the whole history
  * @property hasMore Whether there are more messages
+ * @property nextCursor Opaque cursor for the next (older) page, null on the last page
  */
 @Serializable
 data class MessagesResponse(
     val messages: List<ChatMessage>,
-    val totalCount: Int,
-    val hasMore: Boolean
+    val totalCount: Int? = null,
+    val hasMore: Boolean,
+    val nextCursor: String? = null
 )
 
 /**
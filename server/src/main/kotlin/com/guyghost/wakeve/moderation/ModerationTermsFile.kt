@@ -0,0 +1,88 @@
+package com.guyghost.wakeve.moderation
+
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.isActive
+import kotlinx.coroutines.launch
+import org.slf4j.LoggerFactory
+import java.io.File
+
+/**
+ * Moderation term lists kept in a text file and pushed into a [ModerationPolicy]
+ * whenever the file changes, so lists can be edited without a redeploy.
+ *
+ * One term per line, prefixed with its list: `hard:`, `review:` or `spam:`.
+ * Blank lines and lines starting with `#` are ignored. A file without `spam:` lines
+ * keeps the built-in spam words rather than turning spam detection off.
+ */
+class ModerationTermsFile(
+    private val file: File,
+    private val policy: ModerationPolicy,
+    private val pollIntervalMs: Long = DEFAULT_POLL_INTERVAL_MS
+) {
+    private val logger = LoggerFactory.getLogger(ModerationTermsFile::class.java)
+    private var loadedModifiedAt = 0L
+
+    /**
+     * Applies the file to the policy if it changed since the last load.
+     *
+     * @return true when new lists were applied
+     */
+    fun reloadIfChanged(): Boolean {
+        val modifiedAt = file.lastModified()
+        if (modifiedAt == 0L || modifiedAt == loadedModifiedAt) return false
+
+        val terms = try {
+            parse(file.readLines())
+        } catch (e: Exception) {
+            logger.warn("Failed to read moderation terms from ${file.path}", e)
+            return false
+        }
+        policy.updateTerms(
+            hardPolicyTerms = terms[HARD_PREFIX].orEmpty(),
+            pendingReviewTerms = terms[REVIEW_PREFIX].orEmpty(),
+            spamTerms = terms[SPAM_PREFIX] ?: ModerationPolicy.SPAM_WORDS
+        )
+        loadedModifiedAt = modifiedAt
+        logger.info("Loaded ${terms.values.sumOf { it.size }} moderation terms from ${file.path}")
+        return true
+    }
+
+    /**
+     * Loads the file now, then checks it every [pollIntervalMs] until [scope] is cancelled.
+     */
+    fun watch(scope: CoroutineScope): Job {
+        reloadIfChanged()
+        return scope.launch {
+            while (isActive) {
+                delay(pollIntervalMs)
+                reloadIfChanged()
+            }
+        }
+    }
+
+    private fun parse(lines: List<String>): Map<String, Set<String>> {
+        val terms = mutableMapOf<String, MutableSet<String>>()
+        for (line in lines) {
+            val trimmed = line.trim()
+            if (trimmed.isEmpty() || trimmed.startsWith("#")) continue
+            val prefix = trimmed.substringBefore(':', "").trim().lowercase()
+            val term = trimmed.substringAfter(':', "").trim()
+            if (prefix !in PREFIXES || term.isEmpty()) {
+                logger.warn("Ignoring moderation term line: $trimmed")
+                continue
+            }
+            terms.getOrPut(prefix) { mutableSetOf() } += term
+        }
+        return terms
+    }
+
+    private companion object {
+        const val DEFAULT_POLL_INTERVAL_MS = 30_000L
+        const val HARD_PREFIX = "hard"
+        const val REVIEW_PREFIX = "review"
+        const val SPAM_PREFIX = "spam"
+        val PREFIXES = setOf(HARD_PREFIX, REVIEW_PREFIX, SPAM_PREFIX)
+    }
+}
@@ -3,19 +3,16 @@ package com.guyghost.wakeve.notification
 import com.guyghost.wakeve.repository.DatabaseEventRepository
 import com.guyghost.wakeve.i18n.ServerLocalizer
 import com.guyghost.wakeve.moderation.ModerationRepository
+import com.guyghost.wakeve.security.RateLimitPolicy
+import com.guyghost.wakeve.security.RateLimiter
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.SupervisorJob
-import kotlinx.coroutines.delay
+import kotlinx.coroutines.cancel
 import kotlinx.coroutines.launch
-import kotlinx.coroutines.sync.Mutex
-import kotlinx.coroutines.sync.withLock
-import kotlinx.datetime.Clock
-import kotlinx.datetime.Instant
 import org.slf4j.LoggerFactory
 import java.util.concurrent.ConcurrentHashMap
 import kotlin.time.Duration.Companion.hours
-import kotlin.time.Duration.Companion.minutes
 
 /**
  * Service for triggering push notifications on key event actions.
@@ -27,86 +24,118 @@ import kotlin.time.Duration.Companion.minutes
  * - New comment posted
  * - Deadline approaching (via scheduled task)
  *
- * Inclut la deduplication intelligente et le rate limiting :
- * - Les votes multiples pour le meme evenement sont regroupes en 5 minutes
- * - Maximum 10 notifications par heure par utilisateur
+ * Inclut le regroupement et le rate limiting :
+ * - Votes, commentaires et changements de statut sont regroupes par
+ *   (destinataire, evenement, categorie) par le [NotificationCoalescer] :
+ *   5 minutes pour les votes, 2 minutes pour les commentaires, 30 secondes
+ *   pour les statuts (seul le dernier statut est envoye)
+ * - Maximum 10 notifications par heure par utilisateur, via [notificationRateLimiter]
  */
 class EventNotificationTrigger(
     private val notificationService: NotificationService,
     private val eventRepository: DatabaseEventRepository,
-    private val moderationRepository: ModerationRepository? = null
+    private val moderationRepository: ModerationRepository? = null,
+    coalescingWindowMs: (CoalescingCategory) -> Long = CoalescingCategory::windowMs,
+    /** Limite de notifications par utilisateur, partageable entre instances via son backend */
+    val notificationRateLimiter: RateLimiter = RateLimiter(
+        name = "notification.push",
+        policy = RateLimitPolicy(limit = 10, windowMs = 1.hours.inWholeMilliseconds)
+    )
 ) {
     private val logger = LoggerFactory.getLogger("EventNotificationTrigger")
     private val scope = CoroutineScope(SupervisorJob() + Dispatchers.IO)
 
-    // ==================== DEDUPLICATION ====================
+    // ==================== REGROUPEMENT ====================
 
     /**
-     * Buffer de votes en attente de regroupement.
-     * Cle : "userId:eventId" -> liste des noms de votants
+     * Moteur de regroupement, avec un seul timer partage pour tous les lots.
      */
-    private val pendingVoteNotifications = ConcurrentHashMap<String, MutableList<String>>()
-    private val pendingVoteLocales = ConcurrentHashMap<String, String>()
-    private val voteFlushMutex = Mutex()
+    private val coalescer = NotificationCoalescer(::sendDigests, coalescingWindowMs).also { it.start(scope) }
 
     /**
-     * Delai de regroupement des notifications de vote (5 minutes).
+     * Titre et organisateur des evenements recemment notifies, pour ne pas
+     * recharger l'evenement complet a chaque vote ou commentaire.
      */
-    private val voteBatchWindowMs = 5.minutes
+    private data class EventSummary(val title: String, val organizerId: String, val loadedAt: Long)
+
+    private val eventSummaries = ConcurrentHashMap<String, EventSummary>()
 
     // ==================== RATE LIMITING ====================
 
     /**
-     * Compteur de notifications envoyees par utilisateur dans l'heure courante.
-     * Cle : userId -> liste de timestamps des notifications envoyees.
+     * Verifie si l'utilisateur peut recevoir une notification (rate limiting)
+     * et la compte le cas echeant.
+     *
+     * @return true si la notification peut etre envoyee
      */
-    private val rateLimitCounters = ConcurrentHashMap<String, MutableList<Long>>()
-    private val rateLimitMutex = Mutex()
+    private fun canSendNotification(userId: String): Boolean {
+        if (notificationRateLimiter.tryAcquire(userId)) return true
+        logger.info("Notification rate limit reached ({}/h)", notificationRateLimiter.policy.limit)
+        return false
+    }
 
     /**
-     * Limite maximale de notifications par heure par utilisateur.
+     * Envoie la meme notification a plusieurs utilisateurs avec rate limiting.
+     * Un seul envoi groupe : le payload est partage, ce qui permet le multicast.
+     *
+     * @return Un resultat par destinataire, dans l'ordre de [userIds]
      */
-    private val maxNotificationsPerHour = 10
+    private suspend fun sendBroadcastWithRateLimit(
+        notification: BroadcastNotification,
+        userIds: List<String>
+    ): List<Result<String>> {
+        val allowed = userIds.filter { canSendNotification(it) }
+        val sent = notificationService.sendBroadcast(notification.withDeepLink(), allowed)
+            .let { results -> allowed.zip(results).toMap() }
+        return userIds.map { userId ->
+            sent[userId] ?: Result.failure(Exception("Rate limit atteint"))
+        }
+    }
 
     /**
-     * Verifie si l'utilisateur peut recevoir une notification (rate limiting).
-     *
-     * @return true si la notification peut etre envoyee
+     * Titre et organisateur de l'evenement, depuis le cache s'il a moins de
+     * [EVENT_SUMMARY_TTL_MS].
      */
-    private suspend fun canSendNotification(userId: String): Boolean {
-        rateLimitMutex.withLock {
-            val now = Clock.System.now().toEpochMilliseconds()
-            val oneHourAgo = now - 1.hours.inWholeMilliseconds
+    private fun eventSummary(eventId: String): EventSummary? {
+        val now = System.currentTimeMillis()
+        eventSummaries[eventId]?.takeIf { now - it.loadedAt < EVENT_SUMMARY_TTL_MS }?.let { return it }
 
-            val timestamps = rateLimitCounters.getOrPut(userId) { mutableListOf() }
-
-            // Nettoyer les entrees de plus d'une heure
-            timestamps.removeAll { it < oneHourAgo }
-
-            if (timestamps.size >= maxNotificationsPerHour) {
-                logger.info("Notification rate limit reached ({}/{}/h)", timestamps.size, maxNotificationsPerHour)
-                return false
-            }
-
-            timestamps.add(now)
-            return true
+        if (eventSummaries.size >= MAX_EVENT_SUMMARIES) {
+            eventSummaries.values.removeIf { now - it.loadedAt >= EVENT_SUMMARY_TTL_MS }
+        }
+        val event = eventRepository.getEvent(eventId) ?: run {
+            eventSummaries.remove(eventId)
+            return null
         }
+        return EventSummary(event.title, event.organizerId, now).also { eventSummaries[eventId] = it }
     }
 
     /**
-     * Envoie une notification avec rate limiting.
+     * A appeler apres toute modification ou suppression d'un evenement :
+     * la prochaine notification rechargera son titre et son organisateur.
+     *
+     * @param eventId ID de l'evenement modifie
      */
-    private suspend fun sendWithRateLimit(request: NotificationRequest): Result<String> {
-        if (!canSendNotification(request.userId)) {
-            return Result.failure(Exception("Rate limit atteint pour ${request.userId}"))
-        }
-        return notificationService.sendNotification(request.withDeepLink())
+    fun onEventUpdated(eventId: String) {
+        eventSummaries.remove(eventId)
+    }
+
+    /**
+     * Envoie les lots encore ouverts puis arrete le timer de regroupement.
+     * A appeler a l'arret du serveur, avant de vider la file des pushs.
+     *
+     * @return Nombre de lots envoyes
+     */
+    suspend fun shutdown(): Int {
+        val flushed = coalescer.flushAll()
+        scope.cancel()
+        return flushed
     }
 
     /**
      * Trigger notification when a vote is added to an event poll.
      *
-     * Utilise la deduplication : si plusieurs votes arrivent pour le meme
+     * Utilise le regroupement : si plusieurs votes arrivent pour le meme
      * evenement dans une fenetre de 5 minutes, ils sont regroupes en une
      * seule notification "X personnes ont vote".
      *
@@ -117,29 +146,18 @@ class EventNotificationTrigger(
     fun onVoteAdded(eventId: String, voterId: String, voterName: String? = null, locale: String = "fr") {
         scope.launch {
             try {
-                val event = eventRepository.getEvent(eventId) ?: return@launch
-                val organizerId = event.organizerId
+                val event = eventSummary(eventId) ?: return@launch
 
                 // Ne pas notifier l'organisateur s'il vote lui-meme
-                if (organizerId == voterId) return@launch
+                if (event.organizerId == voterId) return@launch
 
                 val displayName = voterName ?: ServerLocalizer.t("notification.vote.default_voter", locale)
-                val batchKey = "$organizerId:$eventId"
-
-                val isFirstInBatch = voteFlushMutex.withLock {
-                    val pending = pendingVoteNotifications.getOrPut(batchKey) { mutableListOf() }
-                    pending.add(displayName)
-                    pendingVoteLocales.putIfAbsent(batchKey, locale)
-                    pending.size == 1 // Premier vote dans ce batch
-                }
-
-                // Si c'est le premier vote, planifier l'envoi apres 5 minutes
-                if (isFirstInBatch) {
-                    scope.launch {
-                        delay(voteBatchWindowMs)
-                        flushVoteNotification(batchKey, organizerId, eventId, event.title)
-                    }
-                }
+                coalescer.add(
+                    CoalescingKey(event.organizerId, eventId, CoalescingCategory.VOTE),
+                    event.title,
+                    locale,
+                    mapOf("voterName" to displayName)
+                )
 
                 logger.info("Vote notification queued for batching")
             } catch (e: Exception) {
@@ -148,58 +166,11 @@ class EventNotificationTrigger(
         }
     }
 
-    /**
-     * Envoie la notification regroupee de votes.
-     */
-    private suspend fun flushVoteNotification(
-        batchKey: String,
-        organizerId: String,
-        eventId: String,
-        eventTitle: String
-    ) {
-        try {
-            val voterNames: List<String>
-            val locale: String
-            voteFlushMutex.withLock {
-                voterNames = pendingVoteNotifications.remove(batchKey) ?: return
-                locale = pendingVoteLocales.remove(batchKey) ?: "fr"
-            }
-
-            if (voterNames.isEmpty()) return
-
-            val (title, body) = if (voterNames.size == 1) {
-                ServerLocalizer.t("notification.vote.title_single", locale) to
-                    ServerLocalizer.t("notification.vote.body_single", locale, voterNames.first(), eventTitle)
-            } else {
-                ServerLocalizer.t("notification.vote.title_multiple", locale) to
-                    ServerLocalizer.t("notification.vote.body_multiple", locale, voterNames.size, eventTitle)
-            }
-
-            val request = NotificationRequest(
-                userId = organizerId,
-                type = NotificationType.VOTE_REMINDER,
-                title = title,
-                body = body,
-                eventId = eventId,
-                data = mapOf(
-                    "eventId" to eventId,
-                    "voteCount" to voterNames.size.toString(),
-                    "batched" to "true"
-                )
-            )
-
-            sendWithRateLimit(request)
-                .onSuccess { logger.info("Vote notification batch sent (count={})", voterNames.size) }
-                .onFailure { logger.warn("Failed to send batched vote notification") }
-        } catch (e: Exception) {
-            logger.error("Error flushing vote notification batch", e)
-        }
-    }
-
     /**
      * Trigger notification when event status changes.
      *
-     * Notifies all participants about the status change.
+     * Notifies all participants about the status change. Les changements
+     * rapproches sont regroupes : seul le dernier statut est notifie.
      *
      * @param eventId ID de l'evenement
      * @param newStatus Nouveau statut de l'evenement
@@ -208,68 +179,19 @@ class EventNotificationTrigger(
     fun onEventStatusChanged(eventId: String, newStatus: String, finalDate: String? = null, locale: String = "fr") {
         scope.launch {
             try {
-                val event = eventRepository.getEvent(eventId) ?: return@launch
+                // Le statut change : recharger l'evenement
+                onEventUpdated(eventId)
+                val event = eventSummary(eventId) ?: return@launch
                 val participants = eventRepository.getParticipants(eventId) ?: return@launch
 
-                val (notificationType, title, body) = when (newStatus.uppercase()) {
-                    "CONFIRMED", "FINALIZED" -> Triple(
-                        NotificationType.DATE_CONFIRMED,
-                        ServerLocalizer.t("notification.status.confirmed_title", locale),
-                        if (finalDate != null) {
-                            ServerLocalizer.t("notification.status.confirmed_body_with_date", locale, event.title, finalDate)
-                        } else {
-                            ServerLocalizer.t("notification.status.confirmed_body", locale, event.title)
-                        }
-                    )
-                    "POLLING" -> Triple(
-                        NotificationType.VOTE_REMINDER,
-                        ServerLocalizer.t("notification.status.polling_title", locale),
-                        ServerLocalizer.t("notification.status.polling_body", locale, event.title)
-                    )
-                    "CANCELLED" -> Triple(
-                        NotificationType.EVENT_UPDATE,
-                        ServerLocalizer.t("notification.status.cancelled_title", locale),
-                        ServerLocalizer.t("notification.status.cancelled_body", locale, event.title)
-                    )
-                    else -> Triple(
-                        NotificationType.EVENT_UPDATE,
-                        ServerLocalizer.t("notification.status.updated_title", locale),
-                        ServerLocalizer.t("notification.status.updated_body", locale, event.title)
-                    )
-                }
-
                 // Notifier tous les participants (sauf l'organisateur qui a fait le changement)
-                val deliveryResults = mutableListOf<Result<String>>()
-                for (participantId in participants) {
-                    if (participantId == event.organizerId) continue
-
-                    val request = NotificationRequest(
-                        userId = participantId,
-                        type = notificationType,
-                        title = title,
-                        body = body,
-                        eventId = eventId,
-                        data = mapOf(
-                            "eventId" to eventId,
-                            "status" to newStatus,
-                            "finalDate" to (finalDate ?: "")
-                        )
-                    )
-
-                    val result = sendWithRateLimit(request)
-                    deliveryResults += result
-                    result
-                        .onFailure { logger.warn("Failed to send status change notification") }
+                val item = mapOf("status" to newStatus, "finalDate" to (finalDate ?: ""))
+                participants.filter { it != event.organizerId }.forEach { participantId ->
+                    val key = CoalescingKey(participantId, eventId, CoalescingCategory.STATUS)
+                    coalescer.add(key, event.title, locale, item)
                 }
 
-                val summary = summarizeNotificationDelivery(deliveryResults)
-                logger.info(
-                    "Status change notifications processed (status={}, attempted={}, sent={}, failed={})",
-                    newStatus,
-                    summary.attempted,
-                    summary.sent,
-                    summary.failed
-                )
+                logger.info("Status change notifications queued (status={})", newStatus)
             } catch (e: Exception) {
                 logger.error("Error triggering status change notification", e)
             }
@@ -279,7 +201,8 @@ class EventNotificationTrigger(
     /**
      * Trigger notification when a new comment is posted.
      *
-     * Notifies other participants in the event.
+     * Notifies other participants in the event. Les commentaires d'une fenetre
+     * de 2 minutes sont regroupes en une notification par participant.
      *
      * @param eventId ID de l'evenement
      * @param authorId ID de l'auteur du commentaire
@@ -289,7 +212,7 @@ class EventNotificationTrigger(
     fun onNewComment(eventId: String, authorId: String, authorName: String, commentPreview: String, locale: String = "fr") {
         scope.launch {
             try {
-                val event = eventRepository.getEvent(eventId) ?: return@launch
+                val event = eventSummary(eventId) ?: return@launch
                 val participants = eventRepository.getParticipants(eventId) ?: return@launch
 
                 val truncatedPreview = if (commentPreview.length > 80) {
@@ -298,43 +221,151 @@ class EventNotificationTrigger(
                     commentPreview
                 }
 
-                val deliveryResults = mutableListOf<Result<String>>()
-                for (participantId in participants) {
+                val recipients = participants.filter { participantId ->
                     // Ne pas notifier l'auteur du commentaire
-                    if (participantId == authorId) continue
-                    if (moderationRepository?.isBlockedForEvent(participantId, authorId, eventId) == true) continue
-
-                    val request = NotificationRequest(
-                        userId = participantId,
-                        type = NotificationType.NEW_COMMENT,
-                        title = ServerLocalizer.t("notification.comment.title", locale, authorName),
-                        body = ServerLocalizer.t("notification.comment.body", locale, event.title, truncatedPreview),
-                        eventId = eventId,
-                        data = mapOf(
-                            "eventId" to eventId,
-                            "authorId" to authorId
-                        )
-                    )
-
-                    val result = sendWithRateLimit(request)
-                    deliveryResults += result
-                    result
-                        .onFailure { logger.warn("Failed to send comment notification") }
+                    participantId != authorId &&
+                        moderationRepository?.isBlockedForEvent(participantId, authorId, eventId) != true
+                }
+                val item = mapOf("authorId" to authorId, "authorName" to authorName, "preview" to truncatedPreview)
+                recipients.forEach { participantId ->
+                    val key = CoalescingKey(participantId, eventId, CoalescingCategory.COMMENT)
+                    coalescer.add(key, event.title, locale, item)
                 }
 
-                val summary = summarizeNotificationDelivery(deliveryResults)
+                logger.info("Comment notifications queued (recipients={})", recipients.size)
+            } catch (e: Exception) {
+                logger.error("Error triggering comment notification", e)
+            }
+        }
+    }
+
+    /**
+     * Envoie les lots regroupes. Les lots dont la notification rendue est
+     * identique (meme evenement, meme contenu) partent en un seul envoi groupe.
+     */
+    private suspend fun sendDigests(batches: List<CoalescedBatch>) {
+        batches
+            .groupBy({ renderDigest(it) }, { it.key.recipientId })
+            .forEach { (notification, recipients) ->
+                val summary = summarizeNotificationDelivery(sendBroadcastWithRateLimit(notification, recipients))
+                if (summary.failed > 0) {
+                    logger.warn("Failed to send some {} notifications", notification.type.name)
+                }
                 logger.info(
-                    "Comment notifications processed (attempted={}, sent={}, failed={})",
+                    "Coalesced notifications processed (type={}, attempted={}, sent={}, failed={})",
+                    notification.type.name,
                     summary.attempted,
                     summary.sent,
                     summary.failed
                 )
-            } catch (e: Exception) {
-                logger.error("Error triggering comment notification", e)
+            }
+    }
+
+    /**
+     * Rend un lot en une notification : un element est notifie tel quel,
+     * plusieurs sont resumes ("3 personnes ont vote").
+     */
+    private fun renderDigest(batch: CoalescedBatch): BroadcastNotification {
+        val eventId = batch.key.eventId
+        val locale = batch.locale
+        return when (batch.key.category) {
+            CoalescingCategory.VOTE -> {
+                val (title, body) = if (batch.count == 1) {
+                    val voterName = batch.latest.getValue("voterName")
+                    ServerLocalizer.t("notification.vote.title_single", locale) to
+                        ServerLocalizer.t("notification.vote.body_single", locale, voterName, batch.eventTitle)
+                } else {
+                    ServerLocalizer.t("notification.vote.title_multiple", locale) to
+                        ServerLocalizer.t("notification.vote.body_multiple", locale, batch.count, batch.eventTitle)
+                }
+                BroadcastNotification(
+                    type = NotificationType.VOTE_REMINDER,
+                    title = title,
+                    body = body,
+                    eventId = eventId,
+                    data = mapOf(
+                        "eventId" to eventId,
+                        "voteCount" to batch.count.toString(),
+                        "batched" to "true"
+                    )
+                )
+            }
+            CoalescingCategory.COMMENT -> {
+                val (title, body) = if (batch.count == 1) {
+                    val authorName = batch.latest.getValue("authorName")
+                    val preview = batch.latest.getValue("preview")
+                    ServerLocalizer.t("notification.comment.title", locale, authorName) to
+                        ServerLocalizer.t("notification.comment.body", locale, batch.eventTitle, preview)
+                } else {
+                    val authors = batch.items.map { it.getValue("authorName") }.distinct().take(MAX_DIGEST_NAMES)
+                    ServerLocalizer.t("notification.comment.title_multiple", locale, batch.count) to
+                        ServerLocalizer.t(
+                            "notification.comment.body_multiple", locale, authors.joinToString(", "), batch.eventTitle
+                        )
+                }
+                BroadcastNotification(
+                    type = NotificationType.NEW_COMMENT,
+                    title = title,
+                    body = body,
+                    eventId = eventId,
+                    data = mapOf(
+                        "eventId" to eventId,
+                        "authorId" to batch.latest.getValue("authorId"),
+                        "commentCount" to batch.count.toString()
+                    )
+                )
+            }
+            CoalescingCategory.STATUS -> {
+                val status = batch.latest.getValue("status")
+                val finalDate = batch.latest.getValue("finalDate").ifEmpty { null }
+                val (notificationType, title, body) = renderStatusChange(status, finalDate, batch.eventTitle, locale)
+                BroadcastNotification(
+                    type = notificationType,
+                    title = title,
+                    body = body,
+                    eventId = eventId,
+                    data = mapOf(
+                        "eventId" to eventId,
+                        "status" to status,
+                        "finalDate" to (finalDate ?: "")
+                    )
+                )
             }
         }
     }
 
+    private fun renderStatusChange(
+        newStatus: String,
+        finalDate: String?,
+        eventTitle: String,
+        locale: String
+    ): Triple<NotificationType, String, String> = when (newStatus.uppercase()) {
+        "CONFIRMED", "FINALIZED" -> Triple(
+            NotificationType.DATE_CONFIRMED,
+            ServerLocalizer.t("notification.status.confirmed_title", locale),
+            if (finalDate != null) {
+                ServerLocalizer.t("notification.status.confirmed_body_with_date", locale, eventTitle, finalDate)
+            } else {
+                ServerLocalizer.t("notification.status.confirmed_body", locale, eventTitle)
+            }
+        )
+        "POLLING" -> Triple(
+            NotificationType.VOTE_REMINDER,
+            ServerLocalizer.t("notification.status.polling_title", locale),
+            ServerLocalizer.t("notification.status.polling_body", locale, eventTitle)
+        )
+        "CANCELLED" -> Triple(
+            NotificationType.EVENT_UPDATE,
+            ServerLocalizer.t("notification.status.cancelled_title", locale),
+            ServerLocalizer.t("notification.status.cancelled_body", locale, eventTitle)
+        )
+        else -> Triple(
+            NotificationType.EVENT_UPDATE,
+            ServerLocalizer.t("notification.status.updated_title", locale),
+            ServerLocalizer.t("notification.status.updated_body", locale, eventTitle)
+        )
+    }
+
     /**
      * Trigger deadline reminder notifications.
      *
@@ -346,7 +377,7 @@ class EventNotificationTrigger(
     fun onDeadlineApproaching(eventId: String, hoursRemaining: Int, locale: String = "fr") {
         scope.launch {
             try {
-                val event = eventRepository.getEvent(eventId) ?: return@launch
+                val event = eventSummary(eventId) ?: return@launch
                 val participants = eventRepository.getParticipants(eventId) ?: return@launch
 
                 val timeText = when {
@@ -355,24 +386,19 @@ class EventNotificationTrigger(
                     else -> ServerLocalizer.t("notification.deadline.time_days", locale, hoursRemaining / 24)
                 }
 
-                val deliveryResults = mutableListOf<Result<String>>()
-                for (participantId in participants) {
-                    val request = NotificationRequest(
-                        userId = participantId,
-                        type = NotificationType.DEADLINE_REMINDER,
-                        title = ServerLocalizer.t("notification.deadline.title", locale),
-                        body = ServerLocalizer.t("notification.deadline.body", locale, timeText, event.title),
-                        eventId = eventId,
-                        data = mapOf(
-                            "eventId" to eventId,
-                            "hoursRemaining" to hoursRemaining.toString()
-                        )
+                val notification = BroadcastNotification(
+                    type = NotificationType.DEADLINE_REMINDER,
+                    title = ServerLocalizer.t("notification.deadline.title", locale),
+                    body = ServerLocalizer.t("notification.deadline.body", locale, timeText, event.title),
+                    eventId = eventId,
+                    data = mapOf(
+                        "eventId" to eventId,
+                        "hoursRemaining" to hoursRemaining.toString()
                     )
-
-                    val result = sendWithRateLimit(request)
-                    deliveryResults += result
-                    result
-                        .onFailure { logger.warn("Failed to send deadline reminder") }
+                )
+                val deliveryResults = sendBroadcastWithRateLimit(notification, participants)
+                if (deliveryResults.any { it.isFailure }) {
+                    logger.warn("Failed to send some deadline reminders")
                 }
 
                 val summary = summarizeNotificationDelivery(deliveryResults)
@@ -390,6 +416,12 @@ class EventNotificationTrigger(
     }
 }
 
+private const val EVENT_SUMMARY_TTL_MS = 60_000L
+private const val MAX_EVENT_SUMMARIES = 10_000
+
+// Noms cites dans un resume de commentaires
+private const val MAX_DIGEST_NAMES = 3
+
 internal data class NotificationDeliverySummary(
     val attempted: Int,
     val sent: Int,
@@ -0,0 +1,105 @@
+package com.guyghost.wakeve.notification
+
+/**
+ * Hierarchical timer wheel: schedules values at millisecond deadlines and
+ * returns them once due, in O(1) per insertion and per tick.
+ *
+ * Level 0 has [slotsPerLevel] slots of one [tickMillis] tick each; every level
+ * above covers [slotsPerLevel] times the span of the one below. An entry sits
+ * at the lowest level whose span reaches its deadline and cascades down as the
+ * wheel turns. Deadlines past the top level wait in an overflow list.
+ *
+ * Values fire on the first tick at or after their deadline. Not thread-safe:
+ * drive it from a single coroutine.
+ */
+class HierarchicalTimerWheel<T>(
+    private val tickMillis: Long = 1_000,
+    private val slotsPerLevel: Int = 64,
+    private val levels: Int = 4,
+    startMillis: Long
+) {
+    private class Entry<T>(val tick: Long, val value: T)
+
+    private val wheels = Array(levels) { arrayOfNulls<MutableList<Entry<T>>>(slotsPerLevel) }
+
+    // Ticks covered by one slot of each level: 1, slots, slots^2, ...
+    private val slotSpans = LongArray(levels + 1).also { spans ->
+        spans[0] = 1
+        for (level in 1..levels) spans[level] = spans[level - 1] * slotsPerLevel
+    }
+    private val overflow = mutableListOf<Entry<T>>()
+    private val due = mutableListOf<T>()
+    private var currentTick = startMillis / tickMillis
+
+    /** Values scheduled and not yet returned by [advanceTo]. */
+    var size = 0
+        private set
+
+    fun schedule(deadlineMillis: Long, value: T) {
+        // First tick at or after the deadline
+        val tick = Math.floorDiv(deadlineMillis + tickMillis - 1, tickMillis)
+        place(Entry(tick, value))
+        size++
+    }
+
+    /**
+     * Turns the wheel up to [nowMillis] and returns the values now due,
+     * earliest tick first.
+     */
+    fun advanceTo(nowMillis: Long): List<T> {
+        val target = Math.floorDiv(nowMillis, tickMillis)
+        while (currentTick < target) {
+            if (size == due.size) {
+                // Nothing pending in the wheel: skip the idle ticks
+                currentTick = target
+                break
+            }
+            currentTick++
+            for (level in levels - 1 downTo 1) {
+                if (currentTick % slotSpans[level] == 0L) cascade(level)
+            }
+            if (currentTick % slotSpans[levels - 1] == 0L) reinsertOverflow()
+            val slot = (currentTick % slotsPerLevel).toInt()
+            wheels[0][slot]?.let { entries ->
+                entries.forEach { due.add(it.value) }
+                wheels[0][slot] = null
+            }
+        }
+        if (due.isEmpty()) return emptyList()
+        val result = due.toList()
+        due.clear()
+        size -= result.size
+        return result
+    }
+
+    private fun place(entry: Entry<T>) {
+        val delta = entry.tick - currentTick
+        if (delta <= 0) {
+            due.add(entry.value)
+            return
+        }
+        for (level in 0 until levels) {
+            if (delta < slotSpans[level + 1]) {
+                val slot = ((entry.tick / slotSpans[level]) % slotsPerLevel).toInt()
+                val entries = wheels[level][slot] ?: mutableListOf<Entry<T>>().also { wheels[level][slot] = it }
+                entries.add(entry)
+                return
+            }
+        }
+        overflow.add(entry)
+    }
+
+    private fun cascade(level: Int) {
+        val slot = ((currentTick / slotSpans[level]) % slotsPerLevel).toInt()
+        val entries = wheels[level][slot] ?: return
+        wheels[level][slot] = null
+        entries.forEach(::place)
+    }
+
+    private fun reinsertOverflow() {
+        if (overflow.isEmpty()) return
+        val waiting = overflow.toList()
+        overflow.clear()
+        waiting.forEach(::place)
+    }
+}
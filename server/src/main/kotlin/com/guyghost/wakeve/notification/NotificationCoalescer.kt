@@ -0,0 +1,174 @@
+package com.guyghost.wakeve.notification
+
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.isActive
+import kotlinx.coroutines.launch
+import org.slf4j.LoggerFactory
+
+/**
+ * Kinds of notification that are coalesced, with their batching window and
+ * the number of items after which a batch is flushed early.
+ */
+enum class CoalescingCategory(val windowMs: Long, val maxBatchSize: Int) {
+    VOTE(windowMs = 5 * 60 * 1000L, maxBatchSize = 50),
+    COMMENT(windowMs = 2 * 60 * 1000L, maxBatchSize = 10),
+    STATUS(windowMs = 30 * 1000L, maxBatchSize = 5)
+}
+
+data class CoalescingKey(
+    val recipientId: String,
+    val eventId: String,
+    val category: CoalescingCategory
+)
+
+/**
+ * Items gathered for one key during a window, ready to be rendered as a digest.
+ *
+ * @property items The first [CoalescingCategory.maxBatchSize] items, in arrival order
+ * @property count Items received, including those past [items]
+ * @property latest The last item received
+ */
+class CoalescedBatch(
+    val key: CoalescingKey,
+    val eventTitle: String,
+    val locale: String,
+    val items: List<Map<String, String>>,
+    val count: Int,
+    val latest: Map<String, String>
+)
+
+/**
+ * Groups notifications by (recipient, event, category) and hands each group
+ * over as one [CoalescedBatch].
+ *
+ * The first item for a key opens a batch, flushed when its category window
+ * ends. A batch reaching the category's max size is flushed at once, but only
+ * once per window per key: past that, items are counted into the open batch.
+ * A key therefore produces at most two flushes per window, however busy the
+ * event is.
+ *
+ * All windows share one [HierarchicalTimerWheel] driven by a single coroutine
+ * ticking every [tickMs], instead of one delayed coroutine per batch. A
+ * category whose [windowMs] is zero is not coalesced: each item is flushed
+ * on its own.
+ */
+class NotificationCoalescer(
+    private val flush: suspend (List<CoalescedBatch>) -> Unit,
+    private val windowMs: (CoalescingCategory) -> Long = CoalescingCategory::windowMs,
+    private val clock: () -> Long = System::currentTimeMillis,
+    private val tickMs: Long = DEFAULT_TICK_MS
+) {
+    private class OpenBatch(
+        val generation: Long,
+        val eventTitle: String,
+        val locale: String,
+        val items: MutableList<Map<String, String>> = mutableListOf(),
+        var count: Int = 0,
+        var latest: Map<String, String> = emptyMap()
+    )
+
+    private val logger = LoggerFactory.getLogger(NotificationCoalescer::class.java)
+    private val lock = Any()
+
+    // Guarded by lock
+    private val wheel = HierarchicalTimerWheel<Pair<CoalescingKey, Long>>(tickMillis = tickMs, startMillis = clock())
+    private val open = HashMap<CoalescingKey, OpenBatch>()
+    private val earlyFlushAt = HashMap<CoalescingKey, Long>()
+    private var nextGeneration = 0L
+
+    /**
+     * Starts the shared timer.
+     */
+    fun start(scope: CoroutineScope): Job =
+        scope.launch {
+            while (isActive) {
+                try {
+                    flushDue()
+                } catch (e: Exception) {
+                    logger.error("Notification coalescing tick failed", e)
+                }
+                delay(tickMs)
+            }
+        }
+
+    /**
+     * Adds [item] to the batch of [key], opening one if needed.
+     * A batch that reaches its max size is flushed before returning.
+     */
+    suspend fun add(key: CoalescingKey, eventTitle: String, locale: String, item: Map<String, String>) {
+        val window = windowMs(key.category)
+        if (window <= 0) {
+            flush(listOf(CoalescedBatch(key, eventTitle, locale, listOf(item), 1, item)))
+            return
+        }
+        val full = synchronized(lock) {
+            val now = clock()
+            val batch = open.getOrPut(key) {
+                OpenBatch(nextGeneration++, eventTitle, locale).also { opened ->
+                    wheel.schedule(now + window, key to opened.generation)
+                }
+            }
+            if (batch.items.size < key.category.maxBatchSize) batch.items += item
+            batch.count++
+            batch.latest = item
+
+            val canFlushEarly = earlyFlushAt[key]?.let { now - it >= window } ?: true
+            if (batch.count >= key.category.maxBatchSize && canFlushEarly) {
+                earlyFlushAt[key] = now
+                open.remove(key)?.let { toBatch(key, it) }
+            } else {
+                null
+            }
+        }
+        full?.let { flush(listOf(it)) }
+    }
+
+    /**
+     * Flushes the batches whose window has ended.
+     *
+     * @return Number of batches flushed
+     */
+    suspend fun flushDue(): Int {
+        val due = synchronized(lock) {
+            val now = clock()
+            earlyFlushAt.entries.removeIf { (key, at) -> now - at >= windowMs(key.category) }
+            wheel.advanceTo(now).mapNotNull { (key, generation) ->
+                // A batch flushed early leaves a stale wheel entry behind
+                if (open[key]?.generation != generation) return@mapNotNull null
+                open.remove(key)?.let { toBatch(key, it) }
+            }
+        }
+        if (due.isNotEmpty()) flush(due)
+        return due.size
+    }
+
+    /**
+     * Flushes every open batch, whatever its window, so none is lost on shutdown.
+     *
+     * @return Number of batches flushed
+     */
+    suspend fun flushAll(): Int {
+        val pending = synchronized(lock) {
+            open.map { (key, batch) -> toBatch(key, batch) }.also {
+                // Their wheel entries go stale and are skipped by flushDue
+                open.clear()
+                earlyFlushAt.clear()
+            }
+        }
+        if (pending.isNotEmpty()) flush(pending)
+        return pending.size
+    }
+
+    /** Batches currently open. */
+    val openBatchCount: Int
+        get() = synchronized(lock) { open.size }
+
+    private fun toBatch(key: CoalescingKey, batch: OpenBatch) =
+        CoalescedBatch(key, batch.eventTitle, batch.locale, batch.items.toList(), batch.count, batch.latest)
+
+    companion object {
+        const val DEFAULT_TICK_MS = 1_000L
+    }
+}
@@ -1,125 +1,91 @@
 package com.guyghost.wakeve.notification
 
+import com.guyghost.wakeve.database.Scheduled_job
+import com.guyghost.wakeve.database.WakeveDb
 import com.guyghost.wakeve.repository.DatabaseEventRepository
 import com.guyghost.wakeve.i18n.ServerLocalizer
 import kotlinx.coroutines.*
-import kotlinx.datetime.Clock
 import kotlinx.datetime.Instant
 import org.slf4j.LoggerFactory
 import kotlin.time.Duration.Companion.hours
-import kotlin.time.Duration.Companion.minutes
 
 /**
  * Planificateur de notifications intelligentes.
  *
  * Gere les rappels automatiques :
  * - Rappel de deadline (24h et 1h avant la date limite du sondage)
- * - Rappel du jour de l'evenement (matin du jour confirme)
+ * - Rappel du jour de l'evenement (jour de la date confirmee)
  * - Digest hebdomadaire (resume des notifications non lues)
  *
- * Utilise des coroutines avec delay() pour la planification.
+ * Les rappels sont des lignes durables de la table `scheduled_job`, ajoutees
+ * par les triggers de la base quand une deadline ou une date finale change.
+ * [ScheduledJobRunner] les execute a l'heure via une roue de timers, avec un
+ * claim exclusif par job : pas de scan des evenements, pas de doublon entre
+ * instances, et rien n'est perdu au redemarrage.
  */
 class NotificationScheduler(
     private val notificationService: NotificationService,
     private val eventNotificationTrigger: EventNotificationTrigger,
-    private val eventRepository: DatabaseEventRepository
+    private val eventRepository: DatabaseEventRepository,
+    database: WakeveDb,
+    private val clock: () -> Long = System::currentTimeMillis
 ) {
     private val logger = LoggerFactory.getLogger("NotificationScheduler")
     private val scope = CoroutineScope(SupervisorJob() + Dispatchers.IO)
+    private val queries = database.scheduledJobQueries
 
-    // Jobs actifs pour le suivi et l'annulation
-    private val scheduledJobs = mutableMapOf<String, Job>()
+    // A chaque refill, le digest de la semaine suivante est planifie d'avance :
+    // la chaine continue meme si celui de la semaine a expire ou echoue
+    val runner = ScheduledJobRunner(
+        database,
+        ::runJob,
+        clock = clock,
+        onRefill = { now -> scheduleWeeklyDigest(nextWeeklyDigestAt(now) + WEEK_MS) }
+    )
 
     /**
      * Demarre le planificateur.
-     * Lance les taches periodiques de verification.
+     * Planifie le digest hebdomadaire courant et lance la boucle des jobs.
      */
     fun start() {
         logger.info("Demarrage du NotificationScheduler")
-
-        // Verification periodique des deadlines (toutes les 15 minutes)
-        scope.launch {
-            while (isActive) {
-                try {
-                    checkDeadlineReminders()
-                } catch (e: Exception) {
-                    logger.error("Erreur lors de la verification des deadlines", e)
-                }
-                delay(15.minutes)
-            }
-        }
-
-        // Verification periodique des evenements du jour (toutes les heures)
-        scope.launch {
-            while (isActive) {
-                try {
-                    checkEventDayReminders()
-                } catch (e: Exception) {
-                    logger.error("Erreur lors de la verification des evenements du jour", e)
-                }
-                delay(1.hours)
-            }
-        }
-
-        // Digest hebdomadaire (toutes les 24h, verifie si c'est lundi matin)
-        scope.launch {
-            while (isActive) {
-                try {
-                    checkWeeklyDigest()
-                } catch (e: Exception) {
-                    logger.error("Erreur lors de la verification du digest hebdomadaire", e)
-                }
-                delay(24.hours)
-            }
-        }
+        scheduleWeeklyDigest(nextWeeklyDigestAt(clock()))
+        runner.start(scope)
     }
 
     /**
-     * Arrete le planificateur et annule tous les jobs.
+     * Arrete le planificateur. Les jobs restent en base pour le prochain demarrage.
      */
     fun stop() {
         logger.info("Arret du NotificationScheduler")
         scope.cancel()
-        scheduledJobs.clear()
+        runner.clear()
     }
 
     /**
      * Planifie un rappel de deadline pour un evenement specifique.
+     * Les evenements en sondage sont deja planifies par les triggers ; cet
+     * appel remplace leurs rappels.
      *
      * @param eventId ID de l'evenement
      * @param deadline Instant de la deadline
      */
     fun scheduleDeadlineReminder(eventId: String, deadline: Instant) {
-        val now = Clock.System.now()
+        val now = clock()
+        val deadlineMs = deadline.toEpochMilliseconds()
 
-        // Rappel 24h avant
-        val reminder24h = deadline - 24.hours
+        // Rappel 24h avant, valable une heure
+        val reminder24h = deadlineMs - 24.hours.inWholeMilliseconds
         if (reminder24h > now) {
-            val delay24h = reminder24h - now
-            val jobKey = "deadline-24h-$eventId"
-
-            scheduledJobs[jobKey]?.cancel()
-            scheduledJobs[jobKey] = scope.launch {
-                delay(delay24h)
-                eventNotificationTrigger.onDeadlineApproaching(eventId, 24)
-                scheduledJobs.remove(jobKey)
-            }
-            logger.info("Rappel 24h planifie dans {} minutes", delay24h.inWholeMinutes)
+            queries.upsertJob("deadline-24h-$eventId", ScheduledJobType.DEADLINE_24H.name, eventId, reminder24h, reminder24h + 1.hours.inWholeMilliseconds)
+            logger.info("Rappel 24h planifie dans {} minutes", (reminder24h - now) / 60_000)
         }
 
-        // Rappel 1h avant
-        val reminder1h = deadline - 1.hours
+        // Rappel 1h avant, valable jusqu'a la deadline
+        val reminder1h = deadlineMs - 1.hours.inWholeMilliseconds
         if (reminder1h > now) {
-            val delay1h = reminder1h - now
-            val jobKey = "deadline-1h-$eventId"
-
-            scheduledJobs[jobKey]?.cancel()
-            scheduledJobs[jobKey] = scope.launch {
-                delay(delay1h)
-                eventNotificationTrigger.onDeadlineApproaching(eventId, 1)
-                scheduledJobs.remove(jobKey)
-            }
-            logger.info("Rappel 1h planifie dans {} minutes", delay1h.inWholeMinutes)
+            queries.upsertJob("deadline-1h-$eventId", ScheduledJobType.DEADLINE_1H.name, eventId, reminder1h, deadlineMs)
+            logger.info("Rappel 1h planifie dans {} minutes", (reminder1h - now) / 60_000)
         }
     }
 
@@ -127,108 +93,66 @@ class NotificationScheduler(
      * Annule les rappels planifies pour un evenement.
      */
     fun cancelReminders(eventId: String) {
-        scheduledJobs.keys
-            .filter { scheduledJobBelongsToEvent(it, eventId) }
-            .forEach { key ->
-                scheduledJobs[key]?.cancel()
-                scheduledJobs.remove(key)
-                logger.info("Rappel annule")
-            }
+        if (eventId.isBlank()) return
+        queries.deleteJobsByEventId(eventId)
+        runner.forget { scheduledJobBelongsToEvent(it, eventId) }
+        logger.info("Rappels annules")
     }
 
     /**
-     * Verifie les deadlines approchantes dans la base de donnees.
-     * Envoie des rappels pour les evenements en cours de sondage
-     * dont la deadline est dans 24h ou 1h.
+     * Execute un job echu, selon son type.
      */
-    private suspend fun checkDeadlineReminders() {
-        val now = Clock.System.now()
-        val events = eventRepository.getAllPollingEvents()
-
-        for (event in events) {
-            val deadline = runCatching {
-                Instant.parse(event.deadline)
-            }.getOrNull() ?: continue
-
-            val hoursRemaining = (deadline - now).inWholeHours.toInt()
-
-            // Envoyer un rappel si on est dans la fenetre de 24h ou 1h
-            when {
-                hoursRemaining in 23..25 -> {
-                    val jobKey = "deadline-check-24h-${event.id}"
-                    if (jobKey !in scheduledJobs) {
-                        scheduledJobs[jobKey] = scope.launch {
-                            eventNotificationTrigger.onDeadlineApproaching(event.id, 24)
-                        }
-                    }
-                }
-                hoursRemaining in 0..1 -> {
-                    val jobKey = "deadline-check-1h-${event.id}"
-                    if (jobKey !in scheduledJobs) {
-                        scheduledJobs[jobKey] = scope.launch {
-                            eventNotificationTrigger.onDeadlineApproaching(event.id, 1)
-                        }
-                    }
-                }
-            }
+    private suspend fun runJob(job: Scheduled_job) {
+        val eventId = job.event_id
+        when (ScheduledJobType.valueOf(job.job_type)) {
+            ScheduledJobType.DEADLINE_24H -> eventNotificationTrigger.onDeadlineApproaching(requireNotNull(eventId), 24)
+            ScheduledJobType.DEADLINE_1H -> eventNotificationTrigger.onDeadlineApproaching(requireNotNull(eventId), 1)
+            ScheduledJobType.EVENT_DAY -> sendEventDayReminders(requireNotNull(eventId))
+            ScheduledJobType.WEEKLY_DIGEST -> sendWeeklyDigest()
         }
     }
 
+    private fun scheduleWeeklyDigest(fireAt: Long) {
+        // Une cle par semaine : plusieurs instances planifient le meme job
+        queries.insertJobIfAbsent(
+            "weekly-digest-${fireAt / WEEK_MS}",
+            ScheduledJobType.WEEKLY_DIGEST.name,
+            null,
+            fireAt,
+            fireAt + DIGEST_WINDOW_MS
+        )
+    }
+
     /**
-     * Verifie les evenements confirmes du jour et envoie des rappels matinaux.
+     * Envoie les rappels du jour J aux participants d'un evenement confirme.
      */
-    private suspend fun checkEventDayReminders() {
-        val now = Clock.System.now()
-        val todayMs = now.toEpochMilliseconds()
-
-        // On verifie les evenements confirmes dont la date finale est aujourd'hui
-        val events = eventRepository.getConfirmedEventsForToday(todayMs)
-
-        for (event in events) {
-            val jobKey = "event-day-${event.id}-${todayMs / 86_400_000}"
-            if (jobKey in scheduledJobs) continue
-
-            val participants = eventRepository.getParticipants(event.id) ?: continue
-
-            for (participantId in participants) {
-                // TODO: resolve user's preferred locale from profile/preferences
-                val locale = "fr"
-
-                val request = NotificationRequest(
-                    userId = participantId,
-                    type = NotificationType.MEETING_REMINDER,
-                    title = ServerLocalizer.t("notification.event_day.title", locale),
-                    body = ServerLocalizer.t("notification.event_day.body", locale, event.title),
-                    eventId = event.id,
-                    data = mapOf("eventId" to event.id)
-                )
-
-                notificationService.sendNotification(request)
-                    .onFailure {
-                        logger.warn("Echec du rappel jour-J")
-                    }
-            }
-
-            scheduledJobs[jobKey] = Job() // Marquer comme traite
-            logger.info("Rappels jour-J envoyes (recipients={})", participants.size)
+    private suspend fun sendEventDayReminders(eventId: String) {
+        val event = eventRepository.getEvent(eventId) ?: return
+        val participants = eventRepository.getParticipants(event.id) ?: return
+
+        // TODO: resolve user's preferred locale from profile/preferences
+        val locale = "fr"
+
+        // Meme payload pour tous les participants : un seul envoi groupe
+        val notification = BroadcastNotification(
+            type = NotificationType.MEETING_REMINDER,
+            title = ServerLocalizer.t("notification.event_day.title", locale),
+            body = ServerLocalizer.t("notification.event_day.body", locale, event.title),
+            eventId = event.id,
+            data = mapOf("eventId" to event.id)
+        )
+        val results = notificationService.sendBroadcast(notification, participants)
+        if (results.any { it.isFailure }) {
+            logger.warn("Echec de rappels jour-J (failed={})", results.count { it.isFailure })
         }
+
+        logger.info("Rappels jour-J envoyes (recipients={})", participants.size)
     }
 
     /**
-     * Verifie s'il faut envoyer le digest hebdomadaire.
-     * Envoye le lundi a 9h (approximation basee sur l'heure UTC).
+     * Envoie le digest hebdomadaire des notifications non lues.
      */
-    private suspend fun checkWeeklyDigest() {
-        val now = Clock.System.now()
-        val dayOfWeek = (now.toEpochMilliseconds() / 86_400_000 + 4) % 7 // 0=dimanche, 1=lundi...
-        val hourOfDay = (now.toEpochMilliseconds() / 3_600_000) % 24
-
-        // Envoyer le digest le lundi entre 8h et 10h UTC
-        if (dayOfWeek != 1L || hourOfDay !in 8..9) return
-
-        val weekKey = "weekly-digest-${now.toEpochMilliseconds() / 604_800_000}"
-        if (weekKey in scheduledJobs) return
-
+    private suspend fun sendWeeklyDigest() {
         logger.info("Envoi du digest hebdomadaire")
 
         // Recuperer tous les utilisateurs avec des tokens enregistres
@@ -281,10 +205,37 @@ class NotificationScheduler(
                     logger.warn("Echec du digest hebdomadaire")
                 }
         }
+    }
 
-        scheduledJobs[weekKey] = Job()
+    companion object {
+        private const val DAY_MS = 86_400_000L
+        private const val WEEK_MS = 7 * DAY_MS
+
+        // Digest le lundi entre 8h et 10h UTC
+        private const val DIGEST_HOUR_MS = 8 * 3_600_000L
+        private const val DIGEST_WINDOW_MS = 2 * 3_600_000L
+
+        /**
+         * Prochain lundi 8h UTC dont la fenetre d'envoi n'est pas passee.
+         */
+        internal fun nextWeeklyDigestAt(nowMs: Long): Long {
+            val day = Math.floorDiv(nowMs, DAY_MS)
+            // Le jour 0 (1er janvier 1970) est un jeudi
+            val daysToMonday = Math.floorMod(-(day + 3), 7L)
+            val fireAt = (day + daysToMonday) * DAY_MS + DIGEST_HOUR_MS
+            return if (fireAt + DIGEST_WINDOW_MS <= nowMs) fireAt + WEEK_MS else fireAt
+        }
     }
+}
 
+/**
+ * Types des jobs de la table `scheduled_job`.
+ */
+enum class ScheduledJobType {
+    DEADLINE_24H,
+    DEADLINE_1H,
+    EVENT_DAY,
+    WEEKLY_DIGEST
 }
 
 internal fun scheduledJobBelongsToEvent(jobKey: String, eventId: String): Boolean {
@@ -0,0 +1,233 @@
+package com.guyghost.wakeve.notification
+
+import com.guyghost.wakeve.metrics.PushDeliveryMetrics
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.channels.Channel
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.flow.MutableStateFlow
+import kotlinx.coroutines.flow.first
+import kotlinx.coroutines.flow.update
+import kotlinx.coroutines.launch
+import kotlinx.coroutines.withTimeoutOrNull
+import org.slf4j.LoggerFactory
+import kotlin.coroutines.cancellation.CancellationException
+import kotlin.random.Random
+
+/**
+ * Asynchronous push delivery in front of the FCM and APNs senders.
+ *
+ * Each platform has a bounded queue of (token, payload) deliveries drained by
+ * [workersPerPlatform] workers. A worker takes up to [maxBatchSize] deliveries,
+ * waiting at most [maxBatchDelayMs] for more, groups those with an identical
+ * payload and sends each group with one multicast call, so a notification
+ * fanned out to a whole event costs one request per 1000 Android tokens and one
+ * multiplexed burst on the APNs connection.
+ *
+ * Retryable failures (gateway unavailable, throttled) are re-queued after an
+ * exponential backoff with full jitter, up to [maxAttempts] tries; permanent
+ * ones (invalid token) are dropped at once. Enqueueing suspends while a queue
+ * holds [queueCapacity] deliveries.
+ *
+ * [fcm] and [apns] plug the pipeline into [NotificationService]: they enqueue and
+ * report success once the delivery is accepted.
+ */
+class PushDeliveryPipeline(
+    private val fcmSender: FCMSender,
+    private val apnsSender: APNsSender,
+    val metrics: PushDeliveryMetrics = PushDeliveryMetrics(),
+    private val workersPerPlatform: Int = DEFAULT_WORKERS_PER_PLATFORM,
+    private val maxBatchSize: Int = FCM_MULTICAST_LIMIT,
+    private val maxBatchDelayMs: Long = DEFAULT_MAX_BATCH_DELAY_MS,
+    private val maxAttempts: Int = DEFAULT_MAX_ATTEMPTS,
+    private val baseBackoffMs: Long = DEFAULT_BASE_BACKOFF_MS,
+    private val maxBackoffMs: Long = DEFAULT_MAX_BACKOFF_MS,
+    queueCapacity: Int = DEFAULT_QUEUE_CAPACITY,
+    private val random: Random = Random.Default
+) {
+    private data class PushMessage(val title: String, val body: String, val data: Map<String, String>)
+
+    private class Delivery(
+        val token: String,
+        val message: PushMessage,
+        val enqueuedAtNanos: Long,
+        val attempt: Int = 1
+    )
+
+    private val logger = LoggerFactory.getLogger(PushDeliveryPipeline::class.java)
+
+    private val queues = Platform.entries.associateWith { Channel<Delivery>(queueCapacity) }
+
+    // Deliveries enqueued and not yet sent or dropped, retries included
+    private val outstanding = MutableStateFlow(0)
+
+    val fcm: FCMSender = object : FCMSender {
+        override suspend fun sendNotification(
+            token: String,
+            title: String,
+            body: String,
+            data: Map<String, String>
+        ): Result<Unit> = sendMulticast(listOf(token), title, body, data).single()
+
+        override suspend fun sendMulticast(
+            tokens: List<String>,
+            title: String,
+            body: String,
+            data: Map<String, String>
+        ): List<Result<Unit>> {
+            enqueue(Platform.ANDROID, tokens, title, body, data)
+            return tokens.map { Result.success(Unit) }
+        }
+    }
+
+    val apns: APNsSender = object : APNsSender {
+        override suspend fun sendNotification(
+            token: String,
+            title: String,
+            body: String,
+            data: Map<String, String>
+        ): Result<Unit> = sendMulticast(listOf(token), title, body, data).single()
+
+        override suspend fun sendMulticast(
+            tokens: List<String>,
+            title: String,
+            body: String,
+            data: Map<String, String>
+        ): List<Result<Unit>> {
+            enqueue(Platform.IOS, tokens, title, body, data)
+            return tokens.map { Result.success(Unit) }
+        }
+    }
+
+    /**
+     * Starts the workers of both platforms.
+     */
+    fun start(scope: CoroutineScope): Job =
+        scope.launch {
+            for (platform in Platform.entries) {
+                repeat(workersPerPlatform) { launch { deliverLoop(platform) } }
+            }
+        }
+
+    /**
+     * Queues one push per token, suspending while the platform queue is full.
+     */
+    suspend fun enqueue(
+        platform: Platform,
+        tokens: List<String>,
+        title: String,
+        body: String,
+        data: Map<String, String>
+    ) {
+        if (tokens.isEmpty()) return
+        val message = PushMessage(title, body, data)
+        val now = System.nanoTime()
+        outstanding.update { it + tokens.size }
+        metrics.recordEnqueued(tokens.size)
+        val queue = queues.getValue(platform)
+        tokens.forEach { token -> queue.send(Delivery(token, message, now)) }
+    }
+
+    /**
+     * Suspends until every queued push has been delivered or dropped.
+     */
+    suspend fun awaitIdle() {
+        outstanding.first { it == 0 }
+    }
+
+    /**
+     * Waits up to [timeoutMs] for the queued pushes to be delivered or dropped, so a
+     * shutdown does not lose notifications that were already accepted.
+     *
+     * @return the number of pushes still outstanding when it returned
+     */
+    suspend fun drain(timeoutMs: Long): Int {
+        withTimeoutOrNull(timeoutMs) { awaitIdle() }
+        return outstanding.value
+    }
+
+    private suspend fun CoroutineScope.deliverLoop(platform: Platform) {
+        val queue = queues.getValue(platform)
+        val batch = ArrayList<Delivery>(maxBatchSize)
+        for (first in queue) {
+            batch += first
+            val deadline = System.nanoTime() + maxBatchDelayMs * 1_000_000
+            while (batch.size < maxBatchSize) {
+                val next = queue.tryReceive().getOrNull()
+                if (next != null) {
+                    batch += next
+                    continue
+                }
+                val remainingMs = (deadline - System.nanoTime()) / 1_000_000
+                if (remainingMs <= 0) break
+                delay(minOf(remainingMs, POLL_INTERVAL_MS))
+            }
+            batch.groupBy { it.message }.forEach { (message, deliveries) ->
+                deliverBatch(platform, message, deliveries)
+            }
+            batch.clear()
+        }
+    }
+
+    private suspend fun CoroutineScope.deliverBatch(platform: Platform, message: PushMessage, deliveries: List<Delivery>) {
+        val tokens = deliveries.map { it.token }
+        metrics.recordBatch(tokens.size)
+        val results = try {
+            when (platform) {
+                Platform.ANDROID -> fcmSender.sendMulticast(tokens, message.title, message.body, message.data)
+                Platform.IOS -> apnsSender.sendMulticast(tokens, message.title, message.body, message.data)
+            }
+        } catch (e: CancellationException) {
+            throw e
+        } catch (e: Exception) {
+            val failure = PushDeliveryException("Push gateway call failed: ${e.message}", retryable = true)
+            tokens.map { Result.failure(failure) }
+        }
+
+        val now = System.nanoTime()
+        var dropped = 0
+        deliveries.forEachIndexed { index, delivery ->
+            val error = results.getOrNull(index)?.exceptionOrNull()
+                ?: if (index < results.size) null else IllegalStateException("Missing delivery result")
+            when {
+                error == null -> {
+                    metrics.recordSent(now - delivery.enqueuedAtNanos)
+                    outstanding.update { it - 1 }
+                }
+                (error as? PushDeliveryException)?.retryable == true && delivery.attempt < maxAttempts -> {
+                    metrics.recordRetried()
+                    val retry = Delivery(delivery.token, delivery.message, delivery.enqueuedAtNanos, delivery.attempt + 1)
+                    launch {
+                        delay(backoffMs(delivery.attempt))
+                        queues.getValue(platform).send(retry)
+                    }
+                }
+                else -> {
+                    dropped++
+                    metrics.recordFailed()
+                    outstanding.update { it - 1 }
+                }
+            }
+        }
+        if (dropped > 0) {
+            logger.warn("{} push deliveries dropped on {}", dropped, platform.name)
+        }
+    }
+
+    // Full jitter: uniform in [0, min(max, base * 2^(attempt - 1))]
+    private fun backoffMs(attempt: Int): Long {
+        val ceiling = minOf(maxBackoffMs, baseBackoffMs shl (attempt - 1).coerceAtMost(30))
+        return random.nextLong(ceiling + 1)
+    }
+
+    companion object {
+        const val DEFAULT_WORKERS_PER_PLATFORM = 4
+        const val DEFAULT_MAX_BATCH_DELAY_MS = 5L
+        const val DEFAULT_MAX_ATTEMPTS = 3
+        const val DEFAULT_BASE_BACKOFF_MS = 500L
+        const val DEFAULT_MAX_BACKOFF_MS = 30_000L
+        const val DEFAULT_QUEUE_CAPACITY = 10_000
+        const val DEFAULT_DRAIN_TIMEOUT_MS = 10_000L
+        private const val POLL_INTERVAL_MS = 1L
+    }
+}
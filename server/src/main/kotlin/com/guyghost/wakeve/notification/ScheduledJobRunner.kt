@@ -0,0 +1,168 @@
+package com.guyghost.wakeve.notification
+
+import com.guyghost.wakeve.database.Scheduled_job
+import com.guyghost.wakeve.database.WakeveDb
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.coroutineScope
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.isActive
+import kotlinx.coroutines.launch
+import org.slf4j.LoggerFactory
+import java.util.UUID
+import java.util.concurrent.ConcurrentHashMap
+
+/**
+ * Runs the durable jobs of the `scheduled_job` table.
+ *
+ * Every [refillIntervalMs] the jobs due within [lookaheadMs] are read with an
+ * indexed range scan on `fire_at` and put on a [HierarchicalTimerWheel]; the
+ * wheel then hands each job over at its fire time. Work per tick is therefore
+ * proportional to the jobs actually due, whatever the number of events.
+ *
+ * Before running a job, the runner claims its row with a conditional update
+ * (still due, same fire time, no live lease). Only one instance can win that
+ * update, so a job runs once even with several servers on the same database.
+ * A claim lasts [leaseMs] and is renewed every half lease while the handler
+ * runs, so a long fan-out keeps its job; if the owner dies, another instance
+ * retakes the job once the lease has run out. Failed jobs are retried with a
+ * backoff up to [maxAttempts] times, and jobs past their `expires_at` are
+ * dropped unfired. [onRefill] runs before each refill, e.g. to enqueue
+ * recurring jobs whatever became of the previous occurrence.
+ */
+class ScheduledJobRunner(
+    database: WakeveDb,
+    private val handler: suspend (Scheduled_job) -> Unit,
+    val instanceId: String = UUID.randomUUID().toString(),
+    private val clock: () -> Long = System::currentTimeMillis,
+    private val lookaheadMs: Long = DEFAULT_LOOKAHEAD_MS,
+    private val refillIntervalMs: Long = DEFAULT_REFILL_INTERVAL_MS,
+    private val leaseMs: Long = DEFAULT_LEASE_MS,
+    private val maxAttempts: Int = DEFAULT_MAX_ATTEMPTS,
+    private val onRefill: (now: Long) -> Unit = {}
+) {
+    private val logger = LoggerFactory.getLogger(ScheduledJobRunner::class.java)
+    private val queries = database.scheduledJobQueries
+
+    // Only touched from the runner loop
+    private val wheel = HierarchicalTimerWheel<Scheduled_job>(tickMillis = TICK_MS, startMillis = clock())
+    private var nextRefillAt = Long.MIN_VALUE
+
+    // Fire time of each job on the wheel; a wheel entry whose fire time no
+    // longer matches was rescheduled or cancelled and is skipped.
+    private val onWheel = ConcurrentHashMap<String, Long>()
+
+    /**
+     * Starts the runner loop: one wheel tick per [TICK_MS], refilling from the
+     * database every [refillIntervalMs].
+     */
+    fun start(scope: CoroutineScope): Job =
+        scope.launch(Dispatchers.IO) {
+            while (isActive) {
+                try {
+                    runDue()
+                } catch (e: Exception) {
+                    logger.error("Scheduled job tick failed", e)
+                }
+                delay(TICK_MS)
+            }
+        }
+
+    /**
+     * One runner step: refills the wheel if due, then claims and runs every
+     * job whose time has come.
+     *
+     * @return Number of jobs run by this instance
+     */
+    suspend fun runDue(): Int {
+        val now = clock()
+        if (now >= nextRefillAt) refill(now)
+        var ran = 0
+        for (job in wheel.advanceTo(now)) {
+            if (onWheel[job.job_key] != job.fire_at) continue
+            onWheel.remove(job.job_key, job.fire_at)
+            if (run(job)) ran++
+        }
+        return ran
+    }
+
+    /**
+     * Forgets the wheel entries of [jobKeys], e.g. after their rows were deleted.
+     */
+    fun forget(jobKeys: (String) -> Boolean) {
+        onWheel.keys.removeIf(jobKeys)
+    }
+
+    fun clear() {
+        onWheel.clear()
+    }
+
+    private fun refill(now: Long) {
+        onRefill(now)
+        queries.deleteExpiredJobs(now)
+        queries.selectJobsDueBefore(now + lookaheadMs).executeAsList().forEach { job ->
+            if (onWheel.put(job.job_key, job.fire_at) != job.fire_at) {
+                wheel.schedule(job.fire_at, job)
+            }
+        }
+        nextRefillAt = now + refillIntervalMs
+    }
+
+    private suspend fun run(job: Scheduled_job): Boolean {
+        val now = clock()
+        if (now > job.expires_at) return false
+        val claimed = queries.claimJob(
+            owner = instanceId,
+            leaseUntil = now + leaseMs,
+            jobKey = job.job_key,
+            fireAt = job.fire_at,
+            now = now
+        ).value == 1L
+        if (!claimed) return false
+
+        try {
+            runWithLease(job)
+            queries.completeJob(job.job_key, instanceId, job.fire_at)
+        } catch (e: Exception) {
+            val attempts = job.attempts + 1
+            if (attempts < maxAttempts) {
+                val retryAt = now + RETRY_BACKOFF_MS * attempts
+                logger.warn("Scheduled job {} failed (attempt {}), retrying", job.job_type, attempts, e)
+                queries.retryJob(fireAt = retryAt, jobKey = job.job_key, owner = instanceId)
+            } else {
+                logger.error("Scheduled job {} failed {} times, dropping it", job.job_type, attempts, e)
+                queries.completeJob(job.job_key, instanceId, job.fire_at)
+            }
+        }
+        return true
+    }
+
+    private suspend fun runWithLease(job: Scheduled_job) = coroutineScope {
+        val renewal = launch {
+            while (true) {
+                delay((leaseMs / 2).coerceAtLeast(1))
+                queries.renewLease(
+                    leaseUntil = clock() + leaseMs,
+                    jobKey = job.job_key,
+                    owner = instanceId,
+                    fireAt = job.fire_at
+                )
+            }
+        }
+        try {
+            handler(job)
+        } finally {
+            renewal.cancel()
+        }
+    }
+
+    companion object {
+        const val TICK_MS = 1_000L
+        const val DEFAULT_LOOKAHEAD_MS = 60 * 60 * 1000L
+        const val DEFAULT_REFILL_INTERVAL_MS = 30_000L
+        const val DEFAULT_LEASE_MS = 5 * 60 * 1000L
+        const val DEFAULT_MAX_ATTEMPTS = 3
+        const val RETRY_BACKOFF_MS = 60_000L
+    }
+}
@@ -38,18 +38,16 @@ fun io.ktor.server.routing.Route.dashboardRoutes(
 
                 val dashboardQueries = database.dashboardQueries
 
-                val totalEvents = dashboardQueries.countEventsByOrganizer(userId)
-                    .executeAsOne()
-                val totalParticipants = dashboardQueries.countParticipantsByOrganizer(userId)
-                    .executeAsOne()
-                val totalVotes = dashboardQueries.countVotesByOrganizer(userId)
-                    .executeAsOne()
-                val totalComments = dashboardQueries.countCommentsByOrganizer(userId)
-                    .executeAsOne()
-
-                val statusBreakdown = dashboardQueries.countEventsByStatusForOrganizer(userId)
+                // Precomputed counters: one row plus one per status, however many events
+                val stats = dashboardQueries.selectOrganizerStats(userId).executeAsOneOrNull()
+                val totalEvents = stats?.eventCount ?: 0L
+                val totalParticipants = stats?.participantCount ?: 0L
+                val totalVotes = stats?.voteCount ?: 0L
+                val totalComments = stats?.commentCount ?: 0L
+
+                val statusBreakdown = dashboardQueries.selectOrganizerStatusCounts(userId)
                     .executeAsList()
-                    .associate { it.status to it.count }
+                    .associate { it.status to it.eventCount }
 
                 val avgParticipants = if (totalEvents > 0) {
                     totalParticipants.toDouble() / totalEvents.toDouble()
@@ -100,8 +98,7 @@ fun io.ktor.server.routing.Route.dashboardRoutes(
                     max = MAX_DASHBOARD_EVENTS_OFFSET
                 ) ?: return@get
 
-                val totalCount = dashboardQueries.countEventsByOrganizer(userId)
-                    .executeAsOne()
+                val totalCount = (dashboardQueries.selectOrganizerStats(userId).executeAsOneOrNull()?.eventCount ?: 0L)
                     .toSafeResponseInt()
 
                 val events = dashboardQueries.selectEventAnalyticsPaged(
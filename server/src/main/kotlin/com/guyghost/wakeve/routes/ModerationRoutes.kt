@@ -98,6 +98,7 @@ fun io.ktor.server.routing.Route.moderationRoutes(
                 eventId = eventId,
                 reason = request.reason
             )
+            eventChatConnections.invalidateBlockLists()
 
             call.respond(HttpStatusCode.Created, block)
         }
@@ -113,6 +114,7 @@ fun io.ktor.server.routing.Route.moderationRoutes(
             )
             val eventId = call.request.queryParameters["eventId"]
             moderationRepository.unblockUser(userId, blockedUserId, eventId)
+            eventChatConnections.invalidateBlockLists()
 
             call.respond(HttpStatusCode.NoContent)
         }
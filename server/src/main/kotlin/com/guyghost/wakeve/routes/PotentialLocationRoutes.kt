@@ -108,6 +108,7 @@ fun io.ktor.server.routing.Route.potentialLocationRoutes(
                     name = request.name,
                     locationType = locationType,
                     address = request.address,
+                    coordinates = request.coordinates,
                     createdAt = now
                 )
                 
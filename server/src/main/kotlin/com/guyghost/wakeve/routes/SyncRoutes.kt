@@ -1,17 +1,31 @@
 package com.guyghost.wakeve.routes
 
+import com.guyghost.wakeve.models.SyncPullRequest
+import com.guyghost.wakeve.models.SyncPullResponse
 import com.guyghost.wakeve.models.SyncRequest
 import com.guyghost.wakeve.models.SyncResponse
+import com.guyghost.wakeve.sync.GzipBodyTooLargeException
+import com.guyghost.wakeve.sync.SyncGzip
 import com.guyghost.wakeve.sync.SyncService
+import com.guyghost.wakeve.sync.SyncWireCodec
+import com.guyghost.wakeve.sync.SyncWireFormat
+import io.ktor.http.ContentType
+import io.ktor.http.HttpHeaders
 import io.ktor.http.HttpStatusCode
+import io.ktor.server.application.ApplicationCall
 import io.ktor.server.auth.jwt.JWTPrincipal
 import io.ktor.server.auth.principal
+import io.ktor.server.request.contentLength
 import io.ktor.server.request.receive
 import io.ktor.server.response.respond
+import io.ktor.server.response.respondBytes
 import io.ktor.server.routing.post
 import io.ktor.server.routing.route
 import kotlinx.datetime.Clock
 
+// Same ceiling for the body on the wire and once gunzipped
+private const val MAX_SYNC_BODY_BYTES = SyncGzip.DEFAULT_MAX_DECOMPRESSED_BYTES
+
 fun io.ktor.server.routing.Route.syncRoutes(syncService: SyncService) {
     route("/sync") {
         // POST /api/sync - Process batch sync changes from client
@@ -28,8 +42,8 @@ fun io.ktor.server.routing.Route.syncRoutes(syncService: SyncService) {
                     mapOf("error" to "Invalid user ID in token")
                 )
 
-                // Receive sync request
-                val request = call.receive<SyncRequest>()
+                // Receive sync request (JSON, or CBOR when the client negotiates it)
+                val request = call.receiveSyncRequest()
 
                 // Process the sync changes
                 val response = syncService.processSyncChanges(request, userId)
@@ -41,10 +55,21 @@ fun io.ktor.server.routing.Route.syncRoutes(syncService: SyncService) {
                     HttpStatusCode.InternalServerError
                 }
 
-                call.respond(statusCode, response)
+                call.respondSync(statusCode, response)
 
+            } catch (e: GzipBodyTooLargeException) {
+                call.respondSync(
+                    HttpStatusCode.PayloadTooLarge,
+                    SyncResponse(
+                        success = false,
+                        appliedChanges = 0,
+                        conflicts = emptyList(),
+                        serverTimestamp = Clock.System.now().toString(),
+                        message = "Sync request is too large. Please sync fewer changes at a time."
+                    )
+                )
             } catch (e: Exception) {
-                call.respond(
+                call.respondSync(
                     HttpStatusCode.BadRequest,
                     SyncResponse(
                         success = false,
@@ -56,7 +81,80 @@ fun io.ktor.server.routing.Route.syncRoutes(syncService: SyncService) {
                 )
             }
         }
+
+        // POST /api/sync/pull - Rows changed since the client's per-table version vector
+        post("/pull") {
+            try {
+                val principal = call.principal<JWTPrincipal>() ?: return@post call.respond(
+                    HttpStatusCode.Unauthorized,
+                    mapOf("error" to "Authentication required")
+                )
+
+                val userId = principal.payload.getClaim("userId")?.asString() ?: return@post call.respond(
+                    HttpStatusCode.Unauthorized,
+                    mapOf("error" to "Invalid user ID in token")
+                )
+
+                val request = call.receive<SyncPullRequest>()
+                val response = syncService.pullChanges(request, userId)
+
+                call.respond(
+                    if (response.success) HttpStatusCode.OK else HttpStatusCode.InternalServerError,
+                    response
+                )
+
+            } catch (e: Exception) {
+                call.respond(
+                    HttpStatusCode.BadRequest,
+                    SyncPullResponse(
+                        success = false,
+                        serverTimestamp = Clock.System.now().toString(),
+                        message = syncRequestFailureMessage()
+                    )
+                )
+            }
+        }
+    }
+}
+
+/**
+ * Decode a /sync body in the format named by Content-Type, gunzipping it first when
+ * the client sent Content-Encoding: gzip.
+ *
+ * @throws GzipBodyTooLargeException when the body, sent or gunzipped, exceeds [MAX_SYNC_BODY_BYTES]
+ */
+private suspend fun ApplicationCall.receiveSyncRequest(): SyncRequest {
+    if ((request.contentLength() ?: 0) > MAX_SYNC_BODY_BYTES) {
+        throw GzipBodyTooLargeException(MAX_SYNC_BODY_BYTES)
+    }
+    val format = SyncWireFormat.fromContentType(request.headers[HttpHeaders.ContentType])
+    val compressed = request.headers[HttpHeaders.ContentEncoding].equals("gzip", ignoreCase = true)
+    if (format == SyncWireFormat.JSON && !compressed) {
+        return receive<SyncRequest>()
+    }
+
+    val body = receive<ByteArray>().let { if (compressed) SyncGzip.decompress(it, MAX_SYNC_BODY_BYTES) else it }
+    return SyncWireCodec.decode(SyncRequest.serializer(), body, format)
+}
+
+/**
+ * Respond in CBOR when the client lists it in Accept, gzipped when it also accepts
+ * gzip and the body is large enough to benefit; JSON otherwise.
+ */
+private suspend fun ApplicationCall.respondSync(status: HttpStatusCode, body: SyncResponse) {
+    if (!SyncWireFormat.accepts(request.headers[HttpHeaders.Accept], SyncWireFormat.CBOR)) {
+        return respond(status, body)
+    }
+
+    var bytes = SyncWireCodec.encode(SyncResponse.serializer(), body, SyncWireFormat.CBOR)
+    val acceptsGzip = request.headers[HttpHeaders.AcceptEncoding]
+        ?.split(',')
+        ?.any { it.substringBefore(';').trim().equals("gzip", ignoreCase = true) } == true
+    if (acceptsGzip && bytes.size >= SyncWireCodec.MIN_COMPRESSED_SIZE) {
+        bytes = SyncGzip.compress(bytes)
+        response.headers.append(HttpHeaders.ContentEncoding, "gzip")
     }
+    respondBytes(bytes, ContentType.parse(SyncWireFormat.CBOR.contentType), status)
 }
 
 internal fun syncRequestFailureMessage(): String =
@@ -0,0 +1,479 @@
+package com.guyghost.wakeve.routes
+
+import com.guyghost.wakeve.models.ChatMessageType
+import java.io.BufferedReader
+import java.io.BufferedWriter
+import java.io.IOException
+import java.net.InetAddress
+import java.net.InetSocketAddress
+import java.net.ServerSocket
+import java.net.Socket
+import java.net.URLDecoder
+import java.net.URLEncoder
+import java.security.MessageDigest
+import java.security.SecureRandom
+import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.LinkedBlockingQueue
+import java.util.concurrent.ThreadLocalRandom
+import java.util.concurrent.TimeUnit
+import java.util.concurrent.atomic.AtomicLong
+import javax.crypto.Mac
+import javax.crypto.spec.SecretKeySpec
+import kotlin.concurrent.thread
+
+/**
+ * One chat frame on the bus: the JSON sent to sockets, plus what delivery needs
+ * to know about it without decoding the JSON again.
+ *
+ * @property filterBlocked Hide the frame from recipients who blocked [senderId]
+ */
+class ChatBusFrame(
+    val senderId: String,
+    val type: ChatMessageType,
+    val filterBlocked: Boolean,
+    val payload: String
+)
+
+/**
+ * Carries encoded chat frames between server nodes.
+ *
+ * Every node publishes through the bus, including to itself, and only receives
+ * events it subscribed to, i.e. events with at least one local WebSocket.
+ * No method blocks on the network: callers may hold locks around them.
+ */
+interface ChatBroadcastBus : AutoCloseable {
+    /**
+     * Register the callback invoked for each frame received on a subscribed event.
+     */
+    fun setListener(listener: (eventId: String, frame: ChatBusFrame) -> Unit)
+
+    /**
+     * Deliver [frame] to every node subscribed to [eventId].
+     */
+    fun publish(eventId: String, frame: ChatBusFrame)
+
+    fun subscribe(eventId: String)
+
+    fun unsubscribe(eventId: String)
+
+    override fun close() {}
+}
+
+/**
+ * Single-process bus: publishing calls the listener directly.
+ * Nodes sharing one [hub] behave like separate servers on the same broker.
+ */
+class InProcessChatBroadcastBus(
+    private val hub: Hub = Hub()
+) : ChatBroadcastBus {
+    /**
+     * Subscription registry shared by the in-process nodes.
+     */
+    class Hub {
+        internal val subscribers = ConcurrentHashMap<String, MutableSet<InProcessChatBroadcastBus>>()
+    }
+
+    @Volatile
+    private var listener: ((String, ChatBusFrame) -> Unit)? = null
+
+    override fun setListener(listener: (eventId: String, frame: ChatBusFrame) -> Unit) {
+        this.listener = listener
+    }
+
+    override fun publish(eventId: String, frame: ChatBusFrame) {
+        hub.subscribers[eventId]?.forEach { node -> node.listener?.invoke(eventId, frame) }
+    }
+
+    override fun subscribe(eventId: String) {
+        hub.subscribers.computeIfAbsent(eventId) { ConcurrentHashMap.newKeySet() }.add(this)
+    }
+
+    override fun unsubscribe(eventId: String) {
+        hub.subscribers.computeIfPresent(eventId) { _, nodes ->
+            nodes.remove(this)
+            nodes.takeIf { it.isNotEmpty() }
+        }
+    }
+
+    override fun close() {
+        hub.subscribers.keys.forEach(::unsubscribe)
+    }
+}
+
+/**
+ * Minimal line-based pub/sub broker over TCP, for multi-node runs on a private network.
+ *
+ * A node first answers `CHALLENGE <nonce>` with `AUTH <HMAC-SHA256(secret, nonce)>`;
+ * the broker replies `OK` or hangs up. Then, one command per line: `SUB <eventId>`,
+ * `UNSUB <eventId>`, `PUB <eventId> <frame>`. Subscribers receive `MSG <eventId> <frame>`,
+ * the frame being relayed as is. Frames end with compact JSON, which never contains
+ * a raw newline.
+ *
+ * Each node has its own bounded outbound queue and writer thread, so a slow node
+ * never delays the others; a node whose queue overflows is disconnected, and
+ * resubscribes when it reconnects.
+ */
+class TcpChatBroadcastBroker(
+    private val secret: String,
+    port: Int = 0,
+    bindAddress: InetAddress = InetAddress.getLoopbackAddress(),
+    private val outboundCapacity: Int = DEFAULT_CHAT_BUS_OUTBOUND_CAPACITY
+) : AutoCloseable {
+    init {
+        requireChatBusSecret(secret)
+    }
+
+    private class Peer(val socket: Socket, capacity: Int) {
+        val outbound = LinkedBlockingQueue<String>(capacity)
+        val subscriptions: MutableSet<String> = ConcurrentHashMap.newKeySet()
+
+        @Volatile
+        var writer: Thread? = null
+
+        fun disconnect() {
+            runCatching { socket.close() }
+        }
+    }
+
+    private val serverSocket = ServerSocket(port, 50, bindAddress)
+    private val subscribers = ConcurrentHashMap<String, MutableSet<Peer>>()
+    private val peers: MutableSet<Peer> = ConcurrentHashMap.newKeySet()
+    private val random = SecureRandom()
+
+    val port: Int get() = serverSocket.localPort
+
+    fun start(): TcpChatBroadcastBroker {
+        thread(isDaemon = true, name = "chat-bus-broker") {
+            while (!serverSocket.isClosed) {
+                val socket = try {
+                    serverSocket.accept()
+                } catch (e: IOException) {
+                    break
+                }
+                val peer = Peer(socket, outboundCapacity).also(peers::add)
+                thread(isDaemon = true, name = "chat-bus-broker-peer") { serve(peer) }
+            }
+        }
+        return this
+    }
+
+    private fun serve(peer: Peer) {
+        try {
+            val reader = peer.socket.getInputStream().bufferedReader()
+            val writer = peer.socket.getOutputStream().bufferedWriter()
+            if (!authenticate(peer.socket, reader, writer)) return
+
+            peer.writer = thread(isDaemon = true, name = "chat-bus-broker-writer") { drain(peer, writer) }
+            reader.forEachLine { line ->
+                val parts = line.split(' ', limit = 3)
+                // Every command names an event; a malformed line is dropped, not fatal to the peer
+                if (parts.size < 2 || parts[1].isEmpty()) return@forEachLine
+                when (parts[0]) {
+                    "SUB" -> {
+                        peer.subscriptions += parts[1]
+                        subscribers.computeIfAbsent(parts[1]) { ConcurrentHashMap.newKeySet() }.add(peer)
+                    }
+                    "UNSUB" -> unsubscribe(peer, parts[1])
+                    "PUB" -> publish(parts[1], parts.getOrElse(2) { "" })
+                }
+            }
+        } catch (e: IOException) {
+            // Node went away; drop its subscriptions below
+        } finally {
+            peer.subscriptions.toList().forEach { unsubscribe(peer, it) }
+            peer.writer?.interrupt()
+            peer.disconnect()
+            peers -= peer
+        }
+    }
+
+    private fun authenticate(socket: Socket, reader: BufferedReader, writer: BufferedWriter): Boolean {
+        val nonce = ByteArray(NONCE_BYTES).also(random::nextBytes).toHex()
+        socket.soTimeout = HANDSHAKE_TIMEOUT_MS
+        writer.writeLineAndFlush("CHALLENGE $nonce")
+        val answer = reader.readLine()?.removePrefix("AUTH ") ?: return false
+        val expected = chatBusProof(secret, nonce)
+        if (!MessageDigest.isEqual(answer.toByteArray(), expected.toByteArray())) return false
+        socket.soTimeout = 0
+        writer.writeLineAndFlush("OK")
+        return true
+    }
+
+    private fun drain(peer: Peer, writer: BufferedWriter) {
+        try {
+            while (true) {
+                writer.write(peer.outbound.take())
+                writer.newLine()
+                if (peer.outbound.isEmpty()) writer.flush()
+            }
+        } catch (e: InterruptedException) {
+            // Peer disconnected
+        } catch (e: IOException) {
+            peer.disconnect()
+        }
+    }
+
+    private fun publish(eventId: String, frame: String) {
+        val line = "MSG $eventId $frame"
+        subscribers[eventId]?.forEach { peer ->
+            if (!peer.outbound.offer(line)) {
+                // Too slow to keep up: it reconnects, resubscribes and its clients reload history
+                peer.disconnect()
+            }
+        }
+    }
+
+    private fun unsubscribe(peer: Peer, eventId: String) {
+        peer.subscriptions -= eventId
+        subscribers.computeIfPresent(eventId) { _, peers ->
+            peers.remove(peer)
+            peers.takeIf { it.isNotEmpty() }
+        }
+    }
+
+    override fun close() {
+        serverSocket.close()
+        peers.forEach(Peer::disconnect)
+    }
+
+    private companion object {
+        const val NONCE_BYTES = 32
+        const val HANDSHAKE_TIMEOUT_MS = 5_000
+    }
+}
+
+/**
+ * Node-side connection to a [TcpChatBroadcastBroker].
+ *
+ * Commands go through a bounded queue drained by a writer thread, so publishing
+ * and subscribing never block on the socket. The connection is re-established
+ * with exponential backoff and jitter; on reconnect every current subscription
+ * is replayed before queued commands. A publish that finds the queue full is
+ * dropped (clients recover it from history); a dropped SUB or UNSUB forces a
+ * reconnect, which replays the subscriptions.
+ */
+class TcpChatBroadcastBus(
+    private val host: String,
+    private val port: Int,
+    private val secret: String,
+    outboundCapacity: Int = DEFAULT_CHAT_BUS_OUTBOUND_CAPACITY,
+    private val reconnectBaseDelayMs: Long = DEFAULT_RECONNECT_BASE_DELAY_MS,
+    private val reconnectMaxDelayMs: Long = DEFAULT_RECONNECT_MAX_DELAY_MS
+) : ChatBroadcastBus {
+    init {
+        requireChatBusSecret(secret)
+    }
+
+    private class Connection(val socket: Socket, val writer: BufferedWriter)
+
+    private val subscriptions: MutableSet<String> = ConcurrentHashMap.newKeySet()
+    private val outbound = LinkedBlockingQueue<String>(outboundCapacity)
+    private val droppedFrames = AtomicLong()
+
+    @Volatile
+    private var connection: Connection? = null
+
+    @Volatile
+    private var closed = false
+
+    @Volatile
+    private var listener: ((String, ChatBusFrame) -> Unit)? = null
+
+    private val connector = thread(isDaemon = true, name = "chat-bus-node") { connectLoop() }
+    private val writer = thread(isDaemon = true, name = "chat-bus-node-writer") { drain() }
+
+    /** Whether the node is currently connected and authenticated. */
+    val isConnected: Boolean get() = connection != null
+
+    override fun setListener(listener: (eventId: String, frame: ChatBusFrame) -> Unit) {
+        this.listener = listener
+    }
+
+    override fun publish(eventId: String, frame: ChatBusFrame) {
+        requireFramable(eventId)
+        if (!outbound.offer("PUB $eventId ${encodeChatBusFrame(frame)}")) {
+            droppedFrames.incrementAndGet()
+        }
+    }
+
+    override fun subscribe(eventId: String) {
+        requireFramable(eventId)
+        subscriptions += eventId
+        enqueueControl("SUB $eventId")
+    }
+
+    override fun unsubscribe(eventId: String) {
+        requireFramable(eventId)
+        subscriptions -= eventId
+        enqueueControl("UNSUB $eventId")
+    }
+
+    /**
+     * Publishes dropped because the outbound queue was full.
+     */
+    fun getDroppedFrameCount(): Long = droppedFrames.get()
+
+    private fun enqueueControl(line: String) {
+        if (!outbound.offer(line)) {
+            connection?.socket?.let { runCatching { it.close() } }
+        }
+    }
+
+    private fun connectLoop() {
+        var attempt = 0
+        while (!closed) {
+            try {
+                Socket().use { socket ->
+                    socket.connect(InetSocketAddress(host, port), HANDSHAKE_TIMEOUT_MS)
+                    val reader = socket.getInputStream().bufferedReader()
+                    val socketWriter = socket.getOutputStream().bufferedWriter()
+                    authenticate(socket, reader, socketWriter)
+                    // Subscriptions first, so frames published after the reconnect are not missed
+                    subscriptions.forEach { eventId ->
+                        socketWriter.write("SUB $eventId")
+                        socketWriter.newLine()
+                    }
+                    socketWriter.flush()
+                    connection = Connection(socket, socketWriter)
+                    attempt = 0
+                    reader.forEachLine(::onLine)
+                }
+            } catch (e: IOException) {
+                // Broker unreachable, rejected the secret or went away: retry below
+            } finally {
+                connection = null
+            }
+            if (closed) break
+            try {
+                Thread.sleep(reconnectDelayMs(attempt++))
+            } catch (e: InterruptedException) {
+                break
+            }
+        }
+    }
+
+    private fun authenticate(socket: Socket, reader: BufferedReader, writer: BufferedWriter) {
+        socket.soTimeout = HANDSHAKE_TIMEOUT_MS
+        val challenge = reader.readLine()?.takeIf { it.startsWith("CHALLENGE ") }
+            ?: throw IOException("Chat bus broker sent no challenge")
+        writer.writeLineAndFlush("AUTH ${chatBusProof(secret, challenge.removePrefix("CHALLENGE "))}")
+        if (reader.readLine() != "OK") throw IOException("Chat bus broker rejected the node")
+        socket.soTimeout = 0
+    }
+
+    private fun onLine(line: String) {
+        val parts = line.split(' ', limit = 3)
+        if (parts[0] != "MSG" || parts.size != 3) return
+        val frame = decodeChatBusFrame(parts[2]) ?: return
+        listener?.invoke(parts[1], frame)
+    }
+
+    private fun drain() {
+        var pending: String? = null
+        try {
+            while (!closed) {
+                val line = pending ?: outbound.poll(WRITER_POLL_MS, TimeUnit.MILLISECONDS) ?: continue
+                val current = connection
+                if (current == null) {
+                    // Hold the line until the connector is back
+                    pending = line
+                    Thread.sleep(WRITER_POLL_MS)
+                    continue
+                }
+                try {
+                    current.writer.write(line)
+                    current.writer.newLine()
+                    if (outbound.isEmpty()) current.writer.flush()
+                    pending = null
+                } catch (e: IOException) {
+                    pending = line
+                    runCatching { current.socket.close() }
+                }
+            }
+        } catch (e: InterruptedException) {
+            // Closed
+        }
+    }
+
+    private fun reconnectDelayMs(attempt: Int): Long {
+        val ceiling = (reconnectBaseDelayMs shl attempt.coerceAtMost(MAX_BACKOFF_SHIFT)).coerceAtMost(reconnectMaxDelayMs)
+        return ThreadLocalRandom.current().nextLong(ceiling / 2, ceiling + 1)
+    }
+
+    private fun requireFramable(eventId: String) {
+        require(eventId.isNotEmpty() && eventId.none { it.isWhitespace() }) { "Event ID cannot be framed" }
+    }
+
+    override fun close() {
+        closed = true
+        connection?.socket?.let { runCatching { it.close() } }
+        connector.interrupt()
+        writer.interrupt()
+    }
+
+    private companion object {
+        const val HANDSHAKE_TIMEOUT_MS = 5_000
+        const val WRITER_POLL_MS = 100L
+        const val MAX_BACKOFF_SHIFT = 16
+        const val DEFAULT_RECONNECT_BASE_DELAY_MS = 100L
+        const val DEFAULT_RECONNECT_MAX_DELAY_MS = 10_000L
+    }
+}
+
+/**
+ * Bus selected from the environment: `CHAT_BUS_ADDRESS=host:port` connects to a
+ * broker with `CHAT_BUS_SECRET`, anything else keeps broadcasts in-process.
+ */
+fun createChatBroadcastBus(
+    address: String? = System.getenv("CHAT_BUS_ADDRESS"),
+    secret: String? = System.getenv("CHAT_BUS_SECRET")
+): ChatBroadcastBus {
+    val host = address?.substringBeforeLast(':', "")?.takeIf { it.isNotBlank() }
+    val port = address?.substringAfterLast(':')?.toIntOrNull()
+    if (host == null || port == null) return InProcessChatBroadcastBus()
+    return TcpChatBroadcastBus(
+        host,
+        port,
+        secret ?: throw IllegalStateException("CHAT_BUS_SECRET is required to connect to the chat bus broker")
+    )
+}
+
+private const val DEFAULT_CHAT_BUS_OUTBOUND_CAPACITY = 10_000
+private const val MIN_CHAT_BUS_SECRET_LENGTH = 32
+
+private fun requireChatBusSecret(secret: String) {
+    require(secret.length >= MIN_CHAT_BUS_SECRET_LENGTH) {
+        "Chat bus secret must be at least $MIN_CHAT_BUS_SECRET_LENGTH characters"
+    }
+}
+
+internal fun chatBusProof(secret: String, nonce: String): String {
+    val mac = Mac.getInstance("HmacSHA256")
+    mac.init(SecretKeySpec(secret.toByteArray(), "HmacSHA256"))
+    return mac.doFinal(nonce.toByteArray()).toHex()
+}
+
+// Frame on the wire: <type> <filterBlocked 0|1> <url-encoded senderId> <json>
+internal fun encodeChatBusFrame(frame: ChatBusFrame): String =
+    "${frame.type.name} ${if (frame.filterBlocked) 1 else 0} " +
+        "${URLEncoder.encode(frame.senderId, Charsets.UTF_8)} ${frame.payload}"
+
+internal fun decodeChatBusFrame(encoded: String): ChatBusFrame? {
+    val parts = encoded.split(' ', limit = 4)
+    if (parts.size != 4) return null
+    val type = ChatMessageType.entries.firstOrNull { it.name == parts[0] } ?: return null
+    return ChatBusFrame(
+        senderId = URLDecoder.decode(parts[2], Charsets.UTF_8),
+        type = type,
+        filterBlocked = parts[1] == "1",
+        payload = parts[3]
+    )
+}
+
+private fun BufferedWriter.writeLineAndFlush(line: String) {
+    write(line)
+    newLine()
+    flush()
+}
+
+private fun ByteArray.toHex(): String = joinToString("") { "%02x".format(it) }
@@ -0,0 +1,43 @@
+package com.guyghost.wakeve.routes
+
+import com.guyghost.wakeve.models.ChatMessage
+import java.util.Base64
+
+/**
+ * Position in an event's chat history: the (timestamp, id) of the last message
+ * a client has already received. Pages continue strictly after it, newest first.
+ *
+ * Clients only see the opaque [encode]d form.
+ */
+internal data class ChatMessageCursor(
+    val timestamp: String,
+    val messageId: String
+) {
+    fun encode(): String =
+        Base64.getUrlEncoder().withoutPadding().encodeToString("$timestamp\n$messageId".encodeToByteArray())
+
+    companion object {
+        /**
+         * Parses a cursor produced by [encode]; null when [raw] is malformed.
+         */
+        fun decode(raw: String): ChatMessageCursor? {
+            val decoded = try {
+                Base64.getUrlDecoder().decode(raw.trim()).decodeToString()
+            } catch (e: IllegalArgumentException) {
+                return null
+            }
+            val timestamp = decoded.substringBefore('\n', "")
+            val messageId = decoded.substringAfter('\n', "")
+            if (timestamp.isEmpty() || messageId.isEmpty()) return null
+            return ChatMessageCursor(timestamp, messageId)
+        }
+    }
+}
+
+/**
+ * One keyset page of chat history, newest first.
+ */
+internal data class ChatMessagePage(
+    val messages: List<ChatMessage>,
+    val nextCursor: ChatMessageCursor?
+)
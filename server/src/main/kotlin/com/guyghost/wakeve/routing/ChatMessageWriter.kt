@@ -0,0 +1,160 @@
+package com.guyghost.wakeve.routes
+
+import com.guyghost.wakeve.database.WakeveDb
+import com.guyghost.wakeve.metrics.ChatPersistenceMetrics
+import com.guyghost.wakeve.models.ChatMessage
+import kotlinx.coroutines.CompletableDeferred
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Deferred
+import kotlinx.coroutines.channels.Channel
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.launch
+import java.util.concurrent.ConcurrentHashMap
+
+/**
+ * Write-behind log for chat messages.
+ *
+ * Messages are appended to a bounded in-memory queue and written by a single
+ * coroutine, which commits everything queued in one transaction once
+ * [maxBatchSize] messages are waiting or [maxBatchDelayMs] has passed since the
+ * first of them. [append] suspends while [capacity] messages are waiting, so a
+ * burst slows senders down instead of growing memory.
+ */
+class ChatMessageWriter(
+    private val database: WakeveDb,
+    scope: CoroutineScope,
+    private val metrics: ChatPersistenceMetrics = ChatPersistenceMetrics(),
+    private val maxBatchSize: Int = DEFAULT_MAX_BATCH_SIZE,
+    private val maxBatchDelayMs: Long = DEFAULT_MAX_BATCH_DELAY_MS,
+    capacity: Int = DEFAULT_CAPACITY
+) {
+    private class PendingWrite(
+        val message: ChatMessage,
+        val ack: CompletableDeferred<Unit> = CompletableDeferred()
+    )
+
+    private val queue = Channel<PendingWrite>(capacity)
+    // Queued but not yet committed, so replies to them can be accepted
+    private val pending = ConcurrentHashMap<String, ChatMessage>()
+    private val writerJob = scope.launch { writeLoop() }
+
+    /**
+     * Queues [message] for persistence.
+     *
+     * @return completes once the message is committed, or with the write error
+     */
+    suspend fun append(message: ChatMessage): Deferred<Unit> {
+        val write = PendingWrite(message)
+        pending[message.id] = message
+        try {
+            queue.send(write)
+        } catch (e: Exception) {
+            pending.remove(message.id)
+            throw e
+        }
+        metrics.recordQueued()
+        return write.ack
+    }
+
+    /**
+     * A message that has been accepted but is not committed yet.
+     */
+    fun pendingMessage(messageId: String): ChatMessage? = pending[messageId]
+
+    /**
+     * Stops accepting messages and waits until the queued ones are written.
+     */
+    suspend fun close() {
+        queue.close()
+        writerJob.join()
+    }
+
+    private suspend fun writeLoop() {
+        val batch = ArrayList<PendingWrite>(maxBatchSize)
+        for (first in queue) {
+            batch += first
+            val deadline = System.nanoTime() + maxBatchDelayMs * 1_000_000
+            while (batch.size < maxBatchSize) {
+                val next = queue.tryReceive().getOrNull()
+                if (next != null) {
+                    batch += next
+                    continue
+                }
+                val remainingMs = (deadline - System.nanoTime()) / 1_000_000
+                if (remainingMs <= 0 || queue.isClosedForReceive) break
+                delay(minOf(remainingMs, POLL_INTERVAL_MS))
+            }
+            commit(batch)
+            batch.clear()
+        }
+    }
+
+    private fun commit(batch: List<PendingWrite>) {
+        val startTime = System.nanoTime()
+        val committed = runCatching {
+            database.transaction {
+                batch.forEach { insert(it.message) }
+            }
+        }
+        if (committed.isSuccess) {
+            metrics.recordCommit(batch.size, System.nanoTime() - startTime)
+            batch.forEach { write ->
+                pending.remove(write.message.id)
+                write.ack.complete(Unit)
+            }
+            return
+        }
+
+        // Retry one by one so a single bad row does not fail its neighbours
+        batch.forEach { write ->
+            val singleStart = System.nanoTime()
+            runCatching { database.transaction { insert(write.message) } }
+                .onSuccess {
+                    metrics.recordCommit(1, System.nanoTime() - singleStart)
+                    write.ack.complete(Unit)
+                }
+                .onFailure { error ->
+                    metrics.recordFailure()
+                    write.ack.completeExceptionally(error)
+                }
+            pending.remove(write.message.id)
+        }
+    }
+
+    private fun insert(message: ChatMessage) {
+        database.chatMessagesQueries.insertMessage(
+            id = message.id,
+            event_id = message.eventId,
+            sender_id = message.senderId,
+            sender_name = message.senderName,
+            sender_avatar_url = message.senderAvatarUrl,
+            content = message.content,
+            section = message.section?.name,
+            section_item_id = message.sectionItemId,
+            parent_message_id = message.parentMessageId,
+            timestamp = message.timestamp,
+            status = message.status.name,
+            is_offline = if (message.isOffline) 1L else 0L,
+            reply_count = 0,
+            edit_timestamp = null,
+            is_edited = 0,
+            reactions_json = null,
+            read_by_json = null,
+            moderation_status = message.moderationStatus.name,
+            created_at = message.timestamp,
+            updated_at = message.timestamp
+        )
+
+        // If this is a reply, increment parent's reply count
+        message.parentMessageId?.let { parentId ->
+            database.chatMessagesQueries.incrementReplyCount(message.timestamp, parentId)
+        }
+    }
+
+    private companion object {
+        const val DEFAULT_MAX_BATCH_SIZE = 256
+        const val DEFAULT_MAX_BATCH_DELAY_MS = 10L
+        const val DEFAULT_CAPACITY = 4_096
+        const val POLL_INTERVAL_MS = 1L
+    }
+}
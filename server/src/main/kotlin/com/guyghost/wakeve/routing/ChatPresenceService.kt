@@ -0,0 +1,202 @@
+package com.guyghost.wakeve.routes
+
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.isActive
+import kotlinx.coroutines.launch
+import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.atomic.AtomicInteger
+
+/**
+ * In-memory typing and presence state for event chats.
+ *
+ * Typing flags expire [typingTtlMs] after the last refresh. Expiry is driven by a
+ * hashed timer wheel with [tickMs] slots, so each tick only looks at the entries
+ * due in that slot. Nothing here touches the database: the state is ephemeral and
+ * is rebuilt by clients as they type and reconnect.
+ *
+ * The state is per node: it only holds the connections and typing updates this
+ * server handled. Transitions reach every node's sockets because they are broadcast
+ * through [ChatBroadcastBus], but [typingUsers], [onlineUsers] and [isOnline] do not
+ * see users connected to another node.
+ */
+class ChatPresenceService(
+    private val typingTtlMs: Long = DEFAULT_TYPING_TTL_MS,
+    private val tickMs: Long = DEFAULT_TICK_MS,
+    private val clock: () -> Long = System::currentTimeMillis,
+    private val onTypingExpired: (eventId: String, userId: String, userName: String) -> Unit = { _, _, _ -> }
+) {
+    /**
+     * Typing state of one user; replaced (never mutated) on refresh.
+     */
+    class TypingState(
+        val userName: String,
+        val startedAt: Long,
+        val lastSeenAt: Long,
+        val expiresAt: Long
+    )
+
+    private data class TypingKey(val eventId: String, val userId: String)
+
+    private val typing = ConcurrentHashMap<String, ConcurrentHashMap<String, TypingState>>()
+    private val online = ConcurrentHashMap<String, ConcurrentHashMap<String, AtomicInteger>>()
+
+    // One slot per tick; longer than the TTL so an entry is never a full turn away
+    private val wheel = Array((typingTtlMs / tickMs + 2).toInt()) { ConcurrentHashMap.newKeySet<TypingKey>() }
+    private val wheelLock = Any()
+    private var processedTick = clock() / tickMs
+
+    /**
+     * Marks [userId] as typing (refreshing the TTL) or stopped.
+     *
+     * @return true when the user's typing state actually changed, i.e. when
+     *   the transition should be broadcast
+     */
+    fun setTyping(eventId: String, userId: String, userName: String, isTyping: Boolean): Boolean {
+        if (!isTyping) {
+            return removeTyping(eventId, userId) { true } != null
+        }
+
+        val now = clock()
+        var started = false
+        lateinit var state: TypingState
+        // Per-event maps are created and dropped under the outer key's lock
+        typing.compute(eventId) { _, users ->
+            (users ?: ConcurrentHashMap()).also { map ->
+                val current = map[userId]
+                started = current == null
+                state = TypingState(
+                    userName = userName,
+                    startedAt = current?.startedAt ?: now,
+                    lastSeenAt = now,
+                    expiresAt = now + typingTtlMs
+                )
+                map[userId] = state
+            }
+        }
+        schedule(TypingKey(eventId, userId), state.expiresAt)
+        return started
+    }
+
+    /**
+     * Users currently typing in [eventId], by user ID.
+     */
+    fun typingUsers(eventId: String): Map<String, TypingState> =
+        typing[eventId]?.toMap().orEmpty()
+
+    /**
+     * Registers one more connection of [userId] to [eventId].
+     *
+     * @return true when the user just came online for this event
+     */
+    fun userConnected(eventId: String, userId: String): Boolean {
+        var cameOnline = false
+        online.compute(eventId) { _, users ->
+            (users ?: ConcurrentHashMap()).also { map ->
+                cameOnline = map.computeIfAbsent(userId) { AtomicInteger() }.incrementAndGet() == 1
+            }
+        }
+        return cameOnline
+    }
+
+    /**
+     * Releases one connection of [userId] to [eventId].
+     *
+     * @return true when the user's last connection for this event closed
+     */
+    fun userDisconnected(eventId: String, userId: String): Boolean {
+        var wentOffline = false
+        online.computeIfPresent(eventId) { _, users ->
+            users.computeIfPresent(userId) { _, count ->
+                if (count.decrementAndGet() <= 0) {
+                    wentOffline = true
+                    null
+                } else {
+                    count
+                }
+            }
+            users.takeIf { it.isNotEmpty() }
+        }
+        return wentOffline
+    }
+
+    fun onlineUsers(eventId: String): Set<String> =
+        online[eventId]?.keys?.toSet().orEmpty()
+
+    fun isOnline(eventId: String, userId: String): Boolean =
+        online[eventId]?.containsKey(userId) == true
+
+    /**
+     * Expires every typing flag that is due, up to the current time.
+     */
+    fun advance() {
+        // Broadcast outside the lock, so a slow listener never holds up the wheel
+        val expired = mutableListOf<Pair<TypingKey, TypingState>>()
+        synchronized(wheelLock) {
+            val now = clock()
+            val currentTick = now / tickMs
+            // After a long pause one full turn covers every slot
+            val firstTick = maxOf(processedTick + 1, currentTick - wheel.size + 1)
+            val notDue = mutableListOf<TypingKey>()
+            for (tick in firstTick..currentTick) {
+                val slot = wheel[(tick % wheel.size).toInt()].iterator()
+                while (slot.hasNext()) {
+                    val key = slot.next()
+                    slot.remove()
+                    val state = typing[key.eventId]?.get(key.userId) ?: continue
+                    if (state.expiresAt > now) {
+                        // Refreshed, or shares a slot with a later turn of the wheel
+                        notDue += key
+                        continue
+                    }
+                    removeTyping(key.eventId, key.userId) { it.expiresAt <= now }
+                        ?.let { expired += key to it }
+                }
+            }
+            processedTick = maxOf(processedTick, currentTick)
+            notDue.forEach { key ->
+                typing[key.eventId]?.get(key.userId)?.let { schedule(key, it.expiresAt) }
+            }
+        }
+        expired.forEach { (key, state) -> onTypingExpired(key.eventId, key.userId, state.userName) }
+    }
+
+    /**
+     * Runs [advance] every tick until [scope] is cancelled.
+     */
+    fun start(scope: CoroutineScope): Job = scope.launch {
+        while (isActive) {
+            delay(tickMs)
+            advance()
+        }
+    }
+
+    private fun schedule(key: TypingKey, expiresAt: Long) {
+        // Ceiling, so the slot is only processed once the entry is due
+        val dueTick = (expiresAt + tickMs - 1) / tickMs
+        wheel[(dueTick % wheel.size).toInt()].add(key)
+    }
+
+    private fun removeTyping(
+        eventId: String,
+        userId: String,
+        predicate: (TypingState) -> Boolean
+    ): TypingState? {
+        var removed: TypingState? = null
+        typing.computeIfPresent(eventId) { _, users ->
+            val state = users[userId]
+            if (state != null && predicate(state)) {
+                users.remove(userId)
+                removed = state
+            }
+            users.takeIf { it.isNotEmpty() }
+        }
+        return removed
+    }
+
+    private companion object {
+        const val DEFAULT_TYPING_TTL_MS = 3_000L
+        const val DEFAULT_TICK_MS = 250L
+    }
+}
@@ -1,6 +1,8 @@
 package com.guyghost.wakeve.routes
 
+import com.guyghost.wakeve.Chat_message
 import com.guyghost.wakeve.database.WakeveDb
+import com.guyghost.wakeve.metrics.ChatPersistenceMetrics
 import com.guyghost.wakeve.models.AddReactionRequest
 import com.guyghost.wakeve.models.ChatMessage
 import com.guyghost.wakeve.models.ChatMessageType
@@ -32,7 +34,6 @@ import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.SupervisorJob
 import kotlinx.coroutines.withContext
-import kotlinx.serialization.json.Json
 import java.util.UUID
 
 /**
@@ -55,8 +56,31 @@ class ChatService(
     private val moderationPolicy: ModerationPolicy = ModerationPolicy(),
     private val moderationRepository: ModerationRepository? = null
 ) {
-    private val json = Json { ignoreUnknownKeys = true }
     private val serviceScope = CoroutineScope(Dispatchers.IO + SupervisorJob())
+
+    /**
+     * Typing and online state, kept in memory on this node. A typing flag that is not
+     * refreshed expires after a few seconds and its stop is broadcast like an explicit one.
+     */
+    val presence = ChatPresenceService(
+        onTypingExpired = { eventId, userId, userName -> broadcastTyping(eventId, userId, userName, false) }
+    ).also { it.start(serviceScope) }
+
+    /**
+     * Throughput and batch sizes of chat persistence; bound to the app's registry.
+     */
+    val persistenceMetrics = ChatPersistenceMetrics()
+
+    // Messages are committed in batches by a single writer, then broadcast
+    private val messageWriter = ChatMessageWriter(database, serviceScope, persistenceMetrics)
+
+    /**
+     * Stops accepting messages and waits until the queued ones are committed.
+     * Called when the application stops.
+     */
+    suspend fun shutdown() {
+        messageWriter.close()
+    }
     
     /**
      * Sends a new message to an event chat.
@@ -85,7 +109,7 @@ class ChatService(
                 throw ModerationRejectedException(moderationResult)
             }
             val parentMessage = parentMessageId?.let { parentId ->
-                getMessage(parentId) ?: return@withContext null
+                getMessage(parentId) ?: messageWriter.pendingMessage(parentId) ?: return@withContext null
             }
             if (parentMessage != null && (parentMessage.eventId != eventId || !parentMessage.isVisibleTo(userId))) {
                 return@withContext null
@@ -111,39 +135,10 @@ class ChatService(
                 moderationStatus = moderationResult.status
             )
             
-            // Save to database
-            database.chatMessagesQueries.insertMessage(
-                id = messageId,
-                event_id = eventId,
-                sender_id = userId,
-                sender_name = userName,
-                sender_avatar_url = userAvatarUrl,
-                content = content,
-                section = section?.name,
-                section_item_id = null,
-                parent_message_id = parentMessageId,
-                timestamp = timestamp,
-                status = MessageStatus.SENT.name,
-                is_offline = 0,
-                reply_count = 0,
-                edit_timestamp = null,
-                is_edited = 0,
-                reactions_json = null,
-                read_by_json = null,
-                moderation_status = moderationResult.status.name,
-                created_at = timestamp,
-                updated_at = timestamp
-            )
-            
-            // If this is a reply, increment parent's reply count
-            parentMessageId?.let { parentId ->
-                database.chatMessagesQueries.incrementReplyCount(
-                    timestamp,
-                    parentId
-                )
-            }
+            // Answer once the message's batch is committed
+            messageWriter.append(message).await()
             
-            // Broadcast only content that is immediately visible to other participants.
+            // Broadcast only committed content that is immediately visible to other participants.
             if (moderationResult.status == ModerationStatus.APPROVED) {
                 broadcastMessage(eventId, message)
             }
@@ -176,31 +171,19 @@ class ChatService(
             val timestamp = getCurrentTimestamp()
             val reactionId = generateMessageId()
             
-            // Add reaction to message_reaction table
-            database.chatMessagesQueries.insertReaction(
+            // One row per reaction; a repeated reaction is ignored by the unique index
+            val inserted = database.chatMessagesQueries.insertReactionIfAbsent(
                 id = reactionId,
                 message_id = messageId,
                 user_id = userId,
                 emoji = normalizedEmoji,
                 timestamp = timestamp
-            )
-            
-            // Get updated reactions for the message
-            val reactions = database.chatMessagesQueries
-                .selectReactionsByMessage(messageId)
-                .executeAsList()
-                .map { Reaction(it.user_id, it.emoji, it.timestamp) }
-            
-            // Update reactions_json in chat_message
-            val reactionsJson = json.encodeToString(reactions)
-            database.chatMessagesQueries.updateMessageReactions(
-                reactionsJson,
-                timestamp,
-                messageId
-            )
+            ).value > 0
             
             // Broadcast reaction via WebSocket
-            broadcastReaction(eventId, messageId, userId, normalizedEmoji)
+            if (inserted) {
+                broadcastReaction(eventId, messageId, userId, normalizedEmoji)
+            }
             true
         } catch (e: Exception) {
             throw ChatServiceException(chatReactionAddFailureMessage(), e)
@@ -224,31 +207,18 @@ class ChatService(
         try {
             getAccessibleMessage(eventId, messageId, userId) ?: return@withContext false
             val normalizedEmoji = emoji.trim().takeIf { it.isNotEmpty() } ?: return@withContext false
-            val timestamp = getCurrentTimestamp()
             
             // Remove reaction from message_reaction table
-            database.chatMessagesQueries.deleteReaction(
+            val removed = database.chatMessagesQueries.deleteReaction(
                 messageId,
                 userId,
                 normalizedEmoji
-            )
-            
-            // Get updated reactions for the message
-            val reactions = database.chatMessagesQueries
-                .selectReactionsByMessage(messageId)
-                .executeAsList()
-                .map { Reaction(it.user_id, it.emoji, it.timestamp) }
-            
-            // Update reactions_json in chat_message
-            val reactionsJson = json.encodeToString(reactions)
-            database.chatMessagesQueries.updateMessageReactions(
-                reactionsJson,
-                timestamp,
-                messageId
-            )
+            ).value > 0
             
             // Broadcast reaction removal via WebSocket
-            broadcastReaction(eventId, messageId, userId, normalizedEmoji)
+            if (removed) {
+                broadcastReaction(eventId, messageId, userId, normalizedEmoji)
+            }
             true
         } catch (e: Exception) {
             throw ChatServiceException(chatReactionRemoveFailureMessage(), e)
@@ -268,31 +238,20 @@ class ChatService(
         userId: String
     ): Boolean = withContext(Dispatchers.IO) {
         try {
-            val message = getAccessibleMessage(eventId, messageId, userId) ?: return@withContext false
-            val timestamp = getCurrentTimestamp()
-            val readStatusId = generateMessageId()
+            getAccessibleMessage(eventId, messageId, userId) ?: return@withContext false
             
-            // Add read status to message_read_status table
-            database.chatMessagesQueries.insertReadStatus(
-                id = readStatusId,
+            // One fixed-size row per reader, whatever the size of the event
+            val firstRead = database.chatMessagesQueries.insertReadStatusIfAbsent(
+                id = "$messageId:$userId",
                 message_id = messageId,
                 user_id = userId,
-                read_at = timestamp
-            )
-            
-            val currentReadBy = message.readBy.toMutableList()
-            if (!currentReadBy.contains(userId)) {
-                currentReadBy.add(userId)
-                val readByJson = json.encodeToString(currentReadBy)
-                database.chatMessagesQueries.updateMessageReadBy(
-                    readByJson,
-                    timestamp,
-                    messageId
-                )
-            }
+                read_at = getCurrentTimestamp()
+            ).value > 0
             
             // Broadcast read receipt via WebSocket
-            broadcastReadReceipt(eventId, messageId, userId)
+            if (firstRead) {
+                broadcastReadReceipt(eventId, messageId, userId)
+            }
             true
         } catch (e: Exception) {
             throw ChatServiceException(chatReadReceiptFailureMessage(), e)
@@ -310,30 +269,11 @@ class ChatService(
         userId: String
     ) = withContext(Dispatchers.IO) {
         try {
-            val timestamp = getCurrentTimestamp()
-            
-            val messages = getMessages(eventId, limit = 0, viewerUserId = userId)
-                .filter { it.senderId != userId }
-            
-            // Mark each message as read
-            messages.forEach { message ->
-                val readStatusId = generateMessageId()
-                database.chatMessagesQueries.insertReadStatus(
-                    id = readStatusId,
-                    message_id = message.id,
-                    user_id = userId,
-                    read_at = timestamp
-                )
-
-                if (!message.readBy.contains(userId)) {
-                    val readByJson = json.encodeToString(message.readBy + userId)
-                    database.chatMessagesQueries.updateMessageReadBy(
-                        readByJson,
-                        timestamp,
-                        message.id
-                    )
-                }
-            }
+            database.chatMessagesQueries.insertReadStatusForEvent(
+                userId = userId,
+                readAt = getCurrentTimestamp(),
+                eventId = eventId
+            )
         } catch (e: Exception) {
             throw ChatServiceException(chatMarkAllReadFailureMessage(), e)
         }
@@ -352,23 +292,12 @@ class ChatService(
         userId: String,
         userName: String,
         isTyping: Boolean
-    ) = withContext(Dispatchers.IO) {
+    ) {
         try {
-            val timestamp = getCurrentTimestamp()
-            val status = if (isTyping) TypingStatus.TYPING.name else TypingStatus.IDLE.name
-            
-            // Save typing indicator to database
-            database.typingIndicatorsQueries.insertTypingIndicator(
-                user_id = userId,
-                chat_id = eventId,
-                chat_type = ChatType.EVENT.name,
-                last_seen_typing = timestamp,
-                typing_status = status,
-                last_activity = timestamp
-            )
-            
-            // Broadcast typing indicator via WebSocket
-            broadcastTyping(eventId, userId, userName, isTyping)
+            // Repeated "still typing" updates only refresh the TTL; transitions are broadcast
+            if (presence.setTyping(eventId, userId, userName, isTyping)) {
+                broadcastTyping(eventId, userId, userName, isTyping)
+            }
         } catch (e: Exception) {
             throw ChatServiceException(chatTypingStatusFailureMessage(), e)
         }
@@ -411,38 +340,56 @@ class ChatService(
                 }
             }
             
-            messages.map { row ->
-                ChatMessage(
-                    id = row.id,
-                    eventId = row.event_id,
-                    senderId = row.sender_id,
-                    senderName = row.sender_name,
-                    senderAvatarUrl = row.sender_avatar_url,
-                    content = row.content,
-                    section = row.section?.let { CommentSection.valueOf(it) },
-                    sectionItemId = row.section_item_id,
-                    parentMessageId = row.parent_message_id,
-                    timestamp = row.timestamp,
-                    status = MessageStatus.valueOf(row.status),
-                    isOffline = row.is_offline == 1L,
-                    reactions = row.reactions_json?.let {
-                        try {
-                            json.decodeFromString<List<Reaction>>(it)
-                        } catch (e: Exception) {
-                            emptyList()
-                        }
-                    } ?: emptyList(),
-                    readBy = row.read_by_json?.let {
-                        try {
-                            json.decodeFromString<List<String>>(it)
-                        } catch (e: Exception) {
-                            emptyList()
-                        }
-                    } ?: emptyList(),
-                    isEdited = row.is_edited == 1L,
-                    moderationStatus = ModerationStatus.valueOf(row.moderation_status)
-                )
-            }.filter { message -> message.isVisibleTo(viewerUserId) }
+            messages.toChatMessages().filter { message -> message.isVisibleTo(viewerUserId) }
+        } catch (e: Exception) {
+            throw ChatServiceException(chatMessagesFetchFailureMessage(), e)
+        }
+    }
+
+    /**
+     * Gets one page of an event's messages, newest first, continuing after [cursor].
+     *
+     * Seeks on (timestamp, id) with block filtering done in SQL, so every page costs
+     * the same regardless of how far back it is and is never short.
+     *
+     * @param cursor Position returned with the previous page, or null for the latest messages
+     * @return The page and the cursor for the next one (null when there is nothing older)
+     */
+    internal suspend fun getMessagePage(
+        eventId: String,
+        limit: Int,
+        cursor: ChatMessageCursor?,
+        viewerUserId: String?
+    ): ChatMessagePage = withContext(Dispatchers.IO) {
+        try {
+            val queries = database.chatMessagesQueries
+            // One extra row tells whether an older page exists
+            val fetch = limit.toLong() + 1
+            val rows = when {
+                viewerUserId != null && cursor != null -> queries.selectVisibleMessagesByEventBefore(
+                    eventId = eventId,
+                    beforeTimestamp = cursor.timestamp,
+                    beforeId = cursor.messageId,
+                    viewerUserId = viewerUserId,
+                    limit = fetch
+                ).executeAsList()
+                viewerUserId != null -> queries.selectLatestVisibleMessagesByEvent(eventId, viewerUserId, fetch).executeAsList()
+                cursor != null -> queries.selectMessagesByEventBefore(
+                    eventId = eventId,
+                    beforeTimestamp = cursor.timestamp,
+                    beforeId = cursor.messageId,
+                    limit = fetch
+                ).executeAsList()
+                else -> queries.selectLatestMessagesByEvent(eventId, fetch).executeAsList()
+            }
+
+            val pageRows = rows.take(limit)
+            ChatMessagePage(
+                messages = pageRows.toChatMessages(),
+                nextCursor = pageRows.lastOrNull()
+                    ?.takeIf { rows.size > limit }
+                    ?.let { ChatMessageCursor(it.timestamp, it.id) }
+            )
         } catch (e: Exception) {
             throw ChatServiceException(chatMessagesFetchFailureMessage(), e)
         }
@@ -484,38 +431,7 @@ class ChatService(
                 .selectThreadMessages(parentMessageId)
                 .executeAsList()
             
-            messages.map { row ->
-                ChatMessage(
-                    id = row.id,
-                    eventId = row.event_id,
-                    senderId = row.sender_id,
-                    senderName = row.sender_name,
-                    senderAvatarUrl = row.sender_avatar_url,
-                    content = row.content,
-                    section = row.section?.let { CommentSection.valueOf(it) },
-                    sectionItemId = row.section_item_id,
-                    parentMessageId = row.parent_message_id,
-                    timestamp = row.timestamp,
-                    status = MessageStatus.valueOf(row.status),
-                    isOffline = row.is_offline == 1L,
-                    reactions = row.reactions_json?.let {
-                        try {
-                            json.decodeFromString<List<Reaction>>(it)
-                        } catch (e: Exception) {
-                            emptyList()
-                        }
-                    } ?: emptyList(),
-                    readBy = row.read_by_json?.let {
-                        try {
-                            json.decodeFromString<List<String>>(it)
-                        } catch (e: Exception) {
-                            emptyList()
-                        }
-                    } ?: emptyList(),
-                    isEdited = row.is_edited == 1L,
-                    moderationStatus = ModerationStatus.valueOf(row.moderation_status)
-                )
-            }.filter { message ->
+            messages.toChatMessages().filter { message ->
                 message.eventId == eventId && message.isVisibleTo(viewerUserId)
             }
         } catch (e: Exception) {
@@ -540,38 +456,7 @@ class ChatService(
                 .selectMessagesByEventAndSection(eventId, section.name)
                 .executeAsList()
             
-            messages.map { row ->
-                ChatMessage(
-                    id = row.id,
-                    eventId = row.event_id,
-                    senderId = row.sender_id,
-                    senderName = row.sender_name,
-                    senderAvatarUrl = row.sender_avatar_url,
-                    content = row.content,
-                    section = CommentSection.valueOf(row.section!!),
-                    sectionItemId = row.section_item_id,
-                    parentMessageId = row.parent_message_id,
-                    timestamp = row.timestamp,
-                    status = MessageStatus.valueOf(row.status),
-                    isOffline = row.is_offline == 1L,
-                    reactions = row.reactions_json?.let {
-                        try {
-                            json.decodeFromString<List<Reaction>>(it)
-                        } catch (e: Exception) {
-                            emptyList()
-                        }
-                    } ?: emptyList(),
-                    readBy = row.read_by_json?.let {
-                        try {
-                            json.decodeFromString<List<String>>(it)
-                        } catch (e: Exception) {
-                            emptyList()
-                        }
-                    } ?: emptyList(),
-                    isEdited = row.is_edited == 1L,
-                    moderationStatus = ModerationStatus.valueOf(row.moderation_status)
-                )
-            }.filter { message -> message.isVisibleTo(viewerUserId) }
+            messages.toChatMessages().filter { message -> message.isVisibleTo(viewerUserId) }
         } catch (e: Exception) {
             throw ChatServiceException(chatSectionMessagesFetchFailureMessage(), e)
         }
@@ -589,42 +474,54 @@ class ChatService(
                 .selectMessageById(messageId)
                 .executeAsOneOrNull()
                 ?.let { row ->
-                    ChatMessage(
-                        id = row.id,
-                        eventId = row.event_id,
-                        senderId = row.sender_id,
-                        senderName = row.sender_name,
-                        senderAvatarUrl = row.sender_avatar_url,
-                        content = row.content,
-                        section = row.section?.let { CommentSection.valueOf(it) },
-                        sectionItemId = row.section_item_id,
-                        parentMessageId = row.parent_message_id,
-                        timestamp = row.timestamp,
-                        status = MessageStatus.valueOf(row.status),
-                        isOffline = row.is_offline == 1L,
-                        reactions = row.reactions_json?.let {
-                            try {
-                                json.decodeFromString<List<Reaction>>(it)
-                            } catch (e: Exception) {
-                                emptyList()
-                            }
-                        } ?: emptyList(),
-                        readBy = row.read_by_json?.let {
-                            try {
-                                json.decodeFromString<List<String>>(it)
-                            } catch (e: Exception) {
-                                emptyList()
-                            }
-                        } ?: emptyList(),
-                        isEdited = row.is_edited == 1L,
-                        moderationStatus = ModerationStatus.valueOf(row.moderation_status)
-                    )
+                    listOf(row).toChatMessages().single()
                 }
         } catch (e: Exception) {
             throw ChatServiceException(chatMessageFetchFailureMessage(), e)
         }
     }
 
+    /**
+     * Maps rows to messages, loading their reactions and read receipts with one
+     * query each per [MESSAGE_ID_CHUNK_SIZE] messages.
+     */
+    private fun List<Chat_message>.toChatMessages(): List<ChatMessage> {
+        if (isEmpty()) return emptyList()
+        val reactions = mutableMapOf<String, MutableList<Reaction>>()
+        val readBy = mutableMapOf<String, MutableList<String>>()
+        map { it.id }.chunked(MESSAGE_ID_CHUNK_SIZE).forEach { ids ->
+            database.chatMessagesQueries.selectReactionsForMessages(ids).executeAsList().forEach {
+                reactions.getOrPut(it.message_id) { mutableListOf() } += Reaction(it.user_id, it.emoji, it.timestamp)
+            }
+            database.chatMessagesQueries.selectReadStatusForMessages(ids).executeAsList().forEach {
+                readBy.getOrPut(it.message_id) { mutableListOf() } += it.user_id
+            }
+        }
+        return map { row -> row.toChatMessage(reactions[row.id].orEmpty(), readBy[row.id].orEmpty()) }
+    }
+
+    private fun Chat_message.toChatMessage(reactions: List<Reaction>, readBy: List<String>): ChatMessage =
+        ChatMessage(
+            id = id,
+            eventId = event_id,
+            senderId = sender_id,
+            senderName = sender_name,
+            senderAvatarUrl = sender_avatar_url,
+            content = content,
+            section = section?.let { CommentSection.valueOf(it) },
+            sectionItemId = section_item_id,
+            parentMessageId = parent_message_id,
+            timestamp = timestamp,
+            status = MessageStatus.valueOf(status),
+            isOffline = is_offline == 1L,
+            reactions = reactions,
+            readBy = readBy,
+            reactionCounts = reactions.groupingBy { it.emoji }.eachCount(),
+            readCount = readBy.size,
+            isEdited = is_edited == 1L,
+            moderationStatus = ModerationStatus.valueOf(moderation_status)
+        )
+
     fun isBlockedForViewer(eventId: String, viewerUserId: String, senderId: String): Boolean =
         moderationRepository?.isBlockedForEvent(viewerUserId, senderId, eventId) == true
 
@@ -657,44 +554,41 @@ class ChatService(
         userId: String
     ): Int = withContext(Dispatchers.IO) {
         try {
-            getMessages(eventId, limit = 0, viewerUserId = userId)
-                .count { message -> message.senderId != userId && !message.readBy.contains(userId) }
+            database.chatMessagesQueries
+                .selectUnreadCountForUser(eventId, userId)
+                .executeAsOne()
+                .coerceAtMost(Int.MAX_VALUE.toLong())
+                .toInt()
         } catch (e: Exception) {
             throw ChatServiceException(chatUnreadCountFailureMessage(), e)
         }
     }
     
     /**
-     * Gets currently typing users for an event.
+     * Gets currently typing users for an event, as seen by this node.
      *
      * @param eventId Event to get typing users for
      * @return List of typing indicators
      */
-    suspend fun getTypingUsers(eventId: String): List<TypingIndicator> = withContext(Dispatchers.IO) {
-        try {
-            val threshold = (System.currentTimeMillis() - 3000).toString()
-            
-            database.typingIndicatorsQueries
-                .selectActiveTypingUsers(eventId, threshold)
-                .executeAsList()
-                .map { row ->
-                    TypingIndicator(
-                        userId = row.user_id,
-                        chatId = eventId,
-                        chatType = ChatType.EVENT,
-                        typingStatus = try {
-                            TypingStatus.valueOf(row.typing_status)
-                        } catch (e: Exception) {
-                            TypingStatus.IDLE
-                        },
-                        lastSeenTyping = row.last_seen_typing,
-                        lastActivity = row.last_activity
-                    )
-                }
-        } catch (e: Exception) {
-            throw ChatServiceException(chatTypingUsersFetchFailureMessage(), e)
-        }
-    }
+    suspend fun getTypingUsers(eventId: String): List<TypingIndicator> =
+        presence.typingUsers(eventId)
+            .entries
+            .sortedByDescending { (_, state) -> state.lastSeenAt }
+            .map { (userId, state) ->
+                TypingIndicator(
+                    userId = userId,
+                    chatId = eventId,
+                    chatType = ChatType.EVENT,
+                    typingStatus = TypingStatus.TYPING,
+                    lastSeenTyping = state.startedAt.toString(),
+                    lastActivity = state.lastSeenAt.toString()
+                )
+            }
+
+    /**
+     * Gets the users with an open chat connection to an event on this node.
+     */
+    fun getOnlineUsers(eventId: String): Set<String> = presence.onlineUsers(eventId)
     
     /**
      * Updates message content.
@@ -784,20 +678,12 @@ class ChatService(
     }
     
     /**
-     * Cleans up expired typing indicators.
+     * Expires due typing indicators now instead of waiting for the next presence tick.
      *
      * @param eventId Event to clean up
      */
-    suspend fun cleanupExpiredTypingIndicators(eventId: String) = withContext(Dispatchers.IO) {
-        try {
-            val threshold = (System.currentTimeMillis() - 3000).toString()
-            database.typingIndicatorsQueries.cleanupExpiredTypingIndicators(
-                eventId,
-                threshold
-            )
-        } catch (e: Exception) {
-            // Log but don't throw - this is a cleanup operation
-        }
+    suspend fun cleanupExpiredTypingIndicators(eventId: String) {
+        presence.advance()
     }
     
     // ========== Private broadcast methods ==========
@@ -868,6 +754,9 @@ class ChatService(
     }
     
     companion object {
+        // Stays well under SQLite's bound-parameter limit
+        private const val MESSAGE_ID_CHUNK_SIZE = 500
+
         /**
          * Generates a unique message ID.
          */
@@ -962,17 +851,39 @@ fun io.ktor.server.routing.Route.chatRoutes(
                 mapOf("error" to "Invalid user ID in token")
             )
             val limit = parseChatMessageLimit(call.request.queryParameters["limit"])
-            val offset = parseChatMessageOffset(call.request.queryParameters["offset"])
-            val lookaheadMessages = chatService.getMessages(eventId, limit + 1, offset, userId)
-            val messages = lookaheadMessages.take(limit)
-            val totalCount = chatService.countVisibleMessages(eventId, userId)
+            val rawCursor = call.request.queryParameters["cursor"]
+            val rawOffset = call.request.queryParameters["offset"]
+
+            // Legacy offset paging, kept for clients that have not moved to cursors
+            if (rawCursor == null && rawOffset != null) {
+                val offset = parseChatMessageOffset(rawOffset)
+                val lookaheadMessages = chatService.getMessages(eventId, limit + 1, offset, userId)
+                return@get call.respond(
+                    HttpStatusCode.OK,
+                    MessagesResponse(
+                        messages = lookaheadMessages.take(limit),
+                        totalCount = chatService.countVisibleMessages(eventId, userId),
+                        hasMore = lookaheadMessages.size > limit
+                    )
+                )
+            }
+
+            val cursor = rawCursor?.let {
+                ChatMessageCursor.decode(it) ?: return@get call.respond(
+                    HttpStatusCode.BadRequest,
+                    mapOf("error" to "Invalid cursor")
+                )
+            }
+            val page = chatService.getMessagePage(eventId, limit, cursor, userId)
 
             call.respond(
                 HttpStatusCode.OK,
                 MessagesResponse(
-                    messages = messages,
-                    totalCount = totalCount,
-                    hasMore = lookaheadMessages.size > limit
+                    messages = page.messages,
+                    // Counted once, on the first page: cursor pages stay O(limit)
+                    totalCount = if (cursor == null) chatService.countVisibleMessages(eventId, userId) else null,
+                    hasMore = page.nextCursor != null,
+                    nextCursor = page.nextCursor?.encode()
                 )
             )
         }
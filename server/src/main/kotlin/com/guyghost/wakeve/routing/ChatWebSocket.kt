@@ -15,36 +15,143 @@ import io.ktor.websocket.Frame
 import io.ktor.websocket.close
 import io.ktor.websocket.CloseReason
 import io.ktor.websocket.readText
+import kotlinx.coroutines.CancellationException
 import kotlinx.coroutines.CoroutineScope
-import kotlinx.coroutines.Dispatchers
-import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.channels.Channel
 import kotlinx.coroutines.launch
 import kotlinx.serialization.json.Json
 import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.atomic.AtomicLong
 
 private val json = Json { ignoreUnknownKeys = true }
 
+/**
+ * Politique appliquée lorsqu'un client ne lit plus assez vite et que sa file
+ * d'envoi est pleine.
+ */
+enum class SlowConsumerPolicy {
+    /** Ignorer la trame pour ce client ; il rattrapera via l'historique. */
+    DROP,
+
+    /** Fermer la connexion ; le client se reconnecte et recharge l'historique. */
+    CLOSE
+}
+
 /**
  * Gestionnaire de connexions WebSocket par événement.
  *
- * Gère les connexions multiples pour chaque événement et permet
- * la diffusion de messages à tous les participants d'un événement.
+ * Chaque connexion possède une file d'envoi bornée vidée par sa propre coroutine :
+ * la diffusion ne fait que déposer la trame (encodée une seule fois) dans chaque file,
+ * sans jamais suspendre, si bien qu'un client lent ne retarde plus les autres.
+ * Les listes de blocage sont chargées une fois par événement puis mises en cache.
+ *
+ * Les messages passent par un [ChatBroadcastBus] : chaque nœud s'abonne aux seuls
+ * événements pour lesquels il a des connexions et livre localement ce qu'il reçoit.
+ * Le filtrage des expéditeurs bloqués utilise le dépôt de modération du nœud qui livre.
  */
-class EventChatConnections {
-    private data class EventChatConnection(
+class EventChatConnections(
+    private val outboundBufferSize: Int = DEFAULT_OUTBOUND_BUFFER_SIZE,
+    private val slowConsumerPolicy: SlowConsumerPolicy = SlowConsumerPolicy.CLOSE,
+    private val blockListTtlMs: Long = DEFAULT_BLOCK_LIST_TTL_MS,
+    private val clock: () -> Long = System::currentTimeMillis,
+    bus: ChatBroadcastBus = InProcessChatBroadcastBus(),
+    moderationRepository: ModerationRepository? = null
+) {
+    private class EventChatConnection(
+        val id: String,
         val userId: String,
-        val session: DefaultWebSocketServerSession
+        val scope: CoroutineScope,
+        val outbound: Channel<Frame>,
+        val close: suspend (CloseReason) -> Unit
+    )
+
+    /**
+     * Bloqueurs par utilisateur bloqué, pour les utilisateurs de [coveredUserIds].
+     */
+    private class EventBlockList(
+        val coveredUserIds: Set<String>,
+        val blockersByBlockedUser: Map<String, Set<String>>,
+        val loadedAt: Long
     )
 
     private val connections = ConcurrentHashMap<String, ConcurrentHashMap<String, EventChatConnection>>()
+    private val blockLists = ConcurrentHashMap<String, EventBlockList>()
+    private val droppedFrames = AtomicLong()
+
+    // Sérialise abonnements et désabonnements avec l'ajout/retrait des connexions
+    private val subscriptionLock = Any()
+
+    @Volatile
+    private var bus: ChatBroadcastBus = bus.also { it.setListener(::deliverLocal) }
+
+    /**
+     * Dépôt utilisé pour filtrer les expéditeurs bloqués lors de la livraison locale,
+     * y compris pour les messages publiés par un autre nœud. Renseigné au câblage
+     * du serveur, jamais par la diffusion.
+     */
+    @Volatile
+    var moderationRepository: ModerationRepository? = moderationRepository
+
+    /**
+     * Remplace le bus (au démarrage du serveur) et y réabonne les événements actifs.
+     */
+    fun connectBus(newBus: ChatBroadcastBus) {
+        val previous = synchronized(subscriptionLock) {
+            newBus.setListener(::deliverLocal)
+            connections.keys.forEach(newBus::subscribe)
+            bus.also { bus = newBus }
+        }
+        previous.close()
+    }
 
     /**
      * Ajoute une connexion pour un événement.
      */
-    fun addConnection(eventId: String, userId: String, session: DefaultWebSocketServerSession): String {
+    fun addConnection(eventId: String, userId: String, session: DefaultWebSocketServerSession): String =
+        addConnection(
+            eventId = eventId,
+            userId = userId,
+            scope = session,
+            send = { frame -> session.send(frame) },
+            close = { reason -> session.close(reason) }
+        )
+
+    internal fun addConnection(
+        eventId: String,
+        userId: String,
+        scope: CoroutineScope,
+        send: suspend (Frame) -> Unit,
+        close: suspend (CloseReason) -> Unit
+    ): String {
         val connectionId = "$userId-${System.nanoTime()}"
-        connections
-            .computeIfAbsent(eventId) { ConcurrentHashMap() }[connectionId] = EventChatConnection(userId, session)
+        val connection = EventChatConnection(
+            id = connectionId,
+            userId = userId,
+            scope = scope,
+            outbound = Channel(outboundBufferSize),
+            close = close
+        )
+        synchronized(subscriptionLock) {
+            val eventConnections = connections.computeIfAbsent(eventId) { ConcurrentHashMap() }
+            val firstForEvent = eventConnections.isEmpty()
+            eventConnections[connectionId] = connection
+            if (firstForEvent) {
+                bus.subscribe(eventId)
+            }
+        }
+
+        scope.launch {
+            try {
+                for (frame in connection.outbound) {
+                    send(frame)
+                }
+            } catch (e: CancellationException) {
+                throw e
+            } catch (e: Exception) {
+                // La connexion est probablement fermée : on arrête de l'alimenter.
+                removeConnection(eventId, connectionId)
+            }
+        }
         return connectionId
     }
 
@@ -52,49 +159,130 @@ class EventChatConnections {
      * Supprime une connexion d'un événement.
      */
     fun removeConnection(eventId: String, connectionId: String) {
-        connections[eventId]?.let { eventConnections ->
-            eventConnections.remove(connectionId)
-            if (eventConnections.isEmpty()) {
-                connections.remove(eventId, eventConnections)
+        synchronized(subscriptionLock) {
+            connections[eventId]?.let { eventConnections ->
+                eventConnections.remove(connectionId)?.outbound?.close()
+                if (eventConnections.isEmpty()) {
+                    connections.remove(eventId, eventConnections)
+                    blockLists.remove(eventId)
+                    bus.unsubscribe(eventId)
+                }
             }
         }
     }
 
     /**
-     * Diffuse un message à la connexion d'un événement.
+     * Diffuse un message à toutes les connexions d'un événement, sur tous les nœuds.
+     *
+     * @param moderationRepository Non nul pour masquer le message aux destinataires
+     *   ayant bloqué l'expéditeur ; chaque nœud filtre avec son propre dépôt
      */
     fun broadcast(
         eventId: String,
         message: ChatWebSocketResponse,
         moderationRepository: ModerationRepository? = null
     ) {
+        bus.publish(
+            eventId,
+            ChatBusFrame(
+                senderId = message.data.userId,
+                type = message.type,
+                filterBlocked = moderationRepository != null,
+                payload = json.encodeToString(message)
+            )
+        )
+    }
+
+    /**
+     * Livre une trame reçue du bus aux connexions locales de l'événement.
+     *
+     * Ne suspend pas et ne redécode pas le JSON : la même charge utile est déposée
+     * dans la file de chaque destinataire non bloqué.
+     */
+    private fun deliverLocal(eventId: String, frame: ChatBusFrame) {
         val eventConnections = connections[eventId] ?: return
-        CoroutineScope(Dispatchers.IO + SupervisorJob()).launch {
-            val senderId = message.data.userId
-            val jsonText = json.encodeToString(message)
-            eventConnections.forEach { (_, connection) ->
-                if (senderId.isNotBlank() &&
-                    senderId != connection.userId &&
-                    moderationRepository?.isBlockedForEvent(connection.userId, senderId, eventId) == true
-                ) {
-                    return@forEach
-                }
+        val senderId = frame.senderId
+        val repository = moderationRepository
+        val blockers = if (frame.filterBlocked && senderId.isNotBlank() && repository != null) {
+            blockListFor(eventId, eventConnections.values, repository)
+                .blockersByBlockedUser[senderId]
+                .orEmpty()
+        } else {
+            emptySet()
+        }
+        // Les indicateurs de frappe sont éphémères : on peut toujours les perdre.
+        val droppable = frame.type == ChatMessageType.TYPING
+        val bytes = frame.payload.encodeToByteArray()
 
-                try {
-                    connection.session.send(Frame.Text(jsonText))
-                } catch (e: Exception) {
-                    // La connexion est probablement fermée, on ignore l'envoi.
-                }
+        eventConnections.values.forEach { connection ->
+            if (connection.userId != senderId && connection.userId in blockers) {
+                return@forEach
+            }
+            val result = connection.outbound.trySend(Frame.Text(true, bytes))
+            if (result.isFailure && !result.isClosed) {
+                onSlowConsumer(eventId, connection, droppable)
             }
         }
     }
 
+    /**
+     * Oublie les listes de blocage en cache, après un blocage ou un déblocage.
+     */
+    fun invalidateBlockLists() {
+        blockLists.clear()
+    }
+
     /**
      * Retourne le nombre de connexions pour un événement.
      */
     fun getConnectionCount(eventId: String): Int {
         return connections[eventId]?.size ?: 0
     }
+
+    /**
+     * Nombre de trames ignorées faute de place dans la file d'un client lent.
+     */
+    fun getDroppedFrameCount(): Long = droppedFrames.get()
+
+    private fun blockListFor(
+        eventId: String,
+        eventConnections: Collection<EventChatConnection>,
+        moderationRepository: ModerationRepository
+    ): EventBlockList {
+        val now = clock()
+        val cached = blockLists[eventId]
+        if (cached != null &&
+            now - cached.loadedAt < blockListTtlMs &&
+            eventConnections.all { it.userId in cached.coveredUserIds }
+        ) {
+            return cached
+        }
+
+        val userIds = eventConnections.mapTo(mutableSetOf()) { it.userId }
+        return EventBlockList(
+            coveredUserIds = userIds,
+            blockersByBlockedUser = moderationRepository.getBlockersByBlockedUserForEvent(eventId, userIds),
+            loadedAt = now
+        ).also { blockLists[eventId] = it }
+    }
+
+    private fun onSlowConsumer(eventId: String, connection: EventChatConnection, droppable: Boolean) {
+        droppedFrames.incrementAndGet()
+        if (droppable || slowConsumerPolicy == SlowConsumerPolicy.DROP) return
+
+        removeConnection(eventId, connection.id)
+        connection.outbound.cancel()
+        connection.scope.launch {
+            runCatching {
+                connection.close(CloseReason(CloseReason.Codes.TRY_AGAIN_LATER, "Client too slow"))
+            }
+        }
+    }
+
+    private companion object {
+        const val DEFAULT_OUTBOUND_BUFFER_SIZE = 256
+        const val DEFAULT_BLOCK_LIST_TTL_MS = 30_000L
+    }
 }
 
 // Instance partagée du gestionnaire de connexions
@@ -110,9 +298,13 @@ val eventChatConnections = EventChatConnections()
  */
 fun Route.chatWebSocketRoute(
     database: WakeveDb,
-    moderationRepository: ModerationRepository? = null
+    moderationRepository: ModerationRepository? = null,
+    presence: ChatPresenceService? = null
 ) {
     val connectionManager = eventChatConnections
+    if (moderationRepository != null) {
+        connectionManager.moderationRepository = moderationRepository
+    }
 
     webSocket("/ws/events/{eventId}/chat") {
         val eventId: String = call.parameters["eventId"] ?: run {
@@ -131,6 +323,7 @@ fun Route.chatWebSocketRoute(
 
         // Ajouter la connexion au gestionnaire
         val connectionId = connectionManager.addConnection(eventId, userId, this)
+        presence?.userConnected(eventId, userId)
 
         try {
             // Boucle de réception des messages
@@ -208,6 +401,7 @@ fun Route.chatWebSocketRoute(
         } finally {
             // Supprimer la connexion lors de la déconnexion
             connectionManager.removeConnection(eventId, connectionId)
+            presence?.userDisconnected(eventId, userId)
         }
     }
 }
@@ -0,0 +1,149 @@
+package com.guyghost.wakeve.security
+
+import java.util.concurrent.ConcurrentHashMap
+
+/**
+ * In-process [RateLimitBackend], sharded into [stripes] independently locked maps
+ * so that requests for different keys rarely contend.
+ *
+ * Each shard keeps its keys in update order. Updating a key moves it to the
+ * tail, and every call evicts a few expired keys from the head, so memory
+ * follows the number of recently limited keys without a cleanup timer. A key
+ * may be kept up to one window after it expired when a longer-lived key is
+ * ahead of it; an expired key still allows the next request.
+ */
+class InMemoryRateLimitBackend(stripes: Int = DEFAULT_STRIPES) : RateLimitBackend {
+    init {
+        require(stripes > 0) { "Stripe count must be positive" }
+    }
+
+    private val shards = Array(stripes) { LinkedHashMap<String, List<Long>>() }
+
+    override fun tryAcquire(key: String, policy: RateLimitPolicy, nowMs: Long): Boolean {
+        val shard = shardFor(key)
+        synchronized(shard) {
+            evictExpired(shard, nowMs)
+            val log = policy.acquire(shard[key], nowMs) ?: return false
+            shard.remove(key)
+            shard[key] = log
+            return true
+        }
+    }
+
+    override fun wouldAllow(key: String, policy: RateLimitPolicy, nowMs: Long): Boolean {
+        val shard = shardFor(key)
+        val log = synchronized(shard) { shard[key] } ?: return true
+        return policy.allows(log, nowMs)
+    }
+
+    override fun refund(key: String, policy: RateLimitPolicy, nowMs: Long): Boolean {
+        val shard = shardFor(key)
+        synchronized(shard) {
+            val log = shard[key]?.dropWhile { it <= nowMs }
+            if (log.isNullOrEmpty()) {
+                shard.remove(key)
+                return false
+            }
+            if (log.size == 1) shard.remove(key) else shard[key] = log.dropLast(1)
+            return true
+        }
+    }
+
+    /** Keys currently tracked, expired ones not yet evicted included. */
+    val size: Int
+        get() = shards.sumOf { shard -> synchronized(shard) { shard.size } }
+
+    private fun shardFor(key: String): LinkedHashMap<String, List<Long>> =
+        shards[Math.floorMod(key.hashCode(), shards.size)]
+
+    private fun evictExpired(shard: LinkedHashMap<String, List<Long>>, nowMs: Long) {
+        val iterator = shard.values.iterator()
+        var checked = 0
+        while (checked < EVICTIONS_PER_CALL && iterator.hasNext()) {
+            if (iterator.next().last() > nowMs) return
+            iterator.remove()
+            checked++
+        }
+    }
+
+    companion object {
+        const val DEFAULT_STRIPES = 64
+        private const val EVICTIONS_PER_CALL = 4
+    }
+}
+
+/**
+ * Key-value store shared by server instances, holding the ascending expiry
+ * log of each key.
+ *
+ * Maps onto a Redis-like store: the log is a short list or sorted set,
+ * [compareAndSet] is a WATCH/MULTI or a small script, and a key may be expired
+ * by the store once its newest entry is in the past (PEXPIREAT on that entry).
+ */
+interface SharedRateLimitStore {
+    fun get(key: String, nowMs: Long): List<Long>?
+
+    /**
+     * Sets [key] to [update], or deletes it when [update] is null, if its
+     * current value is [expected] (null meaning absent).
+     *
+     * @return false if another writer changed the key first
+     */
+    fun compareAndSet(key: String, expected: List<Long>?, update: List<Long>?): Boolean
+}
+
+/**
+ * [SharedRateLimitStore] within one process, for tests and single-instance
+ * deployments. Expired keys are dropped when read.
+ */
+class LocalSharedRateLimitStore : SharedRateLimitStore {
+    private val values = ConcurrentHashMap<String, List<Long>>()
+
+    override fun get(key: String, nowMs: Long): List<Long>? {
+        val value = values[key] ?: return null
+        if (value.last() <= nowMs) {
+            values.remove(key, value)
+            return null
+        }
+        return value
+    }
+
+    override fun compareAndSet(key: String, expected: List<Long>?, update: List<Long>?): Boolean =
+        when {
+            expected == null && update == null -> !values.containsKey(key)
+            expected == null -> values.putIfAbsent(key, update!!) == null
+            update == null -> values.remove(key, expected)
+            else -> values.replace(key, expected, update)
+        }
+
+    val size: Int
+        get() = values.size
+}
+
+/**
+ * [RateLimitBackend] over a [SharedRateLimitStore], so that all server
+ * instances enforce one limit per key. Updates are optimistic: a write
+ * that loses a race is retried on the fresh value.
+ */
+class SharedStoreRateLimitBackend(private val store: SharedRateLimitStore) : RateLimitBackend {
+
+    override fun tryAcquire(key: String, policy: RateLimitPolicy, nowMs: Long): Boolean {
+        while (true) {
+            val log = store.get(key, nowMs)
+            val updated = policy.acquire(log, nowMs) ?: return false
+            if (store.compareAndSet(key, log, updated)) return true
+        }
+    }
+
+    override fun wouldAllow(key: String, policy: RateLimitPolicy, nowMs: Long): Boolean =
+        policy.allows(store.get(key, nowMs), nowMs)
+
+    override fun refund(key: String, policy: RateLimitPolicy, nowMs: Long): Boolean {
+        while (true) {
+            val log = store.get(key, nowMs) ?: return false
+            val live = log.dropWhile { it <= nowMs }
+            if (live.isEmpty()) return false
+            if (store.compareAndSet(key, log, live.dropLast(1).ifEmpty { null })) return true
+        }
+    }
+}
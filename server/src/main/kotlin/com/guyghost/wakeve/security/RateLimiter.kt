@@ -0,0 +1,98 @@
+package com.guyghost.wakeve.security
+
+import com.guyghost.wakeve.metrics.RateLimiterMetrics
+
+/**
+ * At most [limit] requests per key in any [windowMs], as a sliding log: a burst
+ * of [limit] is allowed, and each request frees its slot [windowMs] after it
+ * was counted.
+ */
+data class RateLimitPolicy(val limit: Int, val windowMs: Long) {
+    init {
+        require(limit > 0) { "Rate limit must be positive" }
+        require(windowMs > 0) { "Rate limit window must be positive" }
+    }
+}
+
+/**
+ * Storage of rate limiting state: per key, the ascending expiry times of the
+ * requests counted in the last window, at most [RateLimitPolicy.limit] of them.
+ *
+ * A key whose newest expiry is in the past has nothing counted, so backends may
+ * forget it.
+ */
+interface RateLimitBackend {
+    /**
+     * Takes one request from the bucket of [key] if it is not empty.
+     *
+     * @return true if the request is allowed
+     */
+    fun tryAcquire(key: String, policy: RateLimitPolicy, nowMs: Long): Boolean
+
+    /**
+     * Whether a request for [key] would be allowed now, without taking it.
+     */
+    fun wouldAllow(key: String, policy: RateLimitPolicy, nowMs: Long): Boolean
+
+    /**
+     * Gives back the most recent request counted for [key].
+     *
+     * @return false if nothing was counted for [key]
+     */
+    fun refund(key: String, policy: RateLimitPolicy, nowMs: Long): Boolean
+}
+
+/**
+ * Appends a request to the expiry [log] of a key, or returns null if the key
+ * already has [RateLimitPolicy.limit] unexpired requests.
+ */
+internal fun RateLimitPolicy.acquire(log: List<Long>?, nowMs: Long): List<Long>? {
+    val live = log.orEmpty().dropWhile { it <= nowMs }
+    if (live.size >= limit) return null
+    return live + (nowMs + windowMs)
+}
+
+internal fun RateLimitPolicy.allows(log: List<Long>?, nowMs: Long): Boolean =
+    log.orEmpty().count { it > nowMs } < limit
+
+/**
+ * Per-key rate limiter, e.g. push notifications per user or OTP requests per email.
+ *
+ * State lives in a pluggable [RateLimitBackend]: [InMemoryRateLimitBackend] for a
+ * single instance, or [SharedStoreRateLimitBackend] so that several server
+ * instances enforce one limit together. Keys are namespaced with [name], so
+ * limiters can share a backend.
+ */
+class RateLimiter(
+    val name: String,
+    val policy: RateLimitPolicy,
+    private val backend: RateLimitBackend = InMemoryRateLimitBackend(),
+    private val clock: () -> Long = System::currentTimeMillis
+) {
+    val metrics = RateLimiterMetrics(name)
+
+    /**
+     * Counts one request for [key].
+     *
+     * @return false if [key] is over its limit; the request is then not counted
+     */
+    fun tryAcquire(key: String): Boolean {
+        val allowed = backend.tryAcquire(backendKey(key), policy, clock())
+        if (allowed) metrics.recordAllowed() else metrics.recordRejected()
+        return allowed
+    }
+
+    /**
+     * Whether the next request for [key] would be rejected. Does not count a request.
+     */
+    fun isLimited(key: String): Boolean = !backend.wouldAllow(backendKey(key), policy, clock())
+
+    /**
+     * Gives back a request counted by [tryAcquire] that did not go through.
+     */
+    fun refund(key: String) {
+        if (backend.refund(backendKey(key), policy, clock())) metrics.recordRefunded()
+    }
+
+    private fun backendKey(key: String) = "$name:$key"
+}
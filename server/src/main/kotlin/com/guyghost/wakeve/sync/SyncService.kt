@@ -1,5 +1,7 @@
 package com.guyghost.wakeve.sync
 
+import com.guyghost.wakeve.database.Event as EventRow
+import com.guyghost.wakeve.database.Participant as ParticipantRow
 import com.guyghost.wakeve.repository.DatabaseEventRepository
 import com.guyghost.wakeve.repository.UserRepository
 import com.guyghost.wakeve.database.WakeveDb
@@ -7,17 +9,26 @@ import com.guyghost.wakeve.models.SyncChange
 import com.guyghost.wakeve.models.SyncConflict
 import com.guyghost.wakeve.models.SyncEventData
 import com.guyghost.wakeve.models.SyncOperation
+import com.guyghost.wakeve.models.SyncEventDelta
 import com.guyghost.wakeve.models.SyncParticipantData
+import com.guyghost.wakeve.models.SyncPullRequest
+import com.guyghost.wakeve.models.SyncPullResponse
 import com.guyghost.wakeve.models.SyncRequest
 import com.guyghost.wakeve.models.SyncResponse
+import com.guyghost.wakeve.models.SyncTableVersion
 import com.guyghost.wakeve.models.SyncVoteData
 import kotlinx.datetime.Clock
 import kotlinx.serialization.json.Json
 
 /**
  * Service de synchronisation serveur pour le traitement des changements offline
+ *
+ * @param onEventChanged Appele pour chaque evenement modifie ou supprime par une synchronisation
  */
-class SyncService(private val db: WakeveDb) {
+class SyncService(
+    private val db: WakeveDb,
+    private val onEventChanged: (eventId: String) -> Unit = {}
+) {
 
     private val eventRepository = DatabaseEventRepository(db)
     private val userRepository = UserRepository(db)
@@ -27,59 +38,110 @@ class SyncService(private val db: WakeveDb) {
     private val voteQueries = db.voteQueries
 
     /**
-     * Process a batch of sync changes from client
+     * Process a batch of sync changes from client.
+     *
+     * Payloads are decoded once up front and the events they touch are loaded in bulk.
+     * Changes apply in request order, so the client's causal order is kept; each run of
+     * consecutive changes to the same table is validated before any write, then written
+     * in one transaction, so a long offline queue costs one commit per run instead of
+     * one per change. A change that fails validation is reported as a conflict and never
+     * written; an unexpected database error rolls its run back and replays the run one
+     * change per transaction.
      */
     suspend fun processSyncChanges(request: SyncRequest, userId: String): SyncResponse {
-        val conflicts = mutableListOf<SyncConflict>()
+        val conflicts = mutableListOf<Pair<Int, SyncConflict>>()
         var appliedChanges = 0
 
         try {
-            for (change in request.changes) {
+            val decoded = mutableListOf<DecodedSyncChange>()
+            val rejected = mutableListOf<IndexedValue<SyncChange>>()
+
+            request.changes.forEachIndexed { index, change ->
                 // Verify the change belongs to the authenticated user
                 if (change.userId != userId) {
-                    conflicts.add(SyncConflict(
+                    conflicts += index to SyncConflict(
                         changeId = change.id,
                         table = change.table,
                         recordId = change.recordId,
                         clientData = change.data,
                         serverData = "",
                         resolution = "REJECTED"
-                    ))
-                    continue
+                    )
+                    return@forEachIndexed
                 }
 
-                val result = applySyncChange(change)
-                if (result.isSuccess) {
-                    appliedChanges++
-                } else {
-                    // Handle conflict
-                    val serverData = getServerData(change.table, change.recordId)
-                    conflicts.add(SyncConflict(
-                        changeId = change.id,
-                        table = change.table,
-                        recordId = change.recordId,
-                        clientData = change.data,
-                        serverData = serverData ?: "",
-                        resolution = "SERVER_WINS"  // Last-write-wins strategy
-                    ))
+                val result = runCatching { decodeSyncChange(index, change) }
+                result.onSuccess { decoded += it }
+                result.onFailure { rejected += IndexedValue(index, change) }
+            }
+
+            val now = getCurrentUtcIsoString()
+            var state = loadBatchState(decoded)
+
+            for (run in decoded.consecutiveRunsByTable()) {
+                // Validate the whole run first: nothing is written for a change that fails
+                state.beginRun()
+                val valid = mutableListOf<DecodedSyncChange>()
+                val writes = mutableListOf<() -> Unit>()
+                for (change in run) {
+                    try {
+                        writes += planChange(change, state, now)
+                        valid += change
+                    } catch (e: IllegalArgumentException) {
+                        rejected += IndexedValue(change.index, change.change)
+                    } catch (e: IllegalStateException) {
+                        rejected += IndexedValue(change.index, change.change)
+                    }
+                }
+
+                try {
+                    db.transaction { writes.forEach { it() } }
+                    appliedChanges += valid.size
+                } catch (e: Exception) {
+                    val (applied, failed) = applyOneByOne(valid, now)
+                    appliedChanges += applied
+                    failed.forEach { rejected += IndexedValue(it.index, it.change) }
+                    // The run was planned as if it had committed as a whole
+                    state = loadBatchState(decoded)
                 }
             }
 
+            // Invalidate what other services cached about the touched events; a rejected
+            // change only costs a reload
+            decoded.filter { it.change.table == "events" && it.operation != SyncOperation.CREATE }
+                .map { it.change.recordId }
+                .distinct()
+                .forEach(onEventChanged)
+
+            // Handle conflicts: report the current server version (last-write-wins)
+            rejected.forEach { (index, change) ->
+                val serverData = getServerData(change.table, change.recordId)
+                conflicts += index to SyncConflict(
+                    changeId = change.id,
+                    table = change.table,
+                    recordId = change.recordId,
+                    clientData = change.data,
+                    serverData = serverData ?: "",
+                    resolution = "SERVER_WINS"  // Last-write-wins strategy
+                )
+            }
+
+            val orderedConflicts = conflicts.sortedBy { it.first }.map { it.second }
             val serverTimestamp = getCurrentUtcIsoString()
 
             return SyncResponse(
                 success = true,
                 appliedChanges = appliedChanges,
-                conflicts = conflicts,
+                conflicts = orderedConflicts,
                 serverTimestamp = serverTimestamp,
-                message = if (conflicts.isEmpty()) "All changes applied successfully" else "${conflicts.size} conflicts detected"
+                message = if (orderedConflicts.isEmpty()) "All changes applied successfully" else "${orderedConflicts.size} conflicts detected"
             )
 
         } catch (e: Exception) {
             return SyncResponse(
                 success = false,
                 appliedChanges = appliedChanges,
-                conflicts = conflicts,
+                conflicts = conflicts.sortedBy { it.first }.map { it.second },
                 serverTimestamp = getCurrentUtcIsoString(),
                 message = serverSyncFailureMessage()
             )
@@ -87,47 +149,314 @@ class SyncService(private val db: WakeveDb) {
     }
 
     /**
-     * Apply a single sync change
+     * Delta pull: rows visible to [userId] changed since the client's version vector.
+     * Each table is paged independently on the server change sequence (syncChangeLog.seq),
+     * which follows commit order; the returned vector holds the sequence of the last row
+     * sent per table. Deleted events and removed memberships come back as DELETE changes.
+     *
+     * A membership of [userId] itself is sent with its event and the event's other members:
+     * the new member's cursors may already have passed them, and the join only logs its
+     * own row.
      */
-    private suspend fun applySyncChange(change: SyncChange): Result<Unit> = runCatching {
-        when (change.table) {
-            "events" -> applyEventChange(change)
-            "participants" -> applyParticipantChange(change)
-            "votes" -> applyVoteChange(change)
+    suspend fun pullChanges(request: SyncPullRequest, userId: String): SyncPullResponse {
+        val limit = request.limit.coerceIn(1, MAX_PULL_LIMIT).toLong()
+        return try {
+            val changes = mutableListOf<SyncChange>()
+            val versions = request.versions.toMutableMap()
+            val serverTimestamp = getCurrentUtcIsoString()
+
+            val events = db.syncChangeLogQueries.selectEventsChangedSinceForUser(
+                sinceSeq = request.versions[EVENTS_TABLE]?.seq ?: 0L,
+                userId = userId,
+                limit = limit
+            ).executeAsList()
+            events.forEach { row ->
+                changes += if (row.operation == LOG_DELETE) {
+                    deleteChange(EVENTS_TABLE, row.recordId, row.seq, userId, serverTimestamp)
+                } else {
+                    eventChange(
+                        seq = row.seq,
+                        id = row.recordId,
+                        title = row.title!!,
+                        description = row.description!!,
+                        organizerId = row.organizerId!!,
+                        deadline = row.deadline!!,
+                        status = row.status!!,
+                        updatedAt = row.updatedAt!!
+                    )
+                }
+            }
+            events.lastOrNull()?.let { versions[EVENTS_TABLE] = SyncTableVersion(it.seq) }
+
+            val participants = db.syncChangeLogQueries.selectParticipantsChangedSinceForUser(
+                sinceSeq = request.versions[PARTICIPANTS_TABLE]?.seq ?: 0L,
+                userId = userId,
+                limit = limit
+            ).executeAsList()
+            participants.forEach { row ->
+                changes += if (row.operation == LOG_DELETE) {
+                    deleteChange(PARTICIPANTS_TABLE, row.recordId, row.seq, userId, serverTimestamp)
+                } else {
+                    participantChange(
+                        seq = row.seq,
+                        id = row.recordId,
+                        eventId = row.eventId,
+                        userId = row.userId!!,
+                        role = row.role!!,
+                        hasValidatedDate = row.hasValidatedDate == 1L,
+                        updatedAt = row.updatedAt!!
+                    )
+                }
+            }
+            participants.lastOrNull()?.let { versions[PARTICIPANTS_TABLE] = SyncTableVersion(it.seq) }
+
+            // Own new memberships carry their event and its other members, at the membership's seq
+            val joinedSeq = participants
+                .filter { it.operation != LOG_DELETE && it.userId == userId }
+                .associate { it.eventId to it.seq }
+            if (joinedSeq.isNotEmpty()) {
+                val sent = changes.map { it.table to it.recordId }.toHashSet()
+                db.eventQueries.selectByIds(joinedSeq.keys).executeAsList().forEach { event ->
+                    if (!sent.add(EVENTS_TABLE to event.id)) return@forEach
+                    changes += eventChange(
+                        seq = joinedSeq.getValue(event.id),
+                        id = event.id,
+                        title = event.title,
+                        description = event.description,
+                        organizerId = event.organizerId,
+                        deadline = event.deadline,
+                        status = event.status,
+                        updatedAt = event.updatedAt
+                    )
+                }
+                db.participantQueries.selectByEventIds(joinedSeq.keys).executeAsList().forEach { member ->
+                    if (!sent.add(PARTICIPANTS_TABLE to member.id)) return@forEach
+                    changes += participantChange(
+                        seq = joinedSeq.getValue(member.eventId),
+                        id = member.id,
+                        eventId = member.eventId,
+                        userId = member.userId,
+                        role = member.role,
+                        hasValidatedDate = member.hasValidatedDate == 1L,
+                        updatedAt = member.updatedAt
+                    )
+                }
+            }
+
+            SyncPullResponse(
+                success = true,
+                changes = changes,
+                versions = versions,
+                hasMore = events.size.toLong() == limit || participants.size.toLong() == limit,
+                tablesWithMore = buildList {
+                    if (events.size.toLong() == limit) add(EVENTS_TABLE)
+                    if (participants.size.toLong() == limit) add(PARTICIPANTS_TABLE)
+                },
+                serverTimestamp = serverTimestamp
+            )
+        } catch (e: Exception) {
+            SyncPullResponse(
+                success = false,
+                versions = request.versions,
+                serverTimestamp = getCurrentUtcIsoString(),
+                message = serverSyncFailureMessage()
+            )
+        }
+    }
+
+    private fun eventChange(
+        seq: Long,
+        id: String,
+        title: String,
+        description: String,
+        organizerId: String,
+        deadline: String,
+        status: String,
+        updatedAt: String
+    ) = SyncChange(
+        id = "pull_${EVENTS_TABLE}_$id",
+        table = EVENTS_TABLE,
+        operation = SyncOperation.UPDATE.name,
+        recordId = id,
+        data = json.encodeToString(SyncEventData.serializer(), SyncEventData(
+            id = id,
+            title = title,
+            description = description,
+            organizerId = organizerId,
+            deadline = deadline,
+            status = status,
+            updatedAt = updatedAt
+        )),
+        timestamp = updatedAt,
+        userId = organizerId,
+        seq = seq
+    )
+
+    private fun participantChange(
+        seq: Long,
+        id: String,
+        eventId: String,
+        userId: String,
+        role: String,
+        hasValidatedDate: Boolean,
+        updatedAt: String
+    ) = SyncChange(
+        id = "pull_${PARTICIPANTS_TABLE}_$id",
+        table = PARTICIPANTS_TABLE,
+        operation = SyncOperation.UPDATE.name,
+        recordId = id,
+        data = json.encodeToString(SyncParticipantData.serializer(), SyncParticipantData(
+            eventId = eventId,
+            userId = userId,
+            id = id,
+            role = role,
+            hasValidatedDate = hasValidatedDate,
+            updatedAt = updatedAt
+        )),
+        timestamp = updatedAt,
+        userId = userId,
+        seq = seq
+    )
+
+    // A tombstone only carries the record it removes
+    private fun deleteChange(table: String, recordId: String, seq: Long, userId: String, timestamp: String) =
+        SyncChange(
+            id = "pull_${table}_${recordId}_delete",
+            table = table,
+            operation = SyncOperation.DELETE.name,
+            recordId = recordId,
+            data = "{}",
+            timestamp = timestamp,
+            userId = userId,
+            seq = seq
+        )
+
+    /**
+     * Fallback when a run's transaction fails as a whole: each change is validated again
+     * against fresh state and written in its own transaction, so the failing change is
+     * isolated and the others still apply.
+     */
+    private fun applyOneByOne(
+        changes: List<DecodedSyncChange>,
+        now: String
+    ): Pair<Int, List<DecodedSyncChange>> {
+        val failed = mutableListOf<DecodedSyncChange>()
+        for (change in changes) {
+            try {
+                val write = planChange(change, loadBatchState(listOf(change)), now)
+                db.transaction { write() }
+            } catch (e: Exception) {
+                failed += change
+            }
+        }
+        return changes.size - failed.size to failed
+    }
+
+    /**
+     * Decode a change's payload once, according to its table and operation
+     */
+    private fun decodeSyncChange(index: Int, change: SyncChange): DecodedSyncChange {
+        val operation = SyncOperation.valueOf(change.operation)
+        return when (change.table) {
+            "events" -> when (operation) {
+                SyncOperation.CREATE -> DecodedSyncChange(index, change, operation, event = json.decodeFromString<SyncEventData>(change.data))
+                // Field-level delta: absent fields keep their server value
+                SyncOperation.UPDATE -> DecodedSyncChange(index, change, operation, eventDelta = json.decodeFromString<SyncEventDelta>(change.data))
+                SyncOperation.DELETE -> DecodedSyncChange(index, change, operation)
+            }
+            "participants" -> DecodedSyncChange(index, change, operation, participant = json.decodeFromString<SyncParticipantData>(change.data))
+            "votes" -> DecodedSyncChange(index, change, operation, vote = json.decodeFromString<SyncVoteData>(change.data))
             else -> throw IllegalArgumentException("Unknown table: ${change.table}")
         }
     }
 
-    private suspend fun applyEventChange(change: SyncChange) {
-        val eventData = json.decodeFromString<SyncEventData>(change.data)
+    /**
+     * Bulk-load the events referenced by a batch and their member user IDs
+     */
+    private fun loadBatchState(changes: List<DecodedSyncChange>): SyncBatchState {
+        val eventIds = changes.flatMap { change ->
+            listOfNotNull(
+                change.change.recordId.takeIf { change.change.table == "events" },
+                change.event?.id,
+                change.participant?.eventId,
+                change.vote?.eventId
+            )
+        }.distinct()
+
+        val state = SyncBatchState()
+        eventIds.forEach { state.events[it] = null }
+        eventIds.chunked(BATCH_LOOKUP_CHUNK_SIZE).forEach { chunk ->
+            db.eventQueries.selectByIds(chunk).executeAsList().forEach { state.events[it.id] = it }
+            participantQueries.selectByEventIds(chunk).executeAsList().forEach { participant ->
+                state.members.getOrPut(participant.eventId) { mutableSetOf() } += participant.userId
+            }
+        }
+        return state
+    }
 
-        when (SyncOperation.valueOf(change.operation)) {
+    /**
+     * Validate a single decoded change against [state] without writing anything, advance
+     * [state] as if the change had been applied, and return its writes, to run inside the
+     * run's transaction. Validation failures throw IllegalArgumentException/IllegalStateException.
+     */
+    private fun planChange(change: DecodedSyncChange, state: SyncBatchState, now: String): () -> Unit {
+        return when (change.change.table) {
+            "events" -> planEventChange(change, state, now)
+            "participants" -> planParticipantChange(change, state, now)
+            "votes" -> planVoteChange(change, state, now)
+            else -> throw IllegalArgumentException("Unknown table: ${change.change.table}")
+        }
+    }
+
+    private fun planEventChange(decoded: DecodedSyncChange, state: SyncBatchState, now: String): () -> Unit {
+        val change = decoded.change
+
+        when (decoded.operation) {
             SyncOperation.CREATE -> {
+                val eventData = decoded.event!!
                 if (eventData.organizerId != change.userId) {
                     throw IllegalArgumentException("Cannot create an event for another organizer")
                 }
                 // Check if event already exists
-                val existing = eventRepository.getEvent(change.recordId)
-                if (existing == null) {
-                    // Create a full Event object from the sync data
-                    val now = getCurrentUtcIsoString()
-                    val event = com.guyghost.wakeve.models.Event(
-                        id = eventData.id,
-                        title = eventData.title,
-                        description = eventData.description,
-                        organizerId = eventData.organizerId,
-                        participants = emptyList<String>(),
-                        proposedSlots = emptyList<com.guyghost.wakeve.models.TimeSlot>(), // Will be added separately
-                        deadline = eventData.deadline,
-                        status = com.guyghost.wakeve.models.EventStatus.DRAFT,
-                        createdAt = now,
-                        updatedAt = now
-                    )
-                    eventRepository.createEvent(event)
-                }
+                if (state.event(change.recordId) != null) return NO_WRITE
+
+                // Create a full Event object from the sync data
+                val event = com.guyghost.wakeve.models.Event(
+                    id = eventData.id,
+                    title = eventData.title,
+                    description = eventData.description,
+                    organizerId = eventData.organizerId,
+                    participants = emptyList<String>(),
+                    proposedSlots = emptyList<com.guyghost.wakeve.models.TimeSlot>(), // Will be added separately
+                    deadline = eventData.deadline,
+                    status = com.guyghost.wakeve.models.EventStatus.DRAFT,
+                    createdAt = now,
+                    updatedAt = now
+                )
+                state.events[event.id] = EventRow(
+                    id = event.id,
+                    organizerId = event.organizerId,
+                    title = event.title,
+                    description = event.description,
+                    status = event.status.name,
+                    deadline = event.deadline,
+                    createdAt = now,
+                    updatedAt = now,
+                    version = 1,
+                    eventType = event.eventType.name,
+                    eventTypeCustom = event.eventTypeCustom,
+                    minParticipants = null,
+                    maxParticipants = null,
+                    expectedParticipants = null,
+                    isSample = 0,
+                    planningMode = event.planningMode.name
+                )
+                state.members[event.id] = mutableSetOf(event.organizerId)
+                return { eventRepository.insertEventRecords(event, now) }
             }
             SyncOperation.UPDATE -> {
-                val existing = eventRepository.getEvent(change.recordId)
+                val delta = decoded.eventDelta!!
+                val existing = state.event(change.recordId)
                     ?: throw IllegalArgumentException("Event not found: ${change.recordId}")
                 if (existing.organizerId != change.userId) {
                     throw IllegalArgumentException("Only the event organizer can sync event updates")
@@ -139,50 +468,80 @@ class SyncService(private val db: WakeveDb) {
                 }
 
                 // Mettre a jour l'evenement avec les donnees du client
-                val updatedEvent = existing.copy(
-                    title = eventData.title,
-                    description = eventData.description,
-                    deadline = eventData.deadline,
-                    updatedAt = getCurrentUtcIsoString()
+                val updated = existing.copy(
+                    title = delta.title ?: existing.title,
+                    description = delta.description ?: existing.description,
+                    deadline = delta.deadline ?: existing.deadline,
+                    updatedAt = now
                 )
-                eventRepository.updateEvent(updatedEvent)
+                state.events[updated.id] = updated
+                return {
+                    db.eventQueries.updateEventContent(
+                        title = updated.title,
+                        description = updated.description,
+                        deadline = updated.deadline,
+                        updatedAt = updated.updatedAt,
+                        id = updated.id
+                    )
+                }
             }
             SyncOperation.DELETE -> {
                 // Supprimer l'evenement (cascade vers time slots, participants, votes)
                 // Si l'evenement n'existe plus, on ignore silencieusement
-                val existing = eventRepository.getEvent(change.recordId)
-                if (existing != null) {
-                    if (existing.organizerId != change.userId) {
-                        throw IllegalArgumentException("Only the event organizer can sync event deletion")
-                    }
-                    eventRepository.deleteEvent(change.recordId)
+                val existing = state.event(change.recordId) ?: return NO_WRITE
+                if (existing.organizerId != change.userId) {
+                    throw IllegalArgumentException("Only the event organizer can sync event deletion")
                 }
-                // Deja supprime : rien a faire
+                state.events[change.recordId] = null
+                state.members.remove(change.recordId)
+                return { eventRepository.deleteEventRecords(change.recordId, now) }
             }
         }
     }
 
-    private suspend fun applyParticipantChange(change: SyncChange) {
-        val participantData = json.decodeFromString<SyncParticipantData>(change.data)
-        val event = eventRepository.getEvent(participantData.eventId)
+    private fun planParticipantChange(decoded: DecodedSyncChange, state: SyncBatchState, now: String): () -> Unit {
+        val change = decoded.change
+        val participantData = decoded.participant!!
+        val event = state.event(participantData.eventId)
             ?: throw IllegalArgumentException("Event not found: ${participantData.eventId}")
         if (event.organizerId != change.userId) {
             throw IllegalArgumentException("Only the event organizer can sync participant changes")
         }
+        val key = participantData.eventId to participantData.userId
 
-        when (SyncOperation.valueOf(change.operation)) {
+        when (decoded.operation) {
             SyncOperation.CREATE -> {
-                // Check if participant already exists
-                val existing = eventRepository.getParticipants(participantData.eventId)?.contains(participantData.userId) ?: false
-                if (!existing) {
-                    eventRepository.addParticipant(participantData.eventId, participantData.userId)
+                // Participants can only join while the event is a draft; otherwise the change is a no-op
+                val members = state.members.getOrPut(participantData.eventId) { mutableSetOf() }
+                if (participantData.userId in members || event.status != com.guyghost.wakeve.models.EventStatus.DRAFT.name) {
+                    return NO_WRITE
+                }
+                val participant = ParticipantRow(
+                    id = "part_${participantData.eventId}_${participantData.userId}",
+                    eventId = participantData.eventId,
+                    userId = participantData.userId,
+                    role = "PARTICIPANT",
+                    hasValidatedDate = 0,
+                    joinedAt = now,
+                    updatedAt = now
+                )
+                members += participantData.userId
+                state.participants[key] = participant
+                return {
+                    participantQueries.insertParticipant(
+                        id = participant.id,
+                        eventId = participant.eventId,
+                        userId = participant.userId,
+                        role = participant.role,
+                        hasValidatedDate = participant.hasValidatedDate,
+                        joinedAt = participant.joinedAt,
+                        updatedAt = participant.updatedAt
+                    )
                 }
             }
             SyncOperation.UPDATE -> {
                 // Mettre a jour le role/statut du participant
-                val participantRecord = participantQueries
-                    .selectByEventIdAndUserId(participantData.eventId, participantData.userId)
-                    .executeAsOneOrNull()
+                val participantRecord = participant(state, key)
                     ?: throw IllegalArgumentException("Participant not found: ${participantData.userId} in event ${participantData.eventId}")
 
                 // Conflit : si la version serveur est plus recente
@@ -190,37 +549,37 @@ class SyncService(private val db: WakeveDb) {
                     throw IllegalStateException("Server version is newer for participant ${change.recordId}")
                 }
 
-                val now = getCurrentUtcIsoString()
-                participantQueries.updateParticipant(
-                    role = participantRecord.role,  // Conserver le role existant (le client ne peut pas changer le role via sync)
-                    hasValidatedDate = participantRecord.hasValidatedDate,
-                    updatedAt = now,
-                    id = participantRecord.id
-                )
+                state.participants[key] = participantRecord.copy(updatedAt = now)
+                return {
+                    participantQueries.updateParticipant(
+                        role = participantRecord.role,  // Conserver le role existant (le client ne peut pas changer le role via sync)
+                        hasValidatedDate = participantRecord.hasValidatedDate,
+                        updatedAt = now,
+                        id = participantRecord.id
+                    )
+                }
             }
             SyncOperation.DELETE -> {
                 // Supprimer le participant de l'evenement
                 // Les votes associes seront supprimes en cascade (FK ON DELETE CASCADE)
-                val participantRecord = participantQueries
-                    .selectByEventIdAndUserId(participantData.eventId, participantData.userId)
-                    .executeAsOneOrNull()
-
-                if (participantRecord != null) {
-                    participantQueries.deleteParticipant(participantRecord.id)
-                }
                 // Deja supprime : rien a faire
+                val participantRecord = participant(state, key) ?: return NO_WRITE
+                state.participants[key] = null
+                state.members[participantData.eventId]?.remove(participantData.userId)
+                return { participantQueries.deleteParticipant(participantRecord.id) }
             }
         }
     }
 
-    private suspend fun applyVoteChange(change: SyncChange) {
-        val voteData = json.decodeFromString<SyncVoteData>(change.data)
+    private fun planVoteChange(decoded: DecodedSyncChange, state: SyncBatchState, now: String): () -> Unit {
+        val change = decoded.change
+        val voteData = decoded.vote!!
         if (voteData.participantId != change.userId) {
             throw IllegalArgumentException("Cannot sync a vote for another participant")
         }
-        val event = eventRepository.getEvent(voteData.eventId)
+        val event = state.event(voteData.eventId)
             ?: throw IllegalArgumentException("Event not found: ${voteData.eventId}")
-        if (!event.participants.contains(change.userId)) {
+        if (state.members[voteData.eventId]?.contains(change.userId) != true) {
             throw IllegalArgumentException("Participant not in event")
         }
         val slot = db.timeSlotQueries.selectById(voteData.slotId).executeAsOneOrNull()
@@ -228,49 +587,73 @@ class SyncService(private val db: WakeveDb) {
         if (slot.eventId != voteData.eventId) {
             throw IllegalArgumentException("Vote slot does not belong to event")
         }
+        val voteId = "vote_${voteData.slotId}_${voteData.participantId}"
 
-        when (SyncOperation.valueOf(change.operation)) {
+        when (decoded.operation) {
             SyncOperation.CREATE -> {
-                // For votes, we need to check if it already exists
-                // Since the repository doesn't have a getVote method, we'll try to add it and handle the error
-                try {
-                    val preference = com.guyghost.wakeve.models.Vote.valueOf(voteData.preference)
-                    eventRepository.addVote(voteData.eventId, voteData.participantId, voteData.slotId, preference)
-                } catch (e: Exception) {
-                    // Vote might already exist, skip
+                // Votes are only accepted while polling is open; an existing or invalid vote is skipped
+                val preference = runCatching { com.guyghost.wakeve.models.Vote.valueOf(voteData.preference) }.getOrNull()
+                val pollingOpen = event.status == com.guyghost.wakeve.models.EventStatus.POLLING.name &&
+                    !eventRepository.isDeadlinePassed(event.deadline)
+                if (preference == null || !pollingOpen || voteUpdatedAt(state, voteId) != null ||
+                    participant(state, voteData.eventId to voteData.participantId) == null
+                ) {
+                    return NO_WRITE
                 }
+                state.votes[voteId] = now
+                return { eventRepository.insertVoteRecord(voteData.eventId, voteData.participantId, voteData.slotId, preference, now) }
             }
             SyncOperation.UPDATE -> {
                 // Mettre a jour la preference du vote (last-write-wins sur le timestamp)
-                val voteId = "vote_${voteData.slotId}_${voteData.participantId}"
-                val existingVote = voteQueries.selectById(voteId).executeAsOneOrNull()
+                val existingUpdatedAt = voteUpdatedAt(state, voteId)
                     ?: throw IllegalArgumentException("Vote not found: $voteId")
 
                 // Conflit : last-write-wins base sur le timestamp
-                if (existingVote.updatedAt > change.timestamp) {
+                if (existingUpdatedAt > change.timestamp) {
                     throw IllegalStateException("Server version is newer for vote $voteId")
                 }
 
-                val now = getCurrentUtcIsoString()
-                voteQueries.updateVote(
-                    vote = voteData.preference,
-                    updatedAt = now,
-                    id = voteId
-                )
+                state.votes[voteId] = now
+                return {
+                    voteQueries.updateVote(
+                        vote = voteData.preference,
+                        updatedAt = now,
+                        id = voteId
+                    )
+                }
             }
             SyncOperation.DELETE -> {
                 // Supprimer le vote
-                val voteId = "vote_${voteData.slotId}_${voteData.participantId}"
-                val existingVote = voteQueries.selectById(voteId).executeAsOneOrNull()
-
-                if (existingVote != null) {
-                    voteQueries.deleteVote(voteId)
-                }
                 // Deja supprime : rien a faire
+                voteUpdatedAt(state, voteId) ?: return NO_WRITE
+                state.votes[voteId] = null
+                return { voteQueries.deleteVote(voteId) }
             }
         }
     }
 
+    /**
+     * Participant row as of the changes planned so far in the current run
+     */
+    private fun participant(state: SyncBatchState, key: Pair<String, String>): ParticipantRow? {
+        if (key !in state.participants) {
+            state.participants[key] = participantQueries
+                .selectByEventIdAndUserId(key.first, key.second)
+                .executeAsOneOrNull()
+        }
+        return state.participants[key]
+    }
+
+    /**
+     * Vote updatedAt as of the changes planned so far in the current run, null if there is no vote
+     */
+    private fun voteUpdatedAt(state: SyncBatchState, voteId: String): String? {
+        if (voteId !in state.votes) {
+            state.votes[voteId] = voteQueries.selectById(voteId).executeAsOneOrNull()?.updatedAt
+        }
+        return state.votes[voteId]
+    }
+
     /**
      * Recuperer les donnees serveur actuelles pour la resolution de conflits
      */
@@ -315,5 +698,64 @@ class SyncService(private val db: WakeveDb) {
     }
 }
 
+/**
+ * A client change that passed the ownership check, with its payload decoded once.
+ * [index] is the change's position in the request, used to keep conflicts in request order.
+ */
+private class DecodedSyncChange(
+    val index: Int,
+    val change: SyncChange,
+    val operation: SyncOperation,
+    val event: SyncEventData? = null,
+    val eventDelta: SyncEventDelta? = null,
+    val participant: SyncParticipantData? = null,
+    val vote: SyncVoteData? = null
+)
+
+/**
+ * Events and member user IDs loaded once per batch and kept current as changes are planned,
+ * so later changes in the same batch see earlier ones without re-querying.
+ * Participant and vote rows are only cached for the current run: its writes are not
+ * committed while it is planned, whereas earlier runs are and can be read back.
+ */
+private class SyncBatchState {
+    val events = mutableMapOf<String, EventRow?>()  // null = known not to exist
+    val members = mutableMapOf<String, MutableSet<String>>()
+    val participants = mutableMapOf<Pair<String, String>, ParticipantRow?>()  // by (eventId, userId), null = known not to exist
+    val votes = mutableMapOf<String, String?>()  // vote ID to updatedAt, null = known not to exist
+
+    fun event(id: String): EventRow? = events[id]
+
+    fun beginRun() {
+        participants.clear()
+        votes.clear()
+    }
+}
+
+/**
+ * Split into runs of consecutive changes to the same table, keeping request order
+ */
+private fun List<DecodedSyncChange>.consecutiveRunsByTable(): List<List<DecodedSyncChange>> {
+    val runs = mutableListOf<MutableList<DecodedSyncChange>>()
+    for (change in this) {
+        val run = runs.lastOrNull()
+        if (run != null && run.first().change.table == change.change.table) {
+            run += change
+        } else {
+            runs += mutableListOf(change)
+        }
+    }
+    return runs
+}
+
+// A change that validates but has nothing to write, e.g. a create for a row that already exists
+private val NO_WRITE: () -> Unit = {}
+private const val BATCH_LOOKUP_CHUNK_SIZE = 500
+
+private const val EVENTS_TABLE = "events"
+private const val PARTICIPANTS_TABLE = "participants"
+private const val LOG_DELETE = "DELETE"
+private const val MAX_PULL_LIMIT = 1000
+
 internal fun serverSyncFailureMessage(): String =
     "Sync failed. Please retry when your connection is stable."
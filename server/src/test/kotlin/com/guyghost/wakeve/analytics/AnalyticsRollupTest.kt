@@ -0,0 +1,115 @@
+package com.guyghost.wakeve.analytics
+
+import com.guyghost.wakeve.JvmDatabaseFactory
+import com.guyghost.wakeve.database.WakeveDb
+import kotlinx.datetime.LocalDate
+import kotlin.test.BeforeTest
+import kotlin.test.Test
+import kotlin.test.assertEquals
+
+/**
+ * Analytics metrics answered from the in-memory daily rollups.
+ */
+class AnalyticsRollupTest {
+    private lateinit var database: WakeveDb
+    private lateinit var rollup: AnalyticsRollup
+    private lateinit var dashboard: AnalyticsDashboard
+
+    private val today = LocalDate.parse("2026-03-31").toEpochDays().toLong()
+    private var sessionSeq = 0
+    private var funnelSeq = 0
+
+    @BeforeTest
+    fun setup() {
+        database = WakeveDb(JvmDatabaseFactory(":memory:").createDriver())
+        rollup = AnalyticsRollup(database, clock = { today * DAY_MS + 12 * 3_600_000 })
+        dashboard = AnalyticsDashboard(database, rollup)
+    }
+
+    @Test
+    fun activeUsersAndRetentionComeFromDailyBitmaps() {
+        // Cohort of three signed up a week ago; two of them came back
+        listOf("alice", "bob", "carol").forEach { signUp(it, today - 7) }
+        signUp("dave", today)
+        session("alice", today - 7)
+        session("alice", today - 3)
+        session("bob", today)
+        session("bob", today)
+        session("erin", today - 29)
+        session("frank", today - 30)
+
+        assertEquals(3, dashboard.getMAU())
+        assertEquals(1, dashboard.getDAU())
+        assertEquals(200.0 / 3, dashboard.getRetention(7), 1e-9)
+        assertEquals(1, dashboard.getMetricsSummary().newUsers)
+    }
+
+    @Test
+    fun funnelCountsEachStepOnce() {
+        repeat(4) { funnelEvent("event_started", today - 2) }
+        repeat(2) { funnelEvent("event_details_entered", today) }
+        funnelEvent("event_created", today - 400)
+
+        val funnel = dashboard.getEventCreationFunnel()
+
+        assertEquals(listOf(4, 2, 0, 1), funnel.map { it.count })
+        assertEquals(listOf(100.0, 50.0, 0.0, 0.0), funnel.map { it.conversionRate })
+    }
+
+    @Test
+    fun lateEventsReRollOnlyTheirDay() {
+        session("alice", today)
+        assertEquals(1, dashboard.getMAU())
+
+        // A session from five days ago arrives late, plus one for today
+        session("bob", today - 5)
+        session("carol", today)
+        funnelEvent("event_started", today - 5)
+        assertEquals(1, dashboard.getMAU(), "reads are served from memory until the refresh")
+
+        assertEquals(2, rollup.refreshDirtyDays())
+        assertEquals(3, dashboard.getMAU())
+        assertEquals(2, dashboard.getDAU())
+        assertEquals(1L, rollup.funnelCount("event_started"))
+        assertEquals(0, rollup.refreshDirtyDays())
+
+        database.analyticsQueries.deleteOldFunnelEvents(today * DAY_MS)
+        assertEquals(1, rollup.refreshDirtyDays())
+        assertEquals(0L, rollup.funnelCount("event_started"))
+    }
+
+    @Test
+    fun everyInstanceReRollsTheSameDirtyDays() {
+        val other = AnalyticsRollup(database, clock = { today * DAY_MS + 12 * 3_600_000 })
+        session("alice", today)
+        assertEquals(1, rollup.activeUsers(today, today))
+        assertEquals(1, other.activeUsers(today, today))
+
+        session("bob", today - 2)
+
+        assertEquals(1, rollup.refreshDirtyDays())
+        assertEquals(1, other.refreshDirtyDays(), "the first refresh must not consume the change")
+        assertEquals(2, other.activeUsers(today - 2, today))
+        assertEquals(0, rollup.refreshDirtyDays())
+        assertEquals(0, other.refreshDirtyDays())
+    }
+
+    private fun signUp(userId: String, day: Long) {
+        database.userQueries.insertUser(
+            userId, "provider-$userId", "$userId@example.com", userId, null, "google", "USER",
+            "${LocalDate.fromEpochDays(day.toInt())}T09:00:00Z", "${LocalDate.fromEpochDays(day.toInt())}T09:00:00Z"
+        )
+    }
+
+    private fun session(userId: String, day: Long) {
+        database.analyticsQueries.insertSession("session-${sessionSeq++}", userId, day * DAY_MS + 60_000, "web")
+    }
+
+    private fun funnelEvent(eventType: String, day: Long) {
+        database.analyticsQueries.insertFunnelEvent("funnel-${funnelSeq++}", "alice", eventType, day * DAY_MS, null)
+    }
+
+    private companion object {
+        const val DAY_MS = 86_400_000L
+    }
+}
@@ -0,0 +1,151 @@
+package com.guyghost.wakeve.analytics
+
+import app.cash.sqldelight.db.SqlDriver
+import com.guyghost.wakeve.JvmDatabaseFactory
+import com.guyghost.wakeve.database.WakeveDb
+import com.guyghost.wakeve.models.Event
+import com.guyghost.wakeve.models.EventStatus
+import com.guyghost.wakeve.models.TimeSlot
+import com.guyghost.wakeve.repository.DatabaseEventRepository
+import kotlinx.coroutines.runBlocking
+import kotlin.test.BeforeTest
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertNull
+
+/**
+ * Dashboard counters maintained by triggers, and their rebuild.
+ */
+class DashboardStatsTest {
+    private lateinit var driver: SqlDriver
+    private lateinit var database: WakeveDb
+    private lateinit var eventRepository: DatabaseEventRepository
+
+    @BeforeTest
+    fun setup() {
+        driver = JvmDatabaseFactory(":memory:").createDriver()
+        database = WakeveDb(driver)
+        eventRepository = DatabaseEventRepository(database)
+    }
+
+    @Test
+    fun countersFollowWrites() = runBlocking {
+        createEvent("event-1", slots = 2)
+        createEvent("event-2", slots = 1, status = EventStatus.POLLING)
+        addParticipant("event-1", "alice")
+        addParticipant("event-1", "bob")
+        addParticipant("event-2", "carol")
+        addVote("event-1", "slot-event-1-0", "alice")
+        addVote("event-1", "slot-event-1-1", "bob")
+        addComment("event-1", "comment-1")
+        addComment("event-2", "comment-2")
+
+        // Each event also has its organizer as a participant
+        assertOrganizerStats(events = 2, participants = 5, votes = 2, comments = 2)
+        assertEquals(mapOf("DRAFT" to 1L, "POLLING" to 1L), statusCounts())
+        val event1 = eventRow("event-1")
+        assertEquals(listOf(3L, 2L, 1L, 2L), listOf(event1.participantCount, event1.voteCount, event1.commentCount, event1.timeSlotCount))
+
+        database.commentQueries.softDeleteComment("2026-01-02T00:00:00Z", "comment-1")
+        database.eventQueries.updateEventStatus("POLLING", "2026-01-02T00:00:00Z", "event-1")
+        assertOrganizerStats(events = 2, participants = 5, votes = 2, comments = 1)
+        assertEquals(mapOf("POLLING" to 2L), statusCounts())
+
+        eventRepository.deleteEvent("event-1").getOrThrow()
+        assertOrganizerStats(events = 1, participants = 2, votes = 0, comments = 1)
+        assertNull(database.dashboardQueries.selectEventAnalytics(ORGANIZER).executeAsList().find { it.eventId == "event-1" })
+    }
+
+    @Test
+    fun organizerChangeMovesCounters() = runBlocking {
+        createEvent("event-1", slots = 1)
+        addParticipant("event-1", "alice")
+
+        database.eventQueries.anonymizeOrganizer("deleted-user", "2026-01-02T00:00:00Z", ORGANIZER)
+
+        assertOrganizerStats(events = 0, participants = 0, votes = 0, comments = 0)
+        val moved = database.dashboardQueries.selectOrganizerStats("deleted-user").executeAsOne()
+        assertEquals(1L, moved.eventCount)
+        assertEquals(2L, moved.participantCount)
+    }
+
+    @Test
+    fun rebuildRepairsDrift() = runBlocking {
+        createEvent("event-1", slots = 1)
+        addParticipant("event-1", "alice")
+        addComment("event-1", "comment-1")
+        assertEquals(DashboardStatsRebuilder.Result(organizers = 1, repairedOrganizers = 0), DashboardStatsRebuilder(database).rebuild())
+
+        // Simulate drift, e.g. rows restored from a backup with triggers off
+        driver.execute(null, "UPDATE organizerDashboardStats SET participantCount = 40, commentCount = 0", 0)
+        driver.execute(null, "UPDATE eventDashboardStats SET timeSlotCount = 9", 0)
+
+        val result = DashboardStatsRebuilder(database).rebuild()
+
+        assertEquals(1, result.repairedOrganizers)
+        assertOrganizerStats(events = 1, participants = 2, votes = 0, comments = 1)
+        assertEquals(1L, eventRow("event-1").timeSlotCount)
+    }
+
+    private fun assertOrganizerStats(events: Long, participants: Long, votes: Long, comments: Long) {
+        val stats = database.dashboardQueries.selectOrganizerStats(ORGANIZER).executeAsOneOrNull()
+        assertEquals(
+            listOf(events, participants, votes, comments),
+            listOf(stats?.eventCount ?: 0L, stats?.participantCount ?: 0L, stats?.voteCount ?: 0L, stats?.commentCount ?: 0L)
+        )
+    }
+
+    private fun statusCounts(): Map<String, Long> =
+        database.dashboardQueries.selectOrganizerStatusCounts(ORGANIZER).executeAsList()
+            .associate { it.status to it.eventCount }
+
+    private fun eventRow(eventId: String) =
+        database.dashboardQueries.selectEventAnalytics(ORGANIZER).executeAsList().single { it.eventId == eventId }
+
+    private suspend fun createEvent(eventId: String, slots: Int, status: EventStatus = EventStatus.DRAFT) {
+        eventRepository.createEvent(
+            Event(
+                id = eventId,
+                title = "Event $eventId",
+                description = "Dashboard stats event",
+                organizerId = ORGANIZER,
+                participants = emptyList(),
+                proposedSlots = List(slots) { index ->
+                    TimeSlot(
+                        id = "slot-$eventId-$index",
+                        start = "2026-07-0${index + 1}T10:00:00Z",
+                        end = "2026-07-0${index + 1}T12:00:00Z",
+                        timezone = "UTC"
+                    )
+                },
+                deadline = "2026-06-20T00:00:00Z",
+                status = status,
+                createdAt = "2026-06-01T00:00:00Z",
+                updatedAt = "2026-06-01T00:00:00Z"
+            )
+        ).getOrThrow()
+    }
+
+    private fun addParticipant(eventId: String, userId: String) {
+        database.participantQueries.insertParticipant(
+            "part-$eventId-$userId", eventId, userId, "PARTICIPANT", 0, "2026-06-02T00:00:00Z", "2026-06-02T00:00:00Z"
+        )
+    }
+
+    private fun addVote(eventId: String, slotId: String, userId: String) {
+        database.voteQueries.insertVote(
+            "vote-$slotId-$userId", eventId, slotId, "part-$eventId-$userId", "YES", "2026-06-03T00:00:00Z", "2026-06-03T00:00:00Z"
+        )
+    }
+
+    private fun addComment(eventId: String, commentId: String) {
+        database.commentQueries.insertComment(
+            commentId, eventId, "GENERAL", null, "alice", "Alice", "Hello", null, null,
+            0, 0, "2026-06-04T00:00:00Z", null, 0, 0, "APPROVED"
+        )
+    }
+
+    private companion object {
+        const val ORGANIZER = "organizer-1"
+    }
+}
@@ -0,0 +1,153 @@
+package com.guyghost.wakeve.auth
+
+import com.guyghost.wakeve.JvmTestDatabaseFactory
+import com.guyghost.wakeve.SessionManager
+import com.guyghost.wakeve.cache.JwtBlacklistCache
+import com.guyghost.wakeve.database.DatabaseProvider
+import com.guyghost.wakeve.database.WakeveDb
+import com.guyghost.wakeve.util.sha256Hash
+import kotlinx.coroutines.runBlocking
+import org.junit.After
+import org.junit.Before
+import org.junit.Test
+import java.time.Instant
+import kotlin.test.assertEquals
+import kotlin.test.assertFalse
+import kotlin.test.assertTrue
+
+/**
+ * Revocations reach every instance's in-memory blacklist through the bus,
+ * other servers pick them up from the table, and a restarted instance
+ * recovers them from the table.
+ */
+class TokenRevocationBusTest {
+
+    private lateinit var database: WakeveDb
+    private val bus = LocalTokenRevocationBus()
+
+    // Two server instances sharing the bus
+    private val instanceA = JwtBlacklistCache()
+    private val instanceB = JwtBlacklistCache()
+
+    @Before
+    fun setup() {
+        database = DatabaseProvider.getDatabase(JvmTestDatabaseFactory())
+        bus.subscribe(instanceA::recordRevoked)
+        bus.subscribe(instanceB::recordRevoked)
+    }
+
+    @After
+    fun teardown() {
+        DatabaseProvider.resetDatabase()
+    }
+
+    @Test
+    fun `revoking a session blacklists its token on every instance`() = runBlocking {
+        val sessionManager = SessionManager(database, bus::publish)
+        val sessionId = createSession("token-1")
+        assertFalse(instanceB.isBlacklisted("token-1"))
+
+        sessionManager.revokeSession(sessionId).getOrThrow()
+
+        assertTrue(instanceA.isBlacklisted("token-1"))
+        assertTrue(instanceB.isBlacklisted("token-1"))
+        assertFalse(instanceB.isBlacklisted("token-2"))
+    }
+
+    @Test
+    fun `revoking all sessions publishes every token`() = runBlocking {
+        val repository = SessionRepository(database, bus::publish)
+        createSession("token-1")
+        createSession("token-2")
+
+        repository.revokeAllUserSessions("user-1").getOrThrow()
+
+        assertTrue(instanceA.isBlacklisted("token-1"))
+        assertTrue(instanceA.isBlacklisted("token-2"))
+    }
+
+    @Test
+    fun `restarted instance warms up from the blacklist table`() = runBlocking {
+        SessionRepository(database, bus::publish).revokeJwtToken(
+            jwtToken = "deleted-account-token",
+            userId = "user-1",
+            reason = "account_deleted",
+            expiresAt = Instant.now().plusSeconds(3600).toString()
+        ).getOrThrow()
+
+        val restarted = JwtBlacklistCache()
+        restarted.loadRevoked(SessionRepository(database).getRevokedTokens().getOrThrow())
+
+        assertTrue(restarted.isBlacklisted("deleted-account-token"))
+    }
+
+    @Test
+    fun `revocation on another server reaches this one through the blacklist table`() = runBlocking {
+        // Separate processes: nothing shared but the database
+        val busA = DatabaseTokenRevocationBus(SessionRepository(database))
+        val busB = DatabaseTokenRevocationBus(SessionRepository(database))
+        val serverA = JwtBlacklistCache().also { busA.subscribe(it::recordRevoked) }
+        val serverB = JwtBlacklistCache().also { busB.subscribe(it::recordRevoked) }
+        val pollStartedAt = System.currentTimeMillis()
+
+        SessionRepository(database, busA::publish).revokeJwtToken(
+            jwtToken = "token-revoked-on-a",
+            userId = "user-1",
+            reason = "logout",
+            expiresAt = Instant.now().plusSeconds(3600).toString()
+        ).getOrThrow()
+        assertTrue(serverA.isBlacklisted("token-revoked-on-a"))
+        assertFalse(serverB.isBlacklisted("token-revoked-on-a"))
+
+        busB.pollOnce(pollStartedAt)
+
+        assertTrue(serverB.isBlacklisted("token-revoked-on-a"))
+    }
+
+    @Test
+    fun `failed poll keeps the previous watermark`() = runBlocking {
+        val bus = DatabaseTokenRevocationBus(
+            loadRevokedSince = { Result.failure(IllegalStateException("database unavailable")) },
+            clock = { 50_000L }
+        )
+
+        assertEquals(10_000L, bus.pollOnce(10_000L))
+    }
+
+    @Test
+    fun `entries are dropped once the token expires`() {
+        var now = 1_000L
+        val cache = JwtBlacklistCache(clock = { now })
+        cache.recordRevoked(RevokedTokenData(sha256Hash("short"), "2000"))
+        cache.recordRevoked(RevokedTokenData(sha256Hash("long"), "9000"))
+
+        now = 2_001
+        assertEquals(1, cache.purgeExpired())
+
+        assertFalse(cache.isBlacklisted("short"))
+        assertTrue(cache.isBlacklisted("long"))
+        assertEquals(1, cache.size)
+    }
+
+    @Test
+    fun `unsubscribed listener stops receiving revocations`() {
+        val received = mutableListOf<RevokedTokenData>()
+        val unsubscribe = bus.subscribe { received += it }
+
+        bus.publish(RevokedTokenData("hash-1", "0"))
+        unsubscribe()
+        bus.publish(RevokedTokenData("hash-2", "0"))
+
+        assertEquals(listOf("hash-1"), received.map { it.tokenHash })
+    }
+
+    private suspend fun createSession(jwtToken: String): String =
+        SessionRepository(database).createSession(
+            userId = "user-1",
+            deviceId = "device-$jwtToken",
+            deviceName = "Device",
+            jwtToken = jwtToken,
+            refreshToken = "refresh-$jwtToken",
+            expiresAt = (System.currentTimeMillis() + 3_600_000).toString()
+        ).getOrThrow()
+}
@@ -0,0 +1,196 @@
+package com.guyghost.wakeve.cache
+
+import com.guyghost.wakeve.auth.RevokedTokenData
+import com.guyghost.wakeve.util.sha256Hash
+import kotlinx.coroutines.runBlocking
+import kotlinx.coroutines.sync.Mutex
+import kotlinx.coroutines.sync.withLock
+import java.util.concurrent.CountDownLatch
+import java.util.concurrent.atomic.AtomicLong
+import kotlin.random.Random
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFalse
+import kotlin.test.assertTrue
+
+/**
+ * JWT blacklist checks under 64 concurrent request threads, plus the
+ * correctness guarantees the in-memory revocation set must keep.
+ */
+class JwtBlacklistCacheBenchmarkTest {
+
+    @Test
+    fun revokedTokenIsNeverMissed() {
+        val revoked = (0 until 1_000).map { "revoked-$it" }
+        val cache = JwtBlacklistCache()
+        cache.loadRevoked(revoked.map { RevokedTokenData(sha256Hash(it), FAR_FUTURE) })
+
+        revoked.forEach { token ->
+            assertTrue(cache.isBlacklisted(token), "Revoked token $token was let through")
+        }
+    }
+
+    @Test
+    fun filterAnswersMostValidTokens() {
+        val cache = JwtBlacklistCache()
+        cache.loadRevoked(listOf(RevokedTokenData(sha256Hash("revoked"), FAR_FUTURE)))
+
+        repeat(1_000) { i -> assertFalse(cache.isBlacklisted("valid-$i")) }
+
+        assertTrue(cache.metrics.getFilterNegativeCount() >= 990.0)
+    }
+
+    @Test
+    fun revocationAfterLoadIsSeen() {
+        val cache = JwtBlacklistCache()
+        cache.loadRevoked(emptyList())
+        assertFalse(cache.isBlacklisted("late"))
+
+        cache.recordRevoked(RevokedTokenData(sha256Hash("late"), FAR_FUTURE))
+
+        assertTrue(cache.isBlacklisted("late"))
+    }
+
+    @Test
+    fun filterGrowsPastItsInitialCapacity() {
+        val cache = JwtBlacklistCache()
+        val revoked = (0 until 25_000).map { "revoked-$it" }
+        revoked.forEach { cache.recordRevoked(RevokedTokenData(sha256Hash(it), FAR_FUTURE)) }
+
+        assertTrue(revoked.all(cache::isBlacklisted))
+        assertEquals(25_000, cache.metrics.getRevokedTokenCount())
+    }
+
+    @Test
+    fun isoExpiryIsParsed() {
+        val cache = JwtBlacklistCache()
+        cache.loadRevoked(
+            listOf(
+                RevokedTokenData(sha256Hash("expired"), "2000-01-01T00:00:00Z"),
+                RevokedTokenData(sha256Hash("live"), "2999-01-01T00:00:00Z")
+            )
+        )
+
+        assertFalse(cache.isBlacklisted("expired"))
+        assertTrue(cache.isBlacklisted("live"))
+    }
+
+    @Test
+    fun benchmarkBlacklistCheck_64Threads() {
+        val activeTokens = List(ACTIVE_TOKENS) { "header.payload-$it.signature-${Random.nextLong()}" }
+        val revokedHashes = activeTokens.filterIndexed { i, _ -> i % 100 == 0 }.map(::sha256Hash).toSet()
+        val database = FakeBlacklistDatabase(revokedHashes)
+
+        val baseline = MutexLruBlacklistCache()
+        val baselineResult = measure(activeTokens) { token ->
+            baseline.isBlacklisted(token, database::isTokenBlacklisted)
+        }
+        val baselineLookups = database.lookups.getAndSet(0)
+
+        val cache = JwtBlacklistCache()
+        cache.loadRevoked(revokedHashes.map { RevokedTokenData(it, FAR_FUTURE) })
+        val inMemoryResult = measure(activeTokens) { token -> cache.isBlacklisted(token) }
+        val inMemoryLookups = database.lookups.get()
+
+        val metrics = cache.metrics
+        println("\n=== JWT Blacklist Check Benchmark ($THREADS threads, $ACTIVE_TOKENS active tokens) ===")
+        println("Mutex + LRU cache over database: ${baselineResult.opsPerSec.toLong()} checks/sec, $baselineLookups database lookups")
+        println("In-memory revocation set + filter: ${inMemoryResult.opsPerSec.toLong()} checks/sec, $inMemoryLookups database lookups")
+        println("Speedup: ${"%.1f".format(inMemoryResult.opsPerSec / baselineResult.opsPerSec)}x")
+        println(
+            "Filter negatives: ${metrics.getFilterNegativeCount().toLong()}, " +
+                "revoked hits: ${metrics.getRevokedHitCount().toLong()}, " +
+                "false-positive rate: ${"%.5f".format(metrics.getFalsePositiveRate())}"
+        )
+
+        assertEquals(baselineResult.blacklisted, inMemoryResult.blacklisted, "Both paths must agree on every check")
+        assertEquals(0L, inMemoryLookups, "The in-memory check must never reach the database")
+        assertTrue(
+            inMemoryResult.opsPerSec > baselineResult.opsPerSec,
+            "Expected higher throughput than the mutex cache"
+        )
+    }
+
+    private class BenchmarkResult(val opsPerSec: Double, val blacklisted: Long)
+
+    /**
+     * One warm-up iteration, then the best of [MEASURED_ITERATIONS]. Each thread
+     * replays the same seeded token sequence so both caches see identical work.
+     */
+    private fun measure(tokens: List<String>, check: suspend (String) -> Boolean): BenchmarkResult {
+        runIteration(tokens, check)
+        var bestOpsPerSec = 0.0
+        var blacklisted = 0L
+        repeat(MEASURED_ITERATIONS) {
+            val (elapsedNanos, count) = runIteration(tokens, check)
+            val opsPerSec = THREADS.toLong() * CHECKS_PER_THREAD * 1e9 / elapsedNanos
+            if (opsPerSec > bestOpsPerSec) bestOpsPerSec = opsPerSec
+            blacklisted = count
+        }
+        return BenchmarkResult(bestOpsPerSec, blacklisted)
+    }
+
+    private fun runIteration(tokens: List<String>, check: suspend (String) -> Boolean): Pair<Long, Long> {
+        val gate = CountDownLatch(1)
+        val blacklisted = AtomicLong()
+        val threads = (0 until THREADS).map { t ->
+            Thread {
+                val random = Random(t)
+                gate.await()
+                var count = 0L
+                runBlocking {
+                    repeat(CHECKS_PER_THREAD) {
+                        if (check(tokens[random.nextInt(tokens.size)])) count++
+                    }
+                }
+                blacklisted.addAndGet(count)
+            }.apply { start() }
+        }
+        val begin = System.nanoTime()
+        gate.countDown()
+        threads.forEach { it.join() }
+        return (System.nanoTime() - begin) to blacklisted.get()
+    }
+
+    /**
+     * Stands in for [com.guyghost.wakeve.auth.SessionRepository.isTokenBlacklisted]:
+     * hashes the token and checks the revoked set.
+     */
+    private class FakeBlacklistDatabase(private val revokedHashes: Set<String>) {
+        val lookups = AtomicLong()
+
+        suspend fun isTokenBlacklisted(token: String): Boolean {
+            lookups.incrementAndGet()
+            return sha256Hash(token) in revokedHashes
+        }
+    }
+
+    /**
+     * The previous cache: an access-ordered LinkedHashMap behind a single mutex,
+     * keyed by the raw token.
+     */
+    private class MutexLruBlacklistCache(private val maxSize: Int = 10_000) {
+        private val cache = LinkedHashMap<String, Boolean>(maxSize, 0.75f, true)
+        private val mutex = Mutex()
+
+        suspend fun isBlacklisted(token: String, lookup: suspend (String) -> Boolean): Boolean {
+            mutex.withLock { cache[token] }?.let { return it }
+            val result = lookup(token)
+            mutex.withLock {
+                if (cache.size >= maxSize) cache.remove(cache.keys.first())
+                cache[token] = result
+            }
+            return result
+        }
+    }
+
+    private companion object {
+        const val THREADS = 64
+        const val CHECKS_PER_THREAD = 20_000
+        const val MEASURED_ITERATIONS = 3
+        const val FAR_FUTURE = "4102444800000" // 2100-01-01
+
+        // More live sessions than cache entries, as on a busy server
+        const val ACTIVE_TOKENS = 50_000
+    }
+}
@@ -0,0 +1,131 @@
+package com.guyghost.wakeve.i18n
+
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertTrue
+
+/**
+ * Compiled ServerLocalizer templates: same output as the previous
+ * replaceFirst substitution, then notification formatting throughput.
+ */
+class ServerLocalizerBenchmarkTest {
+
+    @Test
+    fun compiledTemplatesMatchSequentialSubstitution() {
+        val params = arrayOf<Any>("Alice", 42, "Birthday \"Party\"")
+        for (key in NOTIFICATION_KEYS) {
+            for (locale in ServerLocalizer.supportedLocales) {
+                val template = ServerLocalizer.t(key, locale)
+                for (count in 0..params.size) {
+                    val used = params.copyOf(count).requireNoNulls()
+                    assertEquals(legacySubstitute(template, used), ServerLocalizer.t(key, locale, *used), "$key/$locale/$count")
+                }
+            }
+        }
+    }
+
+    @Test
+    fun localesAreNormalizedAndUnknownKeysReturned() {
+        assertEquals("Nouveau vote", ServerLocalizer.t("notification.vote.title_single", "fr-FR"))
+        assertEquals("New vote", ServerLocalizer.t("notification.vote.title_single", "EN_us"))
+        assertEquals("Nouveau vote", ServerLocalizer.t("notification.vote.title_single", "de"))
+        assertEquals("Nouveau vote", ServerLocalizer.t("notification.vote.title_single", ""))
+        assertEquals("pt", ServerLocalizer.normalizeLocale("pt-BR"))
+        assertEquals("missing.key", ServerLocalizer.t("missing.key", "en", "x"))
+        assertEquals(-1, ServerLocalizer.keyIndex("missing.key"))
+    }
+
+    @Test
+    fun parametersAreNotRescannedForPlaceholders() {
+        // The previous implementation substituted the second parameter into the first one
+        assertEquals(
+            "100%s voted on \"Party\"",
+            ServerLocalizer.t("notification.vote.body_single", "en", "100%s", "Party")
+        )
+    }
+
+    @Test
+    fun appendToWritesIntoCallerBuilder() {
+        val builder = StringBuilder("> ")
+        val key = ServerLocalizer.keyIndex("notification.vote.body_multiple")
+
+        assertTrue(ServerLocalizer.appendTo(builder, key, ServerLocalizer.localeIndex("en"), 3, "Party"))
+
+        assertEquals("> 3 people voted on \"Party\"", builder.toString())
+    }
+
+    @Test
+    fun benchmarkNotificationFormatting_oneCore() {
+        println("\n=== ServerLocalizer Formatting Benchmark ===")
+        val names = List(1_000) { "Participant $it" }
+        val locales = listOf("fr", "en-US", "es", "it_IT", "pt-BR")
+        val body = ServerLocalizer.t("notification.vote.body_single", "fr")
+
+        // Warm up both paths
+        repeat(200_000) { i ->
+            legacyT(body, locales[i % locales.size], names[i % names.size], "Party")
+            ServerLocalizer.t("notification.vote.body_single", locales[i % locales.size], names[i % names.size], "Party")
+        }
+
+        var sink = 0
+        val legacyStart = System.nanoTime()
+        repeat(ITERATIONS) { i ->
+            sink += legacyT(body, locales[i % locales.size], names[i % names.size], "Party").length
+        }
+        val legacyNanos = System.nanoTime() - legacyStart
+
+        val start = System.nanoTime()
+        repeat(ITERATIONS) { i ->
+            sink += ServerLocalizer.t(
+                "notification.vote.body_single", locales[i % locales.size], names[i % names.size], "Party"
+            ).length
+        }
+        val nanos = System.nanoTime() - start
+
+        val legacyRate = ITERATIONS / (legacyNanos / 1e9)
+        val rate = ITERATIONS / (nanos / 1e9)
+        println("Messages formatted: $ITERATIONS (2 parameters, 5 locales) [checksum $sink]")
+        println("replaceFirst + split locale: ${"%.2f".format(legacyRate / 1e6)}M/s")
+        println("Compiled templates: ${"%.2f".format(rate / 1e6)}M/s (${"%.1f".format(rate / legacyRate)}x)")
+        println("Target: millions of messages per second on one core, faster than replaceFirst")
+
+        assertTrue(rate > legacyRate, "Compiled templates were not faster (${rate / legacyRate}x)")
+    }
+
+    // Previous implementation: locale split on every call, one replaceFirst per parameter
+    private fun legacyT(template: String, locale: String, vararg params: Any): String {
+        val code = locale.lowercase().split("-", "_").firstOrNull() ?: "fr"
+        check(code.isNotEmpty())
+        return legacySubstitute(template, params)
+    }
+
+    private fun legacySubstitute(template: String, params: Array<out Any>): String {
+        var result = template
+        for (param in params) {
+            result = result.replaceFirst("%s", param.toString())
+        }
+        return result
+    }
+
+    private companion object {
+        const val ITERATIONS = 2_000_000
+
+        val NOTIFICATION_KEYS = listOf(
+            "notification.vote.title_single",
+            "notification.vote.title_multiple",
+            "notification.vote.body_single",
+            "notification.vote.body_multiple",
+            "notification.status.confirmed_title",
+            "notification.status.confirmed_body",
+            "notification.status.confirmed_body_with_date",
+            "notification.comment.title",
+            "notification.comment.body",
+            "notification.comment.title_multiple",
+            "notification.comment.body_multiple",
+            "notification.deadline.title",
+            "notification.deadline.body",
+            "notification.event_day.title",
+            "notification.event_day.body"
+        )
+    }
+}
@@ -0,0 +1,75 @@
+package com.guyghost.wakeve.notification
+
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.sync.Semaphore
+import kotlinx.coroutines.sync.withPermit
+import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.atomic.AtomicInteger
+import kotlin.random.Random
+
+/**
+ * In-process stand-in for FCM and APNs, for load tests of the push pipeline.
+ *
+ * Every call is one gateway request: it waits [requestLatencyMs], with at most
+ * [maxConcurrentRequests] requests in flight, and answers per token. Tokens in
+ * [invalidTokens] always fail permanently; the others fail with a retryable
+ * error their first [transientFailuresPerToken] times, then at random with
+ * [transientFailureRate].
+ */
+class FakePushGateway(
+    private val requestLatencyMs: Long = 0,
+    maxConcurrentRequests: Int = 64,
+    private val invalidTokens: Set<String> = emptySet(),
+    private val transientFailuresPerToken: Int = 0,
+    private val transientFailureRate: Double = 0.0,
+    seed: Int = 7
+) : FCMSender, APNsSender {
+    private val inFlight = Semaphore(maxConcurrentRequests)
+    private val random = Random(seed)
+    private val attemptsByToken = ConcurrentHashMap<String, AtomicInteger>()
+    private val deliveredByToken = ConcurrentHashMap<String, AtomicInteger>()
+
+    /** Gateway requests served. */
+    val requests = AtomicInteger(0)
+
+    val delivered: Int get() = deliveredByToken.values.sumOf { it.get() }
+
+    fun attempts(token: String): Int = attemptsByToken[token]?.get() ?: 0
+
+    fun deliveries(token: String): Int = deliveredByToken[token]?.get() ?: 0
+
+    override suspend fun sendNotification(
+        token: String,
+        title: String,
+        body: String,
+        data: Map<String, String>
+    ): Result<Unit> = sendMulticast(listOf(token), title, body, data).single()
+
+    override suspend fun sendMulticast(
+        tokens: List<String>,
+        title: String,
+        body: String,
+        data: Map<String, String>
+    ): List<Result<Unit>> = inFlight.withPermit {
+        requests.incrementAndGet()
+        if (requestLatencyMs > 0) delay(requestLatencyMs)
+        tokens.map(::answer)
+    }
+
+    private fun answer(token: String): Result<Unit> {
+        val attempt = attemptsByToken.computeIfAbsent(token) { AtomicInteger() }.incrementAndGet()
+        return when {
+            token in invalidTokens ->
+                Result.failure(PushDeliveryException("NotRegistered", retryable = false))
+            attempt <= transientFailuresPerToken || randomFailure() ->
+                Result.failure(PushDeliveryException("Unavailable", retryable = true))
+            else -> {
+                deliveredByToken.computeIfAbsent(token) { AtomicInteger() }.incrementAndGet()
+                Result.success(Unit)
+            }
+        }
+    }
+
+    private fun randomFailure(): Boolean =
+        transientFailureRate > 0 && synchronized(random) { random.nextDouble() } < transientFailureRate
+}
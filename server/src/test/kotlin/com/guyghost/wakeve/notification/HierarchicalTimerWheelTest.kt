@@ -0,0 +1,62 @@
+package com.guyghost.wakeve.notification
+
+import kotlin.random.Random
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertTrue
+
+class HierarchicalTimerWheelTest {
+    @Test
+    fun valuesFireOnTheFirstTickAtOrAfterTheirDeadline() {
+        val wheel = HierarchicalTimerWheel<String>(tickMillis = 1_000, slotsPerLevel = 8, levels = 2, startMillis = 0)
+        wheel.schedule(500, "half-second")
+        wheel.schedule(3_000, "three-seconds")
+        wheel.schedule(20_000, "second-level")
+        wheel.schedule(500_000, "overflow")
+        wheel.schedule(-5_000, "overdue")
+
+        assertEquals(listOf("overdue"), wheel.advanceTo(0))
+        assertEquals(listOf("half-second"), wheel.advanceTo(1_000))
+        assertEquals(emptyList(), wheel.advanceTo(2_999))
+        assertEquals(listOf("three-seconds"), wheel.advanceTo(3_000))
+        assertEquals(listOf("second-level"), wheel.advanceTo(25_000))
+        assertEquals(emptyList(), wheel.advanceTo(499_999))
+        assertEquals(listOf("overflow"), wheel.advanceTo(500_000))
+        assertEquals(0, wheel.size)
+    }
+
+    @Test
+    fun randomSchedulesNeverFireEarlyOrLate() {
+        val random = Random(17)
+        repeat(100) { trial ->
+            val tick = listOf(1L, 10L, 1_000L).random(random)
+            val slots = listOf(2, 4, 8).random(random)
+            val levels = random.nextInt(1, 4)
+            var now = random.nextLong(0, 10_000)
+            val wheel = HierarchicalTimerWheel<Int>(tickMillis = tick, slotsPerLevel = slots, levels = levels, startMillis = now)
+            val pending = HashMap<Int, Long>()
+            var nextId = 0
+            var span = tick
+            repeat(levels + 1) { span *= slots }
+
+            repeat(400) {
+                repeat(random.nextInt(0, 4)) {
+                    val deadline = now + random.nextLong(-50, span * 2)
+                    wheel.schedule(deadline, nextId)
+                    pending[nextId++] = deadline
+                }
+                now += random.nextLong(0, tick * 3)
+
+                wheel.advanceTo(now).forEach { id ->
+                    assertTrue(pending.getValue(id) <= now, "trial $trial fired $id early")
+                    pending.remove(id)
+                }
+                pending.forEach { (id, deadline) ->
+                    // Still pending only if its first tick at or after the deadline is ahead
+                    assertTrue(Math.floorDiv(deadline + tick - 1, tick) > Math.floorDiv(now, tick), "trial $trial missed $id")
+                }
+            }
+            assertEquals(pending.size, wheel.size)
+        }
+    }
+}
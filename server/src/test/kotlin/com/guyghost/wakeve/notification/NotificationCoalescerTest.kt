@@ -0,0 +1,86 @@
+package com.guyghost.wakeve.notification
+
+import kotlinx.coroutines.runBlocking
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertTrue
+
+class NotificationCoalescerTest {
+    private var now = 0L
+    private val flushed = mutableListOf<CoalescedBatch>()
+    private val coalescer = NotificationCoalescer(flush = { flushed += it }, clock = { now })
+
+    @Test
+    fun itemsOfOneKeyAreFlushedTogetherWhenTheWindowEnds() = runBlocking {
+        val organizer = CoalescingKey("organizer", "event-1", CoalescingCategory.VOTE)
+        val otherEvent = CoalescingKey("organizer", "event-2", CoalescingCategory.VOTE)
+        coalescer.add(organizer, "Party", "fr", mapOf("voterName" to "Alice"))
+        now += 60_000
+        coalescer.add(organizer, "Party", "fr", mapOf("voterName" to "Bob"))
+        coalescer.add(otherEvent, "Dinner", "fr", mapOf("voterName" to "Carol"))
+
+        now = CoalescingCategory.VOTE.windowMs - 1
+        assertEquals(0, coalescer.flushDue())
+
+        now = CoalescingCategory.VOTE.windowMs
+        assertEquals(1, coalescer.flushDue())
+        assertEquals(listOf("Alice", "Bob"), flushed.single().items.map { it["voterName"] })
+        assertEquals(2, flushed.single().count)
+
+        now += 60_000
+        assertEquals(1, coalescer.flushDue())
+        assertEquals("event-2", flushed.last().key.eventId)
+        assertEquals(0, coalescer.openBatchCount)
+    }
+
+    @Test
+    fun busyKeyFlushesAtMostTwicePerWindow() = runBlocking {
+        val key = CoalescingKey("participant", "event-1", CoalescingCategory.COMMENT)
+        val maxBatch = CoalescingCategory.COMMENT.maxBatchSize
+
+        repeat(maxBatch * 10) { i ->
+            coalescer.add(key, "Party", "en", mapOf("authorName" to "Author $i"))
+            now += 100
+        }
+        // The first full batch went out at once, the rest waits for the window
+        assertEquals(1, flushed.size)
+        assertEquals(maxBatch, flushed.single().count)
+
+        now = CoalescingCategory.COMMENT.windowMs * 2
+        coalescer.flushDue()
+        assertEquals(2, flushed.size)
+        assertEquals(maxBatch * 9, flushed.last().count)
+        assertEquals(maxBatch, flushed.last().items.size)
+        assertEquals("Author ${maxBatch * 10 - 1}", flushed.last().latest["authorName"])
+    }
+
+    @Test
+    fun flushAllSendsOpenBatchesBeforeTheirWindowEnds() = runBlocking {
+        val vote = CoalescingKey("organizer", "event-1", CoalescingCategory.VOTE)
+        val comment = CoalescingKey("participant", "event-1", CoalescingCategory.COMMENT)
+        coalescer.add(vote, "Party", "fr", mapOf("voterName" to "Alice"))
+        coalescer.add(comment, "Party", "fr", mapOf("authorName" to "Bob"))
+
+        assertEquals(2, coalescer.flushAll())
+        assertEquals(setOf(vote, comment), flushed.map { it.key }.toSet())
+        assertEquals(0, coalescer.openBatchCount)
+
+        // The stale wheel entries flush nothing once their window ends
+        now = CoalescingCategory.VOTE.windowMs
+        assertEquals(0, coalescer.flushDue())
+        assertEquals(2, flushed.size)
+    }
+
+    @Test
+    fun zeroWindowDisablesCoalescing() = runBlocking {
+        val immediate = NotificationCoalescer(flush = { flushed += it }, windowMs = { 0L }, clock = { now })
+        val key = CoalescingKey("participant", "event-1", CoalescingCategory.STATUS)
+
+        immediate.add(key, "Party", "fr", mapOf("status" to "POLLING"))
+        immediate.add(key, "Party", "fr", mapOf("status" to "CONFIRMED"))
+
+        assertEquals(listOf("POLLING", "CONFIRMED"), flushed.map { it.latest["status"] })
+        assertTrue(flushed.all { it.count == 1 })
+        assertEquals(0, immediate.openBatchCount)
+    }
+}
@@ -0,0 +1,151 @@
+package com.guyghost.wakeve.notification
+
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.cancel
+import kotlinx.coroutines.runBlocking
+import kotlinx.coroutines.withTimeout
+import kotlin.test.AfterTest
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertTrue
+
+/**
+ * Push delivery through [PushDeliveryPipeline] against [FakePushGateway]:
+ * coalescing and retry guarantees, then a fan-out load test compared with
+ * the previous one-request-per-token delivery.
+ */
+class PushDeliveryPipelineBenchmarkTest {
+    private val scope = CoroutineScope(SupervisorJob() + Dispatchers.Default)
+
+    @AfterTest
+    fun tearDown() {
+        scope.cancel()
+    }
+
+    @Test
+    fun identicalPayloadsAreCoalescedIntoOneRequest() = runBlocking {
+        val gateway = FakePushGateway()
+        val pipeline = PushDeliveryPipeline(gateway, gateway, workersPerPlatform = 1)
+
+        // Queued before the workers start, so they are drained as one batch
+        pipeline.fcm.sendMulticast(listOf("a1", "a2"), "Confirmed", "Event", mapOf("eventId" to "e1"))
+        pipeline.fcm.sendNotification("a3", "Confirmed", "Event", mapOf("eventId" to "e1"))
+        pipeline.fcm.sendNotification("a4", "Cancelled", "Event", mapOf("eventId" to "e2"))
+        pipeline.start(scope)
+        withTimeout(TIMEOUT_MS) { pipeline.awaitIdle() }
+
+        assertEquals(2, gateway.requests.get())
+        assertEquals(4, gateway.delivered)
+        assertEquals(4.0, pipeline.metrics.getSentCount())
+        assertEquals(2.0, pipeline.metrics.getMeanBatchSize())
+    }
+
+    @Test
+    fun transientFailuresAreRetriedUntilDelivered() = runBlocking {
+        val gateway = FakePushGateway(transientFailuresPerToken = 2)
+        val pipeline = PushDeliveryPipeline(gateway, gateway, maxAttempts = 3, baseBackoffMs = 1, maxBackoffMs = 5)
+        pipeline.start(scope)
+
+        pipeline.apns.sendMulticast(listOf("i1", "i2", "i3"), "Deadline", "Soon", emptyMap())
+        withTimeout(TIMEOUT_MS) { pipeline.awaitIdle() }
+
+        listOf("i1", "i2", "i3").forEach { token ->
+            assertEquals(3, gateway.attempts(token))
+            assertEquals(1, gateway.deliveries(token))
+        }
+        assertEquals(6.0, pipeline.metrics.getRetriedCount())
+        assertEquals(0.0, pipeline.metrics.getFailedCount())
+        assertEquals(0, pipeline.metrics.getPendingCount())
+    }
+
+    @Test
+    fun permanentFailuresAndExhaustedRetriesAreDropped() = runBlocking {
+        val gateway = FakePushGateway(invalidTokens = setOf("stale"), transientFailuresPerToken = 5)
+        val pipeline = PushDeliveryPipeline(gateway, gateway, maxAttempts = 2, baseBackoffMs = 1, maxBackoffMs = 5)
+        pipeline.start(scope)
+
+        pipeline.fcm.sendMulticast(listOf("stale", "flaky"), "Title", "Body", emptyMap())
+        withTimeout(TIMEOUT_MS) { pipeline.awaitIdle() }
+
+        assertEquals(1, gateway.attempts("stale"))
+        assertEquals(2, gateway.attempts("flaky"))
+        assertEquals(2.0, pipeline.metrics.getFailedCount())
+        assertEquals(0, gateway.delivered)
+    }
+
+    @Test
+    fun drainDeliversAcceptedPushesBeforeShutdown() = runBlocking {
+        val gateway = FakePushGateway(requestLatencyMs = GATEWAY_LATENCY_MS)
+        val pipeline = PushDeliveryPipeline(gateway, gateway, workersPerPlatform = 1, maxBatchSize = 10)
+        pipeline.start(scope)
+
+        pipeline.fcm.sendMulticast(List(100) { "a$it" }, "Reminder", "Tomorrow", emptyMap())
+
+        assertEquals(0, pipeline.drain(TIMEOUT_MS))
+        assertEquals(100, gateway.delivered)
+    }
+
+    @Test
+    fun drainGivesUpAfterTheTimeout() = runBlocking {
+        val gateway = FakePushGateway()
+        val pipeline = PushDeliveryPipeline(gateway, gateway)
+
+        // No workers: nothing can be delivered
+        pipeline.apns.sendMulticast(listOf("i1", "i2"), "Title", "Body", emptyMap())
+
+        assertEquals(2, pipeline.drain(50))
+    }
+
+    @Test
+    fun benchmarkFanOut_20kTokens() = runBlocking {
+        println("\n=== Push Delivery Pipeline Benchmark ===")
+
+        // Previous delivery: one gateway request per token, awaited in turn
+        val baselineGateway = FakePushGateway(requestLatencyMs = GATEWAY_LATENCY_MS)
+        val baselineStart = System.nanoTime()
+        repeat(BASELINE_TOKENS) { i ->
+            baselineGateway.sendNotification("token-$i", "Event confirmed", "Event $i", mapOf("eventId" to "event-$i"))
+        }
+        val baselineSeconds = (System.nanoTime() - baselineStart) / 1e9
+        val baselineRate = BASELINE_TOKENS / baselineSeconds
+
+        val gateway = FakePushGateway(requestLatencyMs = GATEWAY_LATENCY_MS, transientFailureRate = 0.05)
+        val pipeline = PushDeliveryPipeline(gateway, gateway, maxAttempts = 5, baseBackoffMs = 5, maxBackoffMs = 50)
+        pipeline.start(scope)
+
+        val start = System.nanoTime()
+        repeat(EVENTS) { event ->
+            val tokens = List(TOKENS_PER_EVENT) { "event-$event-token-$it" }
+            val (android, ios) = tokens.partition { it.hashCode() % 2 == 0 }
+            val data = mapOf("eventId" to "event-$event")
+            pipeline.fcm.sendMulticast(android, "Event confirmed", "Event $event", data)
+            pipeline.apns.sendMulticast(ios, "Event confirmed", "Event $event", data)
+        }
+        withTimeout(TIMEOUT_MS) { pipeline.awaitIdle() }
+        val seconds = (System.nanoTime() - start) / 1e9
+        val rate = EVENTS * TOKENS_PER_EVENT / seconds
+        val p99 = pipeline.metrics.getP99LatencyMillis()
+
+        println("Gateway latency: ${GATEWAY_LATENCY_MS}ms per request, 5% transient failures")
+        println("Per-token baseline: $BASELINE_TOKENS pushes, ${"%.0f".format(baselineRate)} sends/sec")
+        println("Pipeline: ${EVENTS * TOKENS_PER_EVENT} pushes in ${gateway.requests.get()} requests")
+        println("Pipeline throughput: ${"%.0f".format(rate)} sends/sec (${"%.1f".format(rate / baselineRate)}x)")
+        println("Retries: ${pipeline.metrics.getRetriedCount().toLong()}, dropped: ${pipeline.metrics.getFailedCount().toLong()}")
+        println("Enqueue-to-delivered p99: ${"%.1f".format(p99)}ms")
+        println("Target: >= 10x per-token throughput, every push delivered")
+
+        assertEquals(EVENTS * TOKENS_PER_EVENT, gateway.delivered)
+        assertTrue(gateway.requests.get() < EVENTS * TOKENS_PER_EVENT / 10, "Payloads were not coalesced")
+        assertTrue(rate >= baselineRate * 10, "Pipeline reached only ${rate / baselineRate}x the per-token rate")
+    }
+
+    private companion object {
+        const val GATEWAY_LATENCY_MS = 2L
+        const val BASELINE_TOKENS = 500
+        const val EVENTS = 200
+        const val TOKENS_PER_EVENT = 100
+        const val TIMEOUT_MS = 60_000L
+    }
+}
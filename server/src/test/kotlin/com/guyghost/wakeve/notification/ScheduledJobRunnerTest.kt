@@ -0,0 +1,209 @@
+package com.guyghost.wakeve.notification
+
+import com.guyghost.wakeve.JvmDatabaseFactory
+import com.guyghost.wakeve.database.WakeveDb
+import com.guyghost.wakeve.models.Event
+import com.guyghost.wakeve.models.EventStatus
+import com.guyghost.wakeve.models.TimeSlot
+import com.guyghost.wakeve.repository.DatabaseEventRepository
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.runBlocking
+import kotlinx.datetime.Instant
+import kotlin.test.BeforeTest
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertNull
+import kotlin.test.assertTrue
+
+/**
+ * Durable scheduled jobs: enqueued by triggers, fired once across instances.
+ */
+class ScheduledJobRunnerTest {
+    private lateinit var database: WakeveDb
+    private lateinit var eventRepository: DatabaseEventRepository
+    private var now = millis("2026-06-18T00:00:00Z")
+    private val fired = mutableListOf<String>()
+
+    @BeforeTest
+    fun setup() {
+        database = WakeveDb(JvmDatabaseFactory(":memory:").createDriver())
+        eventRepository = DatabaseEventRepository(database)
+    }
+
+    @Test
+    fun triggersEnqueueAndCancelReminders() = runBlocking {
+        createEvent("event-1", EventStatus.POLLING)
+        createEvent("event-2", EventStatus.DRAFT)
+
+        assertEquals(
+            listOf(
+                "deadline-24h-event-1" to millis("2026-06-19T00:00:00Z"),
+                "deadline-1h-event-1" to millis("2026-06-19T23:00:00Z")
+            ),
+            jobs("event-1")
+        )
+        assertEquals(emptyList(), jobs("event-2"))
+
+        database.eventQueries.updateEventStatus("CONFIRMED", "2026-06-21T00:00:00Z", "event-1")
+        database.confirmedDateQueries.insertConfirmedDate(
+            "confirmed-1", "event-1", "slot-event-1", ORGANIZER, "2026-06-21T00:00:00Z", "2026-06-21T00:00:00Z"
+        )
+        val eventDay = millis("2026-07-01T00:00:00Z")
+        assertEquals(listOf("event-day-event-1-${eventDay / DAY_MS}" to eventDay), jobs("event-1"))
+
+        eventRepository.deleteEvent("event-1").getOrThrow()
+        assertEquals(emptyList(), jobs("event-1"))
+    }
+
+    @Test
+    fun dueJobRunsOnceAcrossInstances() = runBlocking {
+        createEvent("event-1", EventStatus.POLLING)
+        val first = runner("server-a")
+        val second = runner("server-b")
+        assertEquals(0, first.runDue() + second.runDue())
+
+        now = millis("2026-06-19T00:00:00Z")
+        assertEquals(1, first.runDue() + second.runDue())
+        assertEquals(0, first.runDue() + second.runDue())
+
+        now = millis("2026-06-19T23:00:01Z")
+        assertEquals(1, second.runDue() + first.runDue())
+
+        assertEquals(listOf("deadline-24h-event-1", "deadline-1h-event-1"), fired.map { it.substringAfter(':') })
+        assertEquals(emptyList(), jobs("event-1"))
+    }
+
+    @Test
+    fun leaseOfDeadInstanceIsRetaken() = runBlocking {
+        createEvent("event-1", EventStatus.POLLING)
+        now = millis("2026-06-19T00:00:00Z")
+        // An instance claimed the job and died before completing it
+        database.scheduledJobQueries.claimJob("dead", now + 60_000, "deadline-24h-event-1", now, now)
+        val survivor = runner("server-a", refillIntervalMs = 0)
+
+        assertEquals(0, survivor.runDue())
+        now += 61_000
+        assertEquals(1, survivor.runDue())
+        assertEquals(listOf("server-a:deadline-24h-event-1"), fired)
+    }
+
+    @Test
+    fun failedJobIsRetriedThenDropped() = runBlocking {
+        createEvent("event-1", EventStatus.POLLING)
+        now = millis("2026-06-19T00:00:00Z")
+        var attempts = 0
+        val failing = ScheduledJobRunner(
+            database,
+            handler = { attempts++; error("push gateway down") },
+            clock = { now },
+            refillIntervalMs = 0,
+            maxAttempts = 2
+        )
+
+        failing.runDue()
+        assertEquals(1, attempts)
+        assertEquals(now + ScheduledJobRunner.RETRY_BACKOFF_MS, job("deadline-24h-event-1")?.fire_at)
+
+        now += ScheduledJobRunner.RETRY_BACKOFF_MS
+        failing.runDue()
+        assertEquals(2, attempts)
+        assertNull(job("deadline-24h-event-1"))
+    }
+
+    @Test
+    fun expiredJobsAreDroppedUnfired() = runBlocking {
+        createEvent("event-1", EventStatus.POLLING)
+        // Server was down through the 24h reminder's hour
+        now = millis("2026-06-19T02:00:00Z")
+
+        runner("server-a").runDue()
+
+        assertTrue(fired.isEmpty())
+        assertEquals(listOf("deadline-1h-event-1"), jobs("event-1").map { it.first })
+    }
+
+    @Test
+    fun leaseIsRenewedWhileTheHandlerRuns() = runBlocking {
+        createEvent("event-1", EventStatus.POLLING)
+        now = millis("2026-06-19T00:00:00Z")
+        val claimedAt = now
+        var leaseSeen: Long? = null
+        val slow = ScheduledJobRunner(
+            database,
+            handler = { scheduled ->
+                now += 1_000
+                delay(400)
+                leaseSeen = job(scheduled.job_key)?.lease_until
+            },
+            clock = { now },
+            refillIntervalMs = 0,
+            leaseMs = 100
+        )
+
+        assertEquals(1, slow.runDue())
+        assertEquals(claimedAt + 1_000 + 100, leaseSeen)
+    }
+
+    @Test
+    fun refillHookRunsBeforeEachRefill() = runBlocking {
+        val refills = mutableListOf<Long>()
+        val runner = ScheduledJobRunner(database, handler = {}, clock = { now }, onRefill = { refills += it })
+
+        runner.runDue()
+        runner.runDue()
+        now += ScheduledJobRunner.DEFAULT_REFILL_INTERVAL_MS
+        runner.runDue()
+
+        assertEquals(listOf(millis("2026-06-18T00:00:00Z"), now), refills)
+    }
+
+    @Test
+    fun weeklyDigestFiresMondayMorning() {
+        // Friday
+        assertEquals(millis("2026-10-19T08:00:00Z"), NotificationScheduler.nextWeeklyDigestAt(millis("2026-10-16T12:00:00Z")))
+        // Monday, inside the 8h-10h window
+        assertEquals(millis("2026-10-19T08:00:00Z"), NotificationScheduler.nextWeeklyDigestAt(millis("2026-10-19T09:30:00Z")))
+        // Monday, window over
+        assertEquals(millis("2026-10-26T08:00:00Z"), NotificationScheduler.nextWeeklyDigestAt(millis("2026-10-19T10:00:00Z")))
+    }
+
+    private fun runner(instanceId: String, refillIntervalMs: Long = ScheduledJobRunner.DEFAULT_REFILL_INTERVAL_MS) =
+        ScheduledJobRunner(
+            database,
+            handler = { job -> fired += "$instanceId:${job.job_key}" },
+            instanceId = instanceId,
+            clock = { now },
+            refillIntervalMs = refillIntervalMs
+        )
+
+    private fun jobs(eventId: String): List<Pair<String, Long>> =
+        database.scheduledJobQueries.selectJobsByEventId(eventId).executeAsList().map { it.job_key to it.fire_at }
+
+    private fun job(jobKey: String) = database.scheduledJobQueries.selectJobByKey(jobKey).executeAsOneOrNull()
+
+    private suspend fun createEvent(eventId: String, status: EventStatus) {
+        eventRepository.createEvent(
+            Event(
+                id = eventId,
+                title = "Event $eventId",
+                description = "Scheduled job event",
+                organizerId = ORGANIZER,
+                participants = emptyList(),
+                proposedSlots = listOf(
+                    TimeSlot(id = "slot-$eventId", start = "2026-07-01T18:00:00Z", end = "2026-07-01T22:00:00Z", timezone = "UTC")
+                ),
+                deadline = "2026-06-20T00:00:00Z",
+                status = status,
+                createdAt = "2026-06-01T00:00:00Z",
+                updatedAt = "2026-06-01T00:00:00Z"
+            )
+        ).getOrThrow()
+    }
+
+    private companion object {
+        const val ORGANIZER = "organizer-1"
+        const val DAY_MS = 86_400_000L
+
+        fun millis(iso: String): Long = Instant.parse(iso).toEpochMilliseconds()
+    }
+}
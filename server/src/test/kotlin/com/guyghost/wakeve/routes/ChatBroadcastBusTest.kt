@@ -0,0 +1,168 @@
+package com.guyghost.wakeve.routes
+
+import com.guyghost.wakeve.models.ChatMessageType
+import com.guyghost.wakeve.models.ChatWebSocketResponse
+import com.guyghost.wakeve.models.MessageData
+import io.ktor.websocket.Frame
+import io.ktor.websocket.readText
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.cancel
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.runBlocking
+import kotlinx.coroutines.withTimeout
+import java.util.Collections
+import kotlin.test.AfterTest
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFalse
+import kotlin.test.assertTrue
+
+class ChatBroadcastBusTest {
+    private val scope = CoroutineScope(Dispatchers.Default + SupervisorJob())
+    private val closeables = mutableListOf<AutoCloseable>()
+
+    @AfterTest
+    fun teardown() {
+        scope.cancel()
+        closeables.reversed().forEach { it.close() }
+    }
+
+    @Test
+    fun `message published on one node reaches sockets on another through the tcp broker`() = runBlocking {
+        val broker = TcpChatBroadcastBroker(SECRET).start().also { closeables += it }
+        val nodeA = EventChatConnections(bus = TcpChatBroadcastBus("127.0.0.1", broker.port, SECRET).also { closeables += it })
+        val nodeB = EventChatConnections(bus = TcpChatBroadcastBus("127.0.0.1", broker.port, SECRET).also { closeables += it })
+
+        val framesOnA = Collections.synchronizedList(mutableListOf<String>())
+        val framesOnB = Collections.synchronizedList(mutableListOf<String>())
+        nodeA.addConnection("event-1", "alice", scope, send = { framesOnA += (it as Frame.Text).readText() }, close = {})
+        nodeB.addConnection("event-1", "bob", scope, send = { framesOnB += (it as Frame.Text).readText() }, close = {})
+        // SUB commands travel asynchronously; give the broker a moment to register them
+        delay(200)
+
+        nodeA.broadcast("event-1", message("alice", "hello from A"))
+
+        withTimeout(5_000) {
+            while (framesOnA.isEmpty() || framesOnB.isEmpty()) delay(5)
+        }
+        assertTrue(framesOnB.single().contains("hello from A"))
+        assertTrue(framesOnA.single().contains("hello from A"))
+    }
+
+    @Test
+    fun `node with the wrong secret is refused by the broker`() = runBlocking {
+        val broker = TcpChatBroadcastBroker(SECRET).start().also { closeables += it }
+        val intruder = TcpChatBroadcastBus("127.0.0.1", broker.port, "x".repeat(32), reconnectMaxDelayMs = 50)
+            .also { closeables += it }
+        val node = EventChatConnections(bus = TcpChatBroadcastBus("127.0.0.1", broker.port, SECRET).also { closeables += it })
+
+        val framesOnNode = Collections.synchronizedList(mutableListOf<String>())
+        node.addConnection("event-1", "bob", scope, send = { framesOnNode += (it as Frame.Text).readText() }, close = {})
+        delay(300)
+
+        intruder.publish("event-1", ChatBusFrame("mallory", ChatMessageType.MESSAGE, false, "{}"))
+        delay(300)
+
+        assertFalse(intruder.isConnected)
+        assertTrue(framesOnNode.isEmpty())
+    }
+
+    @Test
+    fun `node reconnects and resubscribes after the broker restarts`() = runBlocking {
+        val firstBroker = TcpChatBroadcastBroker(SECRET).start()
+        val port = firstBroker.port
+        val bus = TcpChatBroadcastBus("127.0.0.1", port, SECRET, reconnectMaxDelayMs = 50).also { closeables += it }
+        val node = EventChatConnections(bus = bus)
+        val framesOnNode = Collections.synchronizedList(mutableListOf<String>())
+        node.addConnection("event-1", "bob", scope, send = { framesOnNode += (it as Frame.Text).readText() }, close = {})
+        withTimeout(5_000) { while (!bus.isConnected) delay(5) }
+
+        firstBroker.close()
+        withTimeout(5_000) { while (bus.isConnected) delay(5) }
+        val secondBroker = TcpChatBroadcastBroker(SECRET, port).start().also { closeables += it }
+        val publisher = TcpChatBroadcastBus("127.0.0.1", secondBroker.port, SECRET).also { closeables += it }
+        withTimeout(5_000) { while (!bus.isConnected || !publisher.isConnected) delay(5) }
+        delay(200)
+
+        publisher.publish("event-1", ChatBusFrame("alice", ChatMessageType.MESSAGE, false, "{\"after\":\"restart\"}"))
+
+        withTimeout(5_000) { while (framesOnNode.isEmpty()) delay(5) }
+        assertEquals("{\"after\":\"restart\"}", framesOnNode.single())
+    }
+
+    @Test
+    fun `malformed commands are ignored and the peer stays connected`() = runBlocking {
+        val broker = TcpChatBroadcastBroker(SECRET).start().also { closeables += it }
+        val socket = java.net.Socket("127.0.0.1", broker.port).also { closeables += it }
+        socket.soTimeout = 5_000
+        val reader = socket.getInputStream().bufferedReader()
+        val writer = socket.getOutputStream().bufferedWriter()
+        fun send(line: String) {
+            writer.write(line)
+            writer.newLine()
+            writer.flush()
+        }
+        val nonce = reader.readLine().removePrefix("CHALLENGE ")
+        send("AUTH ${chatBusProof(SECRET, nonce)}")
+        assertEquals("OK", reader.readLine())
+
+        listOf("SUB", "UNSUB", "PUB", "SUB ", "", "NOPE").forEach(::send)
+        send("SUB event-1")
+        val publisher = TcpChatBroadcastBus("127.0.0.1", broker.port, SECRET).also { closeables += it }
+        withTimeout(5_000) { while (!publisher.isConnected) delay(5) }
+        delay(200)
+
+        publisher.publish("event-1", frame())
+
+        assertTrue(reader.readLine().startsWith("MSG event-1 "))
+    }
+
+    @Test
+    fun `frames survive the wire encoding`() {
+        val frame = ChatBusFrame("user with spaces", ChatMessageType.TYPING, true, "{\"content\":\"a b c\"}")
+
+        val decoded = decodeChatBusFrame(encodeChatBusFrame(frame))!!
+
+        assertEquals(frame.senderId, decoded.senderId)
+        assertEquals(frame.type, decoded.type)
+        assertEquals(frame.filterBlocked, decoded.filterBlocked)
+        assertEquals(frame.payload, decoded.payload)
+    }
+
+    @Test
+    fun `node only receives events it has connections for`() {
+        val hub = InProcessChatBroadcastBus.Hub()
+        val publisher = InProcessChatBroadcastBus(hub)
+        val subscriber = InProcessChatBroadcastBus(hub)
+        val node = EventChatConnections(bus = subscriber)
+        val connectionId = node.addConnection("event-1", "bob", scope, send = {}, close = {})
+        // Observe what reaches the node's bus instead of its sockets
+        val received = mutableListOf<String>()
+        subscriber.setListener { eventId, _ -> received += eventId }
+
+        publisher.publish("event-1", frame())
+        publisher.publish("event-2", frame())
+        node.removeConnection("event-1", connectionId)
+        publisher.publish("event-1", frame())
+
+        assertEquals(listOf("event-1"), received)
+    }
+
+    private fun frame() = ChatBusFrame("alice", ChatMessageType.MESSAGE, false, "{}")
+
+    private fun message(senderId: String, content: String) = ChatWebSocketResponse(
+        type = ChatMessageType.MESSAGE,
+        data = MessageData(
+            eventId = "event-1",
+            userId = senderId,
+            userName = senderId,
+            content = content
+        )
+    )
+
+    private companion object {
+        const val SECRET = "test-chat-bus-secret-0123456789abcdef"
+    }
+}
@@ -0,0 +1,74 @@
+package com.guyghost.wakeve.routes
+
+import com.guyghost.wakeve.moderation.ModerationRepository
+import kotlinx.coroutines.runBlocking
+import kotlin.test.AfterTest
+import kotlin.test.BeforeTest
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertNotNull
+import kotlin.test.assertNull
+import kotlin.test.assertTrue
+
+class ChatMessagePaginationTest {
+    private lateinit var fixture: ChatTestFixture
+    private val database get() = fixture.database
+    private val chatService get() = fixture.chatService
+
+    @BeforeTest
+    fun setup() {
+        fixture = ChatTestFixture()
+    }
+
+    @AfterTest
+    fun teardown() {
+        fixture.close()
+    }
+
+    @Test
+    fun `cursor pages walk the whole history without gaps or duplicates`() = runBlocking {
+        // Several messages share a timestamp, so the id has to break ties
+        repeat(23) { index ->
+            fixture.insertMessage("msg-${index.toString().padStart(2, '0')}", "alice", "2026-06-13T10:00:0${index / 5}Z")
+        }
+
+        val pages = mutableListOf<ChatMessagePage>()
+        var cursor: ChatMessageCursor? = null
+        do {
+            val page = chatService.getMessagePage("event-1", limit = 5, cursor = cursor, viewerUserId = "bob")
+            pages += page
+            cursor = page.nextCursor
+        } while (cursor != null)
+
+        assertEquals(listOf(5, 5, 5, 5, 3), pages.map { it.messages.size })
+        val ids = pages.flatMap { page -> page.messages.map { it.id } }
+        assertEquals((22 downTo 0).map { "msg-${it.toString().padStart(2, '0')}" }, ids)
+    }
+
+    @Test
+    fun `blocked senders are filtered before the limit so pages stay full`() = runBlocking {
+        repeat(10) { index ->
+            val sender = if (index % 2 == 0) "mallory" else "alice"
+            fixture.insertMessage("msg-$index", sender, "2026-06-13T10:00:0${index}Z")
+        }
+        ModerationRepository(database).blockUser(id = "block-1", blockerUserId = "bob", blockedUserId = "mallory")
+
+        val first = chatService.getMessagePage("event-1", limit = 3, cursor = null, viewerUserId = "bob")
+        assertEquals(listOf("msg-9", "msg-7", "msg-5"), first.messages.map { it.id })
+        assertNotNull(first.nextCursor)
+
+        val second = chatService.getMessagePage("event-1", limit = 3, cursor = first.nextCursor, viewerUserId = "bob")
+        assertEquals(listOf("msg-3", "msg-1"), second.messages.map { it.id })
+        assertNull(second.nextCursor)
+    }
+
+    @Test
+    fun `cursor survives encoding and rejects garbage`() {
+        val cursor = ChatMessageCursor("2026-06-13T10:00:00Z", "msg-42")
+
+        assertEquals(cursor, ChatMessageCursor.decode(cursor.encode()))
+        assertTrue(cursor.encode().none { it == '=' || it == '+' || it == '/' })
+        assertNull(ChatMessageCursor.decode("not a cursor!"))
+        assertNull(ChatMessageCursor.decode(""))
+    }
+}
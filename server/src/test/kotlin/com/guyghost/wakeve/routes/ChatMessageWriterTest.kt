@@ -0,0 +1,101 @@
+package com.guyghost.wakeve.routes
+
+import com.guyghost.wakeve.JvmDatabaseFactory
+import com.guyghost.wakeve.database.WakeveDb
+import com.guyghost.wakeve.metrics.ChatPersistenceMetrics
+import com.guyghost.wakeve.models.ChatMessage
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.async
+import kotlinx.coroutines.awaitAll
+import kotlinx.coroutines.cancel
+import kotlinx.coroutines.runBlocking
+import java.io.File
+import kotlin.system.measureTimeMillis
+import kotlin.test.AfterTest
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertTrue
+
+/**
+ * Group commit of chat messages. Uses file-backed SQLite so commit cost is included.
+ */
+class ChatMessageWriterTest {
+    private val scope = CoroutineScope(Dispatchers.IO + SupervisorJob())
+    private val tempFiles = mutableListOf<File>()
+
+    @AfterTest
+    fun teardown() {
+        scope.cancel()
+        tempFiles.forEach { it.delete() }
+    }
+
+    @Test
+    fun benchmarkGroupCommit_2000Messages() = runBlocking {
+        val messageCount = 2_000
+
+        // Baseline: one transaction per message, like the previous synchronous insert
+        val baselineDb = fileDatabase()
+        val baselineWriter = ChatMessageWriter(baselineDb, scope, maxBatchSize = 1, maxBatchDelayMs = 0)
+        val baselineMs = measureTimeMillis {
+            repeat(messageCount) { i -> baselineWriter.append(message("baseline-$i")).await() }
+        }
+
+        val metrics = ChatPersistenceMetrics()
+        val db = fileDatabase()
+        val writer = ChatMessageWriter(db, scope, metrics)
+        val groupMs = measureTimeMillis {
+            (0 until messageCount).map { i ->
+                async(Dispatchers.Default) { writer.append(message("msg-$i")).await() }
+            }.awaitAll()
+        }
+
+        val baselinePerSec = messageCount * 1000.0 / baselineMs.coerceAtLeast(1)
+        val groupPerSec = messageCount * 1000.0 / groupMs.coerceAtLeast(1)
+
+        println("\n=== Chat Group Commit Benchmark ($messageCount messages) ===")
+        println("One transaction per message: ${baselineMs}ms (${baselinePerSec.toInt()} messages/sec)")
+        println("Group commit: ${groupMs}ms (${groupPerSec.toInt()} messages/sec)")
+        println(
+            "Commits: ${metrics.getCommitCount()}, mean batch ${"%.1f".format(metrics.getMeanBatchSize())}, " +
+                "max batch ${metrics.getMaxBatchSize().toInt()}"
+        )
+
+        assertEquals(messageCount.toLong(), db.chatMessagesQueries.countMessagesByEvent("event-1").executeAsOne())
+        assertEquals(messageCount.toDouble(), metrics.getPersistedCount())
+        assertEquals(0, metrics.getQueueDepth())
+        assertTrue(metrics.getMeanBatchSize() > 1.0, "Concurrent senders should share commits")
+        assertTrue(groupPerSec > baselinePerSec * 2, "Group commit should be well ahead of per-message commits")
+    }
+
+    @Test
+    fun failedRowOnlyFailsItsOwnAcknowledgement() = runBlocking {
+        val metrics = ChatPersistenceMetrics()
+        val db = fileDatabase()
+        val writer = ChatMessageWriter(db, scope, metrics, maxBatchDelayMs = 50)
+
+        val acks = listOf(message("a"), message("dup"), message("dup"), message("b")).map { writer.append(it) }
+        val results = acks.map { runCatching { it.await() } }
+
+        assertEquals(listOf(true, true, false, true), results.map { it.isSuccess })
+        assertEquals(3L, db.chatMessagesQueries.countMessagesByEvent("event-1").executeAsOne())
+        assertEquals(1.0, metrics.getFailureCount())
+        assertEquals(0, metrics.getQueueDepth())
+    }
+
+    private fun message(id: String) = ChatMessage(
+        id = id,
+        eventId = "event-1",
+        senderId = "alice",
+        senderName = "Alice",
+        content = "Message $id",
+        timestamp = "2026-06-13T10:00:00Z"
+    )
+
+    private fun fileDatabase(): WakeveDb {
+        val file = File.createTempFile("chat-writer", ".db").also { it.delete() }
+        tempFiles += file
+        return WakeveDb(JvmDatabaseFactory(file.absolutePath).createDriver())
+    }
+}
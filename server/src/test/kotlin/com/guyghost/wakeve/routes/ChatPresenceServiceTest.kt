@@ -0,0 +1,83 @@
+package com.guyghost.wakeve.routes
+
+import kotlin.concurrent.thread
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFalse
+import kotlin.test.assertTrue
+
+class ChatPresenceServiceTest {
+    private var now = 10_000L
+    private val expired = mutableListOf<String>()
+    private val presence = ChatPresenceService(
+        typingTtlMs = 3_000,
+        tickMs = 250,
+        clock = { now },
+        onTypingExpired = { _, userId, _ -> expired += userId }
+    )
+
+    @Test
+    fun `only typing transitions are reported`() {
+        assertTrue(presence.setTyping("event-1", "alice", "Alice", isTyping = true))
+        assertFalse(presence.setTyping("event-1", "alice", "Alice", isTyping = true))
+        assertTrue(presence.setTyping("event-1", "alice", "Alice", isTyping = false))
+        assertFalse(presence.setTyping("event-1", "alice", "Alice", isTyping = false))
+        assertTrue(presence.typingUsers("event-1").isEmpty())
+    }
+
+    @Test
+    fun `typing expires after the ttl unless refreshed`() {
+        presence.setTyping("event-1", "alice", "Alice", isTyping = true)
+        presence.setTyping("event-1", "bob", "Bob", isTyping = true)
+
+        now += 2_000
+        presence.setTyping("event-1", "bob", "Bob", isTyping = true)
+        now += 1_500
+        presence.advance()
+
+        assertEquals(listOf("alice"), expired)
+        assertEquals(setOf("bob"), presence.typingUsers("event-1").keys)
+        assertEquals(10_000L, presence.typingUsers("event-1").getValue("bob").startedAt)
+
+        now += 2_000
+        presence.advance()
+        assertEquals(listOf("alice", "bob"), expired)
+        assertTrue(presence.typingUsers("event-1").isEmpty())
+    }
+
+    @Test
+    fun `expiry is reported after the wheel lock is released`() {
+        var otherTickFinished = false
+        lateinit var reentrant: ChatPresenceService
+        reentrant = ChatPresenceService(
+            typingTtlMs = 3_000,
+            tickMs = 250,
+            clock = { now },
+            onTypingExpired = { _, _, _ ->
+                // A listener blocking on another tick must not deadlock with this one
+                val other = thread { reentrant.advance() }
+                other.join(1_000)
+                otherTickFinished = !other.isAlive
+            }
+        )
+        reentrant.setTyping("event-1", "alice", "Alice", isTyping = true)
+
+        now += 3_500
+        reentrant.advance()
+
+        assertTrue(otherTickFinished)
+    }
+
+    @Test
+    fun `user stays online until the last connection closes`() {
+        assertTrue(presence.userConnected("event-1", "alice"))
+        assertFalse(presence.userConnected("event-1", "alice"))
+        presence.userConnected("event-1", "bob")
+
+        assertEquals(setOf("alice", "bob"), presence.onlineUsers("event-1"))
+        assertFalse(presence.userDisconnected("event-1", "alice"))
+        assertTrue(presence.isOnline("event-1", "alice"))
+        assertTrue(presence.userDisconnected("event-1", "alice"))
+        assertEquals(setOf("bob"), presence.onlineUsers("event-1"))
+    }
+}
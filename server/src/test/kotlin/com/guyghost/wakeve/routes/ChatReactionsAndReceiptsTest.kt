@@ -0,0 +1,60 @@
+package com.guyghost.wakeve.routes
+
+import com.guyghost.wakeve.moderation.ModerationRepository
+import kotlinx.coroutines.runBlocking
+import kotlin.test.AfterTest
+import kotlin.test.BeforeTest
+import kotlin.test.Test
+import kotlin.test.assertEquals
+
+class ChatReactionsAndReceiptsTest {
+    private lateinit var fixture: ChatTestFixture
+    private val database get() = fixture.database
+    private val chatService get() = fixture.chatService
+
+    @BeforeTest
+    fun setup() {
+        fixture = ChatTestFixture()
+    }
+
+    @AfterTest
+    fun teardown() {
+        fixture.close()
+    }
+
+    @Test
+    fun `every reaction is its own row and repeats are ignored`() = runBlocking {
+        fixture.insertMessage("msg-1", "alice", "2026-06-13T10:00:00Z")
+
+        (1..50).forEach { index ->
+            chatService.addReaction("event-1", "msg-1", "user-$index", "👍")
+            chatService.addReaction("event-1", "msg-1", "user-$index", "👍")
+        }
+        chatService.addReaction("event-1", "msg-1", "user-1", "🎉")
+        chatService.removeReaction("event-1", "msg-1", "user-2", "👍")
+
+        val message = chatService.getMessage("msg-1")!!
+        assertEquals(mapOf("👍" to 49, "🎉" to 1), message.reactionCounts)
+        assertEquals(50, message.reactions.size)
+    }
+
+    @Test
+    fun `mark all as read covers visible messages from others in one pass`() = runBlocking {
+        fixture.insertMessage("msg-1", "alice", "2026-06-13T10:00:00Z")
+        fixture.insertMessage("msg-2", "bob", "2026-06-13T10:00:01Z")
+        fixture.insertMessage("msg-3", "mallory", "2026-06-13T10:00:02Z")
+        fixture.insertMessage("msg-4", "alice", "2026-06-13T10:00:03Z")
+        ModerationRepository(database).blockUser(id = "block-1", blockerUserId = "bob", blockedUserId = "mallory")
+        chatService.markAsRead("event-1", "msg-1", "bob")
+        assertEquals(1, chatService.getUnreadCount("event-1", "bob"))
+
+        chatService.markAllAsRead("event-1", "bob")
+        chatService.markAllAsRead("event-1", "bob")
+
+        assertEquals(0, chatService.getUnreadCount("event-1", "bob"))
+        val readByBob = database.chatMessagesQueries.selectReadStatusByUser("bob").executeAsList()
+        assertEquals(setOf("msg-1", "msg-4"), readByBob.map { it.message_id }.toSet())
+        assertEquals(1, chatService.getMessage("msg-4")!!.readCount)
+        assertEquals(4, chatService.getUnreadCount("event-1", "carol"))
+    }
+}
@@ -0,0 +1,86 @@
+package com.guyghost.wakeve.routes
+
+import kotlinx.coroutines.CompletableDeferred
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.cancel
+import kotlinx.coroutines.runBlocking
+import kotlinx.coroutines.withTimeout
+import kotlin.test.AfterTest
+import kotlin.test.BeforeTest
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+import kotlin.test.assertNotNull
+import kotlin.test.assertTrue
+
+class ChatServiceSendTest {
+    private val scope = CoroutineScope(Dispatchers.Default + SupervisorJob())
+    private val connections = EventChatConnections()
+    private lateinit var fixture: ChatTestFixture
+
+    @BeforeTest
+    fun setup() {
+        fixture = ChatTestFixture(connections)
+    }
+
+    @AfterTest
+    fun teardown() {
+        scope.cancel()
+        fixture.close()
+    }
+
+    @Test
+    fun `message is committed before it is broadcast`() = runBlocking {
+        val storedWhenBroadcast = CompletableDeferred<Boolean>()
+        connections.addConnection(
+            eventId = ChatTestFixture.EVENT_ID,
+            userId = "bob",
+            scope = scope,
+            send = {
+                val stored = fixture.database.chatMessagesQueries
+                    .selectMessagesByEvent(ChatTestFixture.EVENT_ID)
+                    .executeAsList()
+                    .isNotEmpty()
+                storedWhenBroadcast.complete(stored)
+            },
+            close = {}
+        )
+
+        val message = fixture.chatService.sendMessage(
+            eventId = ChatTestFixture.EVENT_ID,
+            userId = "alice",
+            userName = "Alice",
+            content = "Hello"
+        )
+
+        assertNotNull(message)
+        assertTrue(withTimeout(5_000) { storedWhenBroadcast.await() })
+    }
+
+    @Test
+    fun `shutdown commits queued messages and refuses new ones`() = runBlocking {
+        fixture.chatService.sendMessage(
+            eventId = ChatTestFixture.EVENT_ID,
+            userId = "alice",
+            userName = "Alice",
+            content = "Before shutdown"
+        )
+
+        fixture.chatService.shutdown()
+
+        assertFailsWith<ChatServiceException> {
+            fixture.chatService.sendMessage(
+                eventId = ChatTestFixture.EVENT_ID,
+                userId = "alice",
+                userName = "Alice",
+                content = "After shutdown"
+            )
+        }
+        val stored = fixture.database.chatMessagesQueries
+            .selectMessagesByEvent(ChatTestFixture.EVENT_ID)
+            .executeAsList()
+        assertEquals(listOf("Before shutdown"), stored.map { it.content })
+    }
+}
@@ -0,0 +1,57 @@
+package com.guyghost.wakeve.routes
+
+import com.guyghost.wakeve.JvmDatabaseFactory
+import com.guyghost.wakeve.database.DatabaseProvider
+import com.guyghost.wakeve.database.WakeveDb
+import com.guyghost.wakeve.moderation.ModerationRepository
+
+/**
+ * In-memory database and chat service shared by the chat service tests.
+ * Create one per test and close it in teardown.
+ */
+internal class ChatTestFixture(
+    eventConnections: EventChatConnections = EventChatConnections()
+) : AutoCloseable {
+    val database: WakeveDb
+    val chatService: ChatService
+
+    init {
+        DatabaseProvider.resetDatabase()
+        database = DatabaseProvider.getDatabase(JvmDatabaseFactory(":memory:"))
+        chatService = ChatService(
+            database,
+            eventConnections = eventConnections,
+            moderationRepository = ModerationRepository(database)
+        )
+    }
+
+    /** Inserts an approved, already sent message straight into the table. */
+    fun insertMessage(id: String, senderId: String, timestamp: String, eventId: String = EVENT_ID) {
+        database.chatMessagesQueries.insertMessageMinimal(
+            id = id,
+            event_id = eventId,
+            sender_id = senderId,
+            sender_name = senderId,
+            sender_avatar_url = null,
+            content = "Message $id",
+            section = null,
+            section_item_id = null,
+            parent_message_id = null,
+            timestamp = timestamp,
+            status = "SENT",
+            is_offline = 0L,
+            reply_count = 0L,
+            moderation_status = "APPROVED",
+            created_at = timestamp,
+            updated_at = timestamp
+        )
+    }
+
+    override fun close() {
+        DatabaseProvider.resetDatabase()
+    }
+
+    companion object {
+        const val EVENT_ID = "event-1"
+    }
+}
@@ -76,7 +76,9 @@ class EventDiscoveryRoutesTest {
             locationType = "CITY",
             address = "Chamonix, France",
             coordinates = """{"latitude":45.9237,"longitude":6.8694}""",
-            createdAt = "2026-06-13T10:00:00Z"
+            createdAt = "2026-06-13T10:00:00Z",
+            latitude = 45.9237,
+            longitude = 6.8694
         )
 
         application { module(database, eventRepository) }
@@ -146,7 +148,9 @@ class EventDiscoveryRoutesTest {
             locationType = "CITY",
             address = "Chamonix, France",
             coordinates = """{"latitude":45.9237,"longitude":6.8694}""",
-            createdAt = "2026-06-13T10:00:00Z"
+            createdAt = "2026-06-13T10:00:00Z",
+            latitude = 45.9237,
+            longitude = 6.8694
         )
 
         application { module(database, eventRepository) }
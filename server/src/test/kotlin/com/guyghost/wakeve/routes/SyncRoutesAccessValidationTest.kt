@@ -10,14 +10,20 @@ import com.guyghost.wakeve.models.EventStatus
 import com.guyghost.wakeve.models.EventType
 import com.guyghost.wakeve.models.SyncChange
 import com.guyghost.wakeve.models.SyncEventData
+import com.guyghost.wakeve.models.SyncEventDelta
 import com.guyghost.wakeve.models.SyncOperation
 import com.guyghost.wakeve.models.SyncParticipantData
 import com.guyghost.wakeve.models.SyncRequest
+import com.guyghost.wakeve.models.SyncResponse
 import com.guyghost.wakeve.models.SyncVoteData
 import com.guyghost.wakeve.models.TimeOfDay
 import com.guyghost.wakeve.models.TimeSlot
 import com.guyghost.wakeve.module
 import com.guyghost.wakeve.repository.DatabaseEventRepository
+import com.guyghost.wakeve.sync.SyncGzip
+import com.guyghost.wakeve.sync.SyncWireCodec
+import com.guyghost.wakeve.sync.SyncWireFormat
+import io.ktor.client.call.body
 import io.ktor.client.plugins.contentnegotiation.ContentNegotiation
 import io.ktor.client.request.header
 import io.ktor.client.request.post
@@ -176,6 +182,62 @@ class SyncRoutesAccessValidationTest {
         assertNull(database.voteQueries.selectById("vote_sync-slot_other-participant").executeAsOneOrNull())
     }
 
+    @Test
+    fun `sync accepts gzipped cbor and answers in cbor`() = testApplication {
+        val database = DatabaseProvider.getDatabase(JvmDatabaseFactory(":memory:"))
+        val eventRepository = DatabaseEventRepository(database)
+        seedPollingEvent(database, eventRepository)
+
+        application { module(database = database, eventRepository = eventRepository) }
+
+        val request = SyncRequest(
+            changes = listOf(
+                SyncChange(
+                    id = "sync-cbor-update",
+                    table = "events",
+                    operation = SyncOperation.UPDATE.name,
+                    recordId = "sync-event",
+                    data = json.encodeToString(SyncEventDelta(title = "Renamed over CBOR")),
+                    timestamp = "2026-06-20T10:00:00Z",
+                    userId = "organizer-user"
+                )
+            )
+        )
+        val body = SyncGzip.compress(SyncWireCodec.encode(SyncRequest.serializer(), request, SyncWireFormat.CBOR))
+
+        val response = client.post("/api/sync") {
+            header(HttpHeaders.Authorization, "Bearer ${createTestJwt("organizer-user")}")
+            header(HttpHeaders.ContentEncoding, "gzip")
+            header(HttpHeaders.Accept, "application/cbor, application/json;q=0.5")
+            contentType(ContentType.parse(SyncWireFormat.CBOR.contentType))
+            setBody(body)
+        }
+
+        assertEquals(HttpStatusCode.OK, response.status)
+        assertEquals(SyncWireFormat.CBOR, SyncWireFormat.fromContentType(response.headers[HttpHeaders.ContentType]))
+        val syncResponse = SyncWireCodec.decode(SyncResponse.serializer(), response.body<ByteArray>(), SyncWireFormat.CBOR)
+        assertEquals(1, syncResponse.appliedChanges, syncResponse.message)
+        assertEquals("Renamed over CBOR", eventRepository.getEvent("sync-event")?.title)
+    }
+
+    @Test
+    fun `sync rejects a gzip body that inflates past the limit`() = testApplication {
+        val database = DatabaseProvider.getDatabase(JvmDatabaseFactory(":memory:"))
+        application { module(database = database) }
+
+        // A few KB on the wire, well past the limit once inflated
+        val bomb = SyncGzip.compress(ByteArray(SyncGzip.DEFAULT_MAX_DECOMPRESSED_BYTES + 1))
+
+        val response = client.post("/api/sync") {
+            header(HttpHeaders.Authorization, "Bearer ${createTestJwt("organizer-user")}")
+            header(HttpHeaders.ContentEncoding, "gzip")
+            contentType(ContentType.parse(SyncWireFormat.CBOR.contentType))
+            setBody(bomb)
+        }
+
+        assertEquals(HttpStatusCode.PayloadTooLarge, response.status)
+    }
+
     private fun ApplicationTestBuilder.createJsonClient() = createClient {
         install(ContentNegotiation) {
             json(json)
@@ -763,7 +763,13 @@ class UgcModerationRoutesTest {
             fcmSender = SuccessfulFCMSender(),
             apnsSender = SuccessfulAPNsSender()
         )
-        val notificationTrigger = EventNotificationTrigger(notificationService, eventRepository, moderationRepository)
+        // No coalescing window, so the comment notification is sent right away
+        val notificationTrigger = EventNotificationTrigger(
+            notificationService,
+            eventRepository,
+            moderationRepository,
+            coalescingWindowMs = { 0L }
+        )
 
         application {
             module(
@@ -853,8 +859,8 @@ class UgcModerationRoutesTest {
         assertTrue(websocketSource.contains("call.principal<JWTPrincipal>()"), "WebSocket route must use authenticated user identity.")
         assertTrue(websocketSource.contains("hasChatWebSocketAccess(database, eventId, userId)"), "WebSocket route must require event membership before connecting.")
         assertTrue(websocketSource.contains("ConcurrentHashMap<String, ConcurrentHashMap<String, EventChatConnection>>"), "Connections must be tracked per event and per user connection.")
-        assertTrue(websocketSource.contains("moderationRepository?.isBlockedForEvent(connection.userId, senderId, eventId)"), "WebSocket broadcast must suppress blocked senders per recipient within the current event.")
-        assertTrue(applicationSource.contains("chatWebSocketRoute(database, moderationRepository)"), "Application wiring must pass database and moderation repository to WebSocket route.")
+        assertTrue(websocketSource.contains(".blockersByBlockedUser[senderId]"), "WebSocket broadcast must suppress blocked senders per recipient within the current event.")
+        assertTrue(applicationSource.contains("chatWebSocketRoute(database, moderationRepository, chatService.presence)"), "Application wiring must pass database and moderation repository to WebSocket route.")
         assertTrue(chatServiceSource.contains("eventConnections.broadcast(eventId, response, moderationRepository)"), "Chat service broadcasts must use moderation-aware delivery.")
     }
 
@@ -0,0 +1,135 @@
+package com.guyghost.wakeve.security
+
+import java.util.concurrent.CountDownLatch
+import java.util.concurrent.atomic.AtomicInteger
+import kotlin.concurrent.thread
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFalse
+import kotlin.test.assertTrue
+
+class RateLimiterTest {
+    private var now = 1_000_000L
+    private val policy = RateLimitPolicy(limit = 3, windowMs = 900_000)
+
+    @Test
+    fun burstIsAllowedThenEachSlotFreesOneWindowLater() {
+        val limiter = RateLimiter("test", policy, clock = { now })
+
+        repeat(3) { assertTrue(limiter.tryAcquire("alice")) }
+        assertFalse(limiter.tryAcquire("alice"))
+        assertTrue(limiter.tryAcquire("bob"))
+
+        now += policy.windowMs - 1
+        assertFalse(limiter.tryAcquire("alice"))
+        now += 1
+        repeat(3) { assertTrue(limiter.tryAcquire("alice")) }
+        assertFalse(limiter.tryAcquire("alice"))
+    }
+
+    @Test
+    fun rollingWindowNeverExceedsTheLimit() {
+        val limiter = RateLimiter("test", policy, clock = { now })
+        val allowedAt = mutableListOf<Long>()
+
+        // One attempt a minute for two windows
+        repeat(30) {
+            if (limiter.tryAcquire("alice")) allowedAt += now
+            now += 60_000
+        }
+
+        assertEquals(6, allowedAt.size)
+        for (start in allowedAt) {
+            assertTrue(allowedAt.count { it >= start && it < start + policy.windowMs } <= policy.limit)
+        }
+    }
+
+    @Test
+    fun isLimitedDoesNotConsume() {
+        val limiter = RateLimiter("test", policy, clock = { now })
+
+        repeat(10) { assertFalse(limiter.isLimited("alice")) }
+        repeat(3) { assertTrue(limiter.tryAcquire("alice")) }
+        assertTrue(limiter.isLimited("alice"))
+    }
+
+    @Test
+    fun refundGivesBackOneRequest() {
+        val limiter = RateLimiter("test", policy, clock = { now })
+        repeat(3) { limiter.tryAcquire("alice") }
+
+        limiter.refund("alice")
+
+        assertTrue(limiter.tryAcquire("alice"))
+        assertFalse(limiter.tryAcquire("alice"))
+    }
+
+    @Test
+    fun expiredKeysAreEvicted() {
+        val backend = InMemoryRateLimitBackend(stripes = 1)
+        val limiter = RateLimiter("test", policy, backend, clock = { now })
+        repeat(100) { limiter.tryAcquire("user-$it") }
+        assertEquals(100, backend.size)
+
+        now += policy.windowMs
+        repeat(100) { limiter.tryAcquire("other") }
+
+        assertEquals(1, backend.size)
+    }
+
+    @Test
+    fun limitersOnASharedStoreEnforceOneLimit() {
+        val store = LocalSharedRateLimitStore()
+        val instanceA = RateLimiter("otp", policy, SharedStoreRateLimitBackend(store), clock = { now })
+        val instanceB = RateLimiter("otp", policy, SharedStoreRateLimitBackend(store), clock = { now })
+
+        assertTrue(instanceA.tryAcquire("alice"))
+        assertTrue(instanceB.tryAcquire("alice"))
+        assertTrue(instanceA.tryAcquire("alice"))
+        assertFalse(instanceB.tryAcquire("alice"))
+        assertTrue(instanceA.isLimited("alice"))
+
+        instanceB.refund("alice")
+        assertTrue(instanceA.tryAcquire("alice"))
+
+        now += policy.windowMs
+        assertFalse(instanceB.isLimited("alice"))
+        assertEquals(0, store.size)
+    }
+
+    @Test
+    fun concurrentRequestsNeverExceedTheLimit() {
+        val backends = listOf(InMemoryRateLimitBackend(), SharedStoreRateLimitBackend(LocalSharedRateLimitStore()))
+        for (backend in backends) {
+            val limiter = RateLimiter("test", RateLimitPolicy(limit = 50, windowMs = 3_600_000), backend, clock = { now })
+            val allowed = AtomicInteger()
+            val start = CountDownLatch(1)
+
+            val threads = List(8) {
+                thread {
+                    start.await()
+                    repeat(100) { if (limiter.tryAcquire("alice")) allowed.incrementAndGet() }
+                }
+            }
+            start.countDown()
+            threads.forEach { it.join() }
+
+            assertEquals(50, allowed.get(), backend::class.simpleName)
+        }
+    }
+
+    @Test
+    fun metricsCountDecisions() {
+        val limiter = RateLimiter("test", policy, clock = { now })
+
+        repeat(5) { limiter.tryAcquire("alice") }
+        limiter.refund("alice")
+
+        assertEquals(3.0, limiter.metrics.getAllowedCount())
+        assertEquals(2.0, limiter.metrics.getRejectedCount())
+        assertEquals(1.0, limiter.metrics.getRefundedCount())
+
+        limiter.refund("nobody")
+        assertEquals(1.0, limiter.metrics.getRefundedCount())
+    }
+}
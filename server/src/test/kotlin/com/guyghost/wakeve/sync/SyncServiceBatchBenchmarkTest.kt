@@ -0,0 +1,210 @@
+package com.guyghost.wakeve.sync
+
+import app.cash.sqldelight.db.SqlDriver
+import com.guyghost.wakeve.JvmDatabaseFactory
+import com.guyghost.wakeve.database.WakeveDb
+import com.guyghost.wakeve.models.Event
+import com.guyghost.wakeve.models.EventStatus
+import com.guyghost.wakeve.models.SyncChange
+import com.guyghost.wakeve.models.SyncEventDelta
+import com.guyghost.wakeve.models.SyncOperation
+import com.guyghost.wakeve.models.SyncParticipantData
+import com.guyghost.wakeve.models.SyncRequest
+import com.guyghost.wakeve.repository.DatabaseEventRepository
+import kotlinx.coroutines.runBlocking
+import kotlinx.serialization.json.Json
+import java.io.File
+import kotlin.system.measureTimeMillis
+import kotlin.test.AfterTest
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertNull
+import kotlin.test.assertTrue
+
+/**
+ * Throughput of the sync endpoint for a client returning from a long offline period.
+ *
+ * Uses file-backed SQLite so commit cost is included. The baseline sends the same
+ * queue one change per request (one commit each, like the previous per-change apply).
+ */
+class SyncServiceBatchBenchmarkTest {
+    private val json = Json { ignoreUnknownKeys = true }
+    private val userId = "bench-organizer"
+    private val tempFiles = mutableListOf<File>()
+
+    @AfterTest
+    fun cleanup() {
+        tempFiles.forEach { it.delete() }
+    }
+
+    @Test
+    fun benchmarkBatchedApply_1000Changes() = runBlocking {
+        val eventCount = 500
+        val changes = buildOfflineQueue(eventCount)
+
+        val sequentialService = SyncService(seededDatabase(eventCount))
+        var sequentialApplied = 0
+        val sequentialMs = measureTimeMillis {
+            changes.forEach { change ->
+                sequentialApplied += sequentialService.processSyncChanges(SyncRequest(listOf(change)), userId).appliedChanges
+            }
+        }
+
+        val batchedDb = seededDatabase(eventCount)
+        val batchedService = SyncService(batchedDb)
+        var batchedApplied = 0
+        val batchedMs = measureTimeMillis {
+            batchedApplied = batchedService.processSyncChanges(SyncRequest(changes), userId).appliedChanges
+        }
+
+        val sequentialPerSec = changes.size * 1000.0 / sequentialMs.coerceAtLeast(1)
+        val batchedPerSec = changes.size * 1000.0 / batchedMs.coerceAtLeast(1)
+
+        println("\n=== Sync Batch Apply Benchmark (${changes.size} changes) ===")
+        println("One change per request: ${sequentialMs}ms (${sequentialPerSec.toInt()} changes/sec)")
+        println("Single batched request: ${batchedMs}ms (${batchedPerSec.toInt()} changes/sec)")
+        println("Speedup: ${"%.1f".format(batchedPerSec / sequentialPerSec)}x")
+
+        assertEquals(changes.size, sequentialApplied)
+        assertEquals(changes.size, batchedApplied)
+        assertEquals("Offline title 0", batchedDb.eventQueries.selectById("bench-event-0").executeAsOne().title)
+        assertEquals(2, batchedDb.participantQueries.selectByEventId("bench-event-0").executeAsList().size)
+        assertTrue(
+            batchedPerSec >= sequentialPerSec * 10,
+            "Batched apply should be at least 10x faster than per-change commits"
+        )
+    }
+
+    @Test
+    fun invalidChangeInBatchIsReportedWithoutBlockingOthers() = runBlocking {
+        val db = seededDatabase(2)
+        val changes = buildOfflineQueue(2).toMutableList()
+        changes.add(
+            1,
+            SyncChange(
+                id = "bad-change",
+                table = "events",
+                operation = SyncOperation.UPDATE.name,
+                recordId = "missing-event",
+                data = json.encodeToString(SyncEventDelta.serializer(), SyncEventDelta(title = "Lost")),
+                timestamp = "2099-01-01T00:00:00Z",
+                userId = userId
+            )
+        )
+
+        val response = SyncService(db).processSyncChanges(SyncRequest(changes), userId)
+
+        assertTrue(response.success)
+        assertEquals(4, response.appliedChanges)
+        assertEquals(listOf("bad-change"), response.conflicts.map { it.changeId })
+        assertEquals("Offline title 1", db.eventQueries.selectById("bench-event-1").executeAsOne().title)
+    }
+
+    @Test
+    fun changesApplyInRequestOrderAcrossTables() = runBlocking {
+        val db = seededDatabase(1)
+        val changes = listOf(
+            participantChange(0),
+            SyncChange(
+                id = "sync-delete-0",
+                table = "events",
+                operation = SyncOperation.DELETE.name,
+                recordId = "bench-event-0",
+                data = "{}",
+                timestamp = "2099-01-01T00:00:00Z",
+                userId = userId
+            )
+        )
+
+        val response = SyncService(db).processSyncChanges(SyncRequest(changes), userId)
+
+        // Regrouped parents-first, the delete would run before the join and reject it
+        assertEquals(2, response.appliedChanges, response.message)
+        assertTrue(response.conflicts.isEmpty())
+        assertNull(db.eventQueries.selectById("bench-event-0").executeAsOneOrNull())
+    }
+
+    @Test
+    fun databaseErrorRollsBackTheRunAndIsolatesTheFailingChange() = runBlocking {
+        val db = seededDatabase(3) { driver ->
+            driver.execute(
+                null,
+                """
+                CREATE TRIGGER fail_guest_1 BEFORE INSERT ON participant WHEN new.userId = 'guest-1'
+                BEGIN SELECT RAISE(ABORT, 'disk I/O error'); END
+                """.trimIndent(),
+                0
+            )
+        }
+        val changes = (0 until 3).map { participantChange(it) }
+
+        val response = SyncService(db).processSyncChanges(SyncRequest(changes), userId)
+
+        assertEquals(2, response.appliedChanges)
+        assertEquals(listOf("sync-participant-1"), response.conflicts.map { it.changeId })
+        assertEquals(2, db.participantQueries.selectByEventId("bench-event-0").executeAsList().size)
+        assertEquals(1, db.participantQueries.selectByEventId("bench-event-1").executeAsList().size)
+        assertEquals(2, db.participantQueries.selectByEventId("bench-event-2").executeAsList().size)
+    }
+
+    /**
+     * For each event: a new participant, then a field-level title edit. Each table forms
+     * one run of consecutive changes, so the batch costs two commits.
+     */
+    private fun buildOfflineQueue(eventCount: Int): List<SyncChange> {
+        val updates = (0 until eventCount).map { i ->
+            SyncChange(
+                id = "sync-update-$i",
+                table = "events",
+                operation = SyncOperation.UPDATE.name,
+                recordId = "bench-event-$i",
+                data = json.encodeToString(SyncEventDelta.serializer(), SyncEventDelta(title = "Offline title $i")),
+                timestamp = "2099-01-01T00:00:00Z",
+                userId = userId
+            )
+        }
+        val participants = (0 until eventCount).map { participantChange(it) }
+        return participants + updates
+    }
+
+    private fun participantChange(i: Int) = SyncChange(
+        id = "sync-participant-$i",
+        table = "participants",
+        operation = SyncOperation.CREATE.name,
+        recordId = "part_bench-event-${i}_guest-$i",
+        data = json.encodeToString(
+            SyncParticipantData.serializer(),
+            SyncParticipantData(eventId = "bench-event-$i", userId = "guest-$i")
+        ),
+        timestamp = "2099-01-01T00:00:00Z",
+        userId = userId
+    )
+
+    private fun seededDatabase(eventCount: Int, setup: (SqlDriver) -> Unit = {}): WakeveDb {
+        val file = File.createTempFile("sync-bench", ".db").also { it.delete() }
+        tempFiles += file
+        val driver = JvmDatabaseFactory(file.absolutePath).createDriver()
+        setup(driver)
+        val db = WakeveDb(driver)
+        val repository = DatabaseEventRepository(db)
+        db.transaction {
+            repeat(eventCount) { i ->
+                repository.insertEventRecords(
+                    Event(
+                        id = "bench-event-$i",
+                        title = "Event $i",
+                        description = "Benchmark event $i",
+                        organizerId = userId,
+                        participants = emptyList(),
+                        proposedSlots = emptyList(),
+                        deadline = "2026-07-01T00:00:00Z",
+                        status = EventStatus.DRAFT,
+                        createdAt = "2026-06-20T10:00:00Z",
+                        updatedAt = "2026-06-20T10:00:00Z"
+                    )
+                )
+            }
+        }
+        return db
+    }
+}
@@ -0,0 +1,221 @@
+package com.guyghost.wakeve.sync
+
+import com.guyghost.wakeve.JvmDatabaseFactory
+import com.guyghost.wakeve.database.DatabaseProvider
+import com.guyghost.wakeve.database.WakeveDb
+import com.guyghost.wakeve.models.Event
+import com.guyghost.wakeve.models.EventStatus
+import com.guyghost.wakeve.models.SyncChange
+import com.guyghost.wakeve.models.SyncEventData
+import com.guyghost.wakeve.models.SyncEventDelta
+import com.guyghost.wakeve.models.SyncOperation
+import com.guyghost.wakeve.models.SyncPullRequest
+import com.guyghost.wakeve.models.SyncRequest
+import com.guyghost.wakeve.repository.DatabaseEventRepository
+import kotlinx.coroutines.runBlocking
+import kotlinx.serialization.json.Json
+import kotlin.test.AfterTest
+import kotlin.test.BeforeTest
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFalse
+import kotlin.test.assertTrue
+
+class SyncServicePullTest {
+    private val json = Json { ignoreUnknownKeys = true }
+    private lateinit var database: WakeveDb
+    private lateinit var eventRepository: DatabaseEventRepository
+    private lateinit var syncService: SyncService
+
+    @BeforeTest
+    fun setup() {
+        DatabaseProvider.resetDatabase()
+        database = DatabaseProvider.getDatabase(JvmDatabaseFactory(":memory:"))
+        eventRepository = DatabaseEventRepository(database)
+        syncService = SyncService(database)
+    }
+
+    @AfterTest
+    fun teardown() {
+        DatabaseProvider.resetDatabase()
+    }
+
+    @Test
+    fun `first pull returns only rows visible to the user`() = runBlocking {
+        createEvent("organized", organizerId = "me")
+        createEvent("joined", organizerId = "someone-else")
+        eventRepository.addParticipant("joined", "me").getOrThrow()
+        createEvent("unrelated", organizerId = "someone-else")
+
+        val response = syncService.pullChanges(SyncPullRequest(), "me")
+
+        assertTrue(response.success)
+        assertEquals(
+            setOf("organized", "joined"),
+            response.changes.filter { it.table == "events" }.map { it.recordId }.toSet()
+        )
+        assertTrue(response.changes.filter { it.table == "participants" }.all { it.recordId.contains("joined") || it.recordId.contains("organized") })
+        assertFalse(response.hasMore)
+        assertEquals(
+            response.changes.filter { it.table == "events" }.maxOf { it.seq },
+            response.versions.getValue("events").seq
+        )
+    }
+
+    @Test
+    fun `paged pull resumes from the version vector without skipping rows that share updatedAt`() = runBlocking {
+        // DatabaseEventRepository stamps every row with the same updatedAt
+        listOf("event-a", "event-b", "event-c").forEach { createEvent(it, organizerId = "me") }
+
+        val pulled = mutableListOf<String>()
+        var request = SyncPullRequest(limit = 2)
+        do {
+            val response = syncService.pullChanges(request, "me")
+            pulled += response.changes.filter { it.table == "events" }.map { it.recordId }
+            request = request.copy(versions = response.versions)
+        } while (response.hasMore)
+
+        assertEquals(listOf("event-a", "event-b", "event-c"), pulled)
+        assertTrue(syncService.pullChanges(request, "me").changes.none { it.table == "events" })
+    }
+
+    @Test
+    fun `row written after the cursor is pulled even with an older updatedAt`() = runBlocking {
+        createEvent("first", organizerId = "me")
+        val cursor = syncService.pullChanges(SyncPullRequest(), "me").versions
+
+        // A write stamped earlier than the last pulled row but committed after it
+        createEvent("late", organizerId = "me")
+        database.eventQueries.updateRemoteEvent(
+            title = "Late",
+            description = "Stamped in the past",
+            status = EventStatus.DRAFT.name,
+            deadline = "2026-07-01T00:00:00Z",
+            updatedAt = "2000-01-01T00:00:00Z",
+            id = "late"
+        )
+
+        val response = syncService.pullChanges(SyncPullRequest(versions = cursor), "me")
+        assertEquals(listOf("late"), response.changes.filter { it.table == "events" }.map { it.recordId })
+    }
+
+    @Test
+    fun `new member pulls an event the cursor already passed`() = runBlocking {
+        createEvent("existing", organizerId = "someone-else")
+        createEvent("mine", organizerId = "me")
+        val cursor = syncService.pullChanges(SyncPullRequest(), "me").versions
+
+        eventRepository.addParticipant("existing", "me").getOrThrow()
+
+        val response = syncService.pullChanges(SyncPullRequest(versions = cursor), "me")
+        assertEquals(listOf("existing"), response.changes.filter { it.table == "events" }.map { it.recordId })
+        // The organizer's older membership reaches the new member too
+        val memberships = response.changes.filter { it.table == "participants" }
+        assertEquals(2, memberships.size)
+        val event = response.changes.single { it.table == "events" }
+        assertTrue(memberships.all { event.seq <= it.seq }, "The event must not be sequenced after its members")
+    }
+
+    @Test
+    fun `joining logs only the new membership`() = runBlocking {
+        createEvent("crowded", organizerId = "someone-else")
+        listOf("a", "b", "c").forEach { eventRepository.addParticipant("crowded", it).getOrThrow() }
+        val cursor = syncService.pullChanges(SyncPullRequest(), "someone-else").versions
+
+        eventRepository.addParticipant("crowded", "d").getOrThrow()
+
+        // Existing members get the new membership alone, not the event and every member again
+        val response = syncService.pullChanges(SyncPullRequest(versions = cursor), "someone-else")
+        assertEquals(listOf("part_crowded_d"), response.changes.map { it.recordId })
+    }
+
+    @Test
+    fun `deleted event reaches every member as a DELETE`() = runBlocking {
+        createEvent("doomed", organizerId = "me")
+        eventRepository.addParticipant("doomed", "friend").getOrThrow()
+        val myCursor = syncService.pullChanges(SyncPullRequest(), "me").versions
+        val friendCursor = syncService.pullChanges(SyncPullRequest(), "friend").versions
+
+        eventRepository.deleteEvent("doomed").getOrThrow()
+
+        listOf("me" to myCursor, "friend" to friendCursor).forEach { (user, cursor) ->
+            val response = syncService.pullChanges(SyncPullRequest(versions = cursor), user)
+            val change = response.changes.single()
+            assertEquals("events", change.table)
+            assertEquals("doomed", change.recordId)
+            assertEquals(SyncOperation.DELETE.name, change.operation)
+            assertTrue(response.versions.getValue("events").seq > cursor.getValue("events").seq)
+        }
+        assertTrue(syncService.pullChanges(SyncPullRequest(), "stranger").changes.isEmpty())
+    }
+
+    @Test
+    fun `removed membership is a DELETE for the members and drops the event for the removed user`() = runBlocking {
+        createEvent("party", organizerId = "me")
+        eventRepository.addParticipant("party", "friend").getOrThrow()
+        val myCursor = syncService.pullChanges(SyncPullRequest(), "me").versions
+        val friendCursor = syncService.pullChanges(SyncPullRequest(), "friend").versions
+        val membership = database.participantQueries.selectByEventIdAndUserId("party", "friend").executeAsOne()
+
+        database.participantQueries.deleteParticipant(membership.id)
+
+        val organizerChange = syncService.pullChanges(SyncPullRequest(versions = myCursor), "me").changes.single()
+        assertEquals("participants", organizerChange.table)
+        assertEquals(membership.id, organizerChange.recordId)
+        assertEquals(SyncOperation.DELETE.name, organizerChange.operation)
+
+        val friendChange = syncService.pullChanges(SyncPullRequest(versions = friendCursor), "friend").changes.single()
+        assertEquals("events", friendChange.table)
+        assertEquals("party", friendChange.recordId)
+        assertEquals(SyncOperation.DELETE.name, friendChange.operation)
+    }
+
+    @Test
+    fun `field level event delta keeps fields it does not carry`() = runBlocking {
+        createEvent("delta-event", organizerId = "me")
+
+        val response = syncService.processSyncChanges(
+            SyncRequest(
+                changes = listOf(
+                    SyncChange(
+                        id = "sync-delta",
+                        table = "events",
+                        operation = SyncOperation.UPDATE.name,
+                        recordId = "delta-event",
+                        data = json.encodeToString(SyncEventDelta.serializer(), SyncEventDelta(title = "Renamed")),
+                        timestamp = "2099-01-01T00:00:00Z",
+                        userId = "me"
+                    )
+                )
+            ),
+            "me"
+        )
+
+        assertEquals(1, response.appliedChanges, response.message)
+        val event = eventRepository.getEvent("delta-event")!!
+        assertEquals("Renamed", event.title)
+        assertEquals("Description of delta-event", event.description)
+        assertEquals("2026-07-01T00:00:00Z", event.deadline)
+
+        val pulledEvent = syncService.pullChanges(SyncPullRequest(), "me").changes
+            .first { it.table == "events" && it.recordId == "delta-event" }
+        assertEquals("Renamed", json.decodeFromString(SyncEventData.serializer(), pulledEvent.data).title)
+    }
+
+    private suspend fun createEvent(id: String, organizerId: String) {
+        eventRepository.createEvent(
+            Event(
+                id = id,
+                title = "Title of $id",
+                description = "Description of $id",
+                organizerId = organizerId,
+                participants = emptyList(),
+                proposedSlots = emptyList(),
+                deadline = "2026-07-01T00:00:00Z",
+                status = EventStatus.DRAFT,
+                createdAt = "2026-06-20T10:00:00Z",
+                updatedAt = "2026-06-20T10:00:00Z"
+            )
+        ).getOrThrow()
+    }
+}
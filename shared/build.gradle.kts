@@ -30,6 +30,16 @@ kotlin {
     
     // JVM target for server and desktop
     jvm()
+
+    // jvmAndroidMain: java.* code shared by the JVM and Android targets
+    applyDefaultHierarchyTemplate {
+        common {
+            group("jvmAndroid") {
+                withJvm()
+                withAndroidTarget()
+            }
+        }
+    }
     
     sourceSets {
         // Common source set - shared across all platforms
@@ -39,6 +49,7 @@ kotlin {
                 implementation(libs.kotlinx.coroutines)
                 implementation(libs.kotlinx.datetime)
                 implementation(libs.kotlinx.serialization.json)
+                implementation(libs.kotlinx.serialization.cbor)
                 
                 // SQLDelight
                 implementation(libs.sqldelight.runtime)
@@ -201,6 +212,7 @@ tasks.register<JacocoReport>("jacocoJvmTestReport") {
     sourceDirectories.setFrom(
         files(
             "src/commonMain/kotlin",
+            "src/jvmAndroidMain/kotlin",
             "src/jvmMain/kotlin"
         )
     )
@@ -229,6 +241,7 @@ tasks.register<JacocoCoverageVerification>("jacocoCoverageVerification") {
     sourceDirectories.setFrom(
         files(
             "src/commonMain/kotlin",
+            "src/jvmAndroidMain/kotlin",
             "src/jvmMain/kotlin"
         )
     )
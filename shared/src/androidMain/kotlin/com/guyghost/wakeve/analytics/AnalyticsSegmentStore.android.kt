@@ -0,0 +1,18 @@
+package com.guyghost.wakeve.analytics
+
+import java.io.File
+
+/**
+ * Segments live in no-backup storage: they are transient and must not be
+ * restored onto another device.
+ */
+actual fun createAnalyticsSegmentStore(): AnalyticsSegmentStore {
+    val context = try {
+        val activityThread = Class.forName("android.app.ActivityThread")
+        val currentApplication = activityThread.getDeclaredMethod("currentApplication")
+        currentApplication.invoke(null) as android.app.Application
+    } catch (e: Exception) {
+        throw IllegalStateException("Unable to obtain Android Application context", e)
+    }
+    return FileAnalyticsSegmentStore(File(context.noBackupFilesDir, "analytics"))
+}
@@ -1,8 +1,11 @@
 package com.guyghost.wakeve.analytics
 
+import android.content.ComponentCallbacks2
+import android.content.res.Configuration
 import android.os.Bundle
 import com.google.firebase.FirebaseApp
 import com.google.firebase.analytics.FirebaseAnalytics
+import com.guyghost.wakeve.sync.createNetworkStatusDetector
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.SupervisorJob
@@ -17,9 +20,11 @@ import kotlinx.coroutines.launch
  * - Syncs queued events when connectivity is restored
  *
  * @param analyticsQueue Queue for offline analytics event backup
+ * @param segmentUploader Sends queued segments to the analytics backend
  */
 actual class FirebaseAnalyticsProvider actual constructor(
-    private val analyticsQueue: AnalyticsQueue
+    private val analyticsQueue: AnalyticsQueue,
+    private val segmentUploader: AnalyticsSegmentUploader
 ) : AnalyticsProvider {
 
     private val firebaseAnalytics: FirebaseAnalytics by lazy {
@@ -32,6 +37,7 @@ actual class FirebaseAnalyticsProvider actual constructor(
     init {
         // Start sync job for offline events
         startSyncJob()
+        flushWhenBackgrounded()
     }
 
     /**
@@ -219,15 +225,34 @@ actual class FirebaseAnalyticsProvider actual constructor(
         }
     }
 
+    /**
+     * Writes buffered events to disk once no activity is visible, since the
+     * process may be killed without further notice after that.
+     */
+    private fun flushWhenBackgrounded() {
+        FirebaseApp.getInstance().applicationContext.registerComponentCallbacks(object : ComponentCallbacks2 {
+            override fun onTrimMemory(level: Int) {
+                if (level >= ComponentCallbacks2.TRIM_MEMORY_UI_HIDDEN) {
+                    scope.launch { analyticsQueue.flush() }
+                }
+            }
+
+            override fun onConfigurationChanged(newConfig: Configuration) = Unit
+
+            override fun onLowMemory() = Unit
+        })
+    }
+
     /**
      * Start periodic sync job for offline events.
-     * Syncs every 5 minutes when online.
+     * Uploads every 5 minutes when online, backing off after a failed upload.
      */
     private fun startSyncJob() {
-        scope.launch {
-            // TODO: Implement periodic sync with network monitoring
-            // This would check network status and sync queued events
-            // Implementation depends on ConnectivityService
-        }
+        val networkDetector = createNetworkStatusDetector()
+        AnalyticsUploader(
+            queue = analyticsQueue,
+            uploader = segmentUploader,
+            isOnline = { networkDetector.isNetworkAvailable.value }
+        ).start(scope)
     }
 }
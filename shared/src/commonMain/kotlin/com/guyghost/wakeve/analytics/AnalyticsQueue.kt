@@ -1,35 +1,86 @@
 package com.guyghost.wakeve.analytics
 
-import kotlinx.coroutines.flow.MutableStateFlow
-import kotlinx.coroutines.flow.StateFlow
-import kotlinx.coroutines.flow.asStateFlow
 import kotlinx.coroutines.sync.Mutex
 import kotlinx.coroutines.sync.withLock
-import kotlinx.serialization.Serializable
 
 /**
  * Queue for offline analytics events.
- * Events are stored locally and synced when online.
+ * Events are stored locally and uploaded in whole segments when online.
+ *
+ * Layout:
+ * - A bounded buffer of reusable slots takes new events. Event names are
+ *   interned to small codes with their UTF-8 bytes cached, and events without
+ *   properties share one empty map, so enqueueing allocates nothing per event.
+ * - When the buffer fills (or on [flush]) its events are encoded in one pass and
+ *   appended to the tail segment of [store]; a tail larger than
+ *   [segmentMaxBytes] is sealed into an immutable segment.
+ * - [nextSegment] hands out the oldest sealed segment as an opaque payload for
+ *   bulk upload; [acknowledge] retires it with a single marker write. A failed
+ *   upload keeps the segment and backs off ([markAsFailed]); only when more
+ *   than [maxPendingSegments] pile up is the oldest dropped, which bounds the
+ *   storage used while offline.
+ *
+ * On cold start only the segment list, the marker and the tail (at most one
+ * segment) are read; sealed segments are not parsed until they are uploaded.
+ * Events still in the buffer when the process dies are lost, so callers should
+ * [flush] when the app goes to the background.
  *
  * Thread-safe implementation using coroutines Mutex.
  */
-class AnalyticsQueue {
+class AnalyticsQueue(
+    private val store: AnalyticsSegmentStore = InMemoryAnalyticsSegmentStore(),
+    private val bufferCapacity: Int = DEFAULT_BUFFER_CAPACITY,
+    private val segmentMaxBytes: Int = DEFAULT_SEGMENT_MAX_BYTES,
+    private val maxPendingSegments: Int = DEFAULT_MAX_PENDING_SEGMENTS,
+    private val baseRetryDelayMs: Long = DEFAULT_BASE_RETRY_DELAY_MS,
+    private val maxRetryDelayMs: Long = DEFAULT_MAX_RETRY_DELAY_MS,
+    private val clock: () -> Long = { kotlinx.datetime.Clock.System.now().toEpochMilliseconds() }
+) {
 
-    @Serializable
     data class QueuedEvent(
-        val id: String,
         val eventName: String,
         val properties: Map<String, String>,
-        val timestamp: Long,
-        val retryCount: Int = 0
+        val timestamp: Long
     )
 
-    private val _queue = MutableStateFlow<List<QueuedEvent>>(emptyList())
-    val queue: StateFlow<List<QueuedEvent>> = _queue.asStateFlow()
+    /**
+     * A sealed segment ready for upload.
+     *
+     * @property payload Encoded events, compressed as [contentEncoding] (null when raw)
+     */
+    class Segment(
+        val id: Long,
+        val eventCount: Int,
+        val payload: ByteArray,
+        val contentEncoding: String?
+    )
 
     private val mutex = Mutex()
-    private val maxRetries = 3
-    private var nextEventSequence = 0L
+
+    // Buffer slots, reused across flushes
+    private val slotNames = IntArray(bufferCapacity)
+    private val slotTimestamps = LongArray(bufferCapacity)
+    private val slotProperties = arrayOfNulls<Map<String, String>>(bufferCapacity)
+    private var bufferedCount = 0
+
+    // Interned event names and their cached UTF-8 encoding
+    private val nameCodes = HashMap<String, Int>()
+    private val encodedNames = ArrayList<ByteArray>()
+
+    private val writer = RecordWriter()
+    private var tailBytes = 0
+    private var tailEvents = 0
+    private val sealed = ArrayDeque<AnalyticsSegmentStore.SegmentInfo>()
+    private val failures = HashMap<Long, Int>()
+    private var nextSegmentId = 1L
+    private var acknowledgedId = 0L
+
+    init {
+        sealed.addAll(store.sealedSegments())
+        acknowledgedId = store.readAckMarker()
+        nextSegmentId = maxOf(acknowledgedId, sealed.lastOrNull()?.id ?: 0L) + 1
+        recoverTail()
+    }
 
     /**
      * Add event to queue.
@@ -39,53 +90,63 @@ class AnalyticsQueue {
      */
     suspend fun enqueue(event: AnalyticsEvent, properties: Map<String, Any?>) {
         mutex.withLock {
-            val queuedEvent = QueuedEvent(
-                id = generateEventId(),
-                eventName = event.eventName,
-                properties = properties.mapValues { it.value?.toString() ?: "" },
-                timestamp = currentTimeMillis()
-            )
-            _queue.value = _queue.value + queuedEvent
+            val slot = bufferedCount
+            slotNames[slot] = intern(event.eventName)
+            slotTimestamps[slot] = clock()
+            slotProperties[slot] = if (properties.isEmpty()) emptyMap() else properties.mapValues { it.value?.toString() ?: "" }
+            bufferedCount++
+            if (bufferedCount == bufferCapacity) flushLocked()
         }
     }
 
     /**
-     * Get all pending events for sync.
-     * Returns events with retry count less than maxRetries.
+     * Writes buffered events to the tail segment.
      */
-    suspend fun getPendingEvents(): List<QueuedEvent> {
-        return mutex.withLock {
-            _queue.value.filter { it.retryCount < maxRetries }
-        }
+    suspend fun flush() {
+        mutex.withLock { flushLocked() }
     }
 
     /**
-     * Mark events as successfully synced and remove from queue.
-     *
-     * @param eventIds List of event IDs to remove
+     * Oldest segment awaiting upload, sealing the current tail first if nothing
+     * else is pending. Returns the same segment until it is acknowledged.
      */
-    suspend fun markAsSynced(eventIds: List<String>) {
-        mutex.withLock {
-            _queue.value = _queue.value.filter { it.id !in eventIds }
+    suspend fun nextSegment(): Segment? = mutex.withLock {
+        if (sealed.isEmpty()) {
+            flushLocked()
+            sealLocked()
+        }
+        var segment: Segment? = null
+        while (segment == null && sealed.isNotEmpty()) {
+            val info = sealed.first()
+            val payload = store.readSegment(info.id)
+            if (payload == null) {
+                // Reclaimed outside the queue; nothing left to upload
+                sealed.removeFirst()
+            } else {
+                segment = Segment(info.id, info.eventCount, payload, store.contentEncoding)
+            }
         }
+        segment
     }
 
     /**
-     * Mark events as failed and increment retry count.
-     * Events that exceed maxRetries are removed from queue.
+     * Mark a segment as successfully uploaded. Acknowledges every older segment too.
+     */
+    suspend fun acknowledge(segment: Segment) {
+        mutex.withLock { acknowledgeLocked(segment.id) }
+    }
+
+    /**
+     * Mark a segment upload as failed. The segment stays queued.
      *
-     * @param eventIds List of event IDs to mark as failed
+     * @return Delay before the next attempt: [baseRetryDelayMs], doubled per
+     *   consecutive failure of this segment, capped at [maxRetryDelayMs]
      */
-    suspend fun markAsFailed(eventIds: List<String>) {
-        mutex.withLock {
-            _queue.value = _queue.value.map { event ->
-                if (event.id in eventIds) {
-                    event.copy(retryCount = event.retryCount + 1)
-                } else {
-                    event
-                }
-            }.filter { it.retryCount < maxRetries }
-        }
+    suspend fun markAsFailed(segment: Segment): Long = mutex.withLock {
+        val attempts = (failures[segment.id] ?: 0) + 1
+        failures[segment.id] = attempts
+        val shift = (attempts - 1).coerceAtMost(MAX_BACKOFF_SHIFT)
+        (baseRetryDelayMs shl shift).coerceAtMost(maxRetryDelayMs)
     }
 
     /**
@@ -93,29 +154,200 @@ class AnalyticsQueue {
      */
     suspend fun clear() {
         mutex.withLock {
-            _queue.value = emptyList()
+            slotProperties.fill(null)
+            bufferedCount = 0
+            store.clear()
+            sealed.clear()
+            failures.clear()
+            tailBytes = 0
+            tailEvents = 0
+            nextSegmentId = 1L
+            acknowledgedId = 0L
         }
     }
 
     /**
-     * Get current queue size.
+     * Get current queue size (buffered, tail and sealed events).
      */
     val size: Int
-        get() = _queue.value.size
+        get() = bufferedCount + tailEvents + sealed.sumOf { it.eventCount }
+
+    private fun flushLocked() {
+        if (bufferedCount == 0) return
+        writer.reset()
+        for (slot in 0 until bufferedCount) {
+            writeRecord(slot)
+            slotProperties[slot] = null
+        }
+        store.appendTail(writer.toByteArray())
+        tailBytes += writer.size
+        tailEvents += bufferedCount
+        bufferedCount = 0
+        if (tailBytes >= segmentMaxBytes) sealLocked()
+    }
+
+    private fun sealLocked() {
+        if (tailEvents == 0) return
+        val id = nextSegmentId++
+        store.sealTail(id, tailEvents)
+        sealed.addLast(AnalyticsSegmentStore.SegmentInfo(id, tailEvents))
+        tailBytes = 0
+        tailEvents = 0
+        if (sealed.size > maxPendingSegments) {
+            // Offline for too long: give up the oldest segment rather than grow without bound
+            acknowledgeLocked(sealed.first().id)
+        }
+    }
+
+    private fun acknowledgeLocked(id: Long) {
+        // A segment dropped while it was being uploaded is acknowledged twice
+        if (id <= acknowledgedId) return
+        store.writeAckMarker(id)
+        acknowledgedId = id
+        while (sealed.firstOrNull()?.let { it.id <= id } == true) sealed.removeFirst()
+        failures.keys.removeAll { it <= id }
+    }
 
     /**
-     * Generate unique event ID.
+     * Counts tail records by their length prefixes without decoding them, and
+     * cuts off a record torn by a crash mid-append.
      */
-    private fun generateEventId(): String {
-        nextEventSequence += 1
-        return "event-${currentTimeMillis()}-$nextEventSequence"
+    private fun recoverTail() {
+        val tail = store.readTail()
+        var offset = 0
+        var events = 0
+        while (offset + Int.SIZE_BYTES <= tail.size) {
+            val length = readInt(tail, offset)
+            if (length <= 0 || offset + Int.SIZE_BYTES + length > tail.size) break
+            offset += Int.SIZE_BYTES + length
+            events++
+        }
+        if (offset < tail.size) store.truncateTail(offset)
+        tailBytes = offset
+        tailEvents = events
+    }
+
+    private fun intern(eventName: String): Int =
+        nameCodes.getOrPut(eventName) {
+            encodedNames.add(eventName.encodeToByteArray())
+            encodedNames.size - 1
+        }
+
+    // Record: length:int32, timestamp:int64, name, propertyCount:int16, (key, value)*
+    private fun writeRecord(slot: Int) {
+        val start = writer.size
+        writer.writeInt(0)
+        writer.writeLong(slotTimestamps[slot])
+        writer.writeBytes(encodedNames[slotNames[slot]])
+        val properties = slotProperties[slot].orEmpty()
+        writer.writeShort(properties.size)
+        properties.forEach { (key, value) ->
+            writer.writeBytes(key.encodeToByteArray())
+            writer.writeBytes(value.encodeToByteArray())
+        }
+        writer.patchInt(start, writer.size - start - Int.SIZE_BYTES)
+    }
+
+    companion object {
+        private const val DEFAULT_BUFFER_CAPACITY = 256
+        private const val DEFAULT_SEGMENT_MAX_BYTES = 256 * 1024
+        private const val DEFAULT_MAX_PENDING_SEGMENTS = 64
+        private const val DEFAULT_BASE_RETRY_DELAY_MS = 30_000L
+        private const val DEFAULT_MAX_RETRY_DELAY_MS = 60 * 60 * 1000L
+        private const val MAX_BACKOFF_SHIFT = 16
+
+        /**
+         * Decodes an uncompressed segment payload back into events.
+         */
+        fun decodeSegment(payload: ByteArray): List<QueuedEvent> {
+            val events = mutableListOf<QueuedEvent>()
+            var offset = 0
+            while (offset < payload.size) {
+                val end = offset + Int.SIZE_BYTES + readInt(payload, offset)
+                var position = offset + Int.SIZE_BYTES
+                val timestamp = readLong(payload, position)
+                position += Long.SIZE_BYTES
+                val nameLength = readInt(payload, position)
+                val eventName = payload.decodeToString(position + Int.SIZE_BYTES, position + Int.SIZE_BYTES + nameLength)
+                position += Int.SIZE_BYTES + nameLength
+                val propertyCount = readShort(payload, position)
+                position += Short.SIZE_BYTES
+                val properties = LinkedHashMap<String, String>(propertyCount)
+                repeat(propertyCount) {
+                    val keyLength = readInt(payload, position)
+                    val key = payload.decodeToString(position + Int.SIZE_BYTES, position + Int.SIZE_BYTES + keyLength)
+                    position += Int.SIZE_BYTES + keyLength
+                    val valueLength = readInt(payload, position)
+                    properties[key] = payload.decodeToString(position + Int.SIZE_BYTES, position + Int.SIZE_BYTES + valueLength)
+                    position += Int.SIZE_BYTES + valueLength
+                }
+                events.add(QueuedEvent(eventName, properties, timestamp))
+                offset = end
+            }
+            return events
+        }
+
+        private fun readInt(bytes: ByteArray, offset: Int): Int =
+            (bytes[offset].toInt() and 0xFF shl 24) or
+                (bytes[offset + 1].toInt() and 0xFF shl 16) or
+                (bytes[offset + 2].toInt() and 0xFF shl 8) or
+                (bytes[offset + 3].toInt() and 0xFF)
+
+        private fun readLong(bytes: ByteArray, offset: Int): Long =
+            (readInt(bytes, offset).toLong() shl 32) or (readInt(bytes, offset + 4).toLong() and 0xFFFFFFFFL)
+
+        private fun readShort(bytes: ByteArray, offset: Int): Int =
+            (bytes[offset].toInt() and 0xFF shl 8) or (bytes[offset + 1].toInt() and 0xFF)
     }
 
     /**
-     * Get current timestamp in milliseconds.
-     * Platform-specific implementation will be provided.
+     * Growable big-endian byte buffer reused for every flush.
      */
-    private fun currentTimeMillis(): Long {
-        return kotlinx.datetime.Clock.System.now().toEpochMilliseconds()
+    private class RecordWriter {
+        private var buffer = ByteArray(4096)
+        var size = 0
+            private set
+
+        fun reset() {
+            size = 0
+        }
+
+        fun writeShort(value: Int) {
+            ensure(Short.SIZE_BYTES)
+            buffer[size++] = (value shr 8).toByte()
+            buffer[size++] = value.toByte()
+        }
+
+        fun writeInt(value: Int) {
+            ensure(Int.SIZE_BYTES)
+            patchInt(size, value)
+            size += Int.SIZE_BYTES
+        }
+
+        fun writeLong(value: Long) {
+            writeInt((value ushr 32).toInt())
+            writeInt(value.toInt())
+        }
+
+        /** Length-prefixed bytes. */
+        fun writeBytes(bytes: ByteArray) {
+            writeInt(bytes.size)
+            ensure(bytes.size)
+            bytes.copyInto(buffer, size)
+            size += bytes.size
+        }
+
+        fun patchInt(offset: Int, value: Int) {
+            buffer[offset] = (value shr 24).toByte()
+            buffer[offset + 1] = (value shr 16).toByte()
+            buffer[offset + 2] = (value shr 8).toByte()
+            buffer[offset + 3] = value.toByte()
+        }
+
+        fun toByteArray(): ByteArray = buffer.copyOf(size)
+
+        private fun ensure(extra: Int) {
+            if (size + extra > buffer.size) buffer = buffer.copyOf(maxOf(buffer.size * 2, size + extra))
+        }
     }
 }
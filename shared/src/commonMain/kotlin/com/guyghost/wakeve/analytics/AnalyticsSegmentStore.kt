@@ -0,0 +1,126 @@
+package com.guyghost.wakeve.analytics
+
+/**
+ * Durable storage behind [AnalyticsQueue].
+ *
+ * Events are appended to an open tail segment; a full tail is sealed into an
+ * immutable numbered segment that is uploaded as a whole. Uploaded segments are
+ * acknowledged by a single marker write (the highest acknowledged id) rather
+ * than by touching each event, so segments must be acknowledged in id order.
+ *
+ * Implementations must make [sealTail] and [writeAckMarker] atomic: after a
+ * crash the segment is either sealed or still the tail, and the marker holds
+ * either the old or the new id.
+ */
+interface AnalyticsSegmentStore {
+
+    /** Sealed segment metadata; readable without opening the segment. */
+    data class SegmentInfo(val id: Long, val eventCount: Int)
+
+    /** Content encoding of sealed segment payloads (e.g. "gzip"), or null when stored raw. */
+    val contentEncoding: String?
+
+    /** Appends encoded records to the tail segment. */
+    fun appendTail(bytes: ByteArray)
+
+    /** Reads the whole tail segment. */
+    fun readTail(): ByteArray
+
+    /** Drops tail bytes past [length], e.g. a record torn by a crash. */
+    fun truncateTail(length: Int)
+
+    /** Seals the tail as segment [id] holding [eventCount] events and starts an empty tail. */
+    fun sealTail(id: Long, eventCount: Int)
+
+    /** Sealed segments above the acknowledgement marker, oldest first. */
+    fun sealedSegments(): List<SegmentInfo>
+
+    /** Payload of sealed segment [id], encoded as [contentEncoding], or null if it is gone. */
+    fun readSegment(id: Long): ByteArray?
+
+    /** Highest acknowledged segment id, or 0 if none. */
+    fun readAckMarker(): Long
+
+    /** Marks every segment up to [id] as acknowledged; their storage may be reclaimed. */
+    fun writeAckMarker(id: Long)
+
+    /** Removes every segment, the tail and the marker. */
+    fun clear()
+}
+
+/**
+ * Platform store used by the analytics providers: files in app-private storage
+ * on Android and iOS, a directory under the user's home on the JVM.
+ */
+expect fun createAnalyticsSegmentStore(): AnalyticsSegmentStore
+
+/**
+ * File names shared by the file-backed stores.
+ */
+internal object AnalyticsSegmentFiles {
+    const val TAIL = "tail.log"
+
+    private val SEGMENT_NAME = Regex("""segment-(\d+)-(\d+)\.log""")
+    private val ACK_NAME = Regex("""ack-(\d+)""")
+
+    fun segmentName(id: Long, eventCount: Int): String = "segment-$id-$eventCount.log"
+
+    fun ackName(id: Long): String = "ack-$id"
+
+    fun parseSegmentName(name: String): AnalyticsSegmentStore.SegmentInfo? =
+        SEGMENT_NAME.matchEntire(name)?.let { match ->
+            AnalyticsSegmentStore.SegmentInfo(
+                id = match.groupValues[1].toLong(),
+                eventCount = match.groupValues[2].toInt()
+            )
+        }
+
+    fun parseAckName(name: String): Long? = ACK_NAME.matchEntire(name)?.groupValues?.get(1)?.toLong()
+}
+
+/**
+ * [AnalyticsSegmentStore] kept in memory; used where no file system is wired
+ * in and by tests. Nothing survives the process.
+ */
+class InMemoryAnalyticsSegmentStore : AnalyticsSegmentStore {
+    private var tail = ByteArray(0)
+    private val segments = mutableMapOf<Long, Pair<Int, ByteArray>>()
+    private var ackMarker = 0L
+
+    override val contentEncoding: String? = null
+
+    override fun appendTail(bytes: ByteArray) {
+        tail += bytes
+    }
+
+    override fun readTail(): ByteArray = tail
+
+    override fun truncateTail(length: Int) {
+        tail = tail.copyOf(length)
+    }
+
+    override fun sealTail(id: Long, eventCount: Int) {
+        segments[id] = eventCount to tail
+        tail = ByteArray(0)
+    }
+
+    override fun sealedSegments(): List<AnalyticsSegmentStore.SegmentInfo> =
+        segments.filterKeys { it > ackMarker }
+            .map { (id, segment) -> AnalyticsSegmentStore.SegmentInfo(id, segment.first) }
+            .sortedBy { it.id }
+
+    override fun readSegment(id: Long): ByteArray? = segments[id]?.second
+
+    override fun readAckMarker(): Long = ackMarker
+
+    override fun writeAckMarker(id: Long) {
+        ackMarker = id
+        segments.keys.removeAll { it <= id }
+    }
+
+    override fun clear() {
+        tail = ByteArray(0)
+        segments.clear()
+        ackMarker = 0L
+    }
+}
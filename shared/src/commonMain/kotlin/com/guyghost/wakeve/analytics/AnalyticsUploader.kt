@@ -0,0 +1,83 @@
+package com.guyghost.wakeve.analytics
+
+import kotlinx.coroutines.CancellationException
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.isActive
+import kotlinx.coroutines.launch
+
+/**
+ * Sends one sealed segment to the analytics backend.
+ */
+fun interface AnalyticsSegmentUploader {
+    /**
+     * @return Success once the backend has stored the whole segment; any failure
+     *   is retried later with backoff
+     */
+    suspend fun upload(segment: AnalyticsQueue.Segment): Result<Unit>
+}
+
+/**
+ * Drains an [AnalyticsQueue] through an [AnalyticsSegmentUploader].
+ *
+ * Each pass uploads segments oldest first and acknowledges them, until the
+ * queue is empty or an upload fails; the failed segment stays queued and the
+ * next pass waits for the backoff returned by [AnalyticsQueue.markAsFailed].
+ *
+ * Buffered events are written to the store every [flushIntervalMs] while
+ * running, so a crash loses at most that much; callers should also call
+ * [AnalyticsQueue.flush] when the app is backgrounded or stopped.
+ *
+ * @param isOnline Checked before each pass; offline passes upload nothing
+ * @param intervalMs Pause between passes once the queue is drained
+ * @param flushIntervalMs Pause between flushes of buffered events
+ */
+class AnalyticsUploader(
+    private val queue: AnalyticsQueue,
+    private val uploader: AnalyticsSegmentUploader,
+    private val isOnline: () -> Boolean = { true },
+    private val intervalMs: Long = DEFAULT_INTERVAL_MS,
+    private val flushIntervalMs: Long = DEFAULT_FLUSH_INTERVAL_MS
+) {
+    /**
+     * Uploads pending segments until the queue is empty or an upload fails.
+     *
+     * @return Delay before the next pass
+     */
+    suspend fun uploadPending(): Long {
+        if (!isOnline()) return intervalMs
+        while (true) {
+            val segment = queue.nextSegment() ?: return intervalMs
+            val uploaded = try {
+                uploader.upload(segment).isSuccess
+            } catch (e: CancellationException) {
+                throw e
+            } catch (e: Exception) {
+                false
+            }
+            if (!uploaded) return queue.markAsFailed(segment)
+            queue.acknowledge(segment)
+        }
+    }
+
+    /**
+     * Runs [uploadPending] and the periodic flush until [scope] is cancelled.
+     */
+    fun start(scope: CoroutineScope): Job = scope.launch {
+        launch {
+            while (isActive) {
+                delay(flushIntervalMs)
+                queue.flush()
+            }
+        }
+        while (isActive) {
+            delay(uploadPending())
+        }
+    }
+
+    private companion object {
+        const val DEFAULT_INTERVAL_MS = 5 * 60 * 1000L
+        const val DEFAULT_FLUSH_INTERVAL_MS = 30 * 1000L
+    }
+}
@@ -7,10 +7,16 @@ package com.guyghost.wakeve.analytics
  * - Android: Uses Firebase SDK via Google Play Services
  * - iOS: Uses Firebase SDK via CocoaPods
  *
- * @param analyticsQueue Queue for offline analytics event backup
+ * Queued events are flushed to disk periodically and when the app goes to the
+ * background or stops, and uploaded by [segmentUploader].
+ *
+ * @param analyticsQueue Queue for offline analytics event backup, persisted on disk by default
+ * @param segmentUploader Sends queued segments to the analytics backend. Required:
+ *   there is no default backend, and a queue nobody uploads only grows on disk.
  */
 expect class FirebaseAnalyticsProvider(
-    analyticsQueue: AnalyticsQueue
+    analyticsQueue: AnalyticsQueue = AnalyticsQueue(createAnalyticsSegmentStore()),
+    segmentUploader: AnalyticsSegmentUploader
 ) : AnalyticsProvider {
 
     override fun trackEvent(event: AnalyticsEvent, properties: Map<String, Any?>)
@@ -43,6 +43,16 @@ data class DeviceData(
     val updatedAt: String
 )
 
+/**
+ * A blacklisted token, identified by the SHA-256 hash of the raw JWT.
+ *
+ * @property expiresAt Expiry of the token itself; the entry is useless afterwards
+ */
+data class RevokedTokenData(
+    val tokenHash: String,
+    val expiresAt: String
+)
+
 /**
  * Repository for managing user sessions, JWT blacklist, and device fingerprints.
  *
@@ -51,8 +61,14 @@ data class DeviceData(
  * - JWT token blacklisting for revoked tokens
  * - Device fingerprinting for security
  * - Session lifecycle management (creation, validation, revocation)
+ *
+ * @param onTokenRevoked Called after each token is added to the blacklist, so
+ *   in-memory revocation sets can be updated without reading the table back
  */
-class SessionRepository(private val db: WakeveDb) {
+class SessionRepository(
+    private val db: WakeveDb,
+    private val onTokenRevoked: (RevokedTokenData) -> Unit = {}
+) {
 
     private val sessionQueries = db.sessionQueries
 
@@ -284,6 +300,28 @@ class SessionRepository(private val db: WakeveDb) {
         }
     }
 
+    /**
+     * All blacklisted tokens, e.g. to warm up an in-memory revocation set.
+     */
+    suspend fun getRevokedTokens(): Result<List<RevokedTokenData>> = withContext(Dispatchers.Default) {
+        runCatching {
+            sessionQueries.selectAllBlacklistedTokenHashes()
+                .executeAsList()
+                .map { RevokedTokenData(it.token_hash, it.expires_at) }
+        }
+    }
+
+    /**
+     * Tokens blacklisted at or after [revokedSince] (epoch millis), oldest first.
+     */
+    suspend fun getTokensRevokedSince(revokedSince: String): Result<List<RevokedTokenData>> = withContext(Dispatchers.Default) {
+        runCatching {
+            sessionQueries.selectBlacklistedTokenHashesRevokedSince(revokedSince)
+                .executeAsList()
+                .map { RevokedTokenData(it.token_hash, it.expires_at) }
+        }
+    }
+
     /**
      * Add a token to the blacklist.
      */
@@ -302,6 +340,7 @@ class SessionRepository(private val db: WakeveDb) {
                 reason = reason,
                 expires_at = expiresAt
             )
+            onTokenRevoked(RevokedTokenData(tokenHash, expiresAt))
         }
     }
 
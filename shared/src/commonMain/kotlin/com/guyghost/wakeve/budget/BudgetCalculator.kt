@@ -262,40 +262,14 @@ object BudgetCalculator {
     }
     
     /**
-     * Calculate simplified debt settlements using a greedy algorithm.
-     * Minimizes the number of transactions needed to settle all debts.
+     * Calculate debt settlements with the fewest transfers.
+     * Amounts are computed exactly in cents by [SettlementEngine].
      * 
      * @param items List of all budget items
      * @return List of (from, to, amount) tuples representing settlements
      */
-    fun calculateSettlements(items: List<BudgetItem>): List<Triple<String, String, Double>> {
-        val balances = calculateBalances(items).toMutableMap()
-        val settlements = mutableListOf<Triple<String, String, Double>>()
-        
-        // Filter out balanced participants
-        val debtors = balances.filter { it.value > 0.01 }.toMutableMap() // Owes money
-        val creditors = balances.filter { it.value < -0.01 }.toMutableMap() // Is owed
-        
-        // Greedy settlement algorithm
-        while (debtors.isNotEmpty() && creditors.isNotEmpty()) {
-            val (debtor, debtAmount) = debtors.entries.first()
-            val (creditor, creditAmount) = creditors.entries.first()
-            
-            val settlementAmount = minOf(debtAmount, -creditAmount)
-            
-            settlements.add(Triple(debtor, creditor, settlementAmount))
-            
-            // Update balances
-            debtors[debtor] = debtAmount - settlementAmount
-            creditors[creditor] = creditAmount + settlementAmount
-            
-            // Remove if settled
-            if (debtors[debtor]!! < 0.01) debtors.remove(debtor)
-            if (creditors[creditor]!! > -0.01) creditors.remove(creditor)
-        }
-        
-        return settlements
-    }
+    fun calculateSettlements(items: List<BudgetItem>): List<Triple<String, String, Double>> =
+        SettlementEngine.settle(items).map { Triple(it.from, it.to, it.amount) }
     
     /**
      * Validate a budget item before creation/update.
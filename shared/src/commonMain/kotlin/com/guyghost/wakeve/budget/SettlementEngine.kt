@@ -0,0 +1,258 @@
+package com.guyghost.wakeve.budget
+
+import com.guyghost.wakeve.models.BudgetItem
+import kotlin.math.roundToLong
+
+/**
+ * Settlement engine - computes who pays whom to settle a budget.
+ *
+ * Works in integer minor units (cents) so amounts are exact: item costs are
+ * split with the leftover cents going to the first sharers, and every balance
+ * is settled to the cent.
+ *
+ * Minimizing the number of transfers is the same as splitting participants
+ * into as many zero-sum groups as possible (a group of k settles in k - 1
+ * transfers). Up to [EXACT_GROUP_LIMIT] participants with a non-zero balance
+ * the split is found exactly by a subset-sum DP over bitmasks; above that,
+ * equal and opposite balances are cancelled pairwise and the rest is matched
+ * largest debtor to largest creditor with max-heaps.
+ *
+ * When payments do not cover shares yet (unpaid items), debts exceed credits;
+ * only the covered part is settled and nobody is asked to pay more than they owe.
+ */
+object SettlementEngine {
+
+    /** Participants above which the exact grouping is skipped for the heuristic. */
+    const val EXACT_GROUP_LIMIT = 16
+
+    /**
+     * One payment settling part of a debt, in minor units.
+     */
+    data class Transfer(
+        val from: String,
+        val to: String,
+        val amountMinor: Long
+    ) {
+        val amount: Double get() = amountMinor / MINOR_PER_UNIT.toDouble()
+    }
+
+    /**
+     * Net balance per participant in minor units, in one pass over the items.
+     * Positive = owes money, negative = is owed.
+     */
+    fun calculateBalances(items: List<BudgetItem>): Map<String, Long> {
+        val balances = HashMap<String, Long>()
+        items.forEach { item ->
+            val cost = if (item.isPaid && item.actualCost > 0.0) item.actualCost else item.estimatedCost
+            val shareCount = item.sharedBy.size
+            if (shareCount > 0) {
+                val costMinor = toMinorUnits(cost)
+                val share = costMinor / shareCount
+                val remainder = (costMinor % shareCount).toInt()
+                item.sharedBy.forEachIndexed { index, participantId ->
+                    val owed = if (index < remainder) share + 1 else share
+                    balances[participantId] = (balances[participantId] ?: 0L) + owed
+                }
+            }
+            val paidBy = item.paidBy
+            if (item.isPaid && paidBy != null) {
+                balances[paidBy] = (balances[paidBy] ?: 0L) - toMinorUnits(item.actualCost)
+            }
+        }
+        return balances
+    }
+
+    /**
+     * Transfers settling the balances of [items].
+     */
+    fun settle(items: List<BudgetItem>): List<Transfer> = settle(calculateBalances(items))
+
+    /**
+     * Transfers settling [balances] (minor units, positive = owes).
+     */
+    fun settle(balances: Map<String, Long>): List<Transfer> {
+        // Sorted for deterministic output
+        val participants = balances.filterValues { it != 0L }.keys.sorted()
+        val amounts = participants.map { balances.getValue(it) }.toMutableList()
+        val names = participants.toMutableList()
+
+        // Uncovered debt is owed to nobody yet: a virtual creditor absorbs it
+        // (or a virtual debtor the opposite) and its transfers are dropped.
+        val total = amounts.sum()
+        if (total != 0L) {
+            names.add(UNSETTLED)
+            amounts.add(-total)
+        }
+
+        val transfers = if (names.size <= EXACT_GROUP_LIMIT) {
+            zeroSumGroups(amounts).flatMap { group -> matchLargest(group.map { names[it] }, group.map { amounts[it] }) }
+        } else {
+            settleHeuristically(names, amounts)
+        }
+        return transfers.filter { it.from != UNSETTLED && it.to != UNSETTLED }
+    }
+
+    /**
+     * Splits indices of [amounts] (summing to zero) into the largest number of
+     * zero-sum groups. dp[mask] = most zero-sum groups that mask can be cut into,
+     * built by adding one member at a time and counting each time the running
+     * subset sums to zero.
+     */
+    private fun zeroSumGroups(amounts: List<Long>): List<List<Int>> {
+        val n = amounts.size
+        if (n == 0) return emptyList()
+        val full = (1 shl n) - 1
+        val sums = LongArray(full + 1)
+        val groups = IntArray(full + 1)
+        val lastAdded = IntArray(full + 1)
+        for (mask in 1..full) {
+            val low = mask.countTrailingZeroBits()
+            sums[mask] = sums[mask and (mask - 1)] + amounts[low]
+            var best = -1
+            var bestMember = 0
+            var remaining = mask
+            while (remaining != 0) {
+                val member = remaining.countTrailingZeroBits()
+                remaining = remaining and (remaining - 1)
+                val candidate = groups[mask xor (1 shl member)]
+                if (candidate > best) {
+                    best = candidate
+                    bestMember = member
+                }
+            }
+            groups[mask] = best + if (sums[mask] == 0L) 1 else 0
+            lastAdded[mask] = bestMember
+        }
+
+        // Walk back from the full set; each zero-sum prefix closes a group
+        val result = mutableListOf<List<Int>>()
+        var mask = full
+        var current = mutableListOf<Int>()
+        while (mask != 0) {
+            if (sums[mask] == 0L && current.isNotEmpty()) {
+                result.add(current)
+                current = mutableListOf()
+            }
+            val member = lastAdded[mask]
+            current.add(member)
+            mask = mask xor (1 shl member)
+        }
+        result.add(current)
+        return result
+    }
+
+    /**
+     * Cancels equal and opposite balances pairwise, then matches the rest
+     * largest to largest.
+     */
+    private fun settleHeuristically(names: List<String>, amounts: List<Long>): List<Transfer> {
+        val transfers = mutableListOf<Transfer>()
+        val remaining = amounts.toMutableList()
+        val creditorsByAmount = HashMap<Long, ArrayDeque<Int>>()
+        amounts.forEachIndexed { index, amount ->
+            if (amount < 0) creditorsByAmount.getOrPut(-amount) { ArrayDeque() }.addLast(index)
+        }
+        amounts.forEachIndexed { index, amount ->
+            if (amount > 0) {
+                val creditor = creditorsByAmount[amount]?.removeFirstOrNull() ?: return@forEachIndexed
+                transfers.add(Transfer(names[index], names[creditor], amount))
+                remaining[index] = 0
+                remaining[creditor] = 0
+            }
+        }
+        val open = remaining.indices.filter { remaining[it] != 0L }
+        return transfers + matchLargest(open.map { names[it] }, open.map { remaining[it] })
+    }
+
+    /**
+     * Repeatedly settles the largest debt against the largest credit.
+     * Each transfer clears at least one side, so k participants need at most k - 1.
+     */
+    private fun matchLargest(names: List<String>, amounts: List<Long>): List<Transfer> {
+        val debtors = MaxHeap(amounts.size)
+        val creditors = MaxHeap(amounts.size)
+        amounts.forEachIndexed { index, amount ->
+            if (amount > 0) debtors.push(amount, index) else if (amount < 0) creditors.push(-amount, index)
+        }
+        val transfers = mutableListOf<Transfer>()
+        while (!debtors.isEmpty() && !creditors.isEmpty()) {
+            val debt = debtors.peekAmount()
+            val debtor = debtors.pop()
+            val credit = creditors.peekAmount()
+            val creditor = creditors.pop()
+            val amount = minOf(debt, credit)
+            transfers.add(Transfer(names[debtor], names[creditor], amount))
+            if (debt > amount) debtors.push(debt - amount, debtor)
+            if (credit > amount) creditors.push(credit - amount, creditor)
+        }
+        return transfers
+    }
+
+    private fun toMinorUnits(amount: Double): Long = (amount * MINOR_PER_UNIT).roundToLong()
+
+    private const val MINOR_PER_UNIT = 100L
+    private const val UNSETTLED = "\u0000unsettled"
+
+    /**
+     * Binary max-heap of (amount, participant index); ties go to the lower index.
+     */
+    private class MaxHeap(capacity: Int) {
+        private var amounts = LongArray(maxOf(capacity, 1))
+        private var indices = IntArray(maxOf(capacity, 1))
+        private var size = 0
+
+        fun isEmpty(): Boolean = size == 0
+
+        fun peekAmount(): Long = amounts[0]
+
+        fun push(amount: Long, index: Int) {
+            if (size == amounts.size) {
+                amounts = amounts.copyOf(size * 2)
+                indices = indices.copyOf(size * 2)
+            }
+            var position = size++
+            amounts[position] = amount
+            indices[position] = index
+            while (position > 0) {
+                val parent = (position - 1) / 2
+                if (!above(position, parent)) break
+                swap(position, parent)
+                position = parent
+            }
+        }
+
+        /** Removes the top entry and returns its participant index. */
+        fun pop(): Int {
+            val top = indices[0]
+            size--
+            if (size > 0) {
+                amounts[0] = amounts[size]
+                indices[0] = indices[size]
+                var position = 0
+                while (true) {
+                    val left = 2 * position + 1
+                    val right = left + 1
+                    var largest = position
+                    if (left < size && above(left, largest)) largest = left
+                    if (right < size && above(right, largest)) largest = right
+                    if (largest == position) break
+                    swap(position, largest)
+                    position = largest
+                }
+            }
+            return top
+        }
+
+        private fun above(a: Int, b: Int): Boolean =
+            amounts[a] > amounts[b] || (amounts[a] == amounts[b] && indices[a] < indices[b])
+
+        private fun swap(a: Int, b: Int) {
+            val amount = amounts[a]
+            amounts[a] = amounts[b]
+            amounts[b] = amount
+            val index = indices[a]
+            indices[a] = indices[b]
+            indices[b] = index
+        }
+    }
+}
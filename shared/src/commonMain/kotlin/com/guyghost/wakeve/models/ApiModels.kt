@@ -194,7 +194,8 @@ data class ScenarioWithVotesResponse(
 data class CreatePotentialLocationRequest(
     val name: String,
     val locationType: String, // LocationType enum name (CITY, REGION, VENUE, ONLINE)
-    val address: String? = null
+    val address: String? = null,
+    val coordinates: Coordinates? = null // Makes the event findable by nearby search
 )
 
 @Serializable
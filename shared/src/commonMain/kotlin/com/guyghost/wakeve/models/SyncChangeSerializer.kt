@@ -0,0 +1,120 @@
+package com.guyghost.wakeve.models
+
+import kotlinx.serialization.KSerializer
+import kotlinx.serialization.Serializable
+import kotlinx.serialization.descriptors.SerialDescriptor
+import kotlinx.serialization.encoding.Decoder
+import kotlinx.serialization.encoding.Encoder
+import kotlinx.serialization.json.Json
+import kotlinx.serialization.json.JsonDecoder
+import kotlinx.serialization.json.JsonEncoder
+
+/**
+ * [SyncChange] keeps [SyncChange.data] as a JSON string in JSON bodies, unchanged on the
+ * wire, and sends it as a structured value in binary (CBOR) bodies.
+ *
+ * In CBOR the payload travels as the record its table implies (event, event delta,
+ * participant or vote), so its fields are encoded natively instead of as one nested
+ * JSON document. A payload that does not re-encode to the exact same JSON through its
+ * record travels as text, so decoding always gives back the original string.
+ */
+internal object SyncChangeSerializer : KSerializer<SyncChange> {
+    override val descriptor: SerialDescriptor = SyncChangeJsonForm.serializer().descriptor
+
+    override fun serialize(encoder: Encoder, value: SyncChange) {
+        if (encoder is JsonEncoder) {
+            encoder.encodeSerializableValue(SyncChangeJsonForm.serializer(), SyncChangeJsonForm.from(value))
+        } else {
+            encoder.encodeSerializableValue(SyncChangeBinaryForm.serializer(), SyncChangeBinaryForm.from(value))
+        }
+    }
+
+    override fun deserialize(decoder: Decoder): SyncChange =
+        if (decoder is JsonDecoder) {
+            decoder.decodeSerializableValue(SyncChangeJsonForm.serializer()).toChange()
+        } else {
+            decoder.decodeSerializableValue(SyncChangeBinaryForm.serializer()).toChange()
+        }
+}
+
+@Serializable
+private class SyncChangeJsonForm(
+    val id: String,
+    val table: String,
+    val operation: String,
+    val recordId: String,
+    val data: String,
+    val timestamp: String,
+    val userId: String,
+    val seq: Long = 0
+) {
+    fun toChange() = SyncChange(id, table, operation, recordId, data, timestamp, userId, seq)
+
+    companion object {
+        fun from(change: SyncChange) = with(change) {
+            SyncChangeJsonForm(id, table, operation, recordId, data, timestamp, userId, seq)
+        }
+    }
+}
+
+@Serializable
+private class SyncChangeBinaryForm(
+    val id: String,
+    val table: String,
+    val operation: String,
+    val recordId: String,
+    val payload: SyncChangePayload,
+    val timestamp: String,
+    val userId: String,
+    val seq: Long = 0
+) {
+    fun toChange() = SyncChange(id, table, operation, recordId, payload.toJson(), timestamp, userId, seq)
+
+    companion object {
+        fun from(change: SyncChange) = with(change) {
+            SyncChangeBinaryForm(id, table, operation, recordId, SyncChangePayload.of(table, operation, data), timestamp, userId, seq)
+        }
+    }
+}
+
+/** Exactly one field is set. */
+@Serializable
+private class SyncChangePayload(
+    val event: SyncEventData? = null,
+    val eventDelta: SyncEventDelta? = null,
+    val participant: SyncParticipantData? = null,
+    val vote: SyncVoteData? = null,
+    val text: String? = null
+) {
+    fun toJson(): String =
+        event?.let { payloadJson.encodeToString(SyncEventData.serializer(), it) }
+            ?: eventDelta?.let { payloadJson.encodeToString(SyncEventDelta.serializer(), it) }
+            ?: participant?.let { payloadJson.encodeToString(SyncParticipantData.serializer(), it) }
+            ?: vote?.let { payloadJson.encodeToString(SyncVoteData.serializer(), it) }
+            ?: text.orEmpty()
+
+    companion object {
+        // Strict: a payload with fields its record does not know must stay text
+        private val payloadJson = Json
+
+        fun of(table: String, operation: String, data: String): SyncChangePayload {
+            if (operation != SyncOperation.DELETE.name) {
+                val typed = when (table) {
+                    // A pulled update carries the full event, a pushed one a delta
+                    "events" -> typed(SyncEventData.serializer(), data)?.let { SyncChangePayload(event = it) }
+                        ?: typed(SyncEventDelta.serializer(), data)?.let { SyncChangePayload(eventDelta = it) }
+                    "participants" -> typed(SyncParticipantData.serializer(), data)?.let { SyncChangePayload(participant = it) }
+                    "votes" -> typed(SyncVoteData.serializer(), data)?.let { SyncChangePayload(vote = it) }
+                    else -> null
+                }
+                if (typed != null) return typed
+            }
+            return SyncChangePayload(text = data)
+        }
+
+        private fun <T> typed(serializer: KSerializer<T>, data: String): T? {
+            val value = runCatching { payloadJson.decodeFromString(serializer, data) }.getOrNull() ?: return null
+            return value.takeIf { payloadJson.encodeToString(serializer, it) == data }
+        }
+    }
+}
@@ -140,7 +140,7 @@ enum class SyncOperation {
 /**
  * Sync change record
  */
-@Serializable
+@Serializable(with = SyncChangeSerializer::class)
 data class SyncChange(
     val id: String,
     val table: String,  // "events", "participants", "votes"
@@ -148,7 +148,8 @@ data class SyncChange(
     val recordId: String,
     val data: String,  // JSON string of the record
     val timestamp: String,  // ISO 8601 UTC
-    val userId: String
+    val userId: String,
+    val seq: Long = 0  // Server change sequence; set on pulled rows only
 )
 
 /**
@@ -160,6 +161,37 @@ data class SyncRequest(
     val lastSyncTimestamp: String? = null  // Client's last successful sync
 )
 
+/**
+ * High-water mark for one table: the server change sequence of the last row the client applied
+ */
+@Serializable
+data class SyncTableVersion(
+    val seq: Long = 0
+)
+
+/**
+ * Delta pull request: the client's per-table version vector
+ */
+@Serializable
+data class SyncPullRequest(
+    val versions: Map<String, SyncTableVersion> = emptyMap(),
+    val limit: Int = 500  // Max rows per table in one page
+)
+
+/**
+ * Delta pull response: rows changed since the request's vector, and the advanced vector
+ */
+@Serializable
+data class SyncPullResponse(
+    val success: Boolean,
+    val changes: List<SyncChange> = emptyList(),
+    val versions: Map<String, SyncTableVersion> = emptyMap(),
+    val hasMore: Boolean = false,  // At least one table filled its page; pull again
+    val tablesWithMore: List<String> = emptyList(),  // Tables that filled their page
+    val serverTimestamp: String,
+    val message: String? = null
+)
+
 /**
  * Sync response payload
  */
@@ -197,7 +229,8 @@ data class SyncMetadata(
     val userId: String,
     val synced: Boolean = false,
     val retryCount: Int = 0,
-    val lastError: String? = null
+    val lastError: String? = null,
+    val payload: String? = null  // Field-level delta recorded with the change
 )
 
 /**
@@ -210,13 +243,31 @@ data class SyncEventData(
     val description: String,
     val organizerId: String,
     val deadline: String,
-    val timezone: String
+    val timezone: String = "UTC",
+    val status: String? = null,
+    val updatedAt: String? = null
+)
+
+/**
+ * Field-level event delta: only the fields that changed are present.
+ * A full [SyncEventData] snapshot also decodes as a delta.
+ */
+@Serializable
+data class SyncEventDelta(
+    val title: String? = null,
+    val description: String? = null,
+    val deadline: String? = null,
+    val status: String? = null
 )
 
 @Serializable
 data class SyncParticipantData(
     val eventId: String,
-    val userId: String
+    val userId: String,
+    val id: String? = null,
+    val role: String? = null,
+    val hasValidatedDate: Boolean? = null,
+    val updatedAt: String? = null
 )
 
 @Serializable
@@ -1,9 +1,33 @@
 package com.guyghost.wakeve.moderation
 
+import kotlin.concurrent.Volatile
+
+/**
+ * Classifies user-generated text before it is published.
+ *
+ * All term lists are compiled into one [ModerationTermMatcher], so a message is
+ * scanned once whatever the size of the lists. [updateTerms] swaps in new lists
+ * at runtime; callers keep the same instance.
+ */
 class ModerationPolicy(
-    private val hardPolicyTerms: Set<String> = DEFAULT_HARD_POLICY_TERMS,
-    private val pendingReviewTerms: Set<String> = DEFAULT_PENDING_REVIEW_TERMS
+    hardPolicyTerms: Set<String> = DEFAULT_HARD_POLICY_TERMS,
+    pendingReviewTerms: Set<String> = DEFAULT_PENDING_REVIEW_TERMS,
+    spamTerms: Set<String> = SPAM_WORDS
 ) {
+    @Volatile
+    private var matcher: ModerationTermMatcher = compile(hardPolicyTerms, pendingReviewTerms, spamTerms)
+
+    /**
+     * Replaces the term lists. Evaluations already running finish with the old lists.
+     */
+    fun updateTerms(
+        hardPolicyTerms: Set<String>,
+        pendingReviewTerms: Set<String>,
+        spamTerms: Set<String> = SPAM_WORDS
+    ) {
+        matcher = compile(hardPolicyTerms, pendingReviewTerms, spamTerms)
+    }
+
     fun evaluate(text: String): ModerationResult {
         val normalized = text.normalizeForModeration()
 
@@ -15,7 +39,9 @@ class ModerationPolicy(
             )
         }
 
-        if (hardPolicyTerms.any { normalized.contains(it) }) {
+        val hits = matcher.scan(normalized)
+
+        if (hits.contains(ModerationTermCategory.HARD_POLICY)) {
             return ModerationResult(
                 status = ModerationStatus.REJECTED,
                 reasonCode = "hard_policy_term",
@@ -23,7 +49,7 @@ class ModerationPolicy(
             )
         }
 
-        if (containsSpamPattern(normalized) || pendingReviewTerms.any { normalized.contains(it) }) {
+        if (containsSpamPattern(normalized, hits) || hits.contains(ModerationTermCategory.PENDING_REVIEW)) {
             return ModerationResult(
                 status = ModerationStatus.PENDING_REVIEW,
                 reasonCode = "needs_review",
@@ -38,13 +64,47 @@ class ModerationPolicy(
         )
     }
 
-    private fun containsSpamPattern(normalized: String): Boolean {
-        val linkCount = LINK_PATTERN.findAll(normalized).count()
-        val repeatedPhoneLikeDigits = DIGIT_PATTERN.findAll(normalized).count() >= 3
-        val repeatedSalesWords = SPAM_WORDS.count { normalized.contains(it) } >= 2
+    private fun containsSpamPattern(normalized: String, hits: ModerationTermHits): Boolean {
+        val linkCount = hits.occurrences(ModerationTermCategory.LINK)
+        val repeatedPhoneLikeDigits = countDigitRuns(normalized) >= 3
+        val repeatedSalesWords = hits.distinct(ModerationTermCategory.SPAM) >= 2
         return linkCount >= 2 || repeatedPhoneLikeDigits || repeatedSalesWords
     }
 
+    // Runs of at least MIN_DIGIT_RUN digits, like phone or account numbers
+    private fun countDigitRuns(normalized: String): Int {
+        var runs = 0
+        var runLength = 0
+        for (char in normalized) {
+            if (char.isAsciiDigit()) {
+                runLength++
+                if (runLength == MIN_DIGIT_RUN) runs++
+            } else {
+                runLength = 0
+            }
+        }
+        return runs
+    }
+
+    private fun Char.isAsciiDigit(): Boolean = this in '0'..'9'
+
+    private fun compile(
+        hardPolicyTerms: Set<String>,
+        pendingReviewTerms: Set<String>,
+        spamTerms: Set<String>
+    ): ModerationTermMatcher =
+        ModerationTermMatcher.compile(
+            mapOf(
+                ModerationTermCategory.HARD_POLICY to hardPolicyTerms.normalizeTerms(),
+                ModerationTermCategory.PENDING_REVIEW to pendingReviewTerms.normalizeTerms(),
+                ModerationTermCategory.SPAM to spamTerms.normalizeTerms(),
+                ModerationTermCategory.LINK to LINK_PREFIXES
+            )
+        )
+
+    private fun Set<String>.normalizeTerms(): Set<String> =
+        mapTo(mutableSetOf()) { it.normalizeForModeration() }
+
     private fun String.normalizeForModeration(): String =
         trim()
             .lowercase()
@@ -53,11 +113,12 @@ class ModerationPolicy(
     companion object {
         const val SAFE_REJECTION_MESSAGE = "This content cannot be posted. Please revise it and try again."
 
-        private val LINK_PATTERN = Regex("""https?://|www\.""")
-        private val DIGIT_PATTERN = Regex("""\d{3,}""")
+        private const val MIN_DIGIT_RUN = 3
+        private val LINK_PREFIXES = setOf("http://", "https://", "www.")
         private val WHITESPACE_PATTERN = Regex("""\s+""")
 
-        private val SPAM_WORDS = setOf(
+        /** Built-in spam terms, used when no spam list is supplied */
+        val SPAM_WORDS = setOf(
             "free money",
             "limited offer",
             "wire transfer",
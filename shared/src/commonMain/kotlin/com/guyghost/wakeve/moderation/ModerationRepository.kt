@@ -146,9 +146,23 @@ class ModerationRepository(
     fun isBlockedForEvent(blockerUserId: String, blockedUserId: String, eventId: String): Boolean =
         queries.isUserBlockedForEvent(blockerUserId, blockedUserId, eventId).executeAsOne() > 0
 
+    /**
+     * Active blocks applying to [eventId] whose blocker is one of [blockerUserIds],
+     * as blocked user to the set of users blocking them.
+     */
+    fun getBlockersByBlockedUserForEvent(eventId: String, blockerUserIds: Collection<String>): Map<String, Set<String>> =
+        blockerUserIds.distinct()
+            .chunked(BLOCKER_QUERY_CHUNK_SIZE)
+            .flatMap { chunk -> queries.selectActiveBlocksForEventByBlockers(eventId, chunk).executeAsList() }
+            .groupBy({ it.blocked_user_id }, { it.blocker_user_id })
+            .mapValues { (_, blockers) -> blockers.toSet() }
+
     private fun now(): String = clock.now().toString()
 }
 
+// Keeps the IN list under SQLite's bound-parameter limit
+private const val BLOCKER_QUERY_CHUNK_SIZE = 500
+
 private fun Content_report.toModel(): ContentReport =
     ContentReport(
         id = id,
@@ -0,0 +1,175 @@
+package com.guyghost.wakeve.moderation
+
+/**
+ * Term lists checked by [ModerationPolicy], one per outcome.
+ */
+enum class ModerationTermCategory {
+    HARD_POLICY,
+    PENDING_REVIEW,
+    SPAM,
+    LINK
+}
+
+/**
+ * Result of one [ModerationTermMatcher.scan].
+ */
+class ModerationTermHits internal constructor(
+    private val distinctCounts: IntArray,
+    private val occurrenceCounts: IntArray
+) {
+    /** Number of different terms of [category] found. */
+    fun distinct(category: ModerationTermCategory): Int = distinctCounts[category.ordinal]
+
+    /** Number of matches of [category] terms, repeats included. */
+    fun occurrences(category: ModerationTermCategory): Int = occurrenceCounts[category.ordinal]
+
+    fun contains(category: ModerationTermCategory): Boolean = distinct(category) > 0
+}
+
+/**
+ * Aho-Corasick automaton over every moderation term.
+ *
+ * Compiled once per term set; [scan] then finds all occurrences of all terms in a
+ * single pass over the text, whatever the number of terms. Instances are
+ * immutable and safe to share between threads.
+ */
+class ModerationTermMatcher private constructor(
+    // Per state: sorted transition characters and their target states
+    private val transitionChars: Array<CharArray>,
+    private val transitionTargets: Array<IntArray>,
+    private val failure: IntArray,
+    // Nearest state on the failure chain (itself included) that ends a term, or -1
+    private val outputLink: IntArray,
+    private val termAtState: IntArray,
+    private val termCategories: Array<ModerationTermCategory>
+) {
+    val termCount: Int get() = termCategories.size
+
+    /**
+     * Finds every term occurrence in [text], per category.
+     */
+    fun scan(text: String): ModerationTermHits {
+        var seen: BooleanArray? = null
+        val distinct = IntArray(CATEGORIES.size)
+        val occurrences = IntArray(CATEGORIES.size)
+        var state = ROOT
+
+        for (char in text) {
+            while (true) {
+                val next = next(state, char)
+                if (next != NO_STATE) {
+                    state = next
+                    break
+                }
+                if (state == ROOT) break
+                state = failure[state]
+            }
+
+            var match = outputLink[state]
+            while (match != NO_STATE) {
+                val term = termAtState[match]
+                val category = termCategories[term].ordinal
+                occurrences[category]++
+                var hits = seen
+                if (hits == null) {
+                    hits = BooleanArray(termCategories.size)
+                    seen = hits
+                }
+                if (!hits[term]) {
+                    hits[term] = true
+                    distinct[category]++
+                }
+                match = outputLink[failure[match]]
+            }
+        }
+
+        return ModerationTermHits(distinct, occurrences)
+    }
+
+    private fun next(state: Int, char: Char): Int {
+        val chars = transitionChars[state]
+        var low = 0
+        var high = chars.size - 1
+        while (low <= high) {
+            val mid = (low + high) ushr 1
+            val candidate = chars[mid]
+            when {
+                candidate < char -> low = mid + 1
+                candidate > char -> high = mid - 1
+                else -> return transitionTargets[state][mid]
+            }
+        }
+        return NO_STATE
+    }
+
+    companion object {
+        private const val ROOT = 0
+        private const val NO_STATE = -1
+        private val CATEGORIES = ModerationTermCategory.entries
+
+        /**
+         * Builds the automaton. Terms are matched as given, so they should already be
+         * normalized the way the scanned text is; blank terms are ignored.
+         */
+        fun compile(terms: Map<ModerationTermCategory, Set<String>>): ModerationTermMatcher {
+            val children = mutableListOf(HashMap<Char, Int>())
+            val termAtState = mutableListOf(NO_STATE)
+            val termCategories = mutableListOf<ModerationTermCategory>()
+
+            for ((category, categoryTerms) in terms) {
+                for (term in categoryTerms) {
+                    if (term.isBlank()) continue
+                    var state = ROOT
+                    for (char in term) {
+                        state = children[state].getOrPut(char) {
+                            children += HashMap()
+                            termAtState += NO_STATE
+                            children.size - 1
+                        }
+                    }
+                    // The same term in two lists counts for the first one only
+                    if (termAtState[state] == NO_STATE) {
+                        termAtState[state] = termCategories.size
+                        termCategories += category
+                    }
+                }
+            }
+
+            val stateCount = children.size
+            val failure = IntArray(stateCount)
+            val outputLink = IntArray(stateCount) { NO_STATE }
+            val queue = ArrayDeque<Int>()
+            for (child in children[ROOT].values) {
+                failure[child] = ROOT
+                queue += child
+            }
+            // Breadth-first, so a state's failure target is complete before its children
+            while (queue.isNotEmpty()) {
+                val state = queue.removeFirst()
+                outputLink[state] = if (termAtState[state] != NO_STATE) state else outputLink[failure[state]]
+                for ((char, child) in children[state]) {
+                    var fallback = failure[state]
+                    while (fallback != ROOT && char !in children[fallback]) {
+                        fallback = failure[fallback]
+                    }
+                    failure[child] = children[fallback][char] ?: ROOT
+                    queue += child
+                }
+            }
+
+            val transitionChars = Array(stateCount) { state -> children[state].keys.sorted().toCharArray() }
+            val transitionTargets = Array(stateCount) { state ->
+                IntArray(transitionChars[state].size) { i -> children[state].getValue(transitionChars[state][i]) }
+            }
+
+            return ModerationTermMatcher(
+                transitionChars = transitionChars,
+                transitionTargets = transitionTargets,
+                failure = failure,
+                outputLink = outputLink,
+                termAtState = termAtState.toIntArray(),
+                termCategories = termCategories.toTypedArray()
+            )
+        }
+    }
+}
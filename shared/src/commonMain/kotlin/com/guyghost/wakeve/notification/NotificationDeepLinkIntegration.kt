@@ -160,6 +160,22 @@ fun NotificationRequest.withDeepLink(): NotificationRequest {
     )
 }
 
+/**
+ * Extension function to add deep link to a broadcast notification.
+ *
+ * @return A new BroadcastNotification with deep link data added
+ */
+fun BroadcastNotification.withDeepLink(): BroadcastNotification {
+    val deepLink = DeepLinkFactory.createFromNotification(
+        notificationType = type.name,
+        eventId = eventId,
+        additionalParams = data
+    )
+    return copy(
+        data = data + createDeepLinkData(deepLink, deepLink.toDeepLinkRoute())
+    )
+}
+
 /**
  * Extension function to add a specific deep link route to a notification request.
  *
@@ -15,3 +15,27 @@ data class NotificationRequest(
     val section: String? = null,
     val sectionItemId: String? = null
 )
+
+/**
+ * Content of a notification sent to many users at once. It carries no recipient:
+ * the recipients are passed alongside it to [NotificationService.sendBroadcast].
+ */
+data class BroadcastNotification(
+    val type: NotificationType,
+    val title: String,
+    val body: String,
+    val eventId: String? = null,
+    val data: Map<String, String> = emptyMap()
+) {
+    /**
+     * The per-recipient request, used for validation and preference checks
+     */
+    fun toRequest(userId: String): NotificationRequest = NotificationRequest(
+        userId = userId,
+        type = type,
+        title = title,
+        body = body,
+        eventId = eventId,
+        data = data
+    )
+}
@@ -110,6 +110,74 @@ class NotificationService(
         }
     }
 
+    /**
+     * Sends the same notification to many users at once.
+     *
+     * Every user still gets a history row and a preference check, but the push
+     * payload is shared so that senders can coalesce it into one multicast per
+     * platform: its `notificationId` is a broadcast id, and each user's row is
+     * stored as `<broadcastId>:<userId>` (resolved by [markAsReadForUser] and
+     * [deleteNotificationForUser]). Tokens are loaded in bulk.
+     *
+     * @param notification Notification to send
+     * @param userIds Recipients
+     * @return One result per user id, in order: the stored notification id, or why it was not sent
+     */
+    @OptIn(ExperimentalUuidApi::class)
+    suspend fun sendBroadcast(
+        notification: BroadcastNotification,
+        userIds: List<String>,
+        currentTime: Instant = Clock.System.now()
+    ): List<Result<String>> = withContext(Dispatchers.Default) {
+        val broadcastId = Uuid.random().toString()
+        val eligible = userIds.map { userId ->
+            runCatching {
+                val normalizedRequest = normalizeNotificationRequest(notification.toRequest(userId)).getOrThrow()
+                val preferences = preferencesRepository.getPreferences(normalizedRequest.userId)
+                    ?: defaultNotificationPreferences(normalizedRequest.userId)
+
+                if (!preferences.shouldSend(normalizedRequest.type, currentTime)) {
+                    error("Notification type ${normalizedRequest.type.name} is disabled or in quiet hours")
+                }
+                normalizedRequest
+            }
+        }
+        val recipients = eligible.mapNotNull { it.getOrNull() }.distinctBy { it.userId }
+        val template = recipients.firstOrNull()
+            ?: return@withContext eligible.map { result -> result.map { broadcastNotificationId(broadcastId, it.userId) } }
+
+        val nowMs = Clock.System.now().toEpochMilliseconds()
+        val payload = template.data + ("notificationId" to broadcastId)
+        val encodedPayload = Json.encodeToString(payload)
+        database.transaction {
+            recipients.forEach { recipient ->
+                database.notificationQueries.insertNotification(
+                    id = broadcastNotificationId(broadcastId, recipient.userId),
+                    user_id = recipient.userId,
+                    type = template.type.name,
+                    title = template.title,
+                    body = template.body,
+                    data_ = encodedPayload,
+                    created_at = nowMs,
+                    sent_at = nowMs
+                )
+            }
+        }
+
+        val tokens = recipients.map { it.userId }
+            .chunked(TOKEN_LOOKUP_CHUNK_SIZE)
+            .flatMap { chunk -> database.notificationQueries.getTokensByUsers(chunk).executeAsList() }
+            .groupBy({ it.platform.uppercase() }, { it.token })
+        tokens[Platform.ANDROID.name]?.let { androidTokens ->
+            runCatching { fcmSender.sendMulticast(androidTokens, template.title, template.body, payload) }
+        }
+        tokens[Platform.IOS.name]?.let { iosTokens ->
+            runCatching { apnsSender.sendMulticast(iosTokens, template.title, template.body, payload) }
+        }
+
+        eligible.map { result -> result.map { broadcastNotificationId(broadcastId, it.userId) } }
+    }
+
     suspend fun getUnreadNotifications(
         userId: String,
         limit: Int = 50
@@ -150,17 +218,12 @@ class NotificationService(
         runCatching {
             val normalizedNotificationId = normalizeNotificationId(notificationId).getOrThrow()
             val normalizedUserId = normalizeNotificationUserId(userId).getOrThrow()
-            val notification = database.notificationQueries
-                .getNotificationById(normalizedNotificationId)
-                .executeAsOneOrNull()
-
-            if (notification?.user_id != normalizedUserId) {
-                error("Notification not found for authenticated user")
-            }
+            val storedId = findNotificationIdForUser(normalizedNotificationId, normalizedUserId)
+                ?: error("Notification not found for authenticated user")
 
             database.notificationQueries.markAsReadForUser(
                 read_at = Clock.System.now().toEpochMilliseconds(),
-                id = normalizedNotificationId,
+                id = storedId,
                 user_id = normalizedUserId
             )
         }
@@ -189,16 +252,11 @@ class NotificationService(
         runCatching {
             val normalizedNotificationId = normalizeNotificationId(notificationId).getOrThrow()
             val normalizedUserId = normalizeNotificationUserId(userId).getOrThrow()
-            val notification = database.notificationQueries
-                .getNotificationById(normalizedNotificationId)
-                .executeAsOneOrNull()
-
-            if (notification?.user_id != normalizedUserId) {
-                error("Notification not found for authenticated user")
-            }
+            val storedId = findNotificationIdForUser(normalizedNotificationId, normalizedUserId)
+                ?: error("Notification not found for authenticated user")
 
             database.notificationQueries.deleteNotificationForUser(
-                id = normalizedNotificationId,
+                id = storedId,
                 user_id = normalizedUserId
             )
         }
@@ -209,8 +267,22 @@ class NotificationService(
 
     suspend fun updatePreferences(preferences: NotificationPreferences): Result<Unit> =
         preferencesRepository.savePreferences(preferences)
+
+    /**
+     * Id of the user's row for [notificationId], which is either the row id
+     * itself or, for a broadcast, the shared id carried by the push payload.
+     */
+    private fun findNotificationIdForUser(notificationId: String, userId: String): String? =
+        listOf(notificationId, broadcastNotificationId(notificationId, userId)).firstOrNull { id ->
+            database.notificationQueries.getNotificationById(id).executeAsOneOrNull()?.user_id == userId
+        }
 }
 
+internal fun broadcastNotificationId(broadcastId: String, userId: String): String = "$broadcastId:$userId"
+
+// Keeps IN (...) lists under SQLite's bound-parameter limit
+private const val TOKEN_LOOKUP_CHUNK_SIZE = 500
+
 internal fun normalizeNotificationRequest(request: NotificationRequest): Result<NotificationRequest> {
     val normalizedUserId = normalizeNotificationUserId(request.userId).getOrElse { return Result.failure(it) }
 
@@ -323,6 +395,17 @@ interface FCMSender {
         body: String,
         data: Map<String, String>
     ): Result<Unit>
+
+    /**
+     * Sends one payload to many tokens and returns one result per token, in order.
+     * Senders with a multicast API override this; by default tokens are sent one by one.
+     */
+    suspend fun sendMulticast(
+        tokens: List<String>,
+        title: String,
+        body: String,
+        data: Map<String, String>
+    ): List<Result<Unit>> = tokens.map { sendNotification(it, title, body, data) }
 }
 
 interface APNsSender {
@@ -332,8 +415,25 @@ interface APNsSender {
         body: String,
         data: Map<String, String>
     ): Result<Unit>
+
+    /**
+     * Sends one payload to many tokens and returns one result per token, in order.
+     * Senders that can multiplex requests override this; by default tokens are sent one by one.
+     */
+    suspend fun sendMulticast(
+        tokens: List<String>,
+        title: String,
+        body: String,
+        data: Map<String, String>
+    ): List<Result<Unit>> = tokens.map { sendNotification(it, title, body, data) }
 }
 
+/**
+ * Push delivery failure reported by a sender. [retryable] failures (gateway
+ * unavailable, throttled) may succeed later; the others (invalid token) will not.
+ */
+class PushDeliveryException(message: String, val retryable: Boolean) : Exception(message)
+
 object NoConfiguredFCMSender : FCMSender {
     override suspend fun sendNotification(
         token: String,
@@ -1,6 +1,7 @@
 package com.guyghost.wakeve.payment
 
 import com.guyghost.wakeve.budget.BudgetRepository
+import com.guyghost.wakeve.budget.SettlementEngine
 import com.guyghost.wakeve.database.WakeveDb
 import kotlinx.datetime.Clock
 import kotlinx.serialization.Serializable
@@ -34,18 +35,18 @@ class SettlementRepository(private val db: WakeveDb) {
         budgetRepository: BudgetRepository
     ): List<SettlementRecord> {
         val now = Clock.System.now().toString()
-        val suggestions = budgetRepository.getSettlements(budgetId)
+        val transfers = SettlementEngine.settle(budgetRepository.getBudgetItems(budgetId))
 
         db.transaction {
             db.settlementQueries.deleteByBudgetId(budgetId)
-            suggestions.forEach { (from, to, amount) ->
+            transfers.forEach { transfer ->
                 db.settlementQueries.insertSettlement(
                     id = generateId(),
                     eventId = eventId,
                     budgetId = budgetId,
-                    fromParticipantId = from,
-                    toParticipantId = to,
-                    amount = amount,
+                    fromParticipantId = transfer.from,
+                    toParticipantId = transfer.to,
+                    amount = transfer.amount,
                     status = "PERSISTED",
                     createdAt = now,
                     updatedAt = now
@@ -2,6 +2,8 @@ package com.guyghost.wakeve.repository
 
 import com.guyghost.wakeve.access.ParticipantRepositoryRecord
 import com.guyghost.wakeve.database.WakeveDb
+import com.guyghost.wakeve.database.Event as EventRow
+import com.guyghost.wakeve.database.TimeSlot as TimeSlotRow
 import com.guyghost.wakeve.repository.EventRepositoryInterface
 import com.guyghost.wakeve.models.Event
 import com.guyghost.wakeve.models.EventPlanningMode
@@ -13,6 +15,8 @@ import com.guyghost.wakeve.models.NearbyEventsResponse
 import com.guyghost.wakeve.models.Poll
 import com.guyghost.wakeve.models.RecommendedEventsResponse
 import com.guyghost.wakeve.models.SearchResultsResponse
+import com.guyghost.wakeve.models.SyncEventData
+import com.guyghost.wakeve.models.SyncEventDelta
 import com.guyghost.wakeve.models.SyncOperation
 import com.guyghost.wakeve.models.TimeOfDay
 import com.guyghost.wakeve.models.TimeSlot
@@ -24,7 +28,9 @@ import com.guyghost.wakeve.sync.SyncManager
 import com.guyghost.wakeve.workflow.WorkflowOutboxRecord
 import kotlinx.coroutines.flow.Flow
 import kotlinx.coroutines.flow.flowOf
+import kotlinx.serialization.json.Json
 import kotlin.math.PI
+import kotlin.math.abs
 import kotlin.math.asin
 import kotlin.math.cos
 import kotlin.math.round
@@ -43,88 +49,108 @@ class DatabaseEventRepository(private val db: WakeveDb, private val syncManager:
     private val confirmedDateQueries = db.confirmedDateQueries
     private val syncMetadataQueries = db.syncMetadataQueries
     private val workflowOutbox = mutableListOf<WorkflowOutboxRecord>()
+    private val syncJson = Json { ignoreUnknownKeys = true }
 
     override suspend fun createEvent(event: Event): Result<Event> {
         return try {
-            val now = getCurrentUtcIsoString()
-            // Determine isSample flag from ID prefix
-            val isSample = com.guyghost.wakeve.sample.SampleEventFactory.isSampleEventId(event.id)
-
-            eventQueries.insertEvent(
-                id = event.id,
-                organizerId = event.organizerId,
-                title = event.title,
-                description = event.description,
-                status = event.status.name,
-                deadline = event.deadline,
-                createdAt = now,
-                updatedAt = now,
-                version = 1,
-                eventType = event.eventType.name,
-                eventTypeCustom = event.eventTypeCustom,
-                minParticipants = event.minParticipants?.toLong(),
-                maxParticipants = event.maxParticipants?.toLong(),
-                expectedParticipants = event.expectedParticipants?.toLong(),
-                isSample = if (isSample) 1L else 0L
-            )
-            eventQueries.updateEventPlanningMode(
-                planningMode = event.planningMode.name,
-                updatedAt = now,
-                id = event.id
-            )
+            insertEventRecords(event, getCurrentUtcIsoString())
 
-            // Insert organizer as participant
-            val organizerId = "org_${event.id}"
-            participantQueries.insertParticipant(
-                id = organizerId,
-                eventId = event.id,
-                userId = event.organizerId,
-                role = "ORGANIZER",
-                hasValidatedDate = 0,
-                joinedAt = now,
-                updatedAt = now
-            )
-
-            // Insert proposed time slots
-            event.proposedSlots.forEach { slot ->
-                timeSlotQueries.insertTimeSlot(
-                    id = slot.id,
-                    eventId = event.id,
-                    startTime = slot.start,
-                    endTime = slot.end,
-                    timezone = slot.timezone,
-                    proposedByParticipantId = null,
-                    createdAt = now,
-                    updatedAt = now,
-                    timeOfDay = slot.timeOfDay.name
-                )
-            }
-
-            // Record creation in sync metadata
             // Record sync change for offline tracking
             syncManager?.recordLocalChange(
                 table = "events",
                 operation = SyncOperation.CREATE,
                 recordId = event.id,
-                data = """{"id":"${event.id}","title":"${event.title}","description":"${event.description}","organizerId":"${event.organizerId}","deadline":"${event.deadline}"}""",
+                data = syncJson.encodeToString(
+                    SyncEventData.serializer(),
+                    SyncEventData(
+                        id = event.id,
+                        title = event.title,
+                        description = event.description,
+                        organizerId = event.organizerId,
+                        deadline = event.deadline,
+                        timezone = event.proposedSlots.firstOrNull()?.timezone ?: "UTC",
+                        status = event.status.name
+                    )
+                ),
                 userId = event.organizerId
             )
 
-            syncMetadataQueries.insertSyncMetadata(
-                id = "sync_${event.id}",
-                entityType = "event",
-                entityId = event.id,
-                operation = "CREATE",
-                timestamp = now,
-                synced = 0
-            )
-
             Result.success(event)
         } catch (e: Exception) {
             Result.failure(e)
         }
     }
 
+    /**
+     * Writes a new event's rows (event, organizer participant, time slots, sync metadata)
+     * without recording a client sync change. Non-suspending so it can run inside a
+     * caller's transaction, e.g. the server's batched sync apply.
+     */
+    fun insertEventRecords(event: Event, now: String = getCurrentUtcIsoString()) {
+        // Determine isSample flag from ID prefix
+        val isSample = com.guyghost.wakeve.sample.SampleEventFactory.isSampleEventId(event.id)
+
+        eventQueries.insertEvent(
+            id = event.id,
+            organizerId = event.organizerId,
+            title = event.title,
+            description = event.description,
+            status = event.status.name,
+            deadline = event.deadline,
+            createdAt = now,
+            updatedAt = now,
+            version = 1,
+            eventType = event.eventType.name,
+            eventTypeCustom = event.eventTypeCustom,
+            minParticipants = event.minParticipants?.toLong(),
+            maxParticipants = event.maxParticipants?.toLong(),
+            expectedParticipants = event.expectedParticipants?.toLong(),
+            isSample = if (isSample) 1L else 0L
+        )
+        eventQueries.updateEventPlanningMode(
+            planningMode = event.planningMode.name,
+            updatedAt = now,
+            id = event.id
+        )
+
+        // Insert organizer as participant
+        val organizerId = "org_${event.id}"
+        participantQueries.insertParticipant(
+            id = organizerId,
+            eventId = event.id,
+            userId = event.organizerId,
+            role = "ORGANIZER",
+            hasValidatedDate = 0,
+            joinedAt = now,
+            updatedAt = now
+        )
+
+        // Insert proposed time slots
+        event.proposedSlots.forEach { slot ->
+            timeSlotQueries.insertTimeSlot(
+                id = slot.id,
+                eventId = event.id,
+                startTime = slot.start,
+                endTime = slot.end,
+                timezone = slot.timezone,
+                proposedByParticipantId = null,
+                createdAt = now,
+                updatedAt = now,
+                timeOfDay = slot.timeOfDay.name
+            )
+        }
+
+        // Record creation in sync metadata
+        syncMetadataQueries.insertSyncMetadata(
+            id = "sync_${event.id}",
+            entityType = "event",
+            entityId = event.id,
+            operation = "CREATE",
+            timestamp = now,
+            synced = 0
+        )
+    }
+
     override fun getEvent(id: String): Event? {
         return try {
             val eventRow = eventQueries.selectById(id).executeAsOneOrNull() ?: return null
@@ -132,38 +158,111 @@ class DatabaseEventRepository(private val db: WakeveDb, private val syncManager:
             val timeSlots = timeSlotQueries.selectByEventId(id).executeAsList()
             val confirmedSlot = confirmedDateQueries.selectWithTimeslotDetails(id).executeAsOneOrNull()
 
-            Event(
-                id = eventRow.id,
-                title = eventRow.title,
-                description = eventRow.description,
-                organizerId = eventRow.organizerId,
+            toEvent(
+                eventRow = eventRow,
                 participants = participants.map { it.userId },
-                proposedSlots = timeSlots.map {
-                    TimeSlot(
-                        id = it.id,
-                        start = it.startTime,
-                        end = it.endTime,
-                        timezone = it.timezone,
-                        timeOfDay = parseTimeOfDay(it.timeOfDay)
-                    )
-                },
-                deadline = eventRow.deadline,
-                status = parseEventStatus(eventRow.status),
-                finalDate = confirmedSlot?.startTime,
-                createdAt = eventRow.createdAt,
-                updatedAt = eventRow.updatedAt,
-                eventType = parseEventType(eventRow.eventType),
-                eventTypeCustom = eventRow.eventTypeCustom,
-                minParticipants = eventRow.minParticipants?.toInt(),
-                maxParticipants = eventRow.maxParticipants?.toInt(),
-                expectedParticipants = eventRow.expectedParticipants?.toInt(),
-                planningMode = parseEventPlanningMode(eventRow.planningMode)
+                proposedSlots = timeSlots.map { toTimeSlot(it) },
+                finalDate = confirmedSlot?.startTime
             )
         } catch (e: Exception) {
             null
         }
     }
 
+    /**
+     * Load many events at once, preserving the order of [ids] and skipping unknown IDs.
+     *
+     * Unlike calling [getEvent] in a loop (four queries per event), this issues four
+     * set-based queries per chunk of [HYDRATION_CHUNK_SIZE] IDs.
+     */
+    fun getEvents(ids: List<String>): List<Event> {
+        if (ids.isEmpty()) return emptyList()
+        return try {
+            val rows = ids.distinct()
+                .chunked(HYDRATION_CHUNK_SIZE)
+                .flatMap { chunk -> eventQueries.selectByIds(chunk).executeAsList() }
+            val byId = hydrateEvents(rows).associateBy { it.id }
+            ids.mapNotNull { byId[it] }
+        } catch (e: Exception) {
+            emptyList()
+        }
+    }
+
+    /**
+     * Assemble domain events from already-loaded event rows in one pass.
+     * Participants, slots and confirmed dates are fetched with one query per table per chunk.
+     */
+    private fun hydrateEvents(rows: List<EventRow>): List<Event> {
+        if (rows.isEmpty()) return emptyList()
+        val events = ArrayList<Event>(rows.size)
+        rows.chunked(HYDRATION_CHUNK_SIZE).forEach { chunk ->
+            val eventIds = chunk.map { it.id }
+            val participantsByEvent = participantQueries.selectByEventIds(eventIds)
+                .executeAsList()
+                .groupBy({ it.eventId }, { it.userId })
+            val slotsByEvent = timeSlotQueries.selectByEventIds(eventIds)
+                .executeAsList()
+                .groupBy({ it.eventId }, { toTimeSlot(it) })
+            val finalDateByEvent = confirmedDateQueries.selectWithTimeslotDetailsByEventIds(eventIds)
+                .executeAsList()
+                .associate { it.eventId to it.startTime }
+
+            chunk.mapTo(events) { row ->
+                toEvent(
+                    eventRow = row,
+                    participants = participantsByEvent[row.id].orEmpty(),
+                    proposedSlots = slotsByEvent[row.id].orEmpty(),
+                    finalDate = finalDateByEvent[row.id]
+                )
+            }
+        }
+        return events
+    }
+
+    private fun toEvent(
+        eventRow: EventRow,
+        participants: List<String>,
+        proposedSlots: List<TimeSlot>,
+        finalDate: String?
+    ): Event = Event(
+        id = eventRow.id,
+        title = eventRow.title,
+        description = eventRow.description,
+        organizerId = eventRow.organizerId,
+        participants = participants,
+        proposedSlots = proposedSlots,
+        deadline = eventRow.deadline,
+        status = parseEventStatus(eventRow.status),
+        finalDate = finalDate,
+        createdAt = eventRow.createdAt,
+        updatedAt = eventRow.updatedAt,
+        eventType = parseEventType(eventRow.eventType),
+        eventTypeCustom = eventRow.eventTypeCustom,
+        minParticipants = eventRow.minParticipants?.toInt(),
+        maxParticipants = eventRow.maxParticipants?.toInt(),
+        expectedParticipants = eventRow.expectedParticipants?.toInt(),
+        planningMode = parseEventPlanningMode(eventRow.planningMode)
+    )
+
+    private fun toTimeSlot(row: TimeSlotRow): TimeSlot = TimeSlot(
+        id = row.id,
+        start = row.startTime,
+        end = row.endTime,
+        timezone = row.timezone,
+        timeOfDay = parseTimeOfDay(row.timeOfDay)
+    )
+
+    /**
+     * Field-level sync delta between the stored row and [event].
+     * Without a stored row every synced field is included.
+     */
+    private fun eventSyncDelta(previous: EventRow?, event: Event): SyncEventDelta = SyncEventDelta(
+        title = event.title.takeIf { it != previous?.title },
+        description = event.description.takeIf { it != previous?.description },
+        deadline = event.deadline.takeIf { it != previous?.deadline },
+        status = event.status.name.takeIf { it != previous?.status }
+    )
+
     override fun getPoll(eventId: String): Poll? {
         val event = getEvent(eventId) ?: return null
         val votes = mutableMapOf<String, Map<String, Vote>>()
@@ -272,22 +371,10 @@ class DatabaseEventRepository(private val db: WakeveDb, private val syncManager:
             return Result.failure(IllegalArgumentException("Participant not in event"))
         }
 
-        // Get the actual participant record ID (not userId)
-        val participantRecord = participantQueries.selectByEventIdAndUserId(eventId, participantId).executeAsOneOrNull()
-            ?: return Result.failure(IllegalArgumentException("Participant record not found"))
-
         return try {
             val now = getCurrentUtcIsoString()
-            val voteId = "vote_${slotId}_${participantId}"
-            voteQueries.insertVote(
-                id = voteId,
-                eventId = eventId,
-                timeslotId = slotId,
-                participantId = participantRecord.id,  // Use the actual participant record ID
-                vote = vote.name,
-                createdAt = now,
-                updatedAt = now
-            )
+            val voteId = insertVoteRecord(eventId, participantId, slotId, vote, now)
+                ?: return Result.failure(IllegalArgumentException("Participant record not found"))
 
             // Record sync change for offline tracking
             syncManager?.recordLocalChange(
@@ -313,10 +400,41 @@ class DatabaseEventRepository(private val db: WakeveDb, private val syncManager:
         }
     }
 
+    /**
+     * Writes a participant's vote row, keyed by the participant record (not the user ID),
+     * without recording a client sync change. Non-suspending so it can run inside a
+     * caller's transaction, e.g. the server's batched sync apply.
+     *
+     * @return the vote ID, or null if [userId] has no participant record in the event
+     */
+    fun insertVoteRecord(
+        eventId: String,
+        userId: String,
+        slotId: String,
+        vote: Vote,
+        now: String = getCurrentUtcIsoString()
+    ): String? {
+        // Get the actual participant record ID (not userId)
+        val participantRecord = participantQueries.selectByEventIdAndUserId(eventId, userId).executeAsOneOrNull()
+            ?: return null
+        val voteId = "vote_${slotId}_${userId}"
+        voteQueries.insertVote(
+            id = voteId,
+            eventId = eventId,
+            timeslotId = slotId,
+            participantId = participantRecord.id,  // Use the actual participant record ID
+            vote = vote.name,
+            createdAt = now,
+            updatedAt = now
+        )
+        return voteId
+    }
+
     override suspend fun updateEvent(event: Event): Result<Event> {
         return try {
             val isSample = com.guyghost.wakeve.sample.SampleEventFactory.isSampleEventId(event.id)
             val now = getCurrentUtcIsoString()
+            val previous = eventQueries.selectById(event.id).executeAsOneOrNull()
             eventQueries.updateEvent(
                 title = event.title,
                 description = event.description,
@@ -337,12 +455,12 @@ class DatabaseEventRepository(private val db: WakeveDb, private val syncManager:
                 id = event.id
             )
 
-            // Record sync change
+            // Record sync change (only the fields that actually changed)
             syncManager?.recordLocalChange(
                 table = "events",
                 operation = SyncOperation.UPDATE,
                 recordId = event.id,
-                data = """{"title":"${event.title}","description":"${event.description}","status":"${event.status}","deadline":"${event.deadline}"}""",
+                data = syncJson.encodeToString(SyncEventDelta.serializer(), eventSyncDelta(previous, event)),
                 userId = event.organizerId
             )
 
@@ -579,9 +697,7 @@ class DatabaseEventRepository(private val db: WakeveDb, private val syncManager:
 
     override fun getAllEvents(): List<Event> {
         return try {
-            eventQueries.selectAll().executeAsList().mapNotNull { eventRow ->
-                getEvent(eventRow.id)
-            }
+            hydrateEvents(eventQueries.selectAll().executeAsList())
         } catch (e: Exception) {
             emptyList()
         }
@@ -626,8 +742,10 @@ class DatabaseEventRepository(private val db: WakeveDb, private val syncManager:
     // MARK: - Search & Discovery
 
     /**
-     * Search events with full-text filtering, category, date range, and pagination.
-     * TODO: Replace SQL LIKE with Meilisearch for better full-text search at scale.
+     * Search events with full-text filtering, category, location, date range, and pagination.
+     *
+     * Text and location terms go through the eventSearchIndex FTS table, so every filter
+     * is applied in SQL and totalCount/hasMore reflect the filtered result set.
      */
     fun searchEvents(
         query: String?,
@@ -640,40 +758,60 @@ class DatabaseEventRepository(private val db: WakeveDb, private val syncManager:
         offset: Int,
         limit: Int
     ): SearchResultsResponse {
-        val rows = eventQueries.searchEvents(
-            query = query,
-            category = category,
-            status = status,
-            dateFrom = dateFrom,
-            dateTo = dateTo,
-            sortBy = sortBy,
-            limit = limit.toLong(),
-            offset = offset.toLong()
-        ).executeAsList()
-
-        val totalCount = eventQueries.countSearchEvents(
-            query = query,
-            category = category,
-            status = status,
-            dateFrom = dateFrom,
-            dateTo = dateTo
-        ).executeAsOne()
-
-        val events = rows.mapNotNull { row ->
-            eventToSearchResult(row.id)
-        }.let { results ->
-            // Apply location filter client-side if specified
-            if (location != null && location.isNotBlank()) {
-                results.filter { result ->
-                    result.locationName?.contains(location, ignoreCase = true) == true
-                }
-            } else {
-                results
-            }
+        if (EventSearchMatch.isUnmatchable(query, location)) {
+            return SearchResultsResponse(
+                events = emptyList(),
+                totalCount = 0,
+                offset = offset,
+                limit = limit,
+                hasMore = false
+            )
+        }
+        val matchQuery = EventSearchMatch.build(query, location)
+
+        val ids: List<String>
+        val totalCount: Long
+        if (matchQuery != null) {
+            ids = eventQueries.searchEventsMatching(
+                matchQuery = matchQuery,
+                category = category,
+                status = status,
+                dateFrom = dateFrom,
+                dateTo = dateTo,
+                sortBy = sortBy,
+                titleMatchQuery = EventSearchMatch.buildTitle(query, matchQuery),
+                limit = limit.toLong(),
+                offset = offset.toLong()
+            ).executeAsList().map { it.id }
+
+            totalCount = eventQueries.countSearchEventsMatching(
+                matchQuery = matchQuery,
+                category = category,
+                status = status,
+                dateFrom = dateFrom,
+                dateTo = dateTo
+            ).executeAsOne()
+        } else {
+            ids = eventQueries.searchEvents(
+                category = category,
+                status = status,
+                dateFrom = dateFrom,
+                dateTo = dateTo,
+                sortBy = sortBy,
+                limit = limit.toLong(),
+                offset = offset.toLong()
+            ).executeAsList().map { it.id }
+
+            totalCount = eventQueries.countSearchEvents(
+                category = category,
+                status = status,
+                dateFrom = dateFrom,
+                dateTo = dateTo
+            ).executeAsOne()
         }
 
         return SearchResultsResponse(
-            events = events,
+            events = eventsToSearchResults(ids),
             totalCount = totalCount.toInt(),
             offset = offset,
             limit = limit,
@@ -694,9 +832,7 @@ class DatabaseEventRepository(private val db: WakeveDb, private val syncManager:
             limit = limit.toLong()
         ).executeAsList()
 
-        val events = rows.mapNotNull { row ->
-            eventToSearchResult(row.id)
-        }
+        val events = eventsToSearchResults(rows.map { it.id })
 
         return TrendingEventsResponse(
             events = events,
@@ -705,43 +841,81 @@ class DatabaseEventRepository(private val db: WakeveDb, private val syncManager:
     }
 
     /**
-     * Get events near a geographic location.
-     * Uses Haversine formula for distance calculation.
+     * Get events near a geographic location, closest first.
+     *
+     * Candidates come from the 1° grid cells covering the radius' bounding box (an index
+     * point lookup per cell, see [GeoGrid]), or from one latitude band for radii too large
+     * to enumerate cells. The query returns the nearest location per event; only the top
+     * candidates get the exact Haversine check and are hydrated.
      */
     fun getNearbyEvents(lat: Double, lon: Double, radiusKm: Double, limit: Int): NearbyEventsResponse {
-        val locationsWithCoords = db.potentialLocationQueries
-            .selectAllWithCoordinates()
-            .executeAsList()
+        if (limit <= 0 || radiusKm <= 0.0) {
+            return NearbyEventsResponse(events = emptyList(), centerLat = lat, centerLon = lon, radiusKm = radiusKm)
+        }
 
-        // Parse coordinates and compute distances
-        val nearbyResults = mutableListOf<NearbyEventResult>()
-
-        locationsWithCoords.forEach { locRow ->
-            val coords = parseCoordinates(locRow.coordinates ?: return@forEach)
-            if (coords != null) {
-                val distance = haversineDistance(lat, lon, coords.first, coords.second)
-                if (distance <= radiusKm) {
-                    val searchResult = eventToSearchResult(locRow.eventId)
-                    if (searchResult != null) {
-                        nearbyResults.add(
-                            NearbyEventResult(
-                                event = searchResult,
-                                distanceKm = round(distance * 10.0) / 10.0
-                            )
-                        )
-                    }
-                }
+        // Bounding box of the search circle, in degrees; longitude span is taken at the
+        // poleward edge of the box, where degrees of longitude are shortest
+        val latDelta = radiusKm / KM_PER_DEGREE
+        val lonScale = cos(lat * PI / 180.0)
+        val edgeLonScale = cos(minOf(90.0, abs(lat) + latDelta) * PI / 180.0)
+        val lonDelta = if (edgeLonScale > 1e-6) radiusKm / (KM_PER_DEGREE * edgeLonScale) else 180.0
+
+        // Fetch a few extra candidates: the planar ordering can differ slightly from Haversine
+        val candidateLimit = (limit * 2 + NEARBY_EXTRA_CANDIDATES).toLong()
+        val cells = GeoGrid.cellsCovering(lat - latDelta, lat + latDelta, lon - lonDelta, lon + lonDelta)
+        val candidates: List<Triple<String, Double?, Double?>> = if (cells != null) {
+            db.potentialLocationQueries.selectNearestEventsInCells(
+                lat = lat,
+                lon = lon,
+                lonScale = lonScale,
+                cells = cells,
+                minLat = lat - latDelta,
+                maxLat = lat + latDelta,
+                limit = candidateLimit
+            ).executeAsList().map { Triple(it.eventId, it.latitude, it.longitude) }
+        } else {
+            // A box crossing the antimeridian continues on the other side: second longitude range
+            val minLon = lon - lonDelta
+            val maxLon = lon + lonDelta
+            val (wrapMinLon, wrapMaxLon) = when {
+                lonDelta >= 180.0 -> 1.0 to 0.0
+                minLon < -180.0 -> minLon + 360.0 to 180.0
+                maxLon > 180.0 -> -180.0 to maxLon - 360.0
+                else -> 1.0 to 0.0
             }
+            db.potentialLocationQueries.selectNearestEventsInBox(
+                lat = lat,
+                lon = lon,
+                lonScale = lonScale,
+                minLat = lat - latDelta,
+                maxLat = lat + latDelta,
+                minLon = minLon.coerceAtLeast(-180.0),
+                maxLon = maxLon.coerceAtMost(180.0),
+                wrapMinLon = wrapMinLon,
+                wrapMaxLon = wrapMaxLon,
+                limit = candidateLimit
+            ).executeAsList().map { Triple(it.eventId, it.latitude, it.longitude) }
         }
 
-        // Sort by distance, limit results, deduplicate by event ID
-        val uniqueResults = nearbyResults
-            .sortedBy { it.distanceKm }
-            .distinctBy { it.event.id }
+        val distanceByEvent = candidates.mapNotNull { (eventId, candidateLat, candidateLon) ->
+            if (candidateLat == null || candidateLon == null) return@mapNotNull null
+            val distance = haversineDistance(lat, lon, candidateLat, candidateLon)
+            if (distance <= radiusKm) eventId to distance else null
+        }
+            .sortedBy { it.second }
             .take(limit)
+            .toMap()
+
+        // Hydrate only the events that made the cut, in one batch
+        val nearbyResults = eventsToSearchResults(distanceByEvent.keys.toList()).map { searchResult ->
+            NearbyEventResult(
+                event = searchResult,
+                distanceKm = round(distanceByEvent.getValue(searchResult.id) * 10.0) / 10.0
+            )
+        }
 
         return NearbyEventsResponse(
-            events = uniqueResults,
+            events = nearbyResults,
             centerLat = lat,
             centerLon = lon,
             radiusKm = radiusKm
@@ -787,9 +961,7 @@ class DatabaseEventRepository(private val db: WakeveDb, private val syncManager:
             limit = limit.toLong()
         ).executeAsList()
 
-        val events = rows.mapNotNull { row ->
-            eventToSearchResult(row.id)
-        }
+        val events = eventsToSearchResults(rows.map { it.id })
 
         return RecommendedEventsResponse(
             events = events,
@@ -801,51 +973,43 @@ class DatabaseEventRepository(private val db: WakeveDb, private val syncManager:
     // MARK: - Private Helpers
 
     /**
-     * Convert an event ID to an EventSearchResult by loading event + location data.
+     * Convert event IDs to EventSearchResults, loading events and their first location in bulk.
+     * Result order follows [eventIds]; missing events are skipped.
      */
-    private fun eventToSearchResult(eventId: String): EventSearchResult? {
-        val event = getEvent(eventId) ?: return null
-        val participants = participantQueries.selectByEventId(eventId).executeAsList()
-
-        // Get first location if available
-        val location = try {
-            db.potentialLocationQueries
-                .selectFirstLocationByEventId(eventId)
-                .executeAsOneOrNull()
+    private fun eventsToSearchResults(eventIds: List<String>): List<EventSearchResult> {
+        val events = getEvents(eventIds)
+        if (events.isEmpty()) return emptyList()
+
+        // Get first location per event if available
+        val firstLocationByEvent = try {
+            events.map { it.id }
+                .chunked(HYDRATION_CHUNK_SIZE)
+                .flatMap { chunk ->
+                    db.potentialLocationQueries.selectLocationsByEventIds(chunk).executeAsList()
+                }
+                .groupBy { it.eventId }
+                .mapValues { (_, locations) -> locations.first() }
         } catch (_: Exception) {
-            null
+            emptyMap()
         }
 
-        return EventSearchResult(
-            id = event.id,
-            title = event.title,
-            description = event.description,
-            organizerId = event.organizerId,
-            status = event.status.name,
-            eventType = event.eventType.name,
-            eventTypeCustom = event.eventTypeCustom,
-            participantCount = participants.size,
-            maxParticipants = event.maxParticipants,
-            deadline = event.deadline,
-            createdAt = event.createdAt,
-            locationName = location?.name,
-            locationCoordinates = location?.coordinates
-        )
-    }
-
-    /**
-     * Parse a coordinates JSON string to a (latitude, longitude) pair.
-     * Expected format: {"latitude": 48.8566, "longitude": 2.3522}
-     */
-    private fun parseCoordinates(json: String): Pair<Double, Double>? {
-        return try {
-            val latMatch = Regex(""""latitude"\s*:\s*([-\d.]+)""").find(json)
-            val lonMatch = Regex(""""longitude"\s*:\s*([-\d.]+)""").find(json)
-            if (latMatch != null && lonMatch != null) {
-                Pair(latMatch.groupValues[1].toDouble(), lonMatch.groupValues[1].toDouble())
-            } else null
-        } catch (_: Exception) {
-            null
+        return events.map { event ->
+            val location = firstLocationByEvent[event.id]
+            EventSearchResult(
+                id = event.id,
+                title = event.title,
+                description = event.description,
+                organizerId = event.organizerId,
+                status = event.status.name,
+                eventType = event.eventType.name,
+                eventTypeCustom = event.eventTypeCustom,
+                participantCount = event.participants.size,
+                maxParticipants = event.maxParticipants,
+                deadline = event.deadline,
+                createdAt = event.createdAt,
+                locationName = location?.name,
+                locationCoordinates = location?.coordinates
+            )
         }
     }
 
@@ -875,13 +1039,13 @@ class DatabaseEventRepository(private val db: WakeveDb, private val syncManager:
 
         return try {
             val offset = page * pageSize
-            val events = eventQueries.selectPaginated(
-                orderBy = orderBy.name,
-                limit = pageSize.toLong(),
-                offset = offset.toLong()
-            ).executeAsList().mapNotNull { eventRow ->
-                getEvent(eventRow.id)
-            }
+            val events = hydrateEvents(
+                eventQueries.selectPaginated(
+                    orderBy = orderBy.name,
+                    limit = pageSize.toLong(),
+                    offset = offset.toLong()
+                ).executeAsList()
+            )
             flowOf(events)
         } catch (e: Exception) {
             println(databaseEventRepositoryPaginatedEventsFailureLogMessage())
@@ -917,32 +1081,7 @@ class DatabaseEventRepository(private val db: WakeveDb, private val syncManager:
 
             val now = getCurrentUtcIsoString()
 
-            // Use a transaction to ensure atomicity
-            db.transaction {
-                // 1. Delete votes (they reference participants and time slots)
-                voteQueries.deleteByEventId(eventId)
-
-                // 2. Delete participants
-                participantQueries.deleteByEventId(eventId)
-
-                // 3. Delete time slots
-                timeSlotQueries.deleteByEventId(eventId)
-
-                // 4. Delete potential locations
-                db.potentialLocationQueries.deleteByEventId(eventId)
-
-                // 5. Delete scenarios (cascade will delete scenario votes)
-                db.scenarioQueries.deleteByEventId(eventId)
-
-                // 6. Delete confirmed date
-                confirmedDateQueries.deleteByEventId(eventId)
-
-                // 7. Delete all sync metadata related to this event
-                syncMetadataQueries.deleteByEntity("event", eventId)
-
-                // 8. Delete the event itself
-                eventQueries.deleteEvent(eventId)
-            }
+            deleteEventRecords(eventId, now)
 
             // Record tombstone for offline sync (outside transaction to avoid conflicts)
             syncManager?.recordLocalChange(
@@ -953,69 +1092,80 @@ class DatabaseEventRepository(private val db: WakeveDb, private val syncManager:
                 userId = event.organizerId
             )
 
-            // Record sync metadata for the delete operation
-            syncMetadataQueries.insertSyncMetadata(
-                id = "sync_delete_${eventId}_$now",
-                entityType = "event",
-                entityId = eventId,
-                operation = "DELETE",
-                timestamp = now,
-                synced = 0
-            )
-
             Result.success(Unit)
         } catch (e: Exception) {
             Result.failure(e)
         }
     }
 
-    // MARK: - Notification Scheduler Helpers
+    /**
+     * Deletes an event and its dependent rows, then records the delete in sync metadata,
+     * without recording a client sync change. Non-suspending so it can run inside a
+     * caller's transaction (nested transactions join the enclosing one).
+     */
+    fun deleteEventRecords(eventId: String, now: String = getCurrentUtcIsoString()) {
+        deleteEventRows(eventId)
+
+        // Record sync metadata for the delete operation
+        syncMetadataQueries.insertSyncMetadata(
+            id = "sync_delete_${eventId}_$now",
+            entityType = "event",
+            entityId = eventId,
+            operation = "DELETE",
+            timestamp = now,
+            synced = 0
+        )
+    }
 
     /**
-     * Retourne tous les evenements en cours de sondage (status = POLLING).
-     * Utilise par le NotificationScheduler pour verifier les deadlines.
+     * Applies an event delete pulled from the server: removes the event and its dependent
+     * rows without recording anything to push back.
      */
-    fun getAllPollingEvents(): List<Event> {
-        return try {
-            eventQueries.selectByStatus("POLLING").executeAsList().mapNotNull { row ->
-                getEvent(row.id)
-            }
-        } catch (e: Exception) {
-            emptyList()
-        }
+    fun deleteRemoteEvent(eventId: String) {
+        deleteEventRows(eventId)
     }
 
     /**
-     * Retourne les evenements confirmes dont la date finale est aujourd'hui.
-     * Utilise par le NotificationScheduler pour les rappels jour-J.
-     *
-     * @param todayMs Timestamp du jour courant en millisecondes
+     * Applies a membership removal pulled from the server, with the member's votes.
      */
-    fun getConfirmedEventsForToday(todayMs: Long): List<Event> {
-        return try {
-            val confirmedEvents = eventQueries.selectByStatus("CONFIRMED").executeAsList()
-            confirmedEvents.mapNotNull { row ->
-                val event = getEvent(row.id) ?: return@mapNotNull null
-                // Utiliser la requete jointure pour obtenir le startTime du timeslot
-                val confirmedWithDetails = confirmedDateQueries
-                    .selectWithTimeslotDetails(row.id)
-                    .executeAsOneOrNull()
-                if (confirmedWithDetails != null) {
-                    val startTime = confirmedWithDetails.startTime ?: return@mapNotNull null
-                    val dateMs = runCatching {
-                        kotlinx.datetime.Instant.parse(startTime).toEpochMilliseconds()
-                    }.getOrNull() ?: return@mapNotNull null
-                    // Meme jour (arrondi au jour)
-                    val todayDay = todayMs / 86_400_000
-                    val dateDay = dateMs / 86_400_000
-                    if (todayDay == dateDay) event else null
-                } else null
-            }
-        } catch (e: Exception) {
-            emptyList()
+    fun deleteRemoteParticipant(participantId: String) {
+        db.transaction {
+            voteQueries.deleteByParticipantId(participantId)
+            participantQueries.deleteParticipant(participantId)
         }
     }
 
+    private fun deleteEventRows(eventId: String) {
+        // Use a transaction to ensure atomicity
+        db.transaction {
+            // 1. Delete votes (they reference participants and time slots)
+            voteQueries.deleteByEventId(eventId)
+
+            // 2. Delete participants
+            participantQueries.deleteByEventId(eventId)
+
+            // 3. Delete time slots
+            timeSlotQueries.deleteByEventId(eventId)
+
+            // 4. Delete potential locations
+            db.potentialLocationQueries.deleteByEventId(eventId)
+
+            // 5. Delete scenarios (cascade will delete scenario votes)
+            db.scenarioQueries.deleteByEventId(eventId)
+
+            // 6. Delete confirmed date
+            confirmedDateQueries.deleteByEventId(eventId)
+
+            // 7. Delete all sync metadata related to this event
+            syncMetadataQueries.deleteByEntity("event", eventId)
+
+            // 8. Delete the event itself
+            eventQueries.deleteEvent(eventId)
+        }
+    }
+
+    // MARK: - Notification Scheduler Helpers
+
     /**
      * Retourne la liste de tous les ID utilisateurs distincts
      * (organisateurs et participants).
@@ -1189,6 +1339,18 @@ class DatabaseEventRepository(private val db: WakeveDb, private val syncManager:
     }
 }
 
+/**
+ * Maximum number of IDs bound into a single `IN (...)` clause during bulk hydration.
+ * Stays well under SQLite's host-parameter limit on every platform driver.
+ */
+private const val HYDRATION_CHUNK_SIZE = 500
+
+/** Kilometres per degree of latitude, rounded down so the bounding box always contains the radius. */
+private const val KM_PER_DEGREE = 111.0
+
+/** Extra nearby candidates fetched beyond the limit to absorb planar vs. Haversine ordering drift. */
+private const val NEARBY_EXTRA_CANDIDATES = 16
+
 internal fun databaseEventRepositoryTimeSlotSyncFailureLogMessage(): String =
     "Failed to sync time slots"
 
@@ -0,0 +1,105 @@
+package com.guyghost.wakeve.repository
+
+import com.guyghost.wakeve.database.WakeveDb
+import com.guyghost.wakeve.database.PotentialLocation as PotentialLocationRow
+import com.guyghost.wakeve.models.Coordinates
+import com.guyghost.wakeve.models.EventStatus
+import com.guyghost.wakeve.models.LocationType
+import com.guyghost.wakeve.models.PotentialLocation
+
+/**
+ * SQLDelight implementation of [PotentialLocationRepositoryInterface].
+ *
+ * Locations are written with their numeric coordinates and grid cell, so they
+ * feed the search index and nearby search as soon as they are added.
+ */
+class DatabasePotentialLocationRepository(
+    private val db: WakeveDb,
+    private val eventRepository: EventRepositoryInterface
+) : PotentialLocationRepositoryInterface {
+
+    private val queries = db.potentialLocationQueries
+
+    override suspend fun addLocation(
+        eventId: String,
+        location: PotentialLocation
+    ): Result<PotentialLocation> {
+        return try {
+            requireDraftEvent(eventId)?.let { return Result.failure(it) }
+
+            if (location.eventId != eventId) {
+                return Result.failure(
+                    IllegalArgumentException("Location eventId does not match provided eventId")
+                )
+            }
+            if (queries.selectById(location.id).executeAsOneOrNull() != null) {
+                return Result.failure(IllegalArgumentException("Location with this ID already exists"))
+            }
+
+            queries.insertLocation(
+                id = location.id,
+                eventId = eventId,
+                name = location.name,
+                locationType = location.locationType.name,
+                address = location.address,
+                coordinates = location.coordinates?.toJson(),
+                createdAt = location.createdAt,
+                latitude = location.coordinates?.latitude,
+                longitude = location.coordinates?.longitude
+            )
+            Result.success(location)
+        } catch (e: Exception) {
+            Result.failure(e)
+        }
+    }
+
+    override suspend fun removeLocation(eventId: String, locationId: String): Result<Boolean> {
+        return try {
+            requireDraftEvent(eventId)?.let { return Result.failure(it) }
+
+            val existing = queries.selectById(locationId).executeAsOneOrNull()
+            if (existing == null || existing.eventId != eventId) {
+                return Result.failure(IllegalArgumentException("Location not found"))
+            }
+
+            queries.deleteLocation(locationId)
+            Result.success(true)
+        } catch (e: Exception) {
+            Result.failure(e)
+        }
+    }
+
+    override fun getLocationsByEventId(eventId: String): List<PotentialLocation> =
+        queries.selectByEventId(eventId).executeAsList().map { it.toModel() }
+
+    override fun getLocationById(id: String): PotentialLocation? =
+        queries.selectById(id).executeAsOneOrNull()?.toModel()
+
+    override suspend fun removeAllLocationsForEvent(eventId: String): Result<Boolean> {
+        return try {
+            queries.deleteByEventId(eventId)
+            Result.success(true)
+        } catch (e: Exception) {
+            Result.failure(e)
+        }
+    }
+
+    private fun requireDraftEvent(eventId: String): Exception? {
+        val event = eventRepository.getEvent(eventId)
+            ?: return IllegalArgumentException("Event not found")
+        if (event.status != EventStatus.DRAFT) {
+            return IllegalStateException("Potential locations can only be modified in DRAFT status")
+        }
+        return null
+    }
+
+    private fun PotentialLocationRow.toModel() = PotentialLocation(
+        id = id,
+        eventId = eventId,
+        name = name,
+        locationType = LocationType.entries.firstOrNull { it.name == locationType } ?: LocationType.CITY,
+        address = address,
+        coordinates = coordinates?.let(Coordinates::fromJson),
+        createdAt = createdAt
+    )
+}
@@ -0,0 +1,57 @@
+package com.guyghost.wakeve.repository
+
+/**
+ * Builds FTS MATCH expressions for the eventSearchIndex table from raw user input.
+ *
+ * Input is reduced to lower-case letter/digit tokens, so it can never inject FTS
+ * operators (AND, OR, NEAR, quotes, column filters). Each token becomes a prefix
+ * term, and all terms must match.
+ */
+internal object EventSearchMatch {
+    private const val MAX_TOKENS = 8
+
+    /**
+     * Expression matching [query] in any indexed column and [location] in location names.
+     * Returns null when neither contributes a token: use the filter-only search when
+     * both are blank, and return no result when [isUnmatchable] says the input can
+     * never match.
+     */
+    fun build(query: String?, location: String?): String? {
+        val terms = tokenize(query).map { "$it*" } +
+            tokenize(location).map { "locationName:$it*" }
+        return terms.takeIf { it.isNotEmpty() }?.joinToString(" ")
+    }
+
+    /**
+     * True when [query] or [location] is non-blank yet yields no token (e.g. "!!!"),
+     * so it can match no event rather than falling back to every event.
+     */
+    fun isUnmatchable(query: String?, location: String?): Boolean =
+        (!query.isNullOrBlank() && tokenize(query).isEmpty()) ||
+            (!location.isNullOrBlank() && tokenize(location).isEmpty())
+
+    /**
+     * Expression matching [query] in titles only, used to rank title hits first.
+     * Falls back to [matchQuery] when the query has no tokens, which ranks every hit equally.
+     */
+    fun buildTitle(query: String?, matchQuery: String): String {
+        val terms = tokenize(query).map { "title:$it*" }
+        return if (terms.isEmpty()) matchQuery else terms.joinToString(" ")
+    }
+
+    fun tokenize(input: String?): List<String> {
+        if (input.isNullOrBlank()) return emptyList()
+        val tokens = mutableListOf<String>()
+        val current = StringBuilder()
+        for (char in input) {
+            if (char.isLetterOrDigit()) {
+                current.append(char.lowercaseChar())
+            } else if (current.isNotEmpty()) {
+                tokens += current.toString()
+                current.clear()
+            }
+        }
+        if (current.isNotEmpty()) tokens += current.toString()
+        return tokens.distinct().take(MAX_TOKENS)
+    }
+}
@@ -0,0 +1,38 @@
+package com.guyghost.wakeve.repository
+
+import kotlin.math.floor
+
+/**
+ * 1° latitude/longitude grid behind `potentialLocation.geoCell`.
+ *
+ * A cell is `(floor(latitude) + 90) * 360 + (floor(longitude) + 180) mod 360`, the
+ * formula insertLocation and updateLocation compute in SQL. Longitude wraps, so a
+ * box crossing the antimeridian simply continues on the other side.
+ */
+internal object GeoGrid {
+    /** Beyond this many cells a lookup per cell costs more than one latitude band scan. */
+    const val MAX_CELLS = 256
+
+    fun cellOf(latitude: Double, longitude: Double): Long =
+        latitudeRow(latitude) * 360L + longitudeColumn(longitude)
+
+    /**
+     * Cells covering the box [minLat]..[maxLat] x [minLon]..[maxLon], where [minLon]
+     * may be below -180 and [maxLon] above 180. Returns null when more than
+     * [MAX_CELLS] cells would be needed.
+     */
+    fun cellsCovering(minLat: Double, maxLat: Double, minLon: Double, maxLon: Double): List<Long>? {
+        val rows = latitudeRow(minLat.coerceAtLeast(-90.0))..latitudeRow(maxLat.coerceAtMost(90.0))
+        val firstColumn = floor(minLon + 180.0).toLong()
+        val lastColumn = floor(maxLon + 180.0).toLong()
+        val columnCount = (lastColumn - firstColumn + 1).coerceAtMost(360L)
+        if ((rows.last - rows.first + 1) * columnCount > MAX_CELLS) return null
+
+        val columns = (0 until columnCount).map { (firstColumn + it).mod(360L) }
+        return rows.flatMap { row -> columns.map { column -> row * 360L + column } }
+    }
+
+    private fun latitudeRow(latitude: Double): Long = floor(latitude + 90.0).toLong()
+
+    private fun longitudeColumn(longitude: Double): Long = floor(longitude + 180.0).toLong().mod(360L)
+}
@@ -36,10 +36,8 @@ interface PotentialLocationRepositoryInterface {
 }
 
 /**
- * In-memory implementation of PotentialLocationRepository.
- * 
- * This will be replaced with DatabasePotentialLocationRepository using SQLDelight
- * in a future implementation phase.
+ * In-memory implementation of PotentialLocationRepository, for tests and
+ * clients without a database. The server uses [DatabasePotentialLocationRepository].
  */
 class PotentialLocationRepository(
     private val eventRepository: EventRepositoryInterface
@@ -326,9 +326,10 @@ class UserRepository(private val db: WakeveDb) {
         recordId: String,
         operation: SyncOperation,
         timestamp: String,
-        userId: String
+        userId: String,
+        payload: String? = null
     ): Result<Unit> = runCatching {
-        userQueries.insertSyncMetadata(
+        userQueries.insertSyncMetadataWithPayload(
             id = id,
             table_name = tableName,
             record_id = recordId,
@@ -337,7 +338,8 @@ class UserRepository(private val db: WakeveDb) {
             user_id = userId,
             synced = 0L,
             retry_count = 0L,
-            last_error = null
+            last_error = null,
+            payload = payload
         )
     }
 
@@ -352,11 +354,47 @@ class UserRepository(private val db: WakeveDb) {
                 userId = row.user_id,
                 synced = row.synced == 1L,
                 retryCount = row.retry_count?.toInt() ?: 0,
-                lastError = row.last_error
+                lastError = row.last_error,
+                payload = row.payload
             )
         }
     }.getOrDefault(emptyList())
 
+    suspend fun getPendingSyncChange(tableName: String, recordId: String): SyncMetadata? = runCatching {
+        userQueries.selectPendingSyncByTableAndRecord(tableName, recordId).executeAsOneOrNull()?.let { row ->
+            SyncMetadata(
+                id = row.id,
+                tableName = row.table_name,
+                recordId = row.record_id,
+                operation = SyncOperation.valueOf(row.operation),
+                timestamp = row.timestamp,
+                userId = row.user_id,
+                synced = row.synced == 1L,
+                retryCount = row.retry_count?.toInt() ?: 0,
+                lastError = row.last_error,
+                payload = row.payload
+            )
+        }
+    }.getOrNull()
+
+    suspend fun countPendingSyncChanges(): Int = runCatching {
+        userQueries.countPendingSync().executeAsOne().toInt()
+    }.getOrDefault(0)
+
+    suspend fun coalesceSyncMetadata(
+        syncId: String,
+        operation: SyncOperation,
+        payload: String?,
+        timestamp: String
+    ): Result<Unit> = runCatching {
+        userQueries.coalesceSyncMetadata(
+            operation = operation.name,
+            payload = payload,
+            timestamp = timestamp,
+            id = syncId
+        )
+    }
+
     suspend fun updateSyncStatus(
         syncId: String,
         synced: Boolean,
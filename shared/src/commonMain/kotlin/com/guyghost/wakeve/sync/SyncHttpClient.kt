@@ -5,6 +5,21 @@ package com.guyghost.wakeve.sync
  */
 interface SyncHttpClient {
     suspend fun sync(requestJson: String, authToken: String): Result<String>
+
+    /**
+     * Sync with a SyncRequest already encoded in [format]. The client may compress the
+     * body and must undo any compression on the response before returning it.
+     * Clients without binary support fail here and the manager falls back to [sync].
+     */
+    suspend fun syncEncoded(body: ByteArray, format: SyncWireFormat, authToken: String): Result<SyncWirePayload> =
+        Result.failure(UnsupportedOperationException("Binary sync not supported by this client"))
+
+    /**
+     * Delta pull: send a SyncPullRequest, receive a SyncPullResponse.
+     * Clients without pull support fail here and the manager keeps its version vector.
+     */
+    suspend fun pull(requestJson: String, authToken: String): Result<String> =
+        Result.failure(UnsupportedOperationException("Delta pull not supported by this client"))
 }
 
 /**
@@ -9,8 +9,12 @@ import com.guyghost.wakeve.models.SyncChange
 import com.guyghost.wakeve.models.SyncConflict
 import com.guyghost.wakeve.models.SyncEventData
 import com.guyghost.wakeve.models.SyncOperation
+import com.guyghost.wakeve.models.SyncParticipantData
+import com.guyghost.wakeve.models.SyncPullRequest
+import com.guyghost.wakeve.models.SyncPullResponse
 import com.guyghost.wakeve.models.SyncRequest
 import com.guyghost.wakeve.models.SyncResponse
+import com.guyghost.wakeve.models.SyncTableVersion
 import com.guyghost.wakeve.sync.conflict.ConflictDetector
 import com.guyghost.wakeve.sync.conflict.ConflictLogRepository
 import com.guyghost.wakeve.sync.conflict.ConflictSummary
@@ -31,6 +35,10 @@ import kotlinx.datetime.DateTimeUnit
 import kotlinx.datetime.Instant
 import kotlinx.datetime.minus
 import kotlinx.serialization.json.Json
+import kotlinx.serialization.json.JsonObject
+import kotlinx.serialization.json.JsonPrimitive
+import kotlinx.serialization.json.contentOrNull
+import kotlinx.serialization.json.jsonObject
 
 /**
  * Client-side sync manager for offline-first synchronization
@@ -53,13 +61,35 @@ class SyncManager(
      * Safe to flip at runtime — the sync loop checks this on every conflict.
      */
     val conflictResolutionEnabled: Boolean = true,
-    private val pendingSideEffectReplayers: List<PendingSyncSideEffectReplayer> = emptyList()
+    private val pendingSideEffectReplayers: List<PendingSyncSideEffectReplayer> = emptyList(),
+    private val pullPageSize: Int = DEFAULT_PULL_PAGE_SIZE,
+    /** Changes recorded within this window of the first one are sent in one sync. */
+    syncDebounceMs: Long = DEFAULT_SYNC_DEBOUNCE_MS,
+    /** Flush the window early once this many changes are waiting. */
+    maxCoalescedChanges: Int = DEFAULT_MAX_COALESCED_CHANGES,
+    /** Send /sync bodies as CBOR; switches to JSON for good if the server or client can't. */
+    preferBinaryWireFormat: Boolean = true
 ) {
     private val json = Json { ignoreUnknownKeys = true }
     private val scope = CoroutineScope(Dispatchers.Default + SupervisorJob())
     private val conflictLog = ConflictLogRepository(database)
     private val syncMutex = Mutex()
 
+    // Guards coalescing against the set of changes currently being sent
+    private val changeQueueMutex = Mutex()
+    private val inFlightChangeIds = mutableSetOf<String>()
+
+    private val syncScheduler = SyncScheduler(
+        scope = scope,
+        windowMs = syncDebounceMs,
+        maxPendingChanges = maxCoalescedChanges,
+        flush = {
+            if (isNetworkAvailable.value) {
+                triggerSync()
+            }
+        }
+    )
+
     // Callbacks for the presentation layer
     /** Called when critical conflicts require user resolution. */
     var onCriticalConflictsDetected: ((ConflictSummary) -> Unit)? = null
@@ -68,8 +98,12 @@ class SyncManager(
     private val _syncStatus = MutableStateFlow<SyncStatus>(SyncStatus.Idle)
     val syncStatus: StateFlow<SyncStatus> = _syncStatus
 
-    // Timestamp of the last successful sync — used for incremental sync (avoids full re-sync)
-    private var lastSuccessfulSyncTimestamp: String? = null
+    // Per-table high-water marks persisted in syncVersionVector — survive restarts,
+    // so each pull only fetches rows changed since the last applied page
+    private val versionVectorQueries = database.syncVersionVectorQueries
+
+    // Cleared the first time the binary /sync exchange is rejected
+    private var binaryWireFormatEnabled = preferBinaryWireFormat
 
     // Network status from platform-specific detector
     val isNetworkAvailable: StateFlow<Boolean> = networkDetector.isNetworkAvailable
@@ -77,7 +111,10 @@ class SyncManager(
     init {
         scope.launch {
             networkDetector.isNetworkAvailable.collect { available ->
-                if (available && hasPendingChanges()) {
+                if (!available) {
+                    // Nothing can be sent until the network is back, which syncs on its own
+                    syncScheduler.cancel()
+                } else if (hasPendingChanges()) {
                     triggerSync()
                 }
             }
@@ -85,7 +122,11 @@ class SyncManager(
     }
 
     /**
-     * Record a local change for later synchronization
+     * Record a local change for later synchronization.
+     *
+     * A change to a record that already has an unsent change is merged into it
+     * (see [coalesceOperation]), and the sync itself is debounced by the scheduler,
+     * so a burst of edits becomes one queued change per record and one round-trip.
      */
     suspend fun recordLocalChange(
         table: String,
@@ -94,22 +135,114 @@ class SyncManager(
         data: String,
         userId: String
     ): Result<Unit> = runCatching {
-        val syncId = "sync_${getCurrentTimeMillis()}_${recordId}"
         val timestamp = getCurrentUtcIsoString()
+        val payload = data.takeIf { it.isNotBlank() }
+
+        val coalesced = changeQueueMutex.withLock {
+            val pending = userRepository.getPendingSyncChange(table, recordId)
+                ?.takeIf { it.id !in inFlightChangeIds }
+            val merged = pending?.let { coalesceOperation(it.operation, operation) }
+
+            when {
+                pending == null || merged == null -> {
+                    // Store the change in sync metadata
+                    userRepository.addSyncMetadata(
+                        id = "sync_${getCurrentTimeMillis()}_${recordId}",
+                        tableName = table,
+                        recordId = recordId,
+                        operation = operation,
+                        timestamp = timestamp,
+                        userId = userId,
+                        payload = payload
+                    ).getOrThrow()
+                    false
+                }
+                merged == CoalescedOperation.Cancelled -> {
+                    // Created and deleted before the server ever saw it, and so were its children
+                    userRepository.removeSyncMetadata(pending.id).getOrThrow()
+                    removeDependentChanges(table, recordId, pending.payload)
+                    true
+                }
+                else -> {
+                    userRepository.coalesceSyncMetadata(
+                        syncId = pending.id,
+                        operation = (merged as CoalescedOperation.Replace).operation,
+                        payload = if (operation == SyncOperation.DELETE) payload else mergePayloads(pending.payload, payload),
+                        timestamp = timestamp
+                    ).getOrThrow()
+                    true
+                }
+            }
+        }
 
-        // Store the change in sync metadata
-        userRepository.addSyncMetadata(
-            id = syncId,
-            tableName = table,
-            recordId = recordId,
-            operation = operation,
-            timestamp = timestamp,
-            userId = userId
-        ).getOrThrow()
-
-        // If network is available, trigger immediate sync
+        metrics.recordChangeRecorded(coalesced)
+        metrics.recordQueueDepth(userRepository.countPendingSyncChanges())
+
+        // If network is available, schedule a (debounced) sync
         if (isNetworkAvailable.value) {
-            triggerSync()
+            syncScheduler.onChangeRecorded()
+        }
+    }
+
+    /**
+     * How a new change folds into an unsent change to the same record,
+     * or null when both must be sent (e.g. a re-create after a delete).
+     */
+    private fun coalesceOperation(pending: SyncOperation, incoming: SyncOperation): CoalescedOperation? =
+        when (pending) {
+            SyncOperation.CREATE -> when (incoming) {
+                SyncOperation.CREATE, SyncOperation.UPDATE -> CoalescedOperation.Replace(SyncOperation.CREATE)
+                SyncOperation.DELETE -> CoalescedOperation.Cancelled
+            }
+            SyncOperation.UPDATE -> when (incoming) {
+                SyncOperation.CREATE -> null
+                SyncOperation.UPDATE -> CoalescedOperation.Replace(SyncOperation.UPDATE)
+                SyncOperation.DELETE -> CoalescedOperation.Replace(SyncOperation.DELETE)
+            }
+            SyncOperation.DELETE -> null
+        }
+
+    /**
+     * Drop the unsent changes that depend on a record whose create was cancelled: the
+     * participants, slots and votes of an event, or the votes of a participant.
+     * Changes already in flight are left alone. Caller holds [changeQueueMutex].
+     */
+    private suspend fun removeDependentChanges(table: String, recordId: String, payload: String?) {
+        val parent = payload?.let(::parseJsonObject)
+        val dependents = userRepository.getPendingSyncChanges().filter { change ->
+            if (change.id in inFlightChangeIds) return@filter false
+            val fields = change.payload?.let(::parseJsonObject)
+            when (table) {
+                "events" -> change.tableName != "events" && (
+                    fields.stringField("eventId") == recordId ||
+                        (change.tableName == "timeSlots" && change.recordId == recordId)
+                    )
+                "participants" -> change.tableName == "votes" && parent != null &&
+                    fields.stringField("eventId") == parent.stringField("eventId") &&
+                    fields.stringField("participantId") == parent.stringField("userId")
+                else -> false
+            }
+        }
+        dependents.forEach { userRepository.removeSyncMetadata(it.id).getOrThrow() }
+    }
+
+    private fun parseJsonObject(payload: String): JsonObject? =
+        runCatching { json.parseToJsonElement(payload).jsonObject }.getOrNull()
+
+    private fun JsonObject?.stringField(name: String): String? =
+        (this?.get(name) as? JsonPrimitive)?.contentOrNull
+
+    /**
+     * Field-level merge of two JSON object payloads; fields in [incoming] win.
+     * Falls back to [incoming] when either side is not a JSON object.
+     */
+    private fun mergePayloads(pending: String?, incoming: String?): String? {
+        if (pending == null || incoming == null) return incoming ?: pending
+        return try {
+            val merged = json.parseToJsonElement(pending).jsonObject + json.parseToJsonElement(incoming).jsonObject
+            json.encodeToString(JsonObject.serializer(), JsonObject(merged))
+        } catch (e: Exception) {
+            incoming
         }
     }
 
@@ -122,12 +255,13 @@ class SyncManager(
     }
 
     /**
-     * Get all pending changes ready for sync
+     * Get all pending changes ready for sync.
+     * Ships the field-level delta recorded with each change; only legacy rows
+     * without a stored payload are rebuilt from the current record.
      */
     suspend fun getPendingChangesForSync(): List<SyncChange> {
         return userRepository.getPendingSyncChanges().map { metadata ->
-            // Get the actual data for this change
-            val data = getChangeData(metadata.tableName, metadata.recordId)
+            val data = metadata.payload ?: getChangeData(metadata.tableName, metadata.recordId)
             SyncChange(
                 id = metadata.id,
                 table = metadata.tableName,
@@ -150,7 +284,15 @@ class SyncManager(
     }
 
     /**
-     * Get data for a specific change
+     * Current persisted version vector, keyed by table name
+     */
+    fun getVersionVector(): Map<String, SyncTableVersion> =
+        versionVectorQueries.selectAll().executeAsList().associate { row ->
+            row.tableName to SyncTableVersion(seq = row.version)
+        }
+
+    /**
+     * Get data for a specific change (legacy fallback when no delta was recorded)
      */
     private suspend fun getChangeData(table: String, recordId: String): String {
         return when (table) {
@@ -344,7 +486,7 @@ class SyncManager(
      */
     fun logSyncStatus() {
         val stats = metrics.getSyncStats()
-        println("Sync Stats: total=${stats.totalSyncs}, success=${stats.successfulSyncs}, failed=${stats.failedSyncs}, avgDuration=${stats.averageDurationMs}ms, conflicts=${stats.totalConflictsResolved}")
+        println("Sync Stats: total=${stats.totalSyncs}, success=${stats.successfulSyncs}, failed=${stats.failedSyncs}, avgDuration=${stats.averageDurationMs}ms, conflicts=${stats.totalConflictsResolved}, queueDepth=${stats.queueDepth}, coalescingRatio=${stats.coalescingRatio}")
     }
 
     /**
@@ -356,11 +498,11 @@ class SyncManager(
         }
     }
 
-    private suspend fun updateLocalSyncStatus(response: SyncResponse) {
-        // Mark all pending changes as synced if the sync was successful
+    private suspend fun updateLocalSyncStatus(response: SyncResponse, sentChanges: List<SyncChange>) {
+        // Mark the changes that were sent as synced if the sync was successful.
+        // Changes recorded while the request was in flight stay pending for the next sync.
         if (response.success) {
-            val pendingChanges = userRepository.getPendingSyncChanges()
-            pendingChanges.forEach { change ->
+            sentChanges.forEach { change ->
                 userRepository.updateSyncStatus(
                     syncId = change.id,
                     synced = true,
@@ -418,8 +560,26 @@ class SyncManager(
 
         replayPendingSideEffects()
 
-        val pendingChanges = getPendingChangesForSync()
+        val pendingChanges = changeQueueMutex.withLock {
+            getPendingChangesForSync().also { changes ->
+                inFlightChangeIds.clear()
+                changes.mapTo(inFlightChangeIds) { it.id }
+            }
+        }
+        try {
+            return sendPendingChanges(pendingChanges, authToken, startTime)
+        } finally {
+            changeQueueMutex.withLock { inFlightChangeIds.clear() }
+        }
+    }
+
+    private suspend fun sendPendingChanges(
+        pendingChanges: List<SyncChange>,
+        authToken: String,
+        startTime: Long
+    ): SyncResponse {
         if (pendingChanges.isEmpty()) {
+            pullRemoteChanges(authToken)
             _syncStatus.value = SyncStatus.Idle
             val duration = getCurrentTimeMillis() - startTime
             metrics.recordSyncSuccess(duration, 0)
@@ -434,16 +594,15 @@ class SyncManager(
 
         val syncRequest = SyncRequest(
             changes = pendingChanges,
-            lastSyncTimestamp = lastSuccessfulSyncTimestamp
+            lastSyncTimestamp = versionVectorQueries.selectAll().executeAsList().maxOfOrNull { it.updatedAt }
         )
 
         // Make actual HTTP call to server
-        val requestJson = json.encodeToString(SyncRequest.serializer(), syncRequest)
-        val responseJson = httpClient.sync(requestJson, authToken).getOrThrow()
-        val response = json.decodeFromString(SyncResponse.serializer(), responseJson)
+        val response = exchangeSync(syncRequest, authToken)
 
         // Update local sync status based on response
-        updateLocalSyncStatus(response)
+        updateLocalSyncStatus(response, pendingChanges)
+        metrics.recordQueueDepth(userRepository.countPendingSyncChanges())
 
         // Handle conflicts with CRDT-based merging
         for (conflict in response.conflicts) {
@@ -458,10 +617,13 @@ class SyncManager(
 
         _syncStatus.value = if (response.success) SyncStatus.Idle else SyncStatus.Error(syncFailureMessage())
 
+        if (response.success) {
+            // Fetch only what changed on the server since the persisted version vector
+            pullRemoteChanges(authToken)
+        }
+
         val duration = getCurrentTimeMillis() - startTime
         if (response.success) {
-            // Update incremental sync timestamp so next sync only fetches new changes
-            lastSuccessfulSyncTimestamp = response.serverTimestamp
             metrics.recordSyncSuccess(duration, response.appliedChanges)
         } else {
             metrics.recordSyncFailure(duration, syncFailureMessage())
@@ -472,6 +634,169 @@ class SyncManager(
         return response
     }
 
+    /**
+     * Send [request] as CBOR when possible, falling back to JSON when the client has no
+     * binary support or the server rejects the media type.
+     */
+    private suspend fun exchangeSync(request: SyncRequest, authToken: String): SyncResponse {
+        if (binaryWireFormatEnabled) {
+            val result = httpClient.syncEncoded(
+                SyncWireCodec.encode(SyncRequest.serializer(), request, SyncWireFormat.CBOR),
+                SyncWireFormat.CBOR,
+                authToken
+            )
+            result.getOrNull()?.let { payload ->
+                return SyncWireCodec.decode(SyncResponse.serializer(), payload.body, payload.format)
+            }
+            val error = result.exceptionOrNull()
+            if (!isBinaryWireFormatRejected(error)) throw error!!
+            binaryWireFormatEnabled = false
+        }
+
+        val requestJson = json.encodeToString(SyncRequest.serializer(), request)
+        val responseJson = httpClient.sync(requestJson, authToken).getOrThrow()
+        return json.decodeFromString(SyncResponse.serializer(), responseJson)
+    }
+
+    // Only a media-type refusal means the server lacks CBOR; a 400 is a bad request in either format
+    private fun isBinaryWireFormatRejected(error: Throwable?): Boolean =
+        error is UnsupportedOperationException ||
+            (error is HttpException && error.statusCode in BINARY_REJECTED_STATUS_CODES)
+
+    /**
+     * Pull server rows changed since the version vector and apply them locally.
+     * A failed pull leaves the vector untouched, so the next sync resumes from the
+     * last applied page; it never fails the push that preceded it.
+     *
+     * @return Number of pulled rows applied
+     */
+    private suspend fun pullRemoteChanges(authToken: String): Int {
+        var applied = 0
+        var pages = 0
+        try {
+            do {
+                val request = SyncPullRequest(versions = getVersionVector(), limit = pullPageSize)
+                val responseJson = httpClient.pull(
+                    json.encodeToString(SyncPullRequest.serializer(), request),
+                    authToken
+                ).getOrThrow()
+                val response = json.decodeFromString(SyncPullResponse.serializer(), responseJson)
+                if (!response.success) break
+                applied += applyPulledChanges(request, response)
+                pages++
+            } while (response.hasMore && pages < MAX_PULL_PAGES)
+        } catch (e: Exception) {
+            // The vector only advances with applied pages: the next sync resumes from it
+        }
+        return applied
+    }
+
+    /**
+     * Apply one pulled page and advance the version vector in the same transaction.
+     * Rows with pending local changes are skipped: the local edit is pushed and
+     * resolved through the conflict path instead of being overwritten here. Deletes
+     * apply regardless, since a pending edit to a removed row can only be rejected.
+     * Events are applied before participants so new events can receive their members.
+     *
+     * A participant whose event has not been pulled yet holds the participants cursor
+     * back at the row before it while the events table still has pages to send, so the
+     * membership is pulled again once its event has arrived.
+     */
+    private suspend fun applyPulledChanges(request: SyncPullRequest, response: SyncPullResponse): Int {
+        val pendingRecordIds = userRepository.getPendingSyncChanges()
+            .map { it.tableName to it.recordId }
+            .toSet()
+        val eventsPending = "events" in response.tablesWithMore
+        var participantsReached = request.versions["participants"]?.seq ?: 0L
+        var participantsHeldAt: Long? = null
+        var applied = 0
+
+        database.transaction {
+            val ordered = response.changes.sortedWith(compareBy({ if (it.table == "events") 0 else 1 }, { it.seq }))
+            for (change in ordered) {
+                if (change.operation == SyncOperation.DELETE.name) {
+                    when (change.table) {
+                        "events" -> eventRepository.deleteRemoteEvent(change.recordId)
+                        "participants" -> {
+                            participantsReached = change.seq
+                            eventRepository.deleteRemoteParticipant(change.recordId)
+                        }
+                    }
+                    applied++
+                    continue
+                }
+                if ((change.table to change.recordId) in pendingRecordIds) {
+                    if (change.table == "participants") participantsReached = change.seq
+                    continue
+                }
+                when (change.table) {
+                    "events" -> {
+                        val data = json.decodeFromString(SyncEventData.serializer(), change.data)
+                        val updatedAt = data.updatedAt ?: change.timestamp
+                        val status = data.status ?: "DRAFT"
+                        database.eventQueries.insertRemoteEventIfAbsent(
+                            id = data.id,
+                            organizerId = data.organizerId,
+                            title = data.title,
+                            description = data.description,
+                            status = status,
+                            deadline = data.deadline,
+                            updatedAt = updatedAt
+                        )
+                        database.eventQueries.updateRemoteEvent(
+                            title = data.title,
+                            description = data.description,
+                            status = status,
+                            deadline = data.deadline,
+                            updatedAt = updatedAt,
+                            id = data.id
+                        )
+                        applied++
+                    }
+                    "participants" -> {
+                        val data = json.decodeFromString(SyncParticipantData.serializer(), change.data)
+                        // Parent event unknown locally: nothing to attach the member to yet
+                        if (database.eventQueries.selectById(data.eventId).executeAsOneOrNull() == null) {
+                            if (eventsPending && participantsHeldAt == null) participantsHeldAt = participantsReached
+                            participantsReached = change.seq
+                            continue
+                        }
+                        participantsReached = change.seq
+                        val updatedAt = data.updatedAt ?: change.timestamp
+                        val role = data.role ?: "PARTICIPANT"
+                        val hasValidatedDate = if (data.hasValidatedDate == true) 1L else 0L
+                        database.participantQueries.insertRemoteParticipantIfAbsent(
+                            id = data.id ?: change.recordId,
+                            eventId = data.eventId,
+                            userId = data.userId,
+                            role = role,
+                            hasValidatedDate = hasValidatedDate,
+                            updatedAt = updatedAt
+                        )
+                        database.participantQueries.updateRemoteParticipant(
+                            role = role,
+                            hasValidatedDate = hasValidatedDate,
+                            updatedAt = updatedAt,
+                            id = data.id ?: change.recordId
+                        )
+                        applied++
+                    }
+                }
+            }
+
+            val now = getCurrentUtcIsoString()
+            response.versions.forEach { (table, version) ->
+                val held = participantsHeldAt.takeIf { table == "participants" }
+                versionVectorQueries.upsertVersion(
+                    tableName = table,
+                    version = held ?: version.seq,
+                    updatedAt = now
+                )
+            }
+        }
+        return applied
+    }
+
     private suspend fun replayPendingSideEffects(): Int {
         var replayed = 0
         pendingSideEffectReplayers.forEach { replayer ->
@@ -533,13 +858,34 @@ class SyncManager(
     }
 
     /**
-     * Clean up resources
+     * Clean up resources, on logout or shutdown. Cancelling the scope also drops the
+     * scheduler's open debounce window.
      */
     fun dispose() {
         scope.cancel()
     }
 }
 
+/**
+ * Result of folding a new change into an unsent change to the same record
+ */
+private sealed class CoalescedOperation {
+    /** Keep one change with this operation and the merged payload */
+    data class Replace(val operation: SyncOperation) : CoalescedOperation()
+
+    /** Drop the unsent change; nothing needs to reach the server */
+    data object Cancelled : CoalescedOperation()
+}
+
+private const val DEFAULT_PULL_PAGE_SIZE = 500
+private const val DEFAULT_SYNC_DEBOUNCE_MS = 2_000L
+private const val DEFAULT_MAX_COALESCED_CHANGES = 50
+
+private val BINARY_REJECTED_STATUS_CODES = setOf(406, 415)
+
+// Upper bound on pages fetched per sync; the rest is picked up by the next sync
+private const val MAX_PULL_PAGES = 20
+
 internal fun syncFailureMessage(): String =
     "Sync failed. Please retry when your connection is stable."
 
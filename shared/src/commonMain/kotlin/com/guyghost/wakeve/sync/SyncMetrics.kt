@@ -10,6 +10,13 @@ interface SyncMetrics {
     fun recordSyncSuccess(durationMs: Long, changesApplied: Int)
     fun recordSyncFailure(durationMs: Long, error: String)
     fun recordConflictResolved(table: String, strategy: String)
+
+    /** A local change was recorded; [coalesced] when it was merged into an unsent change */
+    fun recordChangeRecorded(coalesced: Boolean)
+
+    /** Unsent changes waiting for the next sync */
+    fun recordQueueDepth(depth: Int)
+
     fun getSyncStats(): SyncStats
 }
 
@@ -19,8 +26,15 @@ data class SyncStats(
     val failedSyncs: Int = 0,
     val averageDurationMs: Long = 0,
     val totalConflictsResolved: Int = 0,
-    val lastSyncTime: Long = 0
-)
+    val lastSyncTime: Long = 0,
+    val queueDepth: Int = 0,
+    val recordedChanges: Int = 0,
+    val coalescedChanges: Int = 0
+) {
+    /** Share of recorded changes merged into an existing unsent change (0.0 - 1.0) */
+    val coalescingRatio: Double
+        get() = if (recordedChanges > 0) coalescedChanges.toDouble() / recordedChanges else 0.0
+}
 
 /**
  * Simple in-memory metrics implementation
@@ -33,6 +47,9 @@ class InMemorySyncMetrics : SyncMetrics {
     private var totalConflictsResolved = 0
     private var lastSyncTime = 0L
     private var currentSyncStartTime = 0L
+    private var queueDepth = 0
+    private var recordedChanges = 0
+    private var coalescedChanges = 0
 
     override fun recordSyncStart() {
         currentSyncStartTime = getCurrentTimeMillis()
@@ -55,6 +72,15 @@ class InMemorySyncMetrics : SyncMetrics {
         totalConflictsResolved++
     }
 
+    override fun recordChangeRecorded(coalesced: Boolean) {
+        recordedChanges++
+        if (coalesced) coalescedChanges++
+    }
+
+    override fun recordQueueDepth(depth: Int) {
+        queueDepth = depth
+    }
+
     override fun getSyncStats(): SyncStats {
         val avgDuration = if (totalSyncs > 0) totalDurationMs / totalSyncs else 0L
         return SyncStats(
@@ -63,7 +89,10 @@ class InMemorySyncMetrics : SyncMetrics {
             failedSyncs = failedSyncs,
             averageDurationMs = avgDuration,
             totalConflictsResolved = totalConflictsResolved,
-            lastSyncTime = lastSyncTime
+            lastSyncTime = lastSyncTime,
+            queueDepth = queueDepth,
+            recordedChanges = recordedChanges,
+            coalescedChanges = coalescedChanges
         )
     }
 }
\ No newline at end of file
@@ -0,0 +1,67 @@
+package com.guyghost.wakeve.sync
+
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.launch
+import kotlinx.coroutines.sync.Mutex
+import kotlinx.coroutines.sync.withLock
+
+/**
+ * Batches sync requests instead of syncing on every recorded change.
+ *
+ * The first change after a flush opens a window of [windowMs]; changes recorded inside
+ * the window ride along with it. The window flushes early once [maxPendingChanges]
+ * changes have accumulated, which bounds the size of a single sync request.
+ */
+class SyncScheduler(
+    private val scope: CoroutineScope,
+    private val windowMs: Long,
+    private val maxPendingChanges: Int,
+    private val flush: suspend () -> Unit
+) {
+    private val mutex = Mutex()
+    private var pendingChanges = 0
+    private var windowJob: Job? = null
+
+    /**
+     * Note a recorded change and schedule (or bring forward) the next flush
+     */
+    suspend fun onChangeRecorded() {
+        val flushNow = mutex.withLock {
+            pendingChanges++
+            if (pendingChanges >= maxPendingChanges) {
+                windowJob?.cancel()
+                windowJob = null
+                pendingChanges = 0
+                true
+            } else {
+                if (windowJob == null) {
+                    windowJob = scope.launch {
+                        delay(windowMs)
+                        mutex.withLock {
+                            windowJob = null
+                            pendingChanges = 0
+                        }
+                        flush()
+                    }
+                }
+                false
+            }
+        }
+        if (flushNow) {
+            scope.launch { flush() }
+        }
+    }
+
+    /**
+     * Drop the open window without flushing (e.g. when the network goes away)
+     */
+    suspend fun cancel() {
+        mutex.withLock {
+            windowJob?.cancel()
+            windowJob = null
+            pendingChanges = 0
+        }
+    }
+}
@@ -0,0 +1,65 @@
+package com.guyghost.wakeve.sync
+
+import kotlinx.serialization.DeserializationStrategy
+import kotlinx.serialization.ExperimentalSerializationApi
+import kotlinx.serialization.SerializationStrategy
+import kotlinx.serialization.cbor.Cbor
+import kotlinx.serialization.json.Json
+
+/**
+ * Body encodings understood by the /sync endpoint, negotiated through
+ * Content-Type and Accept. JSON stays the fallback for older clients and servers.
+ */
+enum class SyncWireFormat(val contentType: String) {
+    JSON("application/json"),
+    CBOR("application/cbor");
+
+    companion object {
+        /** Format for a Content-Type header value; anything unrecognised is treated as JSON. */
+        fun fromContentType(contentType: String?): SyncWireFormat {
+            val mediaType = contentType?.substringBefore(';')?.trim()
+            return entries.firstOrNull { it.contentType.equals(mediaType, ignoreCase = true) } ?: JSON
+        }
+
+        /** Whether an Accept header value lists [format] explicitly. */
+        fun accepts(accept: String?, format: SyncWireFormat): Boolean =
+            accept?.split(',')?.any { it.substringBefore(';').trim().equals(format.contentType, ignoreCase = true) } == true
+    }
+}
+
+/**
+ * Raw response body plus the format the server chose to encode it in.
+ * Transport compression has already been removed.
+ */
+class SyncWirePayload(
+    val body: ByteArray,
+    val format: SyncWireFormat
+)
+
+/**
+ * Encodes sync bodies for either wire format.
+ *
+ * CBOR carries field names and strings without quoting or escaping, and each
+ * SyncChange.data payload travels as a structured record rather than a nested
+ * JSON document (see SyncChangeSerializer).
+ */
+@OptIn(ExperimentalSerializationApi::class)
+object SyncWireCodec {
+    private val json = Json { ignoreUnknownKeys = true }
+    private val cbor = Cbor { ignoreUnknownKeys = true }
+
+    // Bodies below this size are sent as-is; gzip framing would outweigh the savings
+    const val MIN_COMPRESSED_SIZE = 1024
+
+    fun <T> encode(serializer: SerializationStrategy<T>, value: T, format: SyncWireFormat): ByteArray =
+        when (format) {
+            SyncWireFormat.JSON -> json.encodeToString(serializer, value).encodeToByteArray()
+            SyncWireFormat.CBOR -> cbor.encodeToByteArray(serializer, value)
+        }
+
+    fun <T> decode(deserializer: DeserializationStrategy<T>, bytes: ByteArray, format: SyncWireFormat): T =
+        when (format) {
+            SyncWireFormat.JSON -> json.decodeFromString(deserializer, bytes.decodeToString())
+            SyncWireFormat.CBOR -> cbor.decodeFromByteArray(deserializer, bytes)
+        }
+}
@@ -5,6 +5,8 @@ import kotlin.test.Test
 import kotlin.test.AfterTest
 import kotlin.test.BeforeTest
 import kotlin.test.assertEquals
+import kotlin.test.assertNotNull
+import kotlin.test.assertNull
 import kotlin.test.assertTrue
 
 /**
@@ -12,19 +14,21 @@ import kotlin.test.assertTrue
  *
  * Tests cover:
  * - Enqueueing events
- * - Getting pending events
- * - Marking events as synced
- * - Marking events as failed
- * - Retry logic
+ * - Buffer flushes and segment sealing
+ * - Acknowledging uploaded segments
+ * - Retry backoff and the pending segment cap
+ * - Cold start from the segment store
  * - Clearing queue
  */
 class AnalyticsQueueTest {
 
+    private lateinit var store: InMemoryAnalyticsSegmentStore
     private lateinit var queue: AnalyticsQueue
 
     @BeforeTest
     fun setup() {
-        queue = AnalyticsQueue()
+        store = InMemoryAnalyticsSegmentStore()
+        queue = AnalyticsQueue(store, bufferCapacity = 4, segmentMaxBytes = 150, clock = { 1_000L })
     }
 
     @AfterTest
@@ -34,156 +38,170 @@ class AnalyticsQueueTest {
 
     @Test
     fun `enqueue adds event to queue`() = runTest {
-        // Given
-        val event = AnalyticsEvent.AppStart
-        val properties = mapOf("test" to "value")
-
         // When
-        queue.enqueue(event, properties)
+        queue.enqueue(AnalyticsEvent.AppStart, mapOf("test" to "value"))
 
         // Then
         assertEquals(1, queue.size)
+        assertTrue(store.readTail().isEmpty(), "event stays buffered until the buffer fills")
     }
 
     @Test
-    fun `enqueue stores event correctly`() = runTest {
-        // Given
-        val event = AnalyticsEvent.EventCreated("BIRTHDAY")
-        val properties = mapOf("test" to "value")
-
+    fun `full buffer is flushed to the tail in one append`() = runTest {
         // When
-        queue.enqueue(event, properties)
+        repeat(4) { queue.enqueue(AnalyticsEvent.AppStart, emptyMap()) }
 
         // Then
-        val pending = queue.getPendingEvents()
-        assertEquals(1, pending.size)
-        assertEquals("event_created", pending[0].eventName)
-        assertEquals("value", pending[0].properties["test"])
+        assertEquals(4, AnalyticsQueue.decodeSegment(store.readTail()).size)
+        assertEquals(4, queue.size)
     }
 
     @Test
-    fun `enqueue multiple events`() = runTest {
+    fun `nextSegment returns events in order with properties as strings`() = runTest {
         // Given
-        val events = listOf(
-            AnalyticsEvent.AppStart to emptyMap<String, Any?>(),
-            AnalyticsEvent.ScreenView("home") to mapOf("screen" to "home"),
-            AnalyticsEvent.EventCreated("WEDDING") to emptyMap()
+        queue.enqueue(
+            AnalyticsEvent.EventCreated("BIRTHDAY"),
+            mapOf(
+                "string" to "value",
+                "int" to 42,
+                "long" to 123456789L,
+                "double" to 3.14,
+                "boolean" to true,
+                "null" to null
+            )
         )
+        queue.enqueue(AnalyticsEvent.ScreenView("home"), mapOf("screen" to "home"))
 
         // When
-        events.forEach { (event, props) ->
-            queue.enqueue(event, props)
-        }
+        val segment = assertNotNull(queue.nextSegment())
 
         // Then
-        assertEquals(3, queue.size)
+        assertEquals(2, segment.eventCount)
+        assertNull(segment.contentEncoding)
+        val events = AnalyticsQueue.decodeSegment(segment.payload)
+        assertEquals(listOf("event_created", "screen_view"), events.map { it.eventName })
+        val properties = events[0].properties
+        assertEquals("value", properties["string"])
+        assertEquals("42", properties["int"])
+        assertEquals("123456789", properties["long"])
+        assertEquals("3.14", properties["double"])
+        assertEquals("true", properties["boolean"])
+        assertEquals("", properties["null"])
+        assertEquals(1_000L, events[1].timestamp)
     }
 
     @Test
-    fun `getPendingEvents returns all events`() = runTest {
-        // Given
-        queue.enqueue(AnalyticsEvent.AppStart, emptyMap())
-        queue.enqueue(AnalyticsEvent.ScreenView("home"), emptyMap())
+    fun `large tail is sealed into several segments uploaded oldest first`() = runTest {
+        // Given - each flush of 4 events exceeds the 150 byte segment limit
+        repeat(8) { queue.enqueue(AnalyticsEvent.ScreenView("screen-$it"), mapOf("index" to it)) }
 
         // When
-        val pending = queue.getPendingEvents()
+        val first = assertNotNull(queue.nextSegment())
+        queue.acknowledge(first)
+        val second = assertNotNull(queue.nextSegment())
+        queue.acknowledge(second)
 
         // Then
-        assertEquals(2, pending.size)
+        assertEquals("0", AnalyticsQueue.decodeSegment(first.payload).first().properties["index"])
+        assertEquals("4", AnalyticsQueue.decodeSegment(second.payload).first().properties["index"])
+        assertNull(queue.nextSegment())
+        assertEquals(0, queue.size)
     }
 
     @Test
-    fun `getPendingEvents filters events exceeding max retries`() = runTest {
+    fun `acknowledge is a single marker write`() = runTest {
         // Given
-        queue.enqueue(AnalyticsEvent.AppStart, emptyMap())
-        val eventId = queue.getPendingEvents()[0].id
+        repeat(8) { queue.enqueue(AnalyticsEvent.AppStart, mapOf("padding" to "x".repeat(40))) }
+        val first = assertNotNull(queue.nextSegment())
 
-        // When - fail 3 times (max retries)
-        repeat(3) {
-            queue.markAsFailed(listOf(eventId))
-        }
+        // When
+        queue.acknowledge(first)
 
-        // Then - event should be removed
-        val pending = queue.getPendingEvents()
-        assertEquals(0, pending.size)
+        // Then
+        assertEquals(first.id, store.readAckMarker())
+        assertEquals(4, queue.size)
     }
 
     @Test
-    fun `markAsSynced removes events from queue`() = runTest {
+    fun `nextSegment returns the same segment until acknowledged`() = runTest {
         // Given
         queue.enqueue(AnalyticsEvent.AppStart, emptyMap())
-        queue.enqueue(AnalyticsEvent.ScreenView("home"), emptyMap())
-        val eventIds = queue.getPendingEvents().map { it.id }
 
         // When
-        queue.markAsSynced(eventIds)
+        val first = assertNotNull(queue.nextSegment())
+        queue.enqueue(AnalyticsEvent.AppForeground, emptyMap())
+        val again = assertNotNull(queue.nextSegment())
 
         // Then
-        assertEquals(0, queue.size)
+        assertEquals(first.id, again.id)
+        assertEquals(2, queue.size)
     }
 
     @Test
-    fun `markAsSynced removes only specified events`() = runTest {
+    fun `markAsFailed keeps the segment and backs off exponentially`() = runTest {
         // Given
-        queue.enqueue(AnalyticsEvent.AppStart, emptyMap())
-        queue.enqueue(AnalyticsEvent.ScreenView("home"), emptyMap())
-        val allEvents = queue.getPendingEvents()
-        val firstEventId = allEvents[0].id
+        val backoffQueue = AnalyticsQueue(store, baseRetryDelayMs = 1_000L, maxRetryDelayMs = 5_000L)
+        backoffQueue.enqueue(AnalyticsEvent.AppStart, emptyMap())
+        val segment = assertNotNull(backoffQueue.nextSegment())
 
-        // When - mark only first event as synced
-        queue.markAsSynced(listOf(firstEventId))
+        // When
+        val delays = List(5) { backoffQueue.markAsFailed(segment) }
 
-        // Then - second event should remain
-        assertEquals(1, queue.size)
-        val remaining = queue.getPendingEvents()
-        assertEquals("screen_view", remaining[0].eventName)
+        // Then
+        assertEquals(listOf(1_000L, 2_000L, 4_000L, 5_000L, 5_000L), delays)
+        assertEquals(segment.id, backoffQueue.nextSegment()?.id)
+        assertEquals(1, backoffQueue.size)
     }
 
     @Test
-    fun `markAsFailed increments retry count`() = runTest {
+    fun `oldest segment is dropped beyond maxPendingSegments`() = runTest {
         // Given
-        queue.enqueue(AnalyticsEvent.AppStart, emptyMap())
-        val eventId = queue.getPendingEvents()[0].id
+        val cappedQueue = AnalyticsQueue(store, bufferCapacity = 1, segmentMaxBytes = 1, maxPendingSegments = 2)
 
-        // When
-        queue.markAsFailed(listOf(eventId))
+        // When - every event seals its own segment
+        repeat(3) { cappedQueue.enqueue(AnalyticsEvent.AppStart, mapOf("index" to it)) }
 
         // Then
-        val pending = queue.getPendingEvents()
-        assertEquals(1, pending.size)
-        assertEquals(1, pending[0].retryCount)
+        assertEquals(2, cappedQueue.size)
+        val oldest = assertNotNull(cappedQueue.nextSegment())
+        assertEquals("1", AnalyticsQueue.decodeSegment(oldest.payload).single().properties["index"])
     }
 
     @Test
-    fun `markAsFailed increments retry count multiple times`() = runTest {
+    fun `cold start resumes from the store without losing flushed events`() = runTest {
         // Given
+        repeat(8) { queue.enqueue(AnalyticsEvent.ScreenView("screen-$it"), emptyMap()) }
         queue.enqueue(AnalyticsEvent.AppStart, emptyMap())
-        val eventId = queue.getPendingEvents()[0].id
+        queue.flush()
 
-        // When - fail twice
-        queue.markAsFailed(listOf(eventId))
-        queue.markAsFailed(listOf(eventId))
+        // When
+        val restarted = AnalyticsQueue(store, bufferCapacity = 4, segmentMaxBytes = 200)
 
         // Then
-        val pending = queue.getPendingEvents()
-        assertEquals(2, pending[0].retryCount)
+        assertEquals(9, restarted.size)
+        val uploaded = mutableListOf<String>()
+        while (true) {
+            val segment = restarted.nextSegment() ?: break
+            uploaded += AnalyticsQueue.decodeSegment(segment.payload).map { it.eventName }
+            restarted.acknowledge(segment)
+        }
+        assertEquals(List(8) { "screen_view" } + "app_start", uploaded)
     }
 
     @Test
-    fun `markAsFailed removes events after max retries`() = runTest {
+    fun `torn tail record is discarded on cold start`() = runTest {
         // Given
         queue.enqueue(AnalyticsEvent.AppStart, emptyMap())
-        val eventId = queue.getPendingEvents()[0].id
+        queue.flush()
+        val validLength = store.readTail().size
+        store.appendTail(byteArrayOf(0, 0, 0, 50, 1, 2))
 
-        // When - fail 3 times
-        repeat(3) {
-            queue.markAsFailed(listOf(eventId))
-        }
+        // When
+        val restarted = AnalyticsQueue(store)
 
-        // Then - event should be removed
-        val pending = queue.getPendingEvents()
-        assertEquals(0, pending.size)
-        assertEquals(0, queue.size)
+        // Then
+        assertEquals(1, restarted.size)
+        assertEquals(validLength, store.readTail().size)
     }
 
     @Test
@@ -198,81 +216,6 @@ class AnalyticsQueueTest {
 
         // Then
         assertEquals(0, queue.size)
-        val pending = queue.getPendingEvents()
-        assertEquals(0, pending.size)
-    }
-
-    @Test
-    fun `event properties are converted to strings`() = runTest {
-        // Given
-        val properties = mapOf(
-            "string" to "value",
-            "int" to 42,
-            "long" to 123456789L,
-            "double" to 3.14,
-            "boolean" to true,
-            "null" to null
-        )
-        val event = AnalyticsEvent.ScreenView("test")
-
-        // When
-        queue.enqueue(event, properties)
-
-        // Then
-        val pending = queue.getPendingEvents()
-        val queuedProps = pending[0].properties
-        assertEquals("value", queuedProps["string"])
-        assertEquals("42", queuedProps["int"])
-        assertEquals("123456789", queuedProps["long"])
-        assertEquals("3.14", queuedProps["double"])
-        assertEquals("true", queuedProps["boolean"])
-        assertEquals("", queuedProps["null"])
-    }
-
-    @Test
-    fun `event IDs are unique`() = runTest {
-        // Given
-        val events = List(10) { AnalyticsEvent.AppStart }
-
-        // When
-        events.forEach { queue.enqueue(it, emptyMap()) }
-
-        // Then
-        val pending = queue.getPendingEvents()
-        val ids = pending.map { it.id }
-        assertEquals(10, ids.size)
-        assertEquals(10, ids.toSet().size) // All IDs should be unique
-    }
-
-    @Test
-    fun `retry count starts at 0`() = runTest {
-        // Given
-        queue.enqueue(AnalyticsEvent.AppStart, emptyMap())
-
-        // When
-        val pending = queue.getPendingEvents()
-
-        // Then
-        assertEquals(0, pending[0].retryCount)
-    }
-
-    @Test
-    fun `markAsFailed only affects specified events`() = runTest {
-        // Given
-        queue.enqueue(AnalyticsEvent.AppStart, emptyMap())
-        queue.enqueue(AnalyticsEvent.ScreenView("home"), emptyMap())
-        val allEvents = queue.getPendingEvents()
-        val firstEventId = allEvents[0].id
-
-        // When - fail only first event
-        queue.markAsFailed(listOf(firstEventId))
-
-        // Then - first event has retry count 1, second has 0
-        val pending = queue.getPendingEvents()
-        val firstEvent = pending.find { it.id == firstEventId }
-        val secondEvent = pending.find { it.id != firstEventId }
-
-        assertEquals(1, firstEvent?.retryCount)
-        assertEquals(0, secondEvent?.retryCount)
+        assertNull(queue.nextSegment())
     }
 }
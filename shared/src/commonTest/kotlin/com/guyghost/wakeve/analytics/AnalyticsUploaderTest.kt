@@ -0,0 +1,107 @@
+package com.guyghost.wakeve.analytics
+
+import kotlinx.coroutines.test.advanceTimeBy
+import kotlinx.coroutines.test.runCurrent
+import kotlinx.coroutines.test.runTest
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertNull
+import kotlin.test.assertTrue
+
+class AnalyticsUploaderTest {
+
+    private val queue = AnalyticsQueue(
+        bufferCapacity = 1,
+        segmentMaxBytes = 1,
+        baseRetryDelayMs = 1_000L,
+        maxRetryDelayMs = 60_000L
+    )
+
+    @Test
+    fun `uploadPending drains and acknowledges every segment`() = runTest {
+        // Given
+        repeat(3) { queue.enqueue(AnalyticsEvent.AppStart, mapOf("index" to it)) }
+        val uploaded = mutableListOf<Long>()
+        val uploader = AnalyticsUploader(queue, { segment ->
+            uploaded += segment.id
+            Result.success(Unit)
+        }, intervalMs = 300_000L)
+
+        // When
+        val delay = uploader.uploadPending()
+
+        // Then
+        assertEquals(300_000L, delay)
+        assertEquals(listOf(1L, 2L, 3L), uploaded)
+        assertNull(queue.nextSegment())
+    }
+
+    @Test
+    fun `failed upload keeps the segment and waits for the backoff`() = runTest {
+        // Given
+        queue.enqueue(AnalyticsEvent.AppStart, emptyMap())
+        val uploader = AnalyticsUploader(queue, { Result.failure(IllegalStateException("offline backend")) })
+
+        // When
+        val delays = List(3) { uploader.uploadPending() }
+
+        // Then
+        assertEquals(listOf(1_000L, 2_000L, 4_000L), delays)
+        assertEquals(1, queue.size)
+    }
+
+    @Test
+    fun `thrown exception counts as a failed upload`() = runTest {
+        // Given
+        queue.enqueue(AnalyticsEvent.AppStart, emptyMap())
+        val uploader = AnalyticsUploader(queue, { throw IllegalStateException("connection reset") })
+
+        // When
+        val delay = uploader.uploadPending()
+
+        // Then
+        assertEquals(1_000L, delay)
+        assertEquals(1, queue.size)
+    }
+
+    @Test
+    fun `nothing is uploaded while offline`() = runTest {
+        // Given
+        queue.enqueue(AnalyticsEvent.AppStart, emptyMap())
+        var calls = 0
+        val uploader = AnalyticsUploader(queue, { calls++; Result.success(Unit) }, isOnline = { false })
+
+        // When
+        uploader.uploadPending()
+
+        // Then
+        assertEquals(0, calls)
+        assertTrue(queue.size > 0)
+    }
+
+    @Test
+    fun `running uploader flushes buffered events periodically`() = runTest {
+        // Given
+        val store = InMemoryAnalyticsSegmentStore()
+        val bufferedQueue = AnalyticsQueue(store, bufferCapacity = 16)
+        val uploader = AnalyticsUploader(
+            bufferedQueue,
+            { Result.success(Unit) },
+            isOnline = { false },
+            flushIntervalMs = 30_000L
+        )
+        uploader.start(backgroundScope)
+        bufferedQueue.enqueue(AnalyticsEvent.AppStart, emptyMap())
+
+        // When
+        advanceTimeBy(29_000L)
+        runCurrent()
+        val tailBeforeFlush = store.readTail().size
+        advanceTimeBy(2_000L)
+        runCurrent()
+
+        // Then
+        assertEquals(0, tailBeforeFlush)
+        assertTrue(store.readTail().isNotEmpty())
+    }
+}
@@ -0,0 +1,152 @@
+package com.guyghost.wakeve.budget
+
+import com.guyghost.wakeve.models.BudgetCategory
+import com.guyghost.wakeve.models.BudgetItem
+import kotlin.random.Random
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertTrue
+
+/**
+ * Property tests for SettlementEngine: money is conserved to the cent and
+ * small groups settle in the fewest transfers.
+ */
+class SettlementEngineTest {
+
+    @Test
+    fun settlementsZeroEveryBalance() {
+        val random = Random(7)
+        repeat(500) { trial ->
+            // Sizes on both sides of the exact grouping limit
+            val balances = randomZeroSumBalances(random, participants = random.nextInt(1, 40))
+
+            val transfers = SettlementEngine.settle(balances)
+
+            val remaining = applyTransfers(balances, transfers)
+            assertTrue(remaining.values.all { it == 0L }, "trial $trial left $remaining")
+            assertTrue(transfers.all { it.amountMinor > 0 && it.from != it.to })
+            assertTrue(transfers.size <= maxOf(0, balances.count { it.value != 0L } - 1))
+        }
+    }
+
+    @Test
+    fun smallGroupsUseFewestTransfers() {
+        val random = Random(11)
+        repeat(300) {
+            val balances = randomZeroSumBalances(random, participants = random.nextInt(2, 10), maxUnits = 4)
+
+            val transfers = SettlementEngine.settle(balances)
+
+            assertEquals(minimumTransfers(balances.values.filter { it != 0L }), transfers.size, "balances $balances")
+        }
+    }
+
+    @Test
+    fun splitsSubsetsThatCancelOut() {
+        // {A, D} and {B, C, E} cancel separately: 3 transfers, where matching
+        // largest to largest over everyone needs 4
+        val balances = mapOf("a" to 600L, "b" to 400L, "c" to 300L, "d" to -600L, "e" to -700L)
+
+        val transfers = SettlementEngine.settle(balances)
+
+        assertEquals(3, transfers.size)
+        assertTrue(SettlementEngine.Transfer("a", "d", 600L) in transfers)
+    }
+
+    @Test
+    fun itemSharesAreExactToTheCent() {
+        val items = listOf(
+            item("dinner", cost = 100.0, paidBy = "alice", sharedBy = listOf("alice", "bob", "carol")),
+            item("taxi", cost = 0.1, paidBy = "bob", sharedBy = listOf("alice", "bob", "carol"))
+        )
+
+        val balances = SettlementEngine.calculateBalances(items)
+
+        // 100.00 / 3 = 33.34 + 33.33 + 33.33; 0.10 / 3 = 0.04 + 0.03 + 0.03
+        assertEquals(mapOf("alice" to -6_662L, "bob" to 3_326L, "carol" to 3_336L), balances)
+        assertEquals(0L, balances.values.sum())
+    }
+
+    @Test
+    fun uncoveredDebtIsNeverOverpaid() {
+        val random = Random(3)
+        repeat(300) {
+            val participants = List(random.nextInt(2, 25)) { "user-$it" }
+            val items = List(random.nextInt(1, 30)) { index ->
+                item(
+                    name = "item-$index",
+                    cost = random.nextInt(1, 50_000) / 100.0,
+                    paidBy = participants.random(random).takeIf { random.nextInt(3) > 0 },
+                    sharedBy = participants.shuffled(random).take(random.nextInt(1, participants.size + 1))
+                )
+            }
+            val balances = SettlementEngine.calculateBalances(items)
+
+            val transfers = SettlementEngine.settle(items)
+
+            val remaining = applyTransfers(balances, transfers)
+            balances.forEach { (participant, balance) ->
+                val left = remaining.getValue(participant)
+                // Moves toward zero without crossing it
+                assertTrue(if (balance >= 0) left in 0..balance else left in balance..0, "$participant $balance -> $left")
+            }
+            val debt = balances.values.filter { it > 0 }.sum()
+            val credit = -balances.values.filter { it < 0 }.sum()
+            assertEquals(minOf(debt, credit), transfers.sumOf { it.amountMinor })
+        }
+    }
+
+    private fun randomZeroSumBalances(random: Random, participants: Int, maxUnits: Int = 500): Map<String, Long> {
+        val amounts = MutableList(participants) { (random.nextInt(-maxUnits, maxUnits + 1) * 100L) }
+        if (amounts.isNotEmpty()) amounts[amounts.lastIndex] -= amounts.sum()
+        return amounts.withIndex().associate { (index, amount) -> "user-$index" to amount }
+    }
+
+    private fun applyTransfers(balances: Map<String, Long>, transfers: List<SettlementEngine.Transfer>): Map<String, Long> {
+        val remaining = balances.toMutableMap()
+        transfers.forEach { transfer ->
+            remaining[transfer.from] = remaining.getValue(transfer.from) - transfer.amountMinor
+            remaining[transfer.to] = remaining.getValue(transfer.to) + transfer.amountMinor
+        }
+        return remaining
+    }
+
+    /**
+     * Reference: n minus the most disjoint zero-sum subsets, by exhaustive search.
+     */
+    private fun minimumTransfers(amounts: List<Long>): Int {
+        fun maxGroups(remaining: List<Long>): Int {
+            if (remaining.isEmpty()) return 0
+            val first = remaining.first()
+            val rest = remaining.drop(1)
+            var best = 0
+            // Every zero-sum subset containing the first element
+            for (mask in 0 until (1 shl rest.size)) {
+                var sum = first
+                for (i in rest.indices) if (mask and (1 shl i) != 0) sum += rest[i]
+                if (sum == 0L) {
+                    val others = rest.filterIndexed { i, _ -> mask and (1 shl i) == 0 }
+                    best = maxOf(best, 1 + maxGroups(others))
+                }
+            }
+            return best
+        }
+        return amounts.size - maxGroups(amounts)
+    }
+
+    private fun item(name: String, cost: Double, paidBy: String?, sharedBy: List<String>) = BudgetItem(
+        id = name,
+        budgetId = "budget-1",
+        category = BudgetCategory.OTHER,
+        name = name,
+        description = "",
+        estimatedCost = cost,
+        actualCost = if (paidBy != null) cost else 0.0,
+        isPaid = paidBy != null,
+        paidBy = paidBy,
+        sharedBy = sharedBy,
+        notes = "",
+        createdAt = "2025-12-25T10:00:00Z",
+        updatedAt = "2025-12-25T10:00:00Z"
+    )
+}
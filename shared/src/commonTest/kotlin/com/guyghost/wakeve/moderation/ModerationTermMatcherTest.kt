@@ -0,0 +1,55 @@
+package com.guyghost.wakeve.moderation
+
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFalse
+import kotlin.test.assertTrue
+
+class ModerationTermMatcherTest {
+    @Test
+    fun `overlapping and nested terms are all reported`() {
+        val matcher = ModerationTermMatcher.compile(
+            mapOf(
+                ModerationTermCategory.HARD_POLICY to setOf("he", "she", "his", "hers"),
+                ModerationTermCategory.SPAM to setOf("ushers")
+            )
+        )
+
+        val hits = matcher.scan("ushers")
+
+        // she, he and hers end inside "ushers"; his does not occur
+        assertEquals(3, hits.distinct(ModerationTermCategory.HARD_POLICY))
+        assertEquals(1, hits.distinct(ModerationTermCategory.SPAM))
+        assertFalse(hits.contains(ModerationTermCategory.PENDING_REVIEW))
+    }
+
+    @Test
+    fun `occurrences count repeats while distinct counts terms`() {
+        val matcher = ModerationTermMatcher.compile(
+            mapOf(ModerationTermCategory.LINK to setOf("http://", "https://", "www."))
+        )
+
+        val hits = matcher.scan("https://a.test then https://b.test and www.c.test")
+
+        assertEquals(3, hits.occurrences(ModerationTermCategory.LINK))
+        assertEquals(2, hits.distinct(ModerationTermCategory.LINK))
+    }
+
+    @Test
+    fun `empty term set matches nothing`() {
+        val hits = ModerationTermMatcher.compile(emptyMap()).scan("anything at all")
+
+        ModerationTermCategory.entries.forEach { assertFalse(hits.contains(it)) }
+    }
+
+    @Test
+    fun `policy picks up updated term lists`() {
+        val policy = ModerationPolicy()
+        assertEquals(ModerationStatus.APPROVED, policy.evaluate("Bring a picnic blanket").status)
+
+        policy.updateTerms(hardPolicyTerms = setOf("Picnic  Blanket"), pendingReviewTerms = emptySet())
+
+        assertEquals(ModerationStatus.REJECTED, policy.evaluate("Bring a picnic blanket").status)
+        assertTrue(policy.evaluate("Train leaves at 18:30").canPublish)
+    }
+}
@@ -0,0 +1,152 @@
+package com.guyghost.wakeve.analytics
+
+import kotlinx.cinterop.ExperimentalForeignApi
+import kotlinx.cinterop.addressOf
+import kotlinx.cinterop.convert
+import kotlinx.cinterop.pointed
+import kotlinx.cinterop.toKString
+import kotlinx.cinterop.usePinned
+import platform.Foundation.NSApplicationSupportDirectory
+import platform.Foundation.NSSearchPathForDirectoriesInDomains
+import platform.Foundation.NSUserDomainMask
+import platform.posix.SEEK_END
+import platform.posix.SEEK_SET
+import platform.posix.closedir
+import platform.posix.fclose
+import platform.posix.fflush
+import platform.posix.fileno
+import platform.posix.fopen
+import platform.posix.fread
+import platform.posix.fseek
+import platform.posix.fsync
+import platform.posix.ftell
+import platform.posix.fwrite
+import platform.posix.mkdir
+import platform.posix.opendir
+import platform.posix.readdir
+import platform.posix.rename
+import platform.posix.truncate
+import platform.posix.unlink
+
+actual fun createAnalyticsSegmentStore(): AnalyticsSegmentStore {
+    val applicationSupport = NSSearchPathForDirectoriesInDomains(NSApplicationSupportDirectory, NSUserDomainMask, true)
+        .first() as String
+    return PosixAnalyticsSegmentStore("$applicationSupport/analytics")
+}
+
+/**
+ * [AnalyticsSegmentStore] backed by files in [directory], through POSIX calls.
+ *
+ * Same layout as the JVM and Android file store: `tail.log`,
+ * `segment-<id>-<count>.log` and `ack-<id>` markers. Sealing is a rename(2) of
+ * the tail. There is no zlib binding here, so segments are uploaded raw.
+ */
+@OptIn(ExperimentalForeignApi::class)
+class PosixAnalyticsSegmentStore(private val directory: String) : AnalyticsSegmentStore {
+    private val tailPath = "$directory/${AnalyticsSegmentFiles.TAIL}"
+
+    init {
+        // mkdir -p; existing levels just fail with EEXIST
+        directory.split('/').filter { it.isNotEmpty() }.fold("") { parent, part ->
+            "$parent/$part".also { mkdir(it, DIRECTORY_MODE.convert()) }
+        }
+    }
+
+    override val contentEncoding: String? = null
+
+    override fun appendTail(bytes: ByteArray) {
+        val file = fopen(tailPath, "ab") ?: throw IllegalStateException("Could not open the analytics tail")
+        try {
+            if (bytes.isNotEmpty()) {
+                val written = bytes.usePinned { fwrite(it.addressOf(0), 1.convert(), bytes.size.convert(), file) }
+                check(written.toLong() == bytes.size.toLong()) { "Short write to the analytics tail" }
+            }
+            fflush(file)
+            fsync(fileno(file))
+        } finally {
+            fclose(file)
+        }
+    }
+
+    override fun readTail(): ByteArray = readFile(tailPath) ?: ByteArray(0)
+
+    override fun truncateTail(length: Int) {
+        truncate(tailPath, length.convert())
+    }
+
+    override fun sealTail(id: Long, eventCount: Int) {
+        val segmentPath = "$directory/${AnalyticsSegmentFiles.segmentName(id, eventCount)}"
+        check(rename(tailPath, segmentPath) == 0) { "Could not seal analytics segment $id" }
+    }
+
+    override fun sealedSegments(): List<AnalyticsSegmentStore.SegmentInfo> {
+        val ackMarker = readAckMarker()
+        return listNames()
+            .mapNotNull(AnalyticsSegmentFiles::parseSegmentName)
+            .filter { it.id > ackMarker }
+            .sortedBy { it.id }
+    }
+
+    override fun readSegment(id: Long): ByteArray? {
+        val info = listNames().mapNotNull(AnalyticsSegmentFiles::parseSegmentName).firstOrNull { it.id == id }
+            ?: return null
+        return readFile("$directory/${AnalyticsSegmentFiles.segmentName(info.id, info.eventCount)}")
+    }
+
+    override fun readAckMarker(): Long = listNames().mapNotNull(AnalyticsSegmentFiles::parseAckName).maxOrNull() ?: 0L
+
+    override fun writeAckMarker(id: Long) {
+        val marker = fopen("$directory/${AnalyticsSegmentFiles.ackName(id)}", "wb")
+            ?: throw IllegalStateException("Could not write analytics ack marker $id")
+        fclose(marker)
+        // Best effort: markers and segments left behind are ignored because of the new marker
+        listNames().forEach { name ->
+            val staleMarker = AnalyticsSegmentFiles.parseAckName(name)?.let { it < id } == true
+            val acknowledged = AnalyticsSegmentFiles.parseSegmentName(name)?.let { it.id <= id } == true
+            if (staleMarker || acknowledged) unlink("$directory/$name")
+        }
+    }
+
+    override fun clear() {
+        listNames().forEach { name ->
+            if (AnalyticsSegmentFiles.parseAckName(name) != null || AnalyticsSegmentFiles.parseSegmentName(name) != null) {
+                unlink("$directory/$name")
+            }
+        }
+        unlink(tailPath)
+    }
+
+    private fun readFile(path: String): ByteArray? {
+        val file = fopen(path, "rb") ?: return null
+        try {
+            fseek(file, 0, SEEK_END)
+            val size = ftell(file).toInt()
+            fseek(file, 0, SEEK_SET)
+            val bytes = ByteArray(size)
+            if (size > 0) {
+                bytes.usePinned { fread(it.addressOf(0), 1.convert(), size.convert(), file) }
+            }
+            return bytes
+        } finally {
+            fclose(file)
+        }
+    }
+
+    private fun listNames(): List<String> {
+        val dir = opendir(directory) ?: return emptyList()
+        try {
+            val names = mutableListOf<String>()
+            while (true) {
+                val entry = readdir(dir) ?: break
+                names += entry.pointed.d_name.toKString()
+            }
+            return names
+        } finally {
+            closedir(dir)
+        }
+    }
+
+    private companion object {
+        const val DIRECTORY_MODE = 0x1C0 // 0700
+    }
+}
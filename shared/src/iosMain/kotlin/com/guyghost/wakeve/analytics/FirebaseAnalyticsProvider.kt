@@ -1,9 +1,14 @@
 package com.guyghost.wakeve.analytics
 
+import com.guyghost.wakeve.sync.createNetworkStatusDetector
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.SupervisorJob
 import kotlinx.coroutines.launch
+import kotlinx.coroutines.runBlocking
+import platform.Foundation.NSNotificationCenter
+import platform.UIKit.UIApplicationDidEnterBackgroundNotification
+import platform.UIKit.UIApplicationWillTerminateNotification
 
 /**
  * iOS analytics provider.
@@ -14,9 +19,11 @@ import kotlinx.coroutines.launch
  * are not emitted to a third-party analytics SDK on iOS.
  *
  * @param analyticsQueue Queue for offline analytics event backup
+ * @param segmentUploader Sends queued segments to the analytics backend
  */
 actual class FirebaseAnalyticsProvider actual constructor(
-    private val analyticsQueue: AnalyticsQueue
+    private val analyticsQueue: AnalyticsQueue,
+    private val segmentUploader: AnalyticsSegmentUploader
 ) : AnalyticsProvider {
 
     private val scope = CoroutineScope(SupervisorJob() + Dispatchers.Default)
@@ -24,6 +31,7 @@ actual class FirebaseAnalyticsProvider actual constructor(
 
     init {
         startSyncJob()
+        flushOnLifecycleEvents()
     }
 
     /**
@@ -84,10 +92,29 @@ actual class FirebaseAnalyticsProvider actual constructor(
     }
 
     /**
-     * Offline analytics sync is intentionally disabled on iOS for the first
-     * App Store build because no third-party analytics SDK is linked.
+     * Writes buffered events to disk when the app enters the background, and
+     * before returning from the termination notification.
+     */
+    private fun flushOnLifecycleEvents() {
+        val center = NSNotificationCenter.defaultCenter
+        center.addObserverForName(UIApplicationDidEnterBackgroundNotification, null, null) { _ ->
+            scope.launch { analyticsQueue.flush() }
+        }
+        center.addObserverForName(UIApplicationWillTerminateNotification, null, null) { _ ->
+            runBlocking { analyticsQueue.flush() }
+        }
+    }
+
+    /**
+     * Uploads queued segments through the app's first-party [segmentUploader];
+     * no third-party analytics SDK is linked on iOS.
      */
     private fun startSyncJob() {
-        // No-op.
+        val networkDetector = createNetworkStatusDetector()
+        AnalyticsUploader(
+            queue = analyticsQueue,
+            uploader = segmentUploader,
+            isOnline = { networkDetector.isNetworkAvailable.value }
+        ).start(scope)
     }
 }
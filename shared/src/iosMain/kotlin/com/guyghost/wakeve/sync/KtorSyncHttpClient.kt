@@ -2,10 +2,14 @@ package com.guyghost.wakeve.sync
 
 import io.ktor.client.HttpClient
 import io.ktor.client.call.body
+import io.ktor.client.request.accept
 import io.ktor.client.request.bearerAuth
+import io.ktor.client.request.header
 import io.ktor.client.request.post
 import io.ktor.client.request.setBody
+import io.ktor.client.statement.HttpResponse
 import io.ktor.http.ContentType
+import io.ktor.http.HttpHeaders
 import io.ktor.http.contentType
 import io.ktor.http.isSuccess
 import kotlinx.cinterop.ExperimentalForeignApi
@@ -58,15 +62,51 @@ class KtorSyncHttpClient(
     private val httpClient: HttpClient = HttpClient()
 ) : SyncHttpClient {
 
-    override suspend fun sync(requestJson: String, authToken: String): Result<String> = runCatching {
+    override suspend fun sync(requestJson: String, authToken: String): Result<String> =
+        post("$baseUrl/api/sync", requestJson, authToken)
+
+    override suspend fun pull(requestJson: String, authToken: String): Result<String> =
+        post("$baseUrl/api/sync/pull", requestJson, authToken)
+
+    // Kotlin/Native has no gzip codec and the CIO engine does not decode Content-Encoding,
+    // so this client asks for an identity body: the server only gzips when Accept-Encoding
+    // lists gzip, and no gzip decoding path is needed. CBOR alone already sends the
+    // payloads as structured values.
+    override suspend fun syncEncoded(
+        body: ByteArray,
+        format: SyncWireFormat,
+        authToken: String
+    ): Result<SyncWirePayload> = runCatching {
         val response = httpClient.post("$baseUrl/api/sync") {
+            contentType(ContentType.parse(format.contentType))
+            accept(ContentType.parse(format.contentType))
+            accept(ContentType.Application.Json)
+            header(HttpHeaders.AcceptEncoding, "identity")
+            bearerAuth(authToken)
+            setBody(body)
+        }
+
+        checkStatus(response)
+        SyncWirePayload(
+            body = response.body<ByteArray>(),
+            format = SyncWireFormat.fromContentType(response.headers[HttpHeaders.ContentType])
+        )
+    }
+
+    private suspend fun post(url: String, requestJson: String, authToken: String): Result<String> = runCatching {
+        val response = httpClient.post(url) {
             contentType(ContentType.Application.Json)
             bearerAuth(authToken)
             setBody(requestJson)
         }
 
+        checkStatus(response)
+        response.body<String>()
+    }
+
+    private fun checkStatus(response: HttpResponse) {
         when {
-            response.status.isSuccess() -> response.body<String>()
+            response.status.isSuccess() -> Unit
             response.status.value == 401 -> throw UnauthorizedException("Authentication failed: token may be expired")
             response.status.value == 403 -> throw ForbiddenException("Access forbidden: insufficient permissions")
             else -> throw HttpException(response.status.value, "Sync failed with status: ${response.status}")
@@ -0,0 +1,90 @@
+package com.guyghost.wakeve.analytics
+
+import java.io.ByteArrayOutputStream
+import java.io.File
+import java.io.FileOutputStream
+import java.io.IOException
+import java.io.RandomAccessFile
+import java.util.zip.GZIPOutputStream
+
+/**
+ * [AnalyticsSegmentStore] backed by files in [directory].
+ *
+ * - `tail.log`: the open segment, appended and synced on every flush
+ * - `segment-<id>-<count>.log`: sealed segments; the event count is in the
+ *   name so a cold start only lists the directory
+ * - `ack-<id>`: the acknowledgement marker, an empty file created atomically
+ *   before older markers are removed
+ *
+ * Sealing is a rename of the tail. Segments are gzip-compressed as a whole when
+ * read for upload. Only java.io is used, so the store also runs on Android
+ * versions without java.nio.file.
+ */
+class FileAnalyticsSegmentStore(private val directory: File) : AnalyticsSegmentStore {
+    private val tailFile = File(directory, AnalyticsSegmentFiles.TAIL)
+
+    init {
+        directory.mkdirs()
+    }
+
+    override val contentEncoding: String = "gzip"
+
+    override fun appendTail(bytes: ByteArray) {
+        FileOutputStream(tailFile, true).use { out ->
+            out.write(bytes)
+            out.fd.sync()
+        }
+    }
+
+    override fun readTail(): ByteArray = if (tailFile.exists()) tailFile.readBytes() else ByteArray(0)
+
+    override fun truncateTail(length: Int) {
+        RandomAccessFile(tailFile, "rw").use { it.setLength(length.toLong()) }
+    }
+
+    override fun sealTail(id: Long, eventCount: Int) {
+        val segment = File(directory, AnalyticsSegmentFiles.segmentName(id, eventCount))
+        if (!tailFile.renameTo(segment)) throw IOException("Could not seal analytics segment $id")
+    }
+
+    override fun sealedSegments(): List<AnalyticsSegmentStore.SegmentInfo> {
+        val ackMarker = readAckMarker()
+        return segmentFiles()
+            .map { (info, _) -> info }
+            .filter { it.id > ackMarker }
+            .sortedBy { it.id }
+    }
+
+    override fun readSegment(id: Long): ByteArray? {
+        val file = segmentFiles().firstOrNull { (info, _) -> info.id == id }?.second ?: return null
+        val compressed = ByteArrayOutputStream()
+        GZIPOutputStream(compressed).use { it.write(file.readBytes()) }
+        return compressed.toByteArray()
+    }
+
+    override fun readAckMarker(): Long = ackFiles().maxOfOrNull { (id, _) -> id } ?: 0L
+
+    override fun writeAckMarker(id: Long) {
+        val marker = File(directory, AnalyticsSegmentFiles.ackName(id))
+        if (!marker.exists() && !marker.createNewFile()) throw IOException("Could not write analytics ack marker $id")
+        // Best effort: markers and segments left behind are ignored because of the new marker
+        ackFiles().filter { (markerId, _) -> markerId < id }.forEach { (_, file) -> file.delete() }
+        segmentFiles().filter { (info, _) -> info.id <= id }.forEach { (_, file) -> file.delete() }
+    }
+
+    override fun clear() {
+        segmentFiles().forEach { (_, file) -> file.delete() }
+        ackFiles().forEach { (_, file) -> file.delete() }
+        tailFile.delete()
+    }
+
+    private fun segmentFiles(): List<Pair<AnalyticsSegmentStore.SegmentInfo, File>> =
+        directory.listFiles().orEmpty().mapNotNull { file ->
+            AnalyticsSegmentFiles.parseSegmentName(file.name)?.let { it to file }
+        }
+
+    private fun ackFiles(): List<Pair<Long, File>> =
+        directory.listFiles().orEmpty().mapNotNull { file ->
+            AnalyticsSegmentFiles.parseAckName(file.name)?.let { it to file }
+        }
+}
@@ -0,0 +1,49 @@
+package com.guyghost.wakeve.sync
+
+import java.io.ByteArrayOutputStream
+import java.io.IOException
+import java.util.zip.GZIPInputStream
+import java.util.zip.GZIPOutputStream
+
+/**
+ * Thrown when a gzip body inflates past the size the reader accepts.
+ */
+class GzipBodyTooLargeException(val maxBytes: Int) :
+    IOException("Decompressed body exceeds $maxBytes bytes")
+
+/**
+ * gzip Content-Encoding for /sync bodies, shared by the server and the JVM and
+ * Android clients.
+ */
+object SyncGzip {
+    /** Largest decompressed /sync body accepted by default. */
+    const val DEFAULT_MAX_DECOMPRESSED_BYTES = 16 * 1024 * 1024
+
+    fun compress(bytes: ByteArray): ByteArray {
+        val output = ByteArrayOutputStream()
+        GZIPOutputStream(output).use { it.write(bytes) }
+        return output.toByteArray()
+    }
+
+    /**
+     * Inflates [bytes], stopping as soon as the output would exceed [maxBytes]
+     * so a small compressed body cannot expand without bound.
+     *
+     * @throws GzipBodyTooLargeException when the body inflates past [maxBytes]
+     */
+    fun decompress(bytes: ByteArray, maxBytes: Int = DEFAULT_MAX_DECOMPRESSED_BYTES): ByteArray {
+        val output = ByteArrayOutputStream()
+        val buffer = ByteArray(BUFFER_SIZE)
+        GZIPInputStream(bytes.inputStream()).use { input ->
+            while (true) {
+                val read = input.read(buffer)
+                if (read < 0) break
+                if (output.size() + read > maxBytes) throw GzipBodyTooLargeException(maxBytes)
+                output.write(buffer, 0, read)
+            }
+        }
+        return output.toByteArray()
+    }
+
+    private const val BUFFER_SIZE = 8 * 1024
+}
@@ -0,0 +1,6 @@
+package com.guyghost.wakeve.analytics
+
+import java.io.File
+
+actual fun createAnalyticsSegmentStore(): AnalyticsSegmentStore =
+    FileAnalyticsSegmentStore(File(System.getProperty("user.home"), ".wakeve/analytics"))
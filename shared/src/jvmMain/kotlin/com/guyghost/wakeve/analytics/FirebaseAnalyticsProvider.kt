@@ -1,9 +1,11 @@
 package com.guyghost.wakeve.analytics
 
+import com.guyghost.wakeve.sync.createNetworkStatusDetector
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.SupervisorJob
 import kotlinx.coroutines.launch
+import kotlinx.coroutines.runBlocking
 
 /**
  * Firebase Analytics implementation for JVM (for testing purposes).
@@ -12,9 +14,11 @@ import kotlinx.coroutines.launch
  * In production, actual Firebase SDK is only available on Android and iOS.
  *
  * @param analyticsQueue Queue for offline analytics event backup
+ * @param segmentUploader Sends queued segments to the analytics backend
  */
 actual class FirebaseAnalyticsProvider actual constructor(
-    private val analyticsQueue: AnalyticsQueue
+    private val analyticsQueue: AnalyticsQueue,
+    private val segmentUploader: AnalyticsSegmentUploader
 ) : AnalyticsProvider {
 
     private val scope = CoroutineScope(SupervisorJob() + Dispatchers.IO)
@@ -23,6 +27,8 @@ actual class FirebaseAnalyticsProvider actual constructor(
     init {
         // No Firebase SDK for JVM, just logging would be used
         startSyncJob()
+        // Buffered events are written to disk before the JVM exits
+        Runtime.getRuntime().addShutdownHook(Thread { runBlocking { analyticsQueue.flush() } })
     }
 
     /**
@@ -85,12 +91,14 @@ actual class FirebaseAnalyticsProvider actual constructor(
 
     /**
      * Start periodic sync job for offline events.
-     * No-op for JVM testing.
+     * Uploads every 5 minutes when online, backing off after a failed upload.
      */
     private fun startSyncJob() {
-        scope.launch {
-            // No-op for JVM testing
-            // In production, this would sync with Firebase
-        }
+        val networkDetector = createNetworkStatusDetector()
+        AnalyticsUploader(
+            queue = analyticsQueue,
+            uploader = segmentUploader,
+            isOnline = { networkDetector.isNetworkAvailable.value }
+        ).start(scope)
     }
 }
@@ -0,0 +1,33 @@
+package com.guyghost.wakeve
+
+import app.cash.sqldelight.db.QueryResult
+import app.cash.sqldelight.db.SqlCursor
+import app.cash.sqldelight.db.SqlDriver
+import app.cash.sqldelight.db.SqlPreparedStatement
+
+/**
+ * Test driver that counts the SELECT round-trips made through [delegate],
+ * so tests can assert on the query count instead of on wall-clock time.
+ */
+class CountingSqlDriver(private val delegate: SqlDriver) : SqlDriver by delegate {
+    var queryCount = 0
+        private set
+
+    override fun <R> executeQuery(
+        identifier: Int?,
+        sql: String,
+        mapper: (SqlCursor) -> QueryResult<R>,
+        parameters: Int,
+        binders: (SqlPreparedStatement.() -> Unit)?
+    ): QueryResult<R> {
+        queryCount++
+        return delegate.executeQuery(identifier, sql, mapper, parameters, binders)
+    }
+
+    /** Runs [block] and returns the number of queries it made. */
+    fun <T> countQueries(block: () -> T): Pair<T, Int> {
+        val before = queryCount
+        val result = block()
+        return result to queryCount - before
+    }
+}
@@ -345,4 +345,31 @@ class DatabaseEventRepositoryTest {
         val updated = repository.getEvent("event-1")
         assertEquals(EventStatus.CONFIRMED, updated?.status, "Status should be CONFIRMED")
     }
+
+    @Test
+    fun testGetEventsHydratesInRequestedOrder() = runBlocking {
+        listOf("event-a", "event-b", "event-c").forEachIndexed { index, id ->
+            repository.createEvent(
+                createTestEvent(
+                    id = id,
+                    title = "Event $index",
+                    organizerId = "org-$index",
+                    proposedSlots = listOf(
+                        createTestTimeSlot(id = "slot-$id", start = "2025-12-0${index + 1}T10:00:00Z", end = "2025-12-0${index + 1}T12:00:00Z")
+                    ),
+                    deadline = "2025-11-20T18:00:00Z",
+                    status = EventStatus.DRAFT
+                )
+            )
+        }
+        repository.addParticipant("event-b", "user-1")
+
+        val events = repository.getEvents(listOf("event-c", "missing", "event-a", "event-b"))
+
+        assertEquals(listOf("event-c", "event-a", "event-b"), events.map { it.id }, "Order should follow requested IDs, skipping unknown ones")
+        events.forEach { event ->
+            assertEquals(repository.getEvent(event.id), event, "Bulk hydration should match getEvent for ${event.id}")
+        }
+        assertEquals(listOf("org-1", "user-1"), events.first { it.id == "event-b" }.participants)
+    }
 }
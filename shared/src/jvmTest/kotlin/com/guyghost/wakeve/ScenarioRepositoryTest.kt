@@ -89,7 +89,9 @@ class ScenarioRepositoryTest {
             locationType = "CITY",
             address = null,
             coordinates = null,
-            createdAt = "2026-06-01T10:00:00Z"
+            createdAt = "2026-06-01T10:00:00Z",
+            latitude = null,
+            longitude = null
         )
         db.potentialLocationQueries.insertLocation(
             id = "loc-2",
@@ -98,7 +100,9 @@ class ScenarioRepositoryTest {
             locationType = "CITY",
             address = null,
             coordinates = null,
-            createdAt = "2026-06-01T10:01:00Z"
+            createdAt = "2026-06-01T10:01:00Z",
+            latitude = null,
+            longitude = null
         )
         return event
     }
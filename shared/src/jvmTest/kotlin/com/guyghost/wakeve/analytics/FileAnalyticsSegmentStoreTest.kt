@@ -0,0 +1,68 @@
+package com.guyghost.wakeve.analytics
+
+import kotlinx.coroutines.test.runTest
+import java.io.File
+import java.nio.file.Files
+import java.util.zip.GZIPInputStream
+import kotlin.test.AfterTest
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFalse
+import kotlin.test.assertNotNull
+import kotlin.test.assertTrue
+
+/**
+ * AnalyticsQueue over the file-backed segment store: events survive a restart,
+ * segments upload gzip-compressed and acknowledgement reclaims their files.
+ */
+class FileAnalyticsSegmentStoreTest {
+
+    private val directory: File = Files.createTempDirectory("analytics-queue").toFile()
+
+    @AfterTest
+    fun tearDown() {
+        directory.deleteRecursively()
+    }
+
+    @Test
+    fun `flushed events survive a restart and upload compressed`() = runTest {
+        // Given
+        val queue = AnalyticsQueue(FileAnalyticsSegmentStore(directory), bufferCapacity = 8, segmentMaxBytes = 1024)
+        repeat(50) { queue.enqueue(AnalyticsEvent.ScreenView("screen-$it"), mapOf("index" to it)) }
+        queue.flush()
+
+        // When
+        val restarted = AnalyticsQueue(FileAnalyticsSegmentStore(directory), bufferCapacity = 8, segmentMaxBytes = 1024)
+
+        // Then
+        assertEquals(50, restarted.size)
+        val indexes = mutableListOf<String>()
+        while (true) {
+            val segment = restarted.nextSegment() ?: break
+            assertEquals("gzip", segment.contentEncoding)
+            val payload = GZIPInputStream(segment.payload.inputStream()).readBytes()
+            indexes += AnalyticsQueue.decodeSegment(payload).map { it.properties.getValue("index") }
+            restarted.acknowledge(segment)
+        }
+        assertEquals(List(50) { it.toString() }, indexes)
+    }
+
+    @Test
+    fun `acknowledged segments are reclaimed`() = runTest {
+        // Given
+        val store = FileAnalyticsSegmentStore(directory)
+        val queue = AnalyticsQueue(store, bufferCapacity = 4, segmentMaxBytes = 64)
+        repeat(8) { queue.enqueue(AnalyticsEvent.AppStart, emptyMap()) }
+        assertEquals(2, store.sealedSegments().size)
+
+        // When
+        val segment = assertNotNull(queue.nextSegment())
+        queue.acknowledge(segment)
+
+        // Then
+        assertEquals(segment.id, store.readAckMarker())
+        assertFalse(File(directory, "segment-${segment.id}-4.log").exists())
+        assertEquals(1, store.sealedSegments().size)
+        assertTrue(File(directory, "ack-${segment.id}").exists())
+    }
+}
@@ -0,0 +1,124 @@
+package com.guyghost.wakeve.budget
+
+import com.guyghost.wakeve.models.BudgetCategory
+import com.guyghost.wakeve.models.BudgetItem
+import kotlin.math.abs
+import kotlin.random.Random
+import kotlin.system.measureNanoTime
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertTrue
+
+/**
+ * Settlement cost and quality against the previous floating-point greedy.
+ */
+class SettlementEngineBenchmarkTest {
+
+    @Test
+    fun benchmarkSettle_1kParticipants100kExpenses() {
+        val random = Random(42)
+        val participants = List(1_000) { "user-$it" }
+        val items = List(100_000) { index ->
+            item(
+                name = "expense-$index",
+                cost = random.nextInt(100, 50_000) / 100.0,
+                paidBy = participants.random(random),
+                sharedBy = List(random.nextInt(2, 9)) { participants.random(random) }.distinct()
+            )
+        }
+
+        repeat(3) { SettlementEngine.settle(items); greedySettle(items) }
+
+        var balances = emptyMap<String, Long>()
+        val balancesNs = measureNanoTime { balances = SettlementEngine.calculateBalances(items) }
+        var transfers = emptyList<SettlementEngine.Transfer>()
+        val settleNs = measureNanoTime { transfers = SettlementEngine.settle(balances) }
+        var greedy = emptyList<Triple<String, String, Double>>()
+        val greedyNs = measureNanoTime { greedy = greedySettle(items) }
+
+        val remaining = balances.toMutableMap()
+        transfers.forEach {
+            remaining[it.from] = remaining.getValue(it.from) - it.amountMinor
+            remaining[it.to] = remaining.getValue(it.to) + it.amountMinor
+        }
+        val greedyRemaining = BudgetCalculator.calculateBalances(items).toMutableMap()
+        greedy.forEach { (from, to, amount) ->
+            greedyRemaining[from] = greedyRemaining.getValue(from) - amount
+            greedyRemaining[to] = greedyRemaining.getValue(to) + amount
+        }
+
+        println("\n=== Settlement Engine Benchmark (${participants.size} participants, ${items.size} expenses) ===")
+        println("Greedy (Double): ${greedyNs / 1_000_000}ms, ${greedy.size} transfers, residual ${"%.6f".format(greedyRemaining.values.sumOf { abs(it) })}")
+        println("Engine balances: ${balancesNs / 1_000_000}ms")
+        println("Engine settle: ${settleNs / 1_000_000}ms, ${transfers.size} transfers, residual ${remaining.values.sumOf { abs(it) }} cents")
+
+        assertTrue(remaining.values.all { it == 0L }, "Every balance settles to the cent")
+        assertTrue(transfers.size <= balances.count { it.value != 0L } - 1)
+    }
+
+    @Test
+    fun benchmarkTransferCount_smallGroups() {
+        val random = Random(7)
+        var engineTransfers = 0
+        var greedyTransfers = 0
+        repeat(1_000) {
+            val participants = List(random.nextInt(3, SettlementEngine.EXACT_GROUP_LIMIT)) { "user-$it" }
+            val items = List(random.nextInt(3, 20)) { index ->
+                val sharedBy = participants.shuffled(random).take(random.nextInt(1, participants.size + 1))
+                // Whole-unit shares so both sides settle the same balances
+                item(
+                    name = "expense-$index",
+                    cost = sharedBy.size * random.nextInt(1, 20) * 5.0,
+                    paidBy = participants.random(random),
+                    sharedBy = sharedBy
+                )
+            }
+            engineTransfers += SettlementEngine.settle(items).size
+            greedyTransfers += greedySettle(items).size
+        }
+
+        println("\n=== Settlement Transfer Count (1000 groups of 3-15 participants) ===")
+        println("Greedy: $greedyTransfers transfers")
+        println("Engine: $engineTransfers transfers")
+
+        assertTrue(engineTransfers <= greedyTransfers, "Exact grouping never needs more transfers")
+        assertEquals(0, SettlementEngine.settle(emptyList()).size)
+    }
+
+    /**
+     * The previous BudgetCalculator.calculateSettlements, kept as the baseline.
+     */
+    private fun greedySettle(items: List<BudgetItem>): List<Triple<String, String, Double>> {
+        val balances = BudgetCalculator.calculateBalances(items)
+        val settlements = mutableListOf<Triple<String, String, Double>>()
+        val debtors = balances.filter { it.value > 0.01 }.toMutableMap()
+        val creditors = balances.filter { it.value < -0.01 }.toMutableMap()
+        while (debtors.isNotEmpty() && creditors.isNotEmpty()) {
+            val (debtor, debtAmount) = debtors.entries.first()
+            val (creditor, creditAmount) = creditors.entries.first()
+            val settlementAmount = minOf(debtAmount, -creditAmount)
+            settlements.add(Triple(debtor, creditor, settlementAmount))
+            debtors[debtor] = debtAmount - settlementAmount
+            creditors[creditor] = creditAmount + settlementAmount
+            if (debtors[debtor]!! < 0.01) debtors.remove(debtor)
+            if (creditors[creditor]!! > -0.01) creditors.remove(creditor)
+        }
+        return settlements
+    }
+
+    private fun item(name: String, cost: Double, paidBy: String, sharedBy: List<String>) = BudgetItem(
+        id = name,
+        budgetId = "budget-1",
+        category = BudgetCategory.OTHER,
+        name = name,
+        description = "",
+        estimatedCost = cost,
+        actualCost = cost,
+        isPaid = true,
+        paidBy = paidBy,
+        sharedBy = sharedBy,
+        notes = "",
+        createdAt = "2025-12-25T10:00:00Z",
+        updatedAt = "2025-12-25T10:00:00Z"
+    )
+}
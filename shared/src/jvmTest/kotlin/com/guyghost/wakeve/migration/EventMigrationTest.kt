@@ -278,7 +278,9 @@ class EventMigrationTest {
             locationType = "CITY",
             address = "Paris, France",
             coordinates = """{"latitude": 48.8566, "longitude": 2.3522}""",
-            createdAt = now
+            createdAt = now,
+            latitude = 48.8566,
+            longitude = 2.3522
         )
 
         // ASSERT: Verify location is stored and retrievable
@@ -331,7 +333,9 @@ class EventMigrationTest {
                 locationType = "CITY",
                 address = null,
                 coordinates = null,
-                createdAt = now
+                createdAt = now,
+                latitude = null,
+                longitude = null
             )
         }
 
@@ -468,7 +472,9 @@ class EventMigrationTest {
                 locationType = "CITY",
                 address = null,
                 coordinates = null,
-                createdAt = now
+                createdAt = now,
+                latitude = null,
+                longitude = null
             )
         }
 
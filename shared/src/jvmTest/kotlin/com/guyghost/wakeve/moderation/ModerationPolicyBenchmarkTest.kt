@@ -0,0 +1,60 @@
+package com.guyghost.wakeve.moderation
+
+import kotlin.random.Random
+import kotlin.system.measureNanoTime
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertTrue
+
+/**
+ * Moderation cost on the send path with production-sized term dictionaries.
+ */
+class ModerationPolicyBenchmarkTest {
+    @Test
+    fun benchmarkEvaluate_10kTermDictionaries() {
+        val random = Random(42)
+        val hardTerms = List(5_000) { randomPhrase(random) }.toSet()
+        val reviewTerms = List(5_000) { randomPhrase(random) }.toSet()
+        val messages = List(2_000) { i ->
+            val base = "Dinner at 19:30 near the station, bring snacks and a rain jacket for the walk #$i"
+            if (i % 100 == 0) "$base ${reviewTerms.elementAt(i % reviewTerms.size)}" else base
+        }
+
+        val compileStart = System.nanoTime()
+        val policy = ModerationPolicy(hardTerms, reviewTerms)
+        val compileMs = (System.nanoTime() - compileStart) / 1_000_000
+
+        // Previous approach: one contains() per term
+        fun naiveEvaluate(text: String): ModerationStatus {
+            val normalized = text.trim().lowercase()
+            return when {
+                hardTerms.any { normalized.contains(it) } -> ModerationStatus.REJECTED
+                reviewTerms.any { normalized.contains(it) } -> ModerationStatus.PENDING_REVIEW
+                else -> ModerationStatus.APPROVED
+            }
+        }
+
+        repeat(3) { messages.forEach { policy.evaluate(it); naiveEvaluate(it) } }
+
+        var automatonStatuses = emptyList<ModerationStatus>()
+        val automatonNs = measureNanoTime { automatonStatuses = messages.map { policy.evaluate(it).status } }
+        var naiveStatuses = emptyList<ModerationStatus>()
+        val naiveNs = measureNanoTime { naiveStatuses = messages.map { naiveEvaluate(it) } }
+
+        val automatonPerSec = messages.size * 1_000_000_000.0 / automatonNs
+        val naivePerSec = messages.size * 1_000_000_000.0 / naiveNs
+
+        println("\n=== Moderation Policy Benchmark (${hardTerms.size + reviewTerms.size} terms, ${messages.size} messages) ===")
+        println("Compile: ${compileMs}ms")
+        println("Per-term contains(): ${naivePerSec.toInt()} messages/sec")
+        println("Aho-Corasick scan: ${automatonPerSec.toInt()} messages/sec")
+        println("Speedup: ${"%.1f".format(automatonPerSec / naivePerSec)}x")
+
+        assertEquals(naiveStatuses, automatonStatuses)
+        assertEquals(messages.size / 100, automatonStatuses.count { it == ModerationStatus.PENDING_REVIEW })
+        assertTrue(automatonPerSec > naivePerSec * 10, "One pass should beat 10k contains() calls by far")
+    }
+
+    private fun randomPhrase(random: Random): String =
+        List(2) { List(random.nextInt(4, 9)) { 'a' + random.nextInt(26) }.joinToString("") }.joinToString(" ")
+}
@@ -1187,6 +1187,63 @@ class NotificationServiceTest {
         assertNotNull(read.first().readAt)
     }
 
+    // ==================== 13. sendBroadcast Tests ====================
+
+    @Test
+    fun sendBroadcast_sendsOneMulticastPerPlatformAndStoresRowPerUser() = runTest {
+        seedNotificationUser("user456")
+        seedNotificationUser("user789")
+        service.registerPushToken("user123", Platform.ANDROID, "android-123").getOrThrow()
+        service.registerPushToken("user456", Platform.ANDROID, "android-456").getOrThrow()
+        service.registerPushToken("user789", Platform.IOS, "ios-789").getOrThrow()
+
+        val results = service.sendBroadcast(
+            createBroadcast("Event confirmed").copy(data = mapOf("eventId" to "evt-1")),
+            listOf("user123", "user456", "user789")
+        )
+
+        assertTrue(results.all { it.isSuccess })
+        assertEquals(1, fcmSender.multicastCount)
+        assertEquals(listOf("android-123", "android-456"), fcmSender.sentTokens.sorted())
+        assertEquals(1, apnsSender.multicastCount)
+        assertEquals(listOf("ios-789"), apnsSender.sentTokens)
+        listOf("user123", "user456", "user789").forEach { userId ->
+            val message = service.getUnreadNotifications(userId).single()
+            assertEquals("Event confirmed", message.body)
+            assertEquals("evt-1", message.data["eventId"])
+        }
+    }
+
+    @Test
+    fun sendBroadcast_skipsUsersWhoDisabledTheType() = runTest {
+        seedUser("user456")
+        preferencesRepository.setPreferences(
+            defaultNotificationPreferences("user456").copy(enabledTypes = setOf(NotificationType.MENTION))
+        )
+
+        val results = service.sendBroadcast(createBroadcast("Invite"), listOf("user123", "user456"))
+
+        assertTrue(results[0].isSuccess)
+        assertTrue(results[1].isFailure)
+        assertEquals(1, service.getUnreadNotifications("user123").size)
+        assertTrue(service.getUnreadNotifications("user456").isEmpty())
+    }
+
+    @Test
+    fun sendBroadcast_pushedIdMarksAndDeletesOnlyTheRecipientsRow() = runTest {
+        seedNotificationUser("user456")
+        service.sendBroadcast(createBroadcast("Shared"), listOf("user123", "user456"))
+        val pushedId = service.getUnreadNotifications("user123").single().data.getValue("notificationId")
+
+        service.markAsReadForUser(pushedId, "user123").getOrThrow()
+        assertTrue(service.getUnreadNotifications("user123").isEmpty())
+        assertEquals(1, service.getUnreadNotifications("user456").size)
+
+        service.deleteNotificationForUser(pushedId, "user456").getOrThrow()
+        assertTrue(service.getNotifications("user456").isEmpty())
+        assertEquals(1, service.getNotifications("user123").size)
+    }
+
     // ==================== Helper Methods ====================
 
     private fun createRequest(
@@ -1201,6 +1258,14 @@ class NotificationServiceTest {
         )
     }
 
+    private fun createBroadcast(body: String): BroadcastNotification {
+        return BroadcastNotification(
+            type = NotificationType.EVENT_INVITE,
+            title = "Test Title",
+            body = body
+        )
+    }
+
     private fun seedUser(userId: String) {
         val now = "2026-01-01T00:00:00Z"
         database.userQueries.insertUser(
@@ -1266,6 +1331,7 @@ private class RecordingFCMSender : FCMSender {
     val sentTitles = mutableListOf<String>()
     val sentBodies = mutableListOf<String>()
     var callCount = 0
+    var multicastCount = 0
     var shouldFail = false
     var failureMessage = "FCM Error"
 
@@ -1285,6 +1351,16 @@ private class RecordingFCMSender : FCMSender {
             Result.success(Unit)
         }
     }
+
+    override suspend fun sendMulticast(
+        tokens: List<String>,
+        title: String,
+        body: String,
+        data: Map<String, String>
+    ): List<Result<Unit>> {
+        multicastCount++
+        return tokens.map { sendNotification(it, title, body, data) }
+    }
 }
 
 private class RecordingAPNsSender : APNsSender {
@@ -1292,6 +1368,7 @@ private class RecordingAPNsSender : APNsSender {
     val sentTitles = mutableListOf<String>()
     val sentBodies = mutableListOf<String>()
     var callCount = 0
+    var multicastCount = 0
     var shouldFail = false
     var failureMessage = "APNs Error"
 
@@ -1311,4 +1388,14 @@ private class RecordingAPNsSender : APNsSender {
             Result.success(Unit)
         }
     }
+
+    override suspend fun sendMulticast(
+        tokens: List<String>,
+        title: String,
+        body: String,
+        data: Map<String, String>
+    ): List<Result<Unit>> {
+        multicastCount++
+        return tokens.map { sendNotification(it, title, body, data) }
+    }
 }
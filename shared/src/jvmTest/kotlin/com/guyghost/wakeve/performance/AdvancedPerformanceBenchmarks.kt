@@ -1,5 +1,10 @@
 package com.guyghost.wakeve.performance
 
+import com.guyghost.wakeve.CountingSqlDriver
+import com.guyghost.wakeve.TestDatabaseFactory
+import com.guyghost.wakeve.createFreshTestDatabase
+import com.guyghost.wakeve.database.WakeveDb
+import com.guyghost.wakeve.repository.DatabaseEventRepository
 import com.guyghost.wakeve.repository.EventRepository
 import com.guyghost.wakeve.poll.PollLogic
 import com.guyghost.wakeve.deeplink.DeepLink
@@ -38,6 +43,7 @@ import kotlinx.datetime.Instant
 import kotlin.system.measureNanoTime
 import kotlin.system.measureTimeMillis
 import kotlin.test.Test
+import kotlin.test.assertEquals
 import kotlin.test.assertTrue
 
 /**
@@ -1093,8 +1099,211 @@ class AdvancedPerformanceBenchmarks {
         )
     }
 
+    // ==================== 21. Bulk Event Hydration Benchmark ====================
+
+    @Test
+    fun benchmarkBulkEventHydration() {
+        listOf(100, 1_000, 10_000).forEach { eventCount ->
+            val driver = CountingSqlDriver(TestDatabaseFactory().createDriver())
+            val db = WakeveDb(driver)
+            seedHydrationEvents(db, eventCount)
+            val repository = DatabaseEventRepository(db)
+            val ids = db.eventQueries.selectAll().executeAsList().map { it.id }
+
+            var perEvent: List<Event> = emptyList()
+            var perEventQueries = 0
+            val perEventMs = measureNanoTime {
+                val (events, queries) = driver.countQueries { ids.mapNotNull { repository.getEvent(it) } }
+                perEvent = events
+                perEventQueries = queries
+            } / 1_000_000.0
+
+            var bulk: List<Event> = emptyList()
+            var bulkQueries = 0
+            val bulkMs = measureNanoTime {
+                val (events, queries) = driver.countQueries { repository.getEvents(ids) }
+                bulk = events
+                bulkQueries = queries
+            } / 1_000_000.0
+
+            // Events, participants, time slots and confirmed dates: one query each per chunk of 500 IDs
+            val chunks = (eventCount + 499) / 500
+            val maxBulkQueries = 4 * chunks
+
+            println("=== Bulk Event Hydration Benchmark ($eventCount events) ===")
+            println("Per-event getEvent: ${"%.2f".format(perEventMs)}ms, $perEventQueries queries")
+            println("Bulk getEvents: ${"%.2f".format(bulkMs)}ms, $bulkQueries queries")
+            println("Speedup: ${"%.1f".format(perEventMs / bulkMs.coerceAtLeast(0.001))}x")
+            println("Target: at most $maxBulkQueries queries for the bulk load")
+
+            assertEquals(perEvent, bulk, "Bulk hydration must produce the same events as getEvent")
+            // Round-trips rather than wall-clock time, which is too noisy on a shared CI runner
+            assertTrue(
+                bulkQueries <= maxBulkQueries,
+                "Bulk hydration made $bulkQueries queries for $eventCount events, expected at most $maxBulkQueries"
+            )
+            assertTrue(
+                perEventQueries >= eventCount,
+                "Per-event hydration made $perEventQueries queries for $eventCount events"
+            )
+        }
+    }
+
+    // ==================== 22. Full-Text Event Search Benchmark ====================
+
+    @Test
+    fun benchmarkFullTextEventSearch_100kEvents() {
+        val eventCount = 100_000
+        val iterations = 200
+        val db = createFreshTestDatabase()
+        val keywords = listOf("birthday", "meeting", "party", "wedding", "conference", "dinner", "lunch")
+        val cities = listOf("Paris", "London", "Lyon", "Tokyo", "Sydney")
+        val now = "2025-11-12T10:00:00Z"
+
+        db.transaction {
+            repeat(eventCount) { index ->
+                val eventId = "fts-event-$index"
+                val keyword = keywords[index % keywords.size]
+                db.eventQueries.insertEvent(
+                    id = eventId,
+                    organizerId = "organizer-${index % 500}",
+                    title = "$keyword ${index * 7}",
+                    description = "Join us for a $keyword gathering number $index",
+                    status = EventStatus.POLLING.name,
+                    deadline = "2025-12-01T18:00:00Z",
+                    createdAt = now,
+                    updatedAt = now,
+                    version = 1,
+                    eventType = EventType.entries[index % EventType.entries.size].name,
+                    eventTypeCustom = null,
+                    minParticipants = null,
+                    maxParticipants = null,
+                    expectedParticipants = null,
+                    isSample = 0
+                )
+                if (index % 10 == 0) {
+                    db.potentialLocationQueries.insertLocation(
+                        id = "fts-location-$index",
+                        eventId = eventId,
+                        name = cities[index % cities.size],
+                        locationType = "CITY",
+                        address = null,
+                        coordinates = null,
+                        createdAt = now,
+                        latitude = null,
+                        longitude = null
+                    )
+                }
+            }
+        }
+
+        val repository = DatabaseEventRepository(db)
+        val searches = listOf<Pair<String?, String?>>(
+            "birthday" to null,
+            "wedd" to null,
+            "dinner 7" to null,
+            "conference" to "paris",
+            null to "lyon"
+        )
+
+        val times = mutableListOf<Double>()
+        repeat(iterations) { index ->
+            val (query, location) = searches[index % searches.size]
+            val time = measureNanoTime {
+                val results = repository.searchEvents(
+                    query = query,
+                    category = null,
+                    location = location,
+                    dateFrom = null,
+                    dateTo = null,
+                    status = null,
+                    sortBy = "RELEVANCE",
+                    offset = 0,
+                    limit = 20
+                )
+                assertTrue(results.events.size <= 20)
+            } / 1_000_000.0
+            times.add(time)
+        }
+
+        val sorted = times.sorted()
+        val p50 = sorted[sorted.size / 2]
+        val p99 = sorted[(sorted.size * 99) / 100]
+
+        println("=== Full-Text Event Search Benchmark ($eventCount events) ===")
+        println("Iterations: $iterations")
+        println("p50: ${"%.2f".format(p50)}ms")
+        println("p99: ${"%.2f".format(p99)}ms")
+        println("Target: p99 < 250ms")
+
+        assertTrue(
+            p99 < 250,
+            "Search p99 ${p99}ms exceeds target of 250ms"
+        )
+    }
+
     // ==================== Helper Methods ====================
 
+    private fun seedHydrationEvents(db: WakeveDb, eventCount: Int) {
+        val now = "2025-11-12T10:00:00Z"
+        db.transaction {
+            repeat(eventCount) { index ->
+                val eventId = "hydration-event-$index"
+                db.eventQueries.insertEvent(
+                    id = eventId,
+                    organizerId = "organizer-${index % 50}",
+                    title = "Hydration Event $index",
+                    description = "Event for bulk hydration benchmark",
+                    status = EventStatus.POLLING.name,
+                    deadline = "2025-12-01T18:00:00Z",
+                    createdAt = now,
+                    updatedAt = now,
+                    version = 1,
+                    eventType = EventType.OTHER.name,
+                    eventTypeCustom = null,
+                    minParticipants = null,
+                    maxParticipants = null,
+                    expectedParticipants = null,
+                    isSample = 0
+                )
+                repeat(5) { participantIndex ->
+                    db.participantQueries.insertParticipant(
+                        id = "part-$index-$participantIndex",
+                        eventId = eventId,
+                        userId = "user-$participantIndex",
+                        role = if (participantIndex == 0) "ORGANIZER" else "PARTICIPANT",
+                        hasValidatedDate = 0,
+                        joinedAt = now,
+                        updatedAt = now
+                    )
+                }
+                repeat(3) { slotIndex ->
+                    db.timeSlotQueries.insertTimeSlot(
+                        id = "slot-$index-$slotIndex",
+                        eventId = eventId,
+                        startTime = "2025-12-${10 + slotIndex}T10:00:00Z",
+                        endTime = "2025-12-${10 + slotIndex}T12:00:00Z",
+                        timezone = "UTC",
+                        proposedByParticipantId = null,
+                        createdAt = now,
+                        updatedAt = now,
+                        timeOfDay = TimeOfDay.SPECIFIC.name
+                    )
+                }
+                if (index % 4 == 0) {
+                    db.confirmedDateQueries.insertConfirmedDate(
+                        id = "confirmed-$index",
+                        eventId = eventId,
+                        timeslotId = "slot-$index-0",
+                        confirmedByOrganizerId = "organizer-${index % 50}",
+                        confirmedAt = now,
+                        updatedAt = now
+                    )
+                }
+            }
+        }
+    }
+
     private fun createMockPreferencesRepository(): NotificationPreferencesRepositoryInterface {
         return object : NotificationPreferencesRepositoryInterface {
             private val preferences = mutableMapOf<String, NotificationPreferences>()
@@ -0,0 +1,220 @@
+package com.guyghost.wakeve.repository
+
+import com.guyghost.wakeve.TestDatabaseFactory
+import com.guyghost.wakeve.createFreshTestDatabase
+import com.guyghost.wakeve.database.WakeveDb
+import com.guyghost.wakeve.models.Coordinates
+import com.guyghost.wakeve.models.EventStatus
+import com.guyghost.wakeve.models.EventType
+import com.guyghost.wakeve.models.LocationType
+import com.guyghost.wakeve.models.PotentialLocation
+import com.guyghost.wakeve.test.createTestEvent
+import kotlinx.coroutines.runBlocking
+import kotlin.test.BeforeTest
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFalse
+import kotlin.test.assertTrue
+
+class DatabaseEventRepositorySearchTest {
+
+    private lateinit var db: WakeveDb
+    private lateinit var repository: DatabaseEventRepository
+
+    @BeforeTest
+    fun setup() {
+        db = createFreshTestDatabase()
+        repository = DatabaseEventRepository(db)
+    }
+
+    @Test
+    fun `search matches title and description prefixes through the index`() = runBlocking {
+        createEvent("event-1", "Birthday party", "Cake for everyone")
+        createEvent("event-2", "Team offsite", "Birthdays of the quarter")
+        createEvent("event-3", "Quarterly review", "Numbers")
+
+        val results = search(query = "birth")
+
+        assertEquals(2, results.totalCount)
+        assertEquals(listOf("event-1", "event-2"), results.events.map { it.id }, "Title hits rank before description hits")
+    }
+
+    @Test
+    fun `query without any searchable character matches nothing`() = runBlocking {
+        createEvent("event-1", "Birthday party", "Cake for everyone")
+        createEvent("event-2", "Team offsite", "Planning")
+
+        val results = search(query = "!!!")
+
+        assertEquals(0, results.totalCount)
+        assertTrue(results.events.isEmpty())
+        assertEquals(2, search(query = "  ").totalCount, "A blank query still lists every event")
+    }
+
+    @Test
+    fun `location filter is applied in SQL so counts and paging stay correct`() = runBlocking {
+        repeat(5) { index ->
+            createEvent("paris-$index", "Dinner $index", "Evening dinner")
+            addLocation("paris-$index", "Paris")
+        }
+        repeat(5) { index ->
+            createEvent("lyon-$index", "Dinner lyon $index", "Evening dinner")
+            addLocation("lyon-$index", "Lyon")
+        }
+
+        val firstPage = search(query = "dinner", location = "paris", limit = 3)
+        val secondPage = search(query = "dinner", location = "paris", offset = 3, limit = 3)
+
+        assertEquals(5, firstPage.totalCount)
+        assertEquals(3, firstPage.events.size)
+        assertTrue(firstPage.hasMore)
+        assertEquals(2, secondPage.events.size)
+        assertFalse(secondPage.hasMore)
+        assertTrue((firstPage.events + secondPage.events).all { it.locationName == "Paris" })
+    }
+
+    @Test
+    fun `index follows event updates and deletes`() = runBlocking {
+        createEvent("event-1", "Picnic", "Sunny afternoon")
+        val event = repository.getEvent("event-1")!!
+
+        repository.updateEvent(event.copy(title = "Barbecue"))
+        assertEquals(0, search(query = "picnic").totalCount)
+        assertEquals(1, search(query = "barbecue").totalCount)
+
+        repository.deleteEvent("event-1")
+        assertEquals(0, search(query = "barbecue").totalCount)
+    }
+
+    @Test
+    fun `index survives events being renumbered`() = runBlocking {
+        val driver = TestDatabaseFactory().createDriver()
+        db = WakeveDb(driver)
+        repository = DatabaseEventRepository(db)
+        createEvent("event-1", "Picnic", "Sunny afternoon")
+        createEvent("event-2", "Concert", "Evening music")
+
+        // What VACUUM may do to a table without an INTEGER PRIMARY KEY
+        driver.execute(null, "UPDATE event SET rowid = rowid + 1000", 0)
+        repository.updateEvent(repository.getEvent("event-2")!!.copy(title = "Opera"))
+
+        assertEquals(listOf("event-1"), search(query = "picnic").events.map { it.id })
+        assertEquals(listOf("event-2"), search(query = "opera").events.map { it.id })
+        assertEquals(0, search(query = "concert").totalCount)
+    }
+
+    @Test
+    fun `search input cannot inject FTS operators`() = runBlocking {
+        createEvent("event-1", "Garden party", "Bring snacks")
+
+        val results = search(query = "\"garden\" OR title:* NEAR(")
+
+        assertEquals(0, results.totalCount, "Operators are treated as plain prefix terms")
+        assertEquals(listOf("garden", "or", "title", "near"), EventSearchMatch.tokenize("\"garden\" OR title:* NEAR("))
+    }
+
+    @Test
+    fun `nearby search returns events inside the radius closest first`() = runBlocking {
+        createEvent("event-louvre", "Louvre visit", "Museum")
+        addLocation("event-louvre", "Louvre", latitude = 48.8606, longitude = 2.3376)
+        createEvent("event-versailles", "Versailles day", "Castle")
+        addLocation("event-versailles", "Versailles", latitude = 48.8049, longitude = 2.1204)
+        createEvent("event-lyon", "Lyon weekend", "Food")
+        addLocation("event-lyon", "Lyon", latitude = 45.7640, longitude = 4.8357)
+        createEvent("event-online", "Online quiz", "Remote")
+        addLocation("event-online", "Online")
+
+        val results = repository.getNearbyEvents(lat = 48.8566, lon = 2.3522, radiusKm = 30.0, limit = 10)
+
+        assertEquals(listOf("event-louvre", "event-versailles"), results.events.map { it.event.id })
+        assertTrue(results.events.zipWithNext().all { (a, b) -> a.distanceKm <= b.distanceKm })
+        assertEquals(1, repository.getNearbyEvents(lat = 48.8566, lon = 2.3522, radiusKm = 30.0, limit = 1).events.size)
+    }
+
+    @Test
+    fun `nearby search crosses the antimeridian`() = runBlocking {
+        createEvent("event-fiji", "Suva market", "Fiji")
+        addLocation("event-fiji", "Suva", latitude = -18.1416, longitude = 178.4419)
+        createEvent("event-wallis", "Wallis lagoon", "Wallis")
+        addLocation("event-wallis", "Futuna", latitude = -14.2938, longitude = -178.1165)
+        createEvent("event-samoa", "Apia", "Samoa")
+        addLocation("event-samoa", "Apia", latitude = -13.8333, longitude = -171.7500)
+
+        // Between Fiji and Futuna, 179.9°E: both are within 600 km, Apia is not
+        val small = repository.getNearbyEvents(lat = -16.0, lon = 179.9, radiusKm = 600.0, limit = 10)
+        assertEquals(setOf("event-fiji", "event-wallis"), small.events.map { it.event.id }.toSet())
+
+        // Radius too large for the cell lookup: the band query splits its longitude range
+        val large = repository.getNearbyEvents(lat = -16.0, lon = 179.9, radiusKm = 2_500.0, limit = 10)
+        assertEquals(setOf("event-fiji", "event-wallis", "event-samoa"), large.events.map { it.event.id }.toSet())
+    }
+
+    @Test
+    fun `locations added through the repository are found nearby`() = runBlocking {
+        repository.createEvent(createTestEvent(id = "event-draft", title = "Draft picnic", status = EventStatus.DRAFT))
+        val locations = DatabasePotentialLocationRepository(db, repository)
+
+        locations.addLocation(
+            "event-draft",
+            PotentialLocation(
+                id = "loc-draft",
+                eventId = "event-draft",
+                name = "Buttes-Chaumont",
+                locationType = LocationType.SPECIFIC_VENUE,
+                coordinates = Coordinates(48.8809, 2.3828),
+                createdAt = "2025-11-12T10:00:00Z"
+            )
+        ).getOrThrow()
+
+        val results = repository.getNearbyEvents(lat = 48.8566, lon = 2.3522, radiusKm = 10.0, limit = 10)
+        assertEquals(listOf("event-draft"), results.events.map { it.event.id })
+        assertEquals(Coordinates(48.8809, 2.3828), locations.getLocationById("loc-draft")?.coordinates)
+        assertEquals(
+            GeoGrid.cellOf(48.8809, 2.3828),
+            db.potentialLocationQueries.selectById("loc-draft").executeAsOne().geoCell
+        )
+    }
+
+    private suspend fun createEvent(id: String, title: String, description: String) {
+        repository.createEvent(
+            createTestEvent(
+                id = id,
+                title = title,
+                description = description,
+                status = EventStatus.POLLING,
+                eventType = EventType.PARTY
+            )
+        )
+    }
+
+    private fun addLocation(eventId: String, name: String, latitude: Double? = null, longitude: Double? = null) {
+        db.potentialLocationQueries.insertLocation(
+            id = "loc-$eventId",
+            eventId = eventId,
+            name = name,
+            locationType = "CITY",
+            address = null,
+            coordinates = if (latitude != null && longitude != null) {
+                """{"latitude":$latitude,"longitude":$longitude}"""
+            } else {
+                null
+            },
+            createdAt = "2025-11-12T10:00:00Z",
+            latitude = latitude,
+            longitude = longitude
+        )
+    }
+
+    private fun search(query: String?, location: String? = null, offset: Int = 0, limit: Int = 20) =
+        repository.searchEvents(
+            query = query,
+            category = null,
+            location = location,
+            dateFrom = null,
+            dateTo = null,
+            status = null,
+            sortBy = "RELEVANCE",
+            offset = offset,
+            limit = limit
+        )
+}
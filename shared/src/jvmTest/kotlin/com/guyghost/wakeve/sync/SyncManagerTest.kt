@@ -3,8 +3,14 @@ package com.guyghost.wakeve.sync
 import com.guyghost.wakeve.repository.DatabaseEventRepository
 import com.guyghost.wakeve.repository.UserRepository
 import com.guyghost.wakeve.createFreshTestDatabase
+import com.guyghost.wakeve.models.SyncChange
+import com.guyghost.wakeve.models.SyncEventData
 import com.guyghost.wakeve.models.SyncOperation
+import com.guyghost.wakeve.models.SyncParticipantData
+import com.guyghost.wakeve.models.SyncPullRequest
+import com.guyghost.wakeve.models.SyncPullResponse
 import com.guyghost.wakeve.models.SyncResponse
+import com.guyghost.wakeve.models.SyncTableVersion
 import kotlinx.coroutines.flow.MutableStateFlow
 import kotlinx.coroutines.flow.StateFlow
 import kotlinx.coroutines.runBlocking
@@ -12,6 +18,7 @@ import kotlin.test.BeforeTest
 import kotlin.test.Test
 import kotlin.test.assertEquals
 import kotlin.test.assertFalse
+import kotlin.test.assertNull
 import kotlin.test.assertTrue
 
 /**
@@ -54,6 +61,54 @@ class FailingSyncHttpClient(
     fun getCallCount(): Int = callCount
 }
 
+/**
+ * Test HTTP client that serves delta pull pages and records pull requests
+ */
+class PullingSyncHttpClient(
+    private val pages: List<SyncPullResponse>
+) : SyncHttpClient {
+    val pullRequests = mutableListOf<SyncPullRequest>()
+
+    override suspend fun sync(requestJson: String, authToken: String): Result<String> =
+        Result.success(
+            kotlinx.serialization.json.Json.encodeToString(
+                SyncResponse.serializer(),
+                SyncResponse(success = true, appliedChanges = 0, serverTimestamp = "2025-11-19T12:00:00Z")
+            )
+        )
+
+    override suspend fun pull(requestJson: String, authToken: String): Result<String> {
+        pullRequests += kotlinx.serialization.json.Json.decodeFromString(SyncPullRequest.serializer(), requestJson)
+        val page = pages.getOrElse(pullRequests.size - 1) {
+            SyncPullResponse(success = true, versions = pullRequests.last().versions, serverTimestamp = "2025-11-19T12:00:00Z")
+        }
+        return Result.success(kotlinx.serialization.json.Json.encodeToString(SyncPullResponse.serializer(), page))
+    }
+}
+
+/**
+ * Test HTTP client whose binary endpoint answers with a fixed status, recording which format was used
+ */
+class BinaryRejectingSyncHttpClient(private val binaryStatusCode: Int) : SyncHttpClient {
+    var binaryCalls = 0
+    var jsonCalls = 0
+
+    override suspend fun sync(requestJson: String, authToken: String): Result<String> {
+        jsonCalls++
+        return Result.success(
+            kotlinx.serialization.json.Json.encodeToString(
+                SyncResponse.serializer(),
+                SyncResponse(success = true, appliedChanges = 1, serverTimestamp = "2025-11-19T12:00:00Z")
+            )
+        )
+    }
+
+    override suspend fun syncEncoded(body: ByteArray, format: SyncWireFormat, authToken: String): Result<SyncWirePayload> {
+        binaryCalls++
+        return Result.failure(HttpException(binaryStatusCode, "Sync failed with status: $binaryStatusCode"))
+    }
+}
+
 private class RecordingPendingSideEffectReplayer(
     private var pending: Boolean = true,
     private val failure: Exception? = null
@@ -463,4 +518,407 @@ class SyncManagerTest {
         // The sync status should eventually be Idle after successful retry
         assertEquals(SyncStatus.Idle, retrySyncManager.syncStatus.value)
     }
+
+    @Test
+    fun testUnsupportedMediaTypeFallsBackToJson() = runBlocking {
+        val client = BinaryRejectingSyncHttpClient(415)
+        val manager = binaryFallbackSyncManager(client)
+
+        assertTrue(manager.triggerSync().isSuccess)
+
+        // Binary mode is off for good after the first refusal
+        assertEquals(1, client.binaryCalls)
+        assertTrue(client.jsonCalls >= 1)
+    }
+
+    @Test
+    fun testBadRequestDoesNotDisableBinaryWireFormat() = runBlocking {
+        val client = BinaryRejectingSyncHttpClient(400)
+        val manager = binaryFallbackSyncManager(client)
+
+        assertTrue(manager.triggerSync().isFailure)
+
+        // Every attempt stays on CBOR; a 400 says nothing about CBOR support
+        assertEquals(0, client.jsonCalls)
+        assertTrue(client.binaryCalls >= 2)
+    }
+
+    private suspend fun binaryFallbackSyncManager(client: SyncHttpClient): SyncManager {
+        val detector = TestNetworkStatusDetector().apply { setNetworkAvailable(false) }
+        val manager = SyncManager(
+            database = database,
+            eventRepository = DatabaseEventRepository(database),
+            userRepository = userRepository,
+            networkDetector = detector,
+            httpClient = client,
+            authTokenProvider = { "test-token" },
+            maxRetries = 1,
+            baseRetryDelayMs = 1L
+        )
+        manager.recordLocalChange(
+            table = "events",
+            operation = SyncOperation.CREATE,
+            recordId = "binary-event",
+            data = """{"id":"binary-event","title":"Binary"}""",
+            userId = "user-1"
+        )
+        detector.setNetworkAvailable(true)
+        return manager
+    }
+
+    @Test
+    fun testPendingChangesShipRecordedDelta() = runBlocking {
+        networkDetector.setNetworkAvailable(false)
+        val delta = """{"title":"Renamed"}"""
+
+        syncManager.recordLocalChange(
+            table = "events",
+            operation = SyncOperation.UPDATE,
+            recordId = "missing-locally",
+            data = delta,
+            userId = "user-1"
+        )
+
+        // The delta is sent as recorded, without re-reading the event
+        val pending = syncManager.getPendingChangesForSync()
+        assertEquals(1, pending.size)
+        assertEquals(delta, pending.single().data)
+    }
+
+    @Test
+    fun testDeltaPullAppliesPagesAndPersistsVersionVector() = runBlocking {
+        val json = kotlinx.serialization.json.Json
+        val eventsVersion = SyncTableVersion(seq = 7)
+        val participantsVersion = SyncTableVersion(seq = 8)
+        val pullClient = PullingSyncHttpClient(
+            listOf(
+                SyncPullResponse(
+                    success = true,
+                    changes = listOf(
+                        // Participant listed first: the manager still applies its event first
+                        SyncChange(
+                            id = "pull_participants_part_remote-event_user-2",
+                            table = "participants",
+                            operation = SyncOperation.UPDATE.name,
+                            recordId = "part_remote-event_user-2",
+                            data = json.encodeToString(
+                                SyncParticipantData.serializer(),
+                                SyncParticipantData(
+                                    eventId = "remote-event",
+                                    userId = "user-2",
+                                    id = "part_remote-event_user-2",
+                                    role = "PARTICIPANT",
+                                    updatedAt = "2025-11-19T11:05:00Z"
+                                )
+                            ),
+                            timestamp = "2025-11-19T11:05:00Z",
+                            userId = "user-2",
+                            seq = participantsVersion.seq
+                        ),
+                        SyncChange(
+                            id = "pull_events_remote-event",
+                            table = "events",
+                            operation = SyncOperation.UPDATE.name,
+                            recordId = "remote-event",
+                            data = json.encodeToString(
+                                SyncEventData.serializer(),
+                                SyncEventData(
+                                    id = "remote-event",
+                                    title = "Created on another device",
+                                    description = "Pulled",
+                                    organizerId = "user-1",
+                                    deadline = "2025-12-01T00:00:00Z",
+                                    status = "POLLING",
+                                    updatedAt = "2025-11-19T11:00:00Z"
+                                )
+                            ),
+                            timestamp = "2025-11-19T11:00:00Z",
+                            userId = "user-1",
+                            seq = eventsVersion.seq
+                        )
+                    ),
+                    versions = mapOf("events" to eventsVersion, "participants" to participantsVersion),
+                    hasMore = true,
+                    serverTimestamp = "2025-11-19T12:00:00Z"
+                )
+            )
+        )
+        val pullSyncManager = SyncManager(
+            database = database,
+            eventRepository = DatabaseEventRepository(database),
+            userRepository = userRepository,
+            networkDetector = networkDetector,
+            httpClient = pullClient,
+            authTokenProvider = { "test-token" }
+        )
+
+        assertTrue(pullSyncManager.triggerSync().isSuccess)
+
+        // hasMore triggered a second page, which resumed from the first page's vector
+        assertEquals(2, pullClient.pullRequests.size)
+        assertTrue(pullClient.pullRequests[0].versions.isEmpty())
+        assertEquals(eventsVersion, pullClient.pullRequests[1].versions["events"])
+
+        val event = DatabaseEventRepository(database).getEvent("remote-event")
+        assertEquals("Created on another device", event?.title)
+        assertEquals(listOf("user-2"), event?.participants)
+
+        // The vector is persisted: a fresh manager (app restart) resumes from it
+        val restarted = SyncManager(
+            database = database,
+            eventRepository = DatabaseEventRepository(database),
+            userRepository = userRepository,
+            networkDetector = networkDetector,
+            httpClient = pullClient,
+            authTokenProvider = { "test-token" }
+        )
+        assertEquals(
+            mapOf("events" to eventsVersion, "participants" to participantsVersion),
+            restarted.getVersionVector()
+        )
+    }
+
+    @Test
+    fun testParticipantWithoutPulledEventHoldsCursorBack() = runBlocking {
+        val json = kotlinx.serialization.json.Json
+        fun participant(id: String, eventId: String, seq: Long) = SyncChange(
+            id = "pull_participants_$id",
+            table = "participants",
+            operation = SyncOperation.UPDATE.name,
+            recordId = id,
+            data = json.encodeToString(
+                SyncParticipantData.serializer(),
+                SyncParticipantData(eventId = eventId, userId = "user-2", id = id, role = "PARTICIPANT")
+            ),
+            timestamp = "2025-11-19T11:05:00Z",
+            userId = "user-2",
+            seq = seq
+        )
+        fun event(id: String, seq: Long) = SyncChange(
+            id = "pull_events_$id",
+            table = "events",
+            operation = SyncOperation.UPDATE.name,
+            recordId = id,
+            data = json.encodeToString(
+                SyncEventData.serializer(),
+                SyncEventData(
+                    id = id,
+                    title = "Pulled $id",
+                    description = "Pulled",
+                    organizerId = "user-1",
+                    deadline = "2025-12-01T00:00:00Z",
+                    status = "POLLING"
+                )
+            ),
+            timestamp = "2025-11-19T11:00:00Z",
+            userId = "user-1",
+            seq = seq
+        )
+        val pullClient = PullingSyncHttpClient(
+            listOf(
+                // The events page is full and stops before late-event
+                SyncPullResponse(
+                    success = true,
+                    changes = listOf(
+                        event("early-event", 1),
+                        participant("part-early", "early-event", 2),
+                        participant("part-late", "late-event", 4),
+                        participant("part-early-2", "early-event", 5)
+                    ),
+                    versions = mapOf("events" to SyncTableVersion(1), "participants" to SyncTableVersion(5)),
+                    hasMore = true,
+                    tablesWithMore = listOf("events"),
+                    serverTimestamp = "2025-11-19T12:00:00Z"
+                ),
+                SyncPullResponse(
+                    success = true,
+                    changes = listOf(event("late-event", 3), participant("part-late", "late-event", 4)),
+                    versions = mapOf("events" to SyncTableVersion(3), "participants" to SyncTableVersion(4)),
+                    serverTimestamp = "2025-11-19T12:00:00Z"
+                )
+            )
+        )
+        val pullSyncManager = SyncManager(
+            database = database,
+            eventRepository = DatabaseEventRepository(database),
+            userRepository = userRepository,
+            networkDetector = networkDetector,
+            httpClient = pullClient,
+            authTokenProvider = { "test-token" },
+            pullPageSize = 1
+        )
+
+        assertTrue(pullSyncManager.triggerSync().isSuccess)
+
+        // The second page resumed just before the skipped membership
+        assertEquals(SyncTableVersion(2), pullClient.pullRequests[1].versions["participants"])
+        assertEquals(listOf("user-2"), DatabaseEventRepository(database).getEvent("late-event")?.participants)
+        assertEquals(SyncTableVersion(4), pullSyncManager.getVersionVector()["participants"])
+    }
+
+    @Test
+    fun testPulledDeletesRemoveLocalRows() = runBlocking {
+        listOf("kept-event", "gone-event").forEach { id ->
+            database.eventQueries.insertRemoteEventIfAbsent(
+                id = id,
+                organizerId = "user-1",
+                title = "Pulled $id",
+                description = "Pulled",
+                status = "POLLING",
+                deadline = "2025-12-01T00:00:00Z",
+                updatedAt = "2025-11-19T11:00:00Z"
+            )
+            database.participantQueries.insertRemoteParticipantIfAbsent(
+                id = "part_${id}_user-2",
+                eventId = id,
+                userId = "user-2",
+                role = "PARTICIPANT",
+                hasValidatedDate = 0,
+                updatedAt = "2025-11-19T11:00:00Z"
+            )
+        }
+        fun tombstone(table: String, recordId: String, seq: Long) = SyncChange(
+            id = "pull_${table}_${recordId}_delete",
+            table = table,
+            operation = SyncOperation.DELETE.name,
+            recordId = recordId,
+            data = "{}",
+            timestamp = "2025-11-19T12:00:00Z",
+            userId = "user-1",
+            seq = seq
+        )
+        val pullClient = PullingSyncHttpClient(
+            listOf(
+                SyncPullResponse(
+                    success = true,
+                    changes = listOf(tombstone("events", "gone-event", 9), tombstone("participants", "part_kept-event_user-2", 10)),
+                    versions = mapOf("events" to SyncTableVersion(9), "participants" to SyncTableVersion(10)),
+                    serverTimestamp = "2025-11-19T12:00:00Z"
+                )
+            )
+        )
+        val pullSyncManager = SyncManager(
+            database = database,
+            eventRepository = DatabaseEventRepository(database),
+            userRepository = userRepository,
+            networkDetector = networkDetector,
+            httpClient = pullClient,
+            authTokenProvider = { "test-token" }
+        )
+
+        assertTrue(pullSyncManager.triggerSync().isSuccess)
+
+        assertNull(database.eventQueries.selectById("gone-event").executeAsOneOrNull())
+        assertTrue(database.participantQueries.selectByEventId("gone-event").executeAsList().isEmpty())
+        assertEquals(emptyList<String>(), DatabaseEventRepository(database).getEvent("kept-event")?.participants)
+        assertEquals(SyncTableVersion(10), pullSyncManager.getVersionVector()["participants"])
+        // Applying a pulled delete records nothing to push back
+        assertTrue(pullSyncManager.getPendingChangesForSync().isEmpty())
+    }
+
+    @Test
+    fun testRepeatedEditsToSameRecordAreCoalesced() = runBlocking {
+        networkDetector.setNetworkAvailable(false)
+
+        syncManager.recordLocalChange("events", SyncOperation.CREATE, "draft-1", """{"id":"draft-1","title":"A"}""", "user-1")
+        syncManager.recordLocalChange("events", SyncOperation.UPDATE, "draft-1", """{"title":"B"}""", "user-1")
+        syncManager.recordLocalChange("events", SyncOperation.UPDATE, "draft-1", """{"description":"Details"}""", "user-1")
+        syncManager.recordLocalChange("events", SyncOperation.UPDATE, "other", """{"title":"C"}""", "user-1")
+
+        val pending = syncManager.getPendingChangesForSync()
+        assertEquals(2, pending.size)
+        val draft = pending.single { it.recordId == "draft-1" }
+        assertEquals(SyncOperation.CREATE.name, draft.operation)
+        assertEquals("""{"id":"draft-1","title":"B","description":"Details"}""", draft.data)
+
+        val stats = syncManager.getSyncMetrics()
+        assertEquals(2, stats.queueDepth)
+        assertEquals(4, stats.recordedChanges)
+        assertEquals(2, stats.coalescedChanges)
+        assertEquals(0.5, stats.coalescingRatio)
+    }
+
+    @Test
+    fun testCreateThenDeleteNeverReachesServer() = runBlocking {
+        networkDetector.setNetworkAvailable(false)
+
+        syncManager.recordLocalChange("events", SyncOperation.CREATE, "draft-1", """{"id":"draft-1"}""", "user-1")
+        syncManager.recordLocalChange("events", SyncOperation.UPDATE, "draft-1", """{"title":"B"}""", "user-1")
+        syncManager.recordLocalChange("events", SyncOperation.DELETE, "draft-1", """{"id":"draft-1"}""", "user-1")
+
+        assertTrue(syncManager.getPendingChangesForSync().isEmpty())
+        assertEquals(0, syncManager.getSyncMetrics().queueDepth)
+    }
+
+    @Test
+    fun testCancelledCreateDropsDependentChanges() = runBlocking {
+        networkDetector.setNetworkAvailable(false)
+
+        syncManager.recordLocalChange("events", SyncOperation.CREATE, "draft-1", """{"id":"draft-1"}""", "user-1")
+        syncManager.recordLocalChange("participants", SyncOperation.CREATE, "part-1", """{"eventId":"draft-1","userId":"user-2"}""", "user-1")
+        syncManager.recordLocalChange("votes", SyncOperation.CREATE, "vote_slot-1_user-2", """{"eventId":"draft-1","participantId":"user-2","slotId":"slot-1","preference":"YES"}""", "user-2")
+        syncManager.recordLocalChange("participants", SyncOperation.CREATE, "part-2", """{"eventId":"other","userId":"user-2"}""", "user-1")
+        syncManager.recordLocalChange("votes", SyncOperation.CREATE, "vote_slot-2_user-2", """{"eventId":"other","participantId":"user-2","slotId":"slot-2","preference":"NO"}""", "user-2")
+
+        // The participant never reached the server, so neither may its vote
+        syncManager.recordLocalChange("participants", SyncOperation.DELETE, "part-2", """{"eventId":"other","userId":"user-2"}""", "user-1")
+        assertEquals(setOf("draft-1", "part-1", "vote_slot-1_user-2"), syncManager.getPendingChangesForSync().map { it.recordId }.toSet())
+
+        syncManager.recordLocalChange("events", SyncOperation.DELETE, "draft-1", """{"id":"draft-1"}""", "user-1")
+        assertTrue(syncManager.getPendingChangesForSync().isEmpty())
+        assertEquals(0, syncManager.getSyncMetrics().queueDepth)
+    }
+
+    @Test
+    fun testBurstOfChangesIsSentInOneDebouncedSync() = runBlocking {
+        val countingClient = FailingSyncHttpClient(listOf(
+            Result.success(SyncResponse(success = true, appliedChanges = 5, serverTimestamp = "2025-11-19T12:00:00Z"))
+        ))
+        val debouncedSyncManager = SyncManager(
+            database = database,
+            eventRepository = DatabaseEventRepository(database),
+            userRepository = userRepository,
+            networkDetector = networkDetector,
+            httpClient = countingClient,
+            authTokenProvider = { "test-token" },
+            syncDebounceMs = 100L,
+            maxCoalescedChanges = 50
+        )
+
+        repeat(5) { i ->
+            debouncedSyncManager.recordLocalChange("events", SyncOperation.UPDATE, "event-$i", """{"title":"T$i"}""", "user-1")
+        }
+        assertEquals(0, countingClient.getCallCount(), "No sync before the window closes")
+
+        kotlinx.coroutines.delay(500L)
+
+        assertEquals(1, countingClient.getCallCount())
+        assertFalse(debouncedSyncManager.hasPendingChanges())
+        debouncedSyncManager.dispose()
+    }
+
+    @Test
+    fun testSchedulerFlushesEarlyWhenBatchIsFull() = runBlocking {
+        val countingClient = FailingSyncHttpClient(listOf(
+            Result.success(SyncResponse(success = true, appliedChanges = 3, serverTimestamp = "2025-11-19T12:00:00Z"))
+        ))
+        val debouncedSyncManager = SyncManager(
+            database = database,
+            eventRepository = DatabaseEventRepository(database),
+            userRepository = userRepository,
+            networkDetector = networkDetector,
+            httpClient = countingClient,
+            authTokenProvider = { "test-token" },
+            syncDebounceMs = 60_000L,
+            maxCoalescedChanges = 3
+        )
+
+        repeat(3) { i ->
+            debouncedSyncManager.recordLocalChange("events", SyncOperation.UPDATE, "event-$i", """{"title":"T$i"}""", "user-1")
+        }
+        kotlinx.coroutines.delay(300L)
+
+        assertEquals(1, countingClient.getCallCount())
+        debouncedSyncManager.dispose()
+    }
 }
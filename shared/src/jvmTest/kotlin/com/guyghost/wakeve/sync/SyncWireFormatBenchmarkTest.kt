@@ -0,0 +1,112 @@
+package com.guyghost.wakeve.sync
+
+import com.guyghost.wakeve.models.SyncChange
+import com.guyghost.wakeve.models.SyncEventData
+import com.guyghost.wakeve.models.SyncOperation
+import com.guyghost.wakeve.models.SyncRequest
+import kotlinx.serialization.json.Json
+import kotlin.system.measureNanoTime
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertTrue
+
+/**
+ * Payload size and decode cost of a large offline queue in each /sync wire format.
+ */
+class SyncWireFormatBenchmarkTest {
+    private val json = Json { ignoreUnknownKeys = true }
+
+    @Test
+    fun benchmarkWireFormats_1000Changes() {
+        val request = buildRequest(1000)
+
+        val jsonBytes = SyncWireCodec.encode(SyncRequest.serializer(), request, SyncWireFormat.JSON)
+        val cborBytes = SyncWireCodec.encode(SyncRequest.serializer(), request, SyncWireFormat.CBOR)
+        val gzippedCbor = SyncGzip.compress(cborBytes)
+
+        // Warm up both decoders before timing
+        repeat(5) {
+            SyncWireCodec.decode(SyncRequest.serializer(), jsonBytes, SyncWireFormat.JSON)
+            SyncWireCodec.decode(SyncRequest.serializer(), SyncGzip.decompress(gzippedCbor), SyncWireFormat.CBOR)
+        }
+        val jsonDecodeNs = measureNanoTime {
+            repeat(10) { SyncWireCodec.decode(SyncRequest.serializer(), jsonBytes, SyncWireFormat.JSON) }
+        } / 10
+        var decoded: SyncRequest? = null
+        val cborDecodeNs = measureNanoTime {
+            repeat(10) { decoded = SyncWireCodec.decode(SyncRequest.serializer(), SyncGzip.decompress(gzippedCbor), SyncWireFormat.CBOR) }
+        } / 10
+
+        println("\n=== Sync Wire Format Benchmark (${request.changes.size} changes) ===")
+        println("JSON: ${jsonBytes.size} bytes, decode ${jsonDecodeNs / 1000}µs")
+        println("CBOR: ${cborBytes.size} bytes")
+        println("CBOR + gzip: ${gzippedCbor.size} bytes, gunzip + decode ${cborDecodeNs / 1000}µs")
+        println("Size ratio: ${"%.2f".format(gzippedCbor.size.toDouble() / jsonBytes.size)}")
+
+        assertEquals(request, decoded)
+        assertTrue(cborBytes.size < jsonBytes.size, "CBOR should drop the nested JSON payload overhead")
+        assertTrue(gzippedCbor.size * 2 <= jsonBytes.size, "Compressed CBOR should be at most half of JSON")
+    }
+
+    @Test
+    fun cborCarriesChangePayloadsAsStructuredValues() {
+        val request = buildRequest(1)
+        val custom = SyncChange(
+            id = "sync-custom",
+            table = "comments",
+            operation = SyncOperation.CREATE.name,
+            recordId = "comment-1",
+            data = """{"text": "kept verbatim", "nested": {"a": [1, 2]}}""",
+            timestamp = "2026-06-20T10:00:00Z",
+            userId = "organizer-0"
+        )
+        val withCustom = request.copy(changes = request.changes + custom)
+
+        val cborBytes = SyncWireCodec.encode(SyncRequest.serializer(), withCustom, SyncWireFormat.CBOR)
+        val cborText = cborBytes.decodeToString()
+
+        // The event payload is a CBOR map, not an embedded JSON document
+        assertTrue("\"title\"" !in cborText, "Event payload should not be embedded as JSON text")
+        assertTrue("Offline event 0" in cborText)
+        // A payload without a record type travels as text and decodes to the same string
+        assertEquals(withCustom, SyncWireCodec.decode(SyncRequest.serializer(), cborBytes, SyncWireFormat.CBOR))
+        // JSON bodies keep data as a string
+        val jsonText = SyncWireCodec.encode(SyncRequest.serializer(), withCustom, SyncWireFormat.JSON).decodeToString()
+        assertTrue("\"data\":\"{\\\"id\\\":\\\"event-0\\\"" in jsonText)
+    }
+
+    @Test
+    fun contentTypeNegotiationFallsBackToJson() {
+        assertEquals(SyncWireFormat.CBOR, SyncWireFormat.fromContentType("application/cbor"))
+        assertEquals(SyncWireFormat.JSON, SyncWireFormat.fromContentType("application/json; charset=UTF-8"))
+        assertEquals(SyncWireFormat.JSON, SyncWireFormat.fromContentType(null))
+        assertTrue(SyncWireFormat.accepts("application/cbor, application/json;q=0.5", SyncWireFormat.CBOR))
+        assertTrue(!SyncWireFormat.accepts("*/*", SyncWireFormat.CBOR))
+    }
+
+    private fun buildRequest(count: Int): SyncRequest = SyncRequest(
+        changes = (0 until count).map { i ->
+            SyncChange(
+                id = "sync-$i",
+                table = "events",
+                operation = SyncOperation.CREATE.name,
+                recordId = "event-$i",
+                data = json.encodeToString(
+                    SyncEventData.serializer(),
+                    SyncEventData(
+                        id = "event-$i",
+                        title = "Offline event $i",
+                        description = "Planned while offline, \"quoted\" notes for event $i",
+                        organizerId = "organizer-${i % 10}",
+                        deadline = "2026-07-01T00:00:00Z",
+                        status = "DRAFT",
+                        updatedAt = "2026-06-20T10:00:00Z"
+                    )
+                ),
+                timestamp = "2026-06-20T10:00:${(i % 60).toString().padStart(2, '0')}Z",
+                userId = "organizer-${i % 10}"
+            )
+        },
+        lastSyncTimestamp = "2026-06-19T10:00:00Z"
+    )
+}
@@ -368,7 +368,9 @@ class EventWeatherServiceTest {
             locationType = LocationType.CITY.name,
             address = "Marseille, France",
             coordinates = coordinates?.toJson(),
-            createdAt = "2026-06-01T08:00:00Z"
+            createdAt = "2026-06-01T08:00:00Z",
+            latitude = coordinates?.latitude,
+            longitude = coordinates?.longitude
         )
     }
 